@@ -0,0 +1,497 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Network-wide exclusion of channels with poor link quality
+*/
+
+#include "channel_map_service.h"
+
+#include "embenet_critical_section.h"
+#include "embenet_node.h"
+#include "enms_node.h"
+#include "embenet_port_capabilities.h"
+#include "embenet_radio_cc1312.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+enum {
+    CHANNEL_MAP_PORT             = 1240,  ///< UDP port of the service, both for reports and maps
+    CHANNEL_MAP_GROUP            = 1240,  ///< Multicast group the channel map is sent to
+    CHANNEL_MAP_PERIOD           = 60000, ///< Time between reports and between map announcements in ms
+    CHANNEL_MAP_ACTIVATION_DELAY = 20000, ///< Network time between the announcement of a new map and its use in ms, lets the map reach every node
+    CHANNEL_MAP_MIN_ATTEMPTS     = 10,    ///< Number of frames sent on a channel in a period needed to judge the channel
+    CHANNEL_MAP_MIN_PDR          = 70,    ///< Delivery ratio in percent below which a channel is reported
+    CHANNEL_MAP_MIN_VOTES        = 2,     ///< Number of reports needed to exclude a channel, a single node does not exclude channels for the whole network
+    CHANNEL_MAP_MIN_VOTE_PCT     = 25,    ///< Share of the nodes reporting in a period, in percent, that must report a channel to exclude it
+    CHANNEL_MAP_HOLD_PERIODS     = 10,    ///< Number of periods for which a reported channel is excluded before it is tried again
+    CHANNEL_MAP_MIN_ALLOWED      = 16,    ///< Minimum number of channels left in use
+    CHANNEL_MAP_RSSI_WEIGHT      = 8,     ///< Inverse of the weight of a new sample in the RSSI average
+
+    CHANNEL_COUNT = EMBENET_RADIO_CHANNEL_MAP_SIZE * 8,
+
+    MSG_REPORT             = 1,                                   ///< Node to coordinator: bitmap of channels with poor delivery
+    MSG_MAP                = 2,                                   ///< Coordinator to nodes: version, activation time and bitmap of allowed channels
+    MSG_MAP_REQUEST        = 3,                                   ///< Joining node to its parent: request of the map in use
+    MSG_MAP_REPLY          = 4,                                   ///< Parent to joining node: the map in use, as in MSG_MAP
+    MSG_REPORT_LENGTH      = 1 + EMBENET_RADIO_CHANNEL_MAP_SIZE,  ///< type, bitmap
+    MSG_MAP_LENGTH         = 10 + EMBENET_RADIO_CHANNEL_MAP_SIZE, ///< type, version, 8 bytes of activation time, bitmap
+    MSG_MAP_REQUEST_LENGTH = 1,                                   ///< type
+};
+
+/// Channel map shared by the whole network
+typedef struct {
+    uint8_t  version;                                 ///< Incremented by the coordinator on every change
+    uint64_t activationTime;                          ///< Network time at which the map is used in ms
+    uint8_t  allowed[EMBENET_RADIO_CHANNEL_MAP_SIZE]; ///< Bitmap of allowed channels
+} ChannelMap;
+
+/// Statistics collected from link layer events
+typedef struct {
+    uint16_t attempts;  ///< Unicast data frames sent in the current period
+    uint16_t acked;     ///< Acknowledged data frames sent in the current period
+    int16_t  rssi;      ///< Average RSSI in 1/16 dBm
+    bool     rssiValid; ///< True if rssi holds at least one sample
+} ChannelStats;
+
+/// Name of the service reported to ENMS
+static const char channelMapServiceName[] = "chmap";
+/// ENMS instance the state is reported to
+static EnmsNode* channelMapEnmsNode;
+/// Socket descriptor of the service
+static EMBENET_UDP_SocketDescriptor channelMapSocket;
+/// Id of the task sending reports and maps
+static EMBENET_TaskId periodicTaskId = EMBENET_TASKID_INVALID;
+/// Id of the task switching to the announced map
+static EMBENET_TaskId activationTaskId = EMBENET_TASKID_INVALID;
+
+static bool         isCoordinator;                     ///< True if this node builds the channel map
+static ChannelStats channelStats[CHANNEL_COUNT];       ///< Link statistics, indexed by the channel used by the radio
+static uint64_t     pendingAckAsn;                     ///< ASN of the last unicast data frame sent
+static uint8_t      pendingAckChannel;                 ///< Channel of the last unicast data frame sent
+static bool         pendingAck;                        ///< True if an ACK for the frame sent in pendingAckAsn is expected
+static ChannelMap   announcedMap;                      ///< Last map built or received
+static bool         mapKnown;                          ///< True if announcedMap holds a valid map
+static bool         coordinatorKnown;                  ///< True if coordinatorAddress is known
+static EMBENET_IPV6 coordinatorAddress;                ///< Source of the last multicast map, reports are sent there
+static uint16_t     channelVotes[CHANNEL_COUNT];       ///< Coordinator only: number of reports of poor delivery in the current period
+static uint16_t     reporterCount;                     ///< Coordinator only: number of reports in the current period, including its own
+static uint8_t      channelHoldPeriods[CHANNEL_COUNT]; ///< Coordinator only: number of periods a channel remains excluded
+
+
+static bool isBitSet(uint8_t const* bitmap, size_t bit) {
+    return 0 != (bitmap[bit / 8] & (1u << (bit % 8)));
+}
+
+
+static void setBit(uint8_t* bitmap, size_t bit, bool value) {
+    if (value) {
+        bitmap[bit / 8] |= (uint8_t)(1u << (bit % 8));
+    } else {
+        bitmap[bit / 8] &= (uint8_t)~(1u << (bit % 8));
+    }
+}
+
+
+static bool isAdvChannel(size_t channel) {
+    for (size_t i = 0; i != embenetMacAdvChannelListSize; ++i) {
+        if (channel == embenetMacAdvChannelList[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Evaluates statistics of the finished period and starts a new one
+ * @param[out] bad bitmap of channels with delivery ratio below CHANNEL_MAP_MIN_PDR
+ * @return number of channels marked in bad
+ */
+static size_t collectBadChannels(uint8_t* bad) {
+    size_t count = 0;
+    memset(bad, 0, EMBENET_RADIO_CHANNEL_MAP_SIZE);
+    EMBENET_CRITICAL_SECTION_Enter();
+    for (size_t channel = 0; channel != CHANNEL_COUNT; ++channel) {
+        ChannelStats* stats = &channelStats[channel];
+        if ((stats->attempts >= CHANNEL_MAP_MIN_ATTEMPTS) && ((uint32_t)stats->acked * 100 < (uint32_t)stats->attempts * CHANNEL_MAP_MIN_PDR)) {
+            setBit(bad, channel, true);
+            ++count;
+        }
+        stats->attempts = 0;
+        stats->acked    = 0;
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+    return count;
+}
+
+
+/**
+ * @brief Counts channels of the MAC hopping sequence allowed by a map
+ * @param[in] allowed bitmap of allowed channels
+ * @return number of allowed channels
+ */
+static size_t countAllowedChannels(uint8_t const* allowed) {
+    size_t count = 0;
+    for (size_t i = 0; i != embenetMacChannelListSize; ++i) {
+        count += isBitSet(allowed, embenetMacChannelList[i]) ? 1 : 0;
+    }
+    return count;
+}
+
+
+static void applyMap(void) {
+    printf("CHANNEL_MAP_SERVICE: Using channel map version %u\n", (unsigned)announcedMap.version);
+    EMBENET_RADIO_SetChannelMap(announcedMap.allowed);
+    (void)ENMS_NODE_SetServiceState(channelMapEnmsNode, channelMapServiceName, (uint8_t)countAllowedChannels(announcedMap.allowed));
+}
+
+
+/**
+ * @brief Stores a new map and schedules the switch to it
+ * @param[in] map new map
+ */
+static void acceptMap(ChannelMap const* map) {
+    announcedMap = *map;
+    mapKnown     = true;
+    if (map->activationTime <= EMBENET_NODE_GetNetworkTime()) {
+        applyMap();
+    } else {
+        EMBENET_NODE_TaskSchedule(activationTaskId, EMBENET_NODE_TIME_SOURCE_NETWORK, map->activationTime);
+    }
+}
+
+
+/**
+ * @brief Coordinator only: builds a new map from the votes of the finished period
+ */
+static void updateMap(void) {
+    ChannelMap map = announcedMap;
+    memset(map.allowed, 0xFF, sizeof(map.allowed));
+
+    uint32_t minVotes = ((uint32_t)reporterCount * CHANNEL_MAP_MIN_VOTE_PCT + 99) / 100;
+    if (minVotes < CHANNEL_MAP_MIN_VOTES) {
+        minVotes = CHANNEL_MAP_MIN_VOTES;
+    }
+    reporterCount = 0;
+    for (size_t channel = 0; channel != CHANNEL_COUNT; ++channel) {
+        if ((channelVotes[channel] >= minVotes) && !isAdvChannel(channel)) {
+            channelHoldPeriods[channel] = CHANNEL_MAP_HOLD_PERIODS;
+        } else if (0 != channelHoldPeriods[channel]) {
+            // an excluded channel carries no traffic, so it is given another chance after a while
+            --channelHoldPeriods[channel];
+        }
+        channelVotes[channel] = 0;
+    }
+
+    size_t allowedCount = embenetMacChannelListSize;
+    for (size_t i = 0; (i != embenetMacChannelListSize) && (allowedCount > CHANNEL_MAP_MIN_ALLOWED); ++i) {
+        uint8_t channel = embenetMacChannelList[i];
+        if ((0 != channelHoldPeriods[channel]) && isBitSet(map.allowed, channel)) {
+            setBit(map.allowed, channel, false);
+            --allowedCount;
+        }
+    }
+
+    if (!mapKnown || (0 != memcmp(map.allowed, announcedMap.allowed, sizeof(map.allowed)))) {
+        map.version += 1;
+        map.activationTime = EMBENET_NODE_GetNetworkTime() + CHANNEL_MAP_ACTIVATION_DELAY;
+        printf("CHANNEL_MAP_SERVICE: New channel map version %u with %u channels\n", (unsigned)map.version, (unsigned)allowedCount);
+        acceptMap(&map);
+    }
+}
+
+
+static void sendReport(uint8_t const* bad) {
+    uint8_t message[MSG_REPORT_LENGTH];
+    message[0] = MSG_REPORT;
+    memcpy(&message[1], bad, EMBENET_RADIO_CHANNEL_MAP_SIZE);
+    if (EMBENET_RESULT_OK != EMBENET_UDP_Send(&channelMapSocket, &coordinatorAddress, CHANNEL_MAP_PORT, message, sizeof(message))) {
+        printf("CHANNEL_MAP_SERVICE: Failed to send report\n");
+    }
+}
+
+
+/**
+ * @brief Sends the request of the map in use to the parent, which joined the network earlier and already uses it
+ */
+static void requestMap(void) {
+    EMBENET_IPV6 parentAddress;
+    if (EMBENET_RESULT_OK != EMBENET_NODE_GetParentAddress(&parentAddress)) {
+        return;
+    }
+    uint8_t message[MSG_MAP_REQUEST_LENGTH] = {MSG_MAP_REQUEST};
+    if (EMBENET_RESULT_OK != EMBENET_UDP_Send(&channelMapSocket, &parentAddress, CHANNEL_MAP_PORT, message, sizeof(message))) {
+        printf("CHANNEL_MAP_SERVICE: Failed to request channel map\n");
+    }
+}
+
+
+/**
+ * @brief Sends announcedMap
+ * @param[in] type MSG_MAP or MSG_MAP_REPLY
+ * @param[in] address destination
+ */
+static void sendMap(uint8_t type, EMBENET_IPV6 const* address) {
+    uint8_t message[MSG_MAP_LENGTH];
+    message[0] = type;
+    message[1] = announcedMap.version;
+    for (size_t i = 0; i != sizeof(announcedMap.activationTime); ++i) {
+        message[2 + i] = (uint8_t)(announcedMap.activationTime >> (8 * i));
+    }
+    memcpy(&message[10], announcedMap.allowed, EMBENET_RADIO_CHANNEL_MAP_SIZE);
+    if (EMBENET_RESULT_OK != EMBENET_UDP_Send(&channelMapSocket, address, CHANNEL_MAP_PORT, message, sizeof(message))) {
+        printf("CHANNEL_MAP_SERVICE: Failed to send channel map\n");
+    }
+}
+
+
+/**
+ * @brief Coordinator only: multicasts announcedMap to all nodes
+ */
+static void announceMap(void) {
+    EMBENET_IPV6 borderRouterAddress;
+    if (EMBENET_RESULT_OK != EMBENET_NODE_GetBorderRouterAddress(&borderRouterAddress)) {
+        return;
+    }
+    EMBENET_NetworkPrefix prefix = 0;
+    for (size_t i = 0; i != sizeof(prefix); ++i) {
+        prefix = (prefix << 8) | borderRouterAddress.val[i];
+    }
+    EMBENET_IPV6 groupAddress = EMBENET_AssembleMulticastIpv6(prefix, CHANNEL_MAP_GROUP);
+    sendMap(MSG_MAP, &groupAddress);
+}
+
+
+/**
+ * @brief Reads a map from MSG_MAP or MSG_MAP_REPLY
+ * @param[in] message received message of MSG_MAP_LENGTH bytes
+ * @param[out] map map read from the message
+ */
+static void readMap(uint8_t const* message, ChannelMap* map) {
+    *map = (ChannelMap){.version = message[1], .activationTime = 0};
+    for (size_t i = 0; i != sizeof(map->activationTime); ++i) {
+        map->activationTime |= (uint64_t)message[2 + i] << (8 * i);
+    }
+    memcpy(map->allowed, &message[10], EMBENET_RADIO_CHANNEL_MAP_SIZE);
+}
+
+
+/**
+ * @brief Task evaluating channel statistics, invoked every CHANNEL_MAP_PERIOD
+ *
+ * @param[in] taskId id of the task
+ * @param[in] timeSource time source (local time or network time)
+ * @param[in] t time at which the task was scheduled to run
+ * @param[in] context generic, user-defined context
+ */
+static void periodicTask(EMBENET_TaskId taskId, EMBENET_NODE_TimeSource timeSource, uint64_t t, void* context) {
+    uint8_t bad[EMBENET_RADIO_CHANNEL_MAP_SIZE];
+    size_t  badCount = collectBadChannels(bad);
+
+    if (isCoordinator) {
+        for (size_t channel = 0; channel != CHANNEL_COUNT; ++channel) {
+            channelVotes[channel] += isBitSet(bad, channel) ? 1 : 0;
+        }
+        reporterCount += 1;
+        updateMap();
+        // the map is repeated even if unchanged, so that a lost announcement is made up for
+        announceMap();
+    } else if (!mapKnown) {
+        // the request sent after joining was lost, or the parent did not know the map yet
+        requestMap();
+    } else if (coordinatorKnown) {
+        // the coordinator address is learnt from the first map multicast by the coordinator
+        printf("CHANNEL_MAP_SERVICE: Reporting %u channels with poor delivery\n", (unsigned)badCount);
+        sendReport(bad);
+    }
+
+    EMBENET_NODE_TaskSchedule(taskId, timeSource, t + CHANNEL_MAP_PERIOD);
+}
+
+
+/**
+ * @brief Task switching to the announced map at its activation time
+ *
+ * @param[in] taskId id of the task
+ * @param[in] timeSource time source (local time or network time)
+ * @param[in] t time at which the task was scheduled to run
+ * @param[in] context generic, user-defined context
+ */
+static void activationTask(EMBENET_TaskId taskId, EMBENET_NODE_TimeSource timeSource, uint64_t t, void* context) {
+    applyMap();
+}
+
+
+/**
+ * @brief Handles reports on the coordinator, maps on the other nodes and map requests on every node that knows the map
+ *
+ * @param[in] socket pointer to socket descriptor
+ * @param[in] sourceAddress IPv6 Address of the packet originator
+ * @param[in] sourcePort UDP source port
+ * @param[in] data pointer to datagram's payload
+ * @param[in] dataSize size of datagram's payload
+ */
+static void receptionHandler(EMBENET_UDP_SocketDescriptor const* socket, EMBENET_IPV6 const* sourceAddress, uint16_t sourcePort, void const* data, size_t dataSize) {
+    uint8_t const* message = (uint8_t const*)data;
+
+    if (isCoordinator && (MSG_REPORT_LENGTH == dataSize) && (MSG_REPORT == message[0])) {
+        for (size_t channel = 0; channel != CHANNEL_COUNT; ++channel) {
+            if (isBitSet(&message[1], channel) && (channelVotes[channel] != UINT16_MAX)) {
+                ++channelVotes[channel];
+            }
+        }
+        if (reporterCount != UINT16_MAX) {
+            ++reporterCount;
+        }
+    } else if ((MSG_MAP_REQUEST_LENGTH == dataSize) && (MSG_MAP_REQUEST == message[0])) {
+        if (mapKnown) {
+            sendMap(MSG_MAP_REPLY, sourceAddress);
+        }
+    } else if (!isCoordinator && (MSG_MAP_LENGTH == dataSize) && (MSG_MAP == message[0])) {
+        coordinatorAddress = *sourceAddress;
+        coordinatorKnown   = true;
+        if (mapKnown && (message[1] == announcedMap.version)) {
+            return;
+        }
+        ChannelMap map;
+        readMap(message, &map);
+        printf("CHANNEL_MAP_SERVICE: Received channel map version %u\n", (unsigned)map.version);
+        acceptMap(&map);
+    } else if (!isCoordinator && (MSG_MAP_LENGTH == dataSize) && (MSG_MAP_REPLY == message[0])) {
+        if (mapKnown) {
+            return; // a reply may be older than the map multicast in the meantime
+        }
+        ChannelMap map;
+        readMap(message, &map);
+        printf("CHANNEL_MAP_SERVICE: Received channel map version %u from parent\n", (unsigned)map.version);
+        acceptMap(&map);
+    } else {
+        printf("CHANNEL_MAP_SERVICE: Unrecognized message with size: %d\n", (int)dataSize);
+    }
+}
+
+
+void channel_map_service_init(EnmsNode* enmsNode, bool coordinator) {
+    isCoordinator    = coordinator;
+    mapKnown         = false;
+    coordinatorKnown = false;
+    pendingAck       = false;
+    reporterCount    = 0;
+    memset(channelStats, 0, sizeof(channelStats));
+    memset(channelVotes, 0, sizeof(channelVotes));
+    memset(channelHoldPeriods, 0, sizeof(channelHoldPeriods));
+
+    channelMapEnmsNode = enmsNode;
+    (void)ENMS_NODE_RegisterService(enmsNode, channelMapServiceName, (uint8_t)embenetMacChannelListSize);
+
+    // Unicast traffic carries reports, multicast traffic carries maps
+    channelMapSocket = (EMBENET_UDP_SocketDescriptor){
+        .port           = CHANNEL_MAP_PORT,
+        .groupId        = 0, // GroupId is ignored, when using EMBENET_UDP_TRAFFIC_ALL
+        .handledTraffic = EMBENET_UDP_TRAFFIC_ALL,
+        .rxDataHandler  = receptionHandler,
+        .userContext    = NULL,
+    };
+
+    EMBENET_Result registrationStatus = EMBENET_UDP_RegisterSocket(&channelMapSocket);
+    if (EMBENET_RESULT_OK == registrationStatus) {
+        periodicTaskId   = EMBENET_NODE_TaskCreate(periodicTask, NULL);
+        activationTaskId = EMBENET_NODE_TaskCreate(activationTask, NULL);
+        if ((EMBENET_TASKID_INVALID == periodicTaskId) || (EMBENET_TASKID_INVALID == activationTaskId)) {
+            printf("CHANNEL_MAP_SERVICE: Unable to create task\n");
+        } else {
+            printf("CHANNEL_MAP_SERVICE: Service initialized\n");
+        }
+    } else {
+        printf("CHANNEL_MAP_SERVICE: Registering socket failed with status %d\n", (int)registrationStatus);
+    }
+}
+
+
+void channel_map_service_start(void) {
+    printf("CHANNEL_MAP_SERVICE: Starting service\n");
+    if (!isCoordinator) {
+        if (!EMBENET_NODE_JoinGroup(CHANNEL_MAP_GROUP)) {
+            printf("CHANNEL_MAP_SERVICE: Unable to join group %u\n", (unsigned)CHANNEL_MAP_GROUP);
+        }
+        // the map may be in use for long, the next announcement is not awaited
+        requestMap();
+    }
+    EMBENET_NODE_TaskSchedule(periodicTaskId, EMBENET_NODE_TIME_SOURCE_LOCAL, EMBENET_NODE_GetLocalTime() + CHANNEL_MAP_PERIOD);
+}
+
+
+void channel_map_service_stop(void) {
+    printf("CHANNEL_MAP_SERVICE: Stopping service\n");
+    EMBENET_NODE_TaskCancel(periodicTaskId);
+    EMBENET_NODE_TaskCancel(activationTaskId);
+    if (!isCoordinator) {
+        EMBENET_NODE_LeaveGroup(CHANNEL_MAP_GROUP);
+        // the next network may use another map, it will be received after joining
+        mapKnown         = false;
+        coordinatorKnown = false;
+        EMBENET_RADIO_SetChannelMap(NULL);
+        (void)ENMS_NODE_SetServiceState(channelMapEnmsNode, channelMapServiceName, (uint8_t)embenetMacChannelListSize);
+    }
+}
+
+
+void channel_map_service_on_link_layer_event(const EMBENET_TRACE_LinkLayerTelemetry* linkLayerTelemetry) {
+    if (EMBENET_TRACE_CELL_ROLE_ADV == linkLayerTelemetry->cellRole) {
+        return; // advertisement cells hop over embenetMacAdvChannelList, which is never restricted
+    }
+    // TSCH hopping: the MAC channel is selected from embenetMacChannelList by ASN and channel offset, the radio maps it further
+    uint8_t macChannel = embenetMacChannelList[(linkLayerTelemetry->asn + linkLayerTelemetry->channelOffset) % embenetMacChannelListSize];
+    uint8_t channel    = EMBENET_RADIO_MapChannel(macChannel);
+    if (channel >= CHANNEL_COUNT) {
+        return;
+    }
+    ChannelStats* stats = &channelStats[channel];
+
+    if (EMBENET_TRACE_CELL_EVENT_TX == linkLayerTelemetry->cellEvent) {
+        bool broadcast = (UINT64_MAX == linkLayerTelemetry->dst) || (EMBENET_EUI64_INVALID == linkLayerTelemetry->dst);
+        if ((EMBENET_TRACE_FRAME_TYPE_DATA == linkLayerTelemetry->frameType) && !broadcast) {
+            if (stats->attempts != UINT16_MAX) {
+                ++stats->attempts;
+            }
+            pendingAckAsn     = linkLayerTelemetry->asn;
+            pendingAckChannel = channel;
+            pendingAck        = true;
+        }
+        return;
+    }
+
+    if ((EMBENET_TRACE_FRAME_TYPE_ACK == linkLayerTelemetry->frameType) && pendingAck && (pendingAckAsn == linkLayerTelemetry->asn)) {
+        if (channelStats[pendingAckChannel].acked < channelStats[pendingAckChannel].attempts) {
+            ++channelStats[pendingAckChannel].acked;
+        }
+        pendingAck = false;
+    }
+    int16_t rssi = (int16_t)(linkLayerTelemetry->rssiOrTxPower * 16);
+    if (stats->rssiValid) {
+        stats->rssi += (int16_t)((rssi - stats->rssi) / CHANNEL_MAP_RSSI_WEIGHT);
+    } else {
+        stats->rssi      = rssi;
+        stats->rssiValid = true;
+    }
+}
+
+
+bool channel_map_service_get_stats(uint8_t channel, ChannelMapStats* stats) {
+    if (channel >= CHANNEL_COUNT) {
+        return false;
+    }
+    EMBENET_CRITICAL_SECTION_Enter();
+    ChannelStats current = channelStats[channel];
+    EMBENET_CRITICAL_SECTION_Exit();
+    *stats = (ChannelMapStats){
+        .attempts = current.attempts,
+        .acked    = current.acked,
+        .rssi     = current.rssiValid ? (int8_t)(current.rssi / 16) : INT8_MIN,
+    };
+    return true;
+}
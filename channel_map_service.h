@@ -0,0 +1,70 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Network-wide exclusion of channels with poor link quality
+*/
+
+#ifndef CHANNEL_MAP_SERVICE_H_
+#define CHANNEL_MAP_SERVICE_H_
+
+#include "embenet_node_trace.h"
+#include "enms_node.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Link statistics of a single channel
+typedef struct {
+    uint16_t attempts; ///< Number of unicast data frames sent in the current period
+    uint16_t acked;    ///< Number of those frames that were acknowledged
+    int8_t   rssi;     ///< Average RSSI of frames received on this channel in dBm, INT8_MIN if none was received
+} ChannelMapStats;
+
+/**
+ * @brief Initializes the channel map service.
+ *
+ * Opens a UDP socket and initializes the tasks of the service. Every node evaluates the delivery ratio of its links on every channel
+ * and periodically reports channels with poor delivery to the coordinator. The coordinator (root) collects the reports and excludes
+ * for some time the channels reported by at least two nodes and by at least a quarter of the nodes reporting in the period.
+ * It multicasts the resulting channel map, all nodes switch to a new map at the same network time. A node that joins the network
+ * requests the map in use from its parent, so that it hops over the same frequencies as its neighbors without waiting for the next
+ * announcement.
+ *
+ * Registers the "chmap" service in ENMS. The state of the service reported in the ENMS status is the number of channels in use.
+ *
+ * @param[in] enmsNode ENMS Node service instance
+ * @param[in] coordinator true if the node builds and distributes the channel map, i.e. it is the root
+ */
+void channel_map_service_init(EnmsNode* enmsNode, bool coordinator);
+
+/**
+ * @brief Starts the channel map service.
+ */
+void channel_map_service_start(void);
+
+/**
+ * @brief Stops the channel map service and restores use of all channels.
+ */
+void channel_map_service_stop(void);
+
+/**
+ * @brief Updates channel statistics with a link layer event.
+ *
+ * Must be connected to onLinkLayerEvent of @ref EMBENET_NODE_TraceHandlers. Called in interrupt context.
+ *
+ * @param[in] linkLayerTelemetry link layer event
+ */
+void channel_map_service_on_link_layer_event(const EMBENET_TRACE_LinkLayerTelemetry* linkLayerTelemetry);
+
+/**
+ * @brief Gets statistics of a single channel.
+ *
+ * @param[in] channel radio channel
+ * @param[out] stats statistics of the channel
+ * @return true on success, false if channel is out of range
+ */
+bool channel_map_service_get_stats(uint8_t channel, ChannelMapStats* stats);
+
+#endif
@@ -0,0 +1,102 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extensions of the AES-128 interface specific to the CC1312 port
+*/
+
+#ifndef EMBENET_AES128_CC1312_H_
+#define EMBENET_AES128_CC1312_H_
+
+#include "embenet_aes128.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup embenet_node_port_aes_cc1312 AES-128 Interface extensions
+ *
+ * Functions provided by this port on top of @ref embenet_node_port_aes. The stack does not use them.
+ * The port keeps the last @ref EMBENET_AES128_KEY_SLOTS keys set by @ref EMBENET_AES128_SetKey, switching back to one of them copies nothing.
+ * @{
+ */
+
+/// Number of keys held by the port at once, see @ref EMBENET_AES128_LoadKey
+#define EMBENET_AES128_KEY_SLOTS 4U
+
+typedef uint8_t EMBENET_AES128_KeyHandle; ///< Handle of a key held by the port, see @ref EMBENET_AES128_LoadKey
+
+/// Length of the CCM* nonce in bytes, as used by IEEE 802.15.4
+#define EMBENET_AES128_CCM_NONCE_LENGTH 13U
+
+/**
+ * @brief Loads a key into the cache of the port without selecting it
+ *
+ * If the key is already held, its handle is returned. Otherwise it replaces the least recently used key. A handle stays valid until
+ * @ref EMBENET_AES128_KEY_SLOTS other keys are loaded without selecting it in between.
+ * This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[in] key 16 Bytes long secret key
+ * @return handle of the key
+ */
+EMBENET_AES128_KeyHandle EMBENET_AES128_LoadKey(uint8_t const key[16U]);
+
+/**
+ * @brief Selects a loaded key for further encryption and decryption operations
+ *
+ * Equivalent to @ref EMBENET_AES128_SetKey with the loaded key, at the cost of a single assignment.
+ * This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[in] keyHandle handle returned by @ref EMBENET_AES128_LoadKey
+ */
+void EMBENET_AES128_SelectKey(EMBENET_AES128_KeyHandle keyHandle);
+
+/**
+ * @brief Authenticates and encrypts a frame with CCM* using the key set by @ref EMBENET_AES128_SetKey
+ *
+ * Performs the whole IEEE 802.15.4 CCM* transformation in a single call instead of one @ref EMBENET_AES128_Encrypt call per block.
+ * This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[in] nonce 13 byte nonce
+ * @param[in] aad additional data that is authenticated but not encrypted (e.g. the frame header), may be NULL if aadLength is 0
+ * @param[in] aadLength length of aad, at most 65279 bytes
+ * @param[in,out] data plaintext, overwritten in place with the ciphertext, or with zeros if the accelerator fails
+ * @param[in] dataLength length of data, at most 65535 bytes
+ * @param[out] mic message integrity code of aad and data, zeros if the accelerator fails
+ * @param[in] micLength length of mic: 4, 8 or 16 bytes, or 0 for encryption only
+ * @return true on success, false if the lengths are not supported or the accelerator failed
+ */
+bool EMBENET_AES128_CcmEncrypt(uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad, size_t aadLength, uint8_t* data, size_t dataLength,
+                               uint8_t* mic, size_t micLength);
+
+/**
+ * @brief Decrypts and verifies a frame with CCM* using the key set by @ref EMBENET_AES128_SetKey
+ *
+ * This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[in] nonce 13 byte nonce
+ * @param[in] aad additional authenticated data, may be NULL if aadLength is 0
+ * @param[in] aadLength length of aad, at most 65279 bytes
+ * @param[in,out] data ciphertext, overwritten in place with the plaintext, or with zeros if the MIC is invalid or the accelerator fails
+ * @param[in] dataLength length of data, at most 65535 bytes
+ * @param[in] mic received message integrity code
+ * @param[in] micLength length of mic: 4, 8 or 16 bytes, or 0 for encryption only
+ * @return true if the MIC is valid, false if it is not, if the lengths are not supported or if the accelerator failed
+ */
+bool EMBENET_AES128_CcmDecrypt(uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad, size_t aadLength, uint8_t* data, size_t dataLength,
+                               uint8_t const* mic, size_t micLength);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_AES128_CC1312_H_ included
@@ -0,0 +1,73 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extensions of the border router communication interface specific to the CC1312 port
+*/
+
+#ifndef EMBENET_BRT_CC1312_H_
+#define EMBENET_BRT_CC1312_H_
+
+#include "embenet_brt.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup embenet_node_port_brt_cc1312 Border Router Communication Interface extensions
+ *
+ * Functions provided by this port on top of @ref embenet_node_port_brt. The stack does not use them.
+ * @{
+ */
+
+/// Single segment of a packet passed to @ref EMBENET_BRT_SendV
+typedef struct {
+    const void* data;   ///< segment data as byte-oriented buffer
+    size_t      length; ///< segment length in bytes
+} EMBENET_BRT_Segment;
+
+/**
+ * @brief 		Sends data packet scattered over several buffers to LBR.
+ *
+ * The segments are framed as a single packet, in the given order, without being gathered into a contiguous buffer first.
+ * @param[in] 	segments array of packet segments
+ * @param[in] 	segmentCount number of segments in the array
+ */
+void EMBENET_BRT_SendV(const EMBENET_BRT_Segment* segments, size_t segmentCount);
+
+/**
+ * @brief 		Requests the border router to switch the link to a different baud rate.
+ *
+ * The request is sent as a link control frame and never reaches the stack on either side. Control frames start with the escape byte (0x7d) followed by 0x00
+ * right after the opening flag, a sequence the HDLC encoder never produces, so every frame of the stack is passed through regardless of its content. The marker
+ * is not covered by the CRC, a border router that does not know it drops the frame as corrupted.
+ *
+ * When the border router accepts the request, both sides switch right after the accepting frame. If the border router does not support the request, the
+ * link stays at its current baud rate. The switch is performed once UART drains the frames already queued, without blocking @ref EMBENET_BRT_Receive.
+ * When too many corrupted frames are received at a raised baud rate, a fallback control frame is sent to the border router and the link returns to the
+ * default baud rate (115200). A fallback control frame received from the border router makes the link return to the default baud rate as well.
+ * @param[in] 	baudRate requested baud rate in bits per second
+ * @return 		true if the request was sent, false if the baud rate is not supported by this port
+ */
+bool EMBENET_BRT_RequestBaudRate(uint32_t baudRate);
+
+/**
+ * @brief 		Returns the baud rate currently used by the link.
+ * @return 		baud rate in bits per second
+ */
+uint32_t EMBENET_BRT_GetBaudRate(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_BRT_CC1312_H_ included
@@ -0,0 +1,415 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extensions of the radio interface specific to the CC1312 port
+*/
+
+#ifndef EMBENET_RADIO_CC1312_H_
+#define EMBENET_RADIO_CC1312_H_
+
+#include "embenet_radio.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup embenet_node_port_radio_cc1312 Radio Interface extensions
+ *
+ * Functions provided by this port on top of @ref embenet_node_port_radio. The stack does not use them.
+ *
+ * The txRxStartDelay and rxDelay reported by @ref EMBENET_RADIO_GetCapabilities are refined at runtime, see @ref EMBENET_RADIO_GetCalibration.
+ * The lqi field of @ref EMBENET_RADIO_RxInfo ranges from 0 (at sensitivity) to 255.
+ * The two timestamps of a received frame differ in origin: the end of frame is computed from the RAT time the RF core latches at the
+ * synchronization word, so it does not depend on the callback latency, while the start of frame is the software time of the startOfFrame
+ * callback less rxStartCorrection, so it is late by the variation of that latency.
+ * @{
+ */
+
+/// Size in bytes of the channel bitmap passed to @ref EMBENET_RADIO_SetChannelMap, enough for 128 channels
+#define EMBENET_RADIO_CHANNEL_MAP_SIZE 16u
+
+/// Value passed to @ref EMBENET_RADIO_SetLinkTxPower to restore the power requested by the MAC
+#define EMBENET_RADIO_LINK_TXP_DEFAULT INT8_MIN
+
+
+/// Radio delays measured at runtime, see @ref EMBENET_RADIO_GetCalibration
+typedef struct {
+    EMBENET_TimeUs txStartCorrection; ///< time between the startOfFrame callback and the appearance of first bit of preamble during transmission
+    EMBENET_TimeUs txEndCorrection;   ///< time between the endOfFrame callback and the end of transmission
+    EMBENET_TimeUs rxStartCorrection; ///< time between the appearance of first bit of preamble and a call of startOfFrame callback during reception
+    EMBENET_TimeUs rxDelay;           ///< time between the reception trigger and the receiver listening, reported as rxDelay by EMBENET_RADIO_GetCapabilities
+    EMBENET_TimeUs txStartDeviation;  ///< standard deviation of txStartCorrection, 0 if not yet calibrated
+    EMBENET_TimeUs txEndDeviation;    ///< standard deviation of txEndCorrection, 0 if not yet calibrated
+    EMBENET_TimeUs rxStartDeviation;  ///< standard deviation of rxStartCorrection, 0 if not yet calibrated
+    bool           calibrated;        ///< true if all corrections were measured, false if some of them are still the defaults
+} EMBENET_RADIO_Calibration;
+
+
+/**
+ * Type defining PHY profile.
+ *
+ * Only profiles whose radio settings were validated on the board are offered. Another profile is added together with its own setup
+ * exported from SmartRF Studio or SysConfig, as the settings cannot be derived from the 50 kbps setup by scaling.
+ */
+typedef enum {
+    EMBENET_RADIO_PHY_50KBPS, ///< 2-GFSK 50 kbps, the setup generated by SysConfig
+    EMBENET_RADIO_PHY_COUNT,  ///< Number of PHY profiles
+} EMBENET_RADIO_Phy;
+
+
+/// Result of energy detection on a single channel
+typedef struct {
+    EMBENET_RADIO_Channel channel;    ///< scanned channel
+    EMBENET_RADIO_Power   noiseFloor; ///< lowest RSSI sampled on the channel, -128 if no sample was taken
+    EMBENET_RADIO_Power   peak;       ///< highest RSSI sampled on the channel, -128 if no sample was taken
+} EMBENET_RADIO_EnergyScanResult;
+
+
+/// Radio events counted since @ref EMBENET_RADIO_ResetCounters, see @ref EMBENET_RADIO_GetCounters
+typedef struct {
+    uint32_t       rxFrames;       ///< Frames received with valid CRC
+    uint32_t       rxCrcErrors;    ///< Frames received with invalid CRC
+    uint32_t       rxSyncMisses;   ///< Listening windows closed without synchronization, see @ref EMBENET_RADIO_SetRxWindow
+    uint32_t       rxOverflows;    ///< Frames dropped for lack of a free RX buffer or for excessive length
+    uint32_t       rxErrors;       ///< Listening ended by an RF driver error
+    uint32_t       txFrames;       ///< Frames transmitted
+    uint32_t       txCcaBusy;      ///< Frames dropped because CCA found the channel busy
+    uint32_t       txAborts;       ///< Transmissions ended by an RF driver error
+    uint32_t       ackFlushMisses; ///< Automatic ACKs sent for frames not to be acknowledged, as they were not cancelled before the ACK delay
+    uint32_t       rxLatencySum;   ///< Sum of delays between the end of a received frame and the onEndFrame callback in us, divide by rxFrames for the mean
+    EMBENET_TimeUs rxLatencyMax;   ///< Longest delay between the end of a received frame and the onEndFrame callback in us
+} EMBENET_RADIO_Counters;
+
+
+/**
+ * @brief Lends received frame without copying it.
+ * @note Should be called after onEndFrame occurs, instead of @ref EMBENET_RADIO_GetReceivedFrame.
+ *
+ * The frame stays in radio-owned memory and is not overwritten by subsequent receptions until it is given back with @ref EMBENET_RADIO_ReleaseReceivedFrame.
+ * If all radio buffers are lent, subsequent frames are dropped.
+ *
+ * @param[out] psdu - set to the received PSDU, NULL if no valid frame was received
+ * @return @ref EMBENET_RADIO_RxInfo
+ */
+EMBENET_RADIO_RxInfo EMBENET_RADIO_LendReceivedFrame(uint8_t const** psdu);
+
+
+/**
+ * @brief Gives back frame lent by @ref EMBENET_RADIO_LendReceivedFrame, so that its memory can be reused for reception.
+ *
+ * @param[in] psdu - pointer obtained from @ref EMBENET_RADIO_LendReceivedFrame
+ */
+void EMBENET_RADIO_ReleaseReceivedFrame(uint8_t const* psdu);
+
+
+/**
+ * @brief Lends radio-owned buffer in which the next frame can be built without copying.
+ *
+ * The buffer holds up to EMBENET_RADIO_MAX_PSDU_LENGTH bytes. It stays owned by the caller until it is passed to @ref EMBENET_RADIO_CommitTx
+ * or the radio is idled with @ref EMBENET_RADIO_Idle, which takes back buffers not committed until then. A frame must therefore be built and committed
+ * without idling the radio in between.
+ * The radio provides two buffers, so the next frame (e.g. ACK) can be built while the previous one is transmitted.
+ * @return pointer to the buffer, NULL if no buffer is available
+ */
+uint8_t* EMBENET_RADIO_GetTxBuffer(void);
+
+
+/**
+ * @brief Wakes transceiver from IDLE state.
+ *        Prepares transceiver for transmission of a frame built in the buffer obtained from @ref EMBENET_RADIO_GetTxBuffer.
+ *        Equivalent of @ref EMBENET_RADIO_TxEnable, but the frame is not copied. The buffer returns to the radio once the frame is transmitted,
+ *        replaced by another commit or the radio is idled.
+ * @param[in] channel - Channel number.
+ * @param[in] txp transmit power in dBm
+ * @param[in] psdu - buffer obtained from @ref EMBENET_RADIO_GetTxBuffer
+ * @param[in] psduLen - data length in bytes (must be in range EMBENET_RADIO_MIN_PSDU_LENGTH to EMBENET_RADIO_MAX_PSDU_LENGTH)
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS when psdu is not a buffer lent by @ref EMBENET_RADIO_GetTxBuffer, or it was taken back by
+ *         @ref EMBENET_RADIO_Idle
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_CommitTx(EMBENET_RADIO_Channel channel, EMBENET_RADIO_Power txp, uint8_t* psdu, size_t psduLen);
+
+
+/**
+ * @brief Schedules transmission trigger at given time.
+ *        Equivalent of calling @ref EMBENET_RADIO_TxNow exactly at triggerTime. The moment is kept by the radio hardware, so it does not depend
+ *        on software and interrupt latency.
+ * @param[in] triggerTime - time of the trigger in us, in the timebase of @ref EMBENET_TIMER_ReadCounter. Time in the past triggers transmission at once.
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_GENERAL_ERROR on error
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_TxAt(EMBENET_TimeUs triggerTime);
+
+
+/**
+ * @brief Schedules listening trigger at given time.
+ *        Equivalent of calling @ref EMBENET_RADIO_RxNow exactly at triggerTime. The moment is kept by the radio hardware, so it does not depend
+ *        on software and interrupt latency.
+ * @param[in] triggerTime - time of the trigger in us, in the timebase of @ref EMBENET_TIMER_ReadCounter. Time in the past triggers listening at once.
+ * @retval EMBENET_RADIO_STATUS_SUCCESS if no error occurred
+ * @retval EMBENET_RADIO_STATUS_GENERAL_ERROR on error
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_RxAt(EMBENET_TimeUs triggerTime);
+
+
+/**
+ * @brief Enables automatic acknowledgement of received frames.
+ *
+ * While enabled, every listening started by @ref EMBENET_RADIO_RxNow or @ref EMBENET_RADIO_RxAt is chained with transmission of the given ACK.
+ * The radio hardware sends it a fixed delay after reception of a frame with valid CRC, on the listening channel, without software involvement.
+ * The hardware cannot match the destination, whose position varies with the IEEE 802.15.4 header, so the ACK is cancelled in the RF callback
+ * unless the frame has the ACK request bit set and is addressed to this node, i.e. to its EUI-64 or to the short address set by
+ * @ref EMBENET_RADIO_SetShortAddress. The cancellation has to beat the delay; ACKs that went out anyway are counted in ackFlushMisses
+ * of @ref EMBENET_RADIO_GetCounters, and rxLatencyMax shows how close the callbacks come to the delay.
+ * Fields depending on the received frame (e.g. sequence number) can be patched with @ref EMBENET_RADIO_GetAutoAck in the onEndFrame callback,
+ * which is why the delay must cover the callback latency. Calling @ref EMBENET_RADIO_Idle in the onEndFrame callback cancels the ACK.
+ *
+ * @param[in] ack - ACK PSDU, NULL disables automatic acknowledgement
+ * @param[in] ackLen - ACK length in bytes (must be in range EMBENET_RADIO_MIN_PSDU_LENGTH to EMBENET_RADIO_MAX_PSDU_LENGTH)
+ * @param[in] txp - transmit power of the ACK in dBm
+ * @param[in] delay - time between the end of the received frame and the ACK transmission trigger in us, at least 500 us
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS when ackLen > EMBENET_RADIO_MAX_PSDU_LENGTH or the delay is too short to cancel the ACK
+ * @retval EMBENET_RADIO_STATUS_WRONG_STATE when called while listening
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_SetAutoAck(uint8_t const* ack, size_t ackLen, EMBENET_RADIO_Power txp, EMBENET_TimeUs delay);
+
+
+/**
+ * @brief Gets ACK set by @ref EMBENET_RADIO_SetAutoAck, so that its fields can be patched in place before it is sent.
+ *
+ * @return pointer to the ACK PSDU, NULL if automatic acknowledgement is disabled
+ */
+uint8_t* EMBENET_RADIO_GetAutoAck(void);
+
+
+/**
+ * @brief Sets the short address assigned to the node by the stack.
+ *
+ * Frames addressed to it are acknowledged by @ref EMBENET_RADIO_SetAutoAck. Until it is set, only frames addressed to the EUI-64 of the node are.
+ *
+ * @param[in] address short address of the node, 0xffff if the node has none
+ */
+void EMBENET_RADIO_SetShortAddress(uint16_t address);
+
+
+/**
+ * @brief Gets radio delays measured at runtime.
+ *
+ * Every transmitted and received frame is compared with the events timed by the radio hardware. @ref EMBENET_RADIO_TxAt has RAT start
+ * the preamble at txDelay after the trigger, whatever time the synthesizer takes to lock, and received frames carry the RAT timestamp of
+ * the synchronization word. Frames sent with @ref EMBENET_RADIO_TxNow, or whose synthesizer locked too late, have no hardware reference
+ * and are not measured. The measured delays replace the empirical defaults used to correct the timestamps passed to the startOfFrame
+ * and endOfFrame callbacks of frames without a reference, once enough frames were exchanged. Frames sent on schedule are reported
+ * at their scheduled times. The lock time of the synthesizer, seen with the callback latency, gives the rxDelay.
+ *
+ * @param[out] calibration measured delays
+ */
+void EMBENET_RADIO_GetCalibration(EMBENET_RADIO_Calibration* calibration);
+
+
+/**
+ * @brief Discards radio delays measured so far and restarts calibration from the empirical defaults.
+ */
+void EMBENET_RADIO_ResetCalibration(void);
+
+
+/**
+ * @brief Gets radio timings of given PHY profile.
+ *
+ * @param[in] phy PHY profile
+ * @return radio timings @ref EMBENET_RADIO_Capabilities, NULL if phy is out of range
+ */
+EMBENET_RADIO_Capabilities const* EMBENET_RADIO_GetPhyCapabilities(EMBENET_RADIO_Phy phy);
+
+
+/**
+ * @brief Selects PHY profile used by subsequent transmissions and receptions.
+ *
+ * Both ends of a link must use the same profile. The MAC can select a faster profile on good links and a more robust one on weak links,
+ * switching before @ref EMBENET_RADIO_TxEnable or @ref EMBENET_RADIO_RxEnable of each slot. @ref EMBENET_RADIO_GetCapabilities
+ * returns timings of the selected profile.
+ *
+ * @param[in] phy PHY profile
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS when phy is out of range
+ * @retval EMBENET_RADIO_STATUS_WRONG_STATE when radio is not idle
+ * @retval EMBENET_RADIO_STATUS_GENERAL_ERROR when the radio could not be reconfigured
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_SetPhy(EMBENET_RADIO_Phy phy);
+
+
+/**
+ * @brief Gets selected PHY profile.
+ *
+ * @return PHY profile set by @ref EMBENET_RADIO_SetPhy
+ */
+EMBENET_RADIO_Phy EMBENET_RADIO_GetPhy(void);
+
+
+/**
+ * @brief Calculates transmission time of a frame, from the first bit of preamble to the last bit of CRC.
+ *
+ * Lets the MAC check which frames fit its slot template on given PHY profile.
+ *
+ * @param[in] phy PHY profile
+ * @param[in] psduLen PSDU length in bytes
+ * @return transmission time in us, 0 if phy is out of range
+ */
+EMBENET_TimeUs EMBENET_RADIO_GetAirTime(EMBENET_RADIO_Phy phy, size_t psduLen);
+
+
+/**
+ * @brief Enables clear channel assessment before every transmission.
+ *
+ * When enabled, the channel is sensed after the transmission trigger and the frame is sent only if RSSI stays below the threshold.
+ * The frame is dropped on busy channel and neither onStartFrame nor onEndFrame callback is called for it.
+ * txDelay reported by @ref EMBENET_RADIO_GetCapabilities grows by the sensing time.
+ *
+ * @param[in] enabled true to enable CCA, false to transmit without sensing the channel
+ * @param[in] threshold RSSI in dBm above which the channel is considered busy
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_WRONG_STATE when radio is not idle
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_SetCca(bool enabled, EMBENET_RADIO_Power threshold);
+
+
+/**
+ * @brief Called when the energy scan started with @ref EMBENET_RADIO_StartEnergyScan ends.
+ *
+ * @param[in] context argument passed to @ref EMBENET_RADIO_StartEnergyScan
+ * @param[in] scanned number of channels with results, less than channelCount if the scan was stopped
+ */
+typedef void (*EMBENET_RADIO_EnergyScanCbt)(void* context, size_t scanned);
+
+
+/**
+ * @brief Starts measuring energy on given channels, one after another.
+ *
+ * RSSI is sampled for dwellTime on every channel, e.g. on the channels of embenetMacChannelList, so that busy channels can be skipped.
+ * The function returns at once, the scan runs from the RF driver callbacks and the radio is busy until onDone is called. Radio is then left idle.
+ *
+ * The scan gives way to the MAC: @ref EMBENET_RADIO_Idle, @ref EMBENET_RADIO_RxEnable and @ref EMBENET_RADIO_CommitTx stop it and call onDone
+ * with the channels finished until then, so a scan started between slots never delays the next one.
+ *
+ * @param[in] channels channels to scan, must stay valid until onDone is called
+ * @param[in] channelCount number of channels to scan
+ * @param[in] dwellTime time of sampling on a single channel in us
+ * @param[out] results results of the scan, one per channel, must stay valid until onDone is called
+ * @param[in] onDone called from the RF driver callback when the last channel is scanned, or from the function that stopped the scan
+ * @param[in] context argument passed to onDone
+ * @retval EMBENET_RADIO_STATUS_SUCCESS if the scan was started
+ * @retval EMBENET_RADIO_STATUS_WRONG_STATE when radio is not idle, e.g. another scan runs
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS when there is no channel to scan or onDone is NULL
+ * @retval EMBENET_RADIO_STATUS_GENERAL_ERROR when the RF driver refused the command
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_StartEnergyScan(EMBENET_RADIO_Channel const* channels, size_t channelCount, EMBENET_TimeUs dwellTime,
+                                                   EMBENET_RADIO_EnergyScanResult* results, EMBENET_RADIO_EnergyScanCbt onDone, void* context);
+
+
+/**
+ * @brief Restricts the channels used for transmission and reception.
+ *
+ * Every channel excluded from the map is replaced with one of the allowed channels, chosen in the same way on every node,
+ * so nodes sharing the same map keep meeting on the same frequency. Allowed channels are used unchanged.
+ * The map is applied to channels passed to @ref EMBENET_RADIO_CommitTx and @ref EMBENET_RADIO_RxEnable after this call.
+ * @ref EMBENET_RADIO_StartEnergyScan and @ref EMBENET_RADIO_StartContinuousTx ignore the map.
+ *
+ * @param[in] allowed bitmap of EMBENET_RADIO_CHANNEL_MAP_SIZE bytes, channel n is allowed if bit (n % 8) of byte (n / 8) is set,
+ *                    NULL or a map without any channel of the band allows all channels
+ */
+void EMBENET_RADIO_SetChannelMap(uint8_t const* allowed);
+
+
+/**
+ * @brief Gets the channel actually used in place of given channel.
+ *
+ * @param[in] channel channel requested by the MAC
+ * @return channel used by the radio according to the map set with @ref EMBENET_RADIO_SetChannelMap
+ */
+EMBENET_RADIO_Channel EMBENET_RADIO_MapChannel(EMBENET_RADIO_Channel channel);
+
+
+/**
+ * @brief Sets transmission power of frames sent to given neighbor.
+ *
+ * Lets a power control loop lower the power on strong links and raise it on weak ones, while the MAC requests the same power for every frame.
+ * The destination is read from the IEEE 802.15.4 header of every frame passed to @ref EMBENET_RADIO_CommitTx. Frames sent to short
+ * or broadcast addresses, and frames sent to neighbors without own power, use the power requested by the MAC. The same applies to ACKs,
+ * which carry the power they are sent at, see @ref EMBENET_RADIO_GetLinkPathLoss.
+ *
+ * @param[in] eui extended address of the neighbor
+ * @param[in] txp transmit power in dBm, clamped to the supported range, EMBENET_RADIO_LINK_TXP_DEFAULT to use the power requested by the MAC
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARG1_OUT_OF_BOUNDS when eui is 0
+ * @retval EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS when powers of too many neighbors are set
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_SetLinkTxPower(uint64_t eui, EMBENET_RADIO_Power txp);
+
+
+/**
+ * @brief Gets average path loss to given neighbor, measured with its ACKs.
+ *
+ * Every enhanced ACK sent by the port carries the power it is sent at in a vendor specific header IE opened by the OUI of the sender, so
+ * the path loss is that power less the RSSI of the ACK, whatever power the MAC or @ref EMBENET_RADIO_SetLinkTxPower chose. The RSSI of
+ * other frames tells little about the loss, since their power is unknown. An ACK is attributed to the extended destination of the last
+ * frame sent with ACK request, ACKs without the IE are ignored. Losses to a bounded number of neighbors are tracked, a new neighbor
+ * replaces the oldest entry.
+ *
+ * @param[in] eui extended address of the neighbor
+ * @param[out] pathLoss average path loss to the neighbor in dB
+ * @return true on success, false if no ACK carrying its power was received from the neighbor
+ */
+bool EMBENET_RADIO_GetLinkPathLoss(uint64_t eui, int16_t* pathLoss);
+
+
+/**
+ * @brief Limits listening to a window.
+ *
+ * Listening started by @ref EMBENET_RADIO_RxNow or @ref EMBENET_RADIO_RxAt is stopped by the radio hardware window us after the trigger,
+ * unless a frame is being received by then. A frame being received is completed normally. When the window closes without a frame,
+ * the receiver turns off at once, no callback is called and the radio waits for @ref EMBENET_RADIO_Idle or @ref EMBENET_RADIO_RxEnable.
+ * Setting the window to the guard time of RX slots saves the energy of listening until the MAC idles the radio.
+ *
+ * The window is opt-in: it is 0 after start-up, and neither the port nor the stack sets it. The stack also listens with no end known to the
+ * port, e.g. while it searches for a network, which a window would cut short, so the demo application leaves it at 0. An application may set
+ * it when every listening of its MAC ends within the window.
+ *
+ * @param[in] window listening time in us, 0 to listen until @ref EMBENET_RADIO_Idle
+ * @retval EMBENET_RADIO_STATUS_SUCCESS on success
+ * @retval EMBENET_RADIO_STATUS_WRONG_STATE when called while listening
+ */
+EMBENET_RADIO_Status EMBENET_RADIO_SetRxWindow(EMBENET_TimeUs window);
+
+
+/**
+ * @brief Gets radio event counters.
+ *
+ * Tells problems of the physical layer (CRC errors, missed synchronization, overflows) apart from problems of MAC scheduling
+ * (late callbacks). Transmissions and receptions cut short by @ref EMBENET_RADIO_Idle are not counted.
+ *
+ * @param[out] radioCounters counters
+ */
+void EMBENET_RADIO_GetCounters(EMBENET_RADIO_Counters* radioCounters);
+
+
+/**
+ * @brief Clears radio event counters.
+ */
+void EMBENET_RADIO_ResetCounters(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_RADIO_CC1312_H_ included
@@ -0,0 +1,183 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extensions of the timer interface specific to the CC1312 port
+*/
+
+#ifndef EMBENET_TIMER_CC1312_H_
+#define EMBENET_TIMER_CC1312_H_
+
+#include "embenet_timer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup embenet_node_port_timer_cc1312 Timer Interface extensions
+ *
+ * Functions provided by this port on top of @ref embenet_node_port_timer. The stack does not use them.
+ * @{
+ */
+
+/**
+ * @brief Reads current time value in us without wrapping.
+ *
+ * The lower 32 bits are equal to the value returned by @ref EMBENET_TIMER_ReadCounter. The value does not drift against the underlying timer
+ * across its wraps. This function is an optional extension of the port and is not used by the stack.
+ * @return Time in us since @ref EMBENET_TIMER_Init.
+ */
+uint64_t EMBENET_TIMER_ReadCounter64(void);
+
+
+typedef struct EMBENET_TIMER_SoftTimer EMBENET_TIMER_SoftTimer; ///< Software timer, see @ref EMBENET_TIMER_SoftTimerInit
+
+
+/**
+ * @brief Software timer callback function type
+ * @param[in] timer timer that expired
+ * @param[in] context general-purpose context associated with the timer
+ */
+typedef void (*EMBENET_TIMER_SoftTimerCallback)(EMBENET_TIMER_SoftTimer* timer, void* context);
+
+
+/**
+ * @brief Software timer.
+ *
+ * The fields are managed by the timer and MUST NOT be accessed directly. The structure is declared here only so that timers can be allocated statically.
+ */
+struct EMBENET_TIMER_SoftTimer {
+    EMBENET_TIMER_SoftTimer*        next;     ///< Next timer in the same slot
+    EMBENET_TIMER_SoftTimer**       pprev;    ///< Link that points to this timer
+    uint64_t                        expiry;   ///< Time of expiry in us, see @ref EMBENET_TIMER_ReadCounter64
+    uint32_t                        period;   ///< Period in us, 0 for a one-shot timer
+    uint8_t                         level;    ///< Level of the wheel holding the timer
+    uint8_t                         slot;     ///< Slot of the level holding the timer
+    EMBENET_TIMER_SoftTimerCallback callback; ///< Function invoked on expiry
+    void*                           context;  ///< Context passed to the callback
+};
+
+
+/**
+ * @brief Initializes a software timer
+ *
+ * Software timers share the compare of the timer with the stack, which always takes precedence. Any number of timers may run at once,
+ * starting and stopping a timer takes constant time. The callback is invoked in interrupt context and should be short, as it delays
+ * other timers. Timers may be started and stopped only from code that does not preempt the timer interrupt, e.g. the main loop or the
+ * timer callbacks. @ref EMBENET_TIMER_Init stops all timers. This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[out] timer timer to initialize
+ * @param[in] callback function invoked when the timer expires
+ * @param[in] context general-purpose context that will be passed to the callback
+ */
+void EMBENET_TIMER_SoftTimerInit(EMBENET_TIMER_SoftTimer* timer, EMBENET_TIMER_SoftTimerCallback callback, void* context);
+
+
+/**
+ * @brief Starts a software timer, restarting it if it is already running
+ *
+ * A time in the past makes the timer expire at once. A periodic timer that falls behind skips the missed periods.
+ *
+ * @param[in, out] timer timer to start
+ * @param[in] expiry time of the first expiry in us, see @ref EMBENET_TIMER_ReadCounter64
+ * @param[in] period period in us, 0 for a one-shot timer
+ */
+void EMBENET_TIMER_SoftTimerStart(EMBENET_TIMER_SoftTimer* timer, uint64_t expiry, uint32_t period);
+
+
+/**
+ * @brief Stops a software timer. Stopping a timer that does not run has no effect.
+ * @param[in, out] timer timer to stop
+ */
+void EMBENET_TIMER_SoftTimerStop(EMBENET_TIMER_SoftTimer* timer);
+
+
+/**
+ * @brief Checks whether a software timer runs
+ * @param[in] timer timer to check
+ * @return true if the timer will expire, false otherwise
+ */
+bool EMBENET_TIMER_SoftTimerIsRunning(EMBENET_TIMER_SoftTimer const* timer);
+
+
+/**
+ * @brief Puts the device into standby until shortly before the next timer event
+ *
+ * The timer stops in standby, so the low-power RTC keeps time instead and the timer is synchronized to it on wake-up. The wake-up is
+ * planned @ref EMBENET_TIMER_GetWakeLatency ahead of the next compare, so that the stack finds the timer running. The device does not
+ * sleep if the next event is too close, if another driver disallows standby, or if @ref EMBENET_TIMER_SignalActivity was called since
+ * the previous attempt. Standby is entered through the power policy (Power_idleFunc), which must be enabled in the power configuration.
+ * Interrupts stay enabled while the device sleeps; the first one that reads the time restarts the timer. The function should be called
+ * from the main loop after @ref EMBENET_NODE_Proc.
+ * This function is an optional extension of the port and is not used by the stack.
+ *
+ * @return true if the device slept, false otherwise
+ */
+bool EMBENET_TIMER_Sleep(void);
+
+
+/**
+ * @brief Prevents the next @ref EMBENET_TIMER_Sleep from entering standby
+ *
+ * Called by interrupt handlers that leave work for the main loop, so that it is done before the device sleeps.
+ */
+void EMBENET_TIMER_SignalActivity(void);
+
+
+/**
+ * @brief Gets the time needed to wake up from standby
+ * @return estimated time from the planned wake-up until the timer runs again, in us
+ */
+EMBENET_TimeUs EMBENET_TIMER_GetWakeLatency(void);
+
+
+/**
+ * @brief Gets the drift of the RTC used during standby
+ * @return drift of the RTC against the timer in parts per billion, positive if the RTC runs slow, 0 if not yet measured
+ */
+int32_t EMBENET_TIMER_GetRtcDrift(void);
+
+
+/// Number of buckets of @ref EMBENET_TIMER_LatencyStats.histogram
+#define EMBENET_TIMER_LATENCY_BUCKETS 16
+
+
+/// Delays of compare events since @ref EMBENET_TIMER_ResetLatencyStats, see @ref EMBENET_TIMER_GetLatencyStats
+typedef struct {
+    uint32_t       histogram[EMBENET_TIMER_LATENCY_BUCKETS]; ///< Bucket 0 counts events that fired on time, bucket k counts delays in [2^(k-1), 2^k) us, the last one also all longer delays
+    uint32_t       events;                                   ///< Compare events delivered to the stack
+    uint32_t       forcedPends;                              ///< Compares too close to the current time, whose interrupt was triggered at once
+    EMBENET_TimeUs maxLatency;                               ///< Longest delay of a compare event in us
+} EMBENET_TIMER_LatencyStats;
+
+
+/**
+ * @brief Gets statistics of compare event delays.
+ *
+ * The delay is measured from the time set by @ref EMBENET_TIMER_SetCompare to the entry of the timer interrupt, so long delays point to
+ * interrupts being blocked by application code. The statistics are collected only if the port is built with EMBENET_TIMER_LATENCY_STATS
+ * defined to 1, otherwise all of them stay 0. This function is an optional extension of the port and is not used by the stack.
+ *
+ * @param[out] stats statistics
+ */
+void EMBENET_TIMER_GetLatencyStats(EMBENET_TIMER_LatencyStats* stats);
+
+
+/**
+ * @brief Clears statistics of compare event delays.
+ */
+void EMBENET_TIMER_ResetLatencyStats(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_TIMER_CC1312_H_ included
@@ -7,12 +7,14 @@
 @brief     Implementation of AES-128 interface for embeNET Node
 */
 
-#include "embenet_aes128.h"
+#include "embenet_aes128_cc1312.h"
 
+#include "embenet_aes128_ccm.h"
 #include "embenet_critical_section.h"
 
 // clang-format off
 #include <ti_drivers_config.h>
+#include <ti/drivers/AESCCM.h>
 #include <ti/drivers/AESECB.h>
 #include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
 #include <ti/drivers/power/PowerCC26X2.h>
@@ -22,9 +24,25 @@
 #include <string.h>
 
 
+#ifndef EMBENET_AES128_CCM_HW
+#    define EMBENET_AES128_CCM_HW 1 ///< Set to 0 to compute CCM* in software on top of EMBENET_AES128_Encrypt
+#endif
+
 static AESECB_Handle handle;
-static CryptoKey     cryptoKey;
-static uint8_t       keyStorage[16U];
+#if EMBENET_AES128_CCM_HW
+static AESCCM_Handle ccmHandle; ///< NULL if the accelerator is not available, CCM* is then computed in software
+#endif
+
+/// Key held in the cache, its CryptoKey refers to the key material of the same slot
+typedef struct {
+    CryptoKey cryptoKey;
+    uint8_t   keyStorage[16U];
+    uint32_t  lastUse; ///< Value of keyUseCounter at the last use, 0 if the slot is empty
+} EMBENET_AES128_KeySlot;
+
+static EMBENET_AES128_KeySlot keySlots[EMBENET_AES128_KEY_SLOTS];
+static CryptoKey*             currentKey;    ///< Key used by encryption and decryption
+static uint32_t               keyUseCounter; ///< Incremented on every key use, orders the slots from the least recently used
 
 extern __attribute__((noreturn)) void EXPECT_OnAbortHandler(char const* why, char const* file, int line);
 
@@ -42,18 +60,72 @@ void EMBENET_AES128_Init(void) {
         EXPECT_OnAbortHandler("AES malfunction", __FILE__, __LINE__);
     }
 
-    CryptoKeyPlaintext_initKey(&cryptoKey, keyStorage, sizeof(keyStorage));
+#if EMBENET_AES128_CCM_HW
+    AESCCM_init();
+
+    AESCCM_Params ccmParams;
+    AESCCM_Params_init(&ccmParams);
+    ccmParams.returnBehavior = AESCCM_RETURN_BEHAVIOR_POLLING;
+    ccmHandle                = AESCCM_open(EMBENET_AESCCM, &ccmParams);
+#endif
+
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        CryptoKeyPlaintext_initKey(&keySlots[i].cryptoKey, keySlots[i].keyStorage, sizeof(keySlots[i].keyStorage));
+        keySlots[i].lastUse = 0;
+    }
+    currentKey    = &keySlots[0].cryptoKey;
+    keyUseCounter = 0;
 }
 
 void EMBENET_AES128_Deinit(void) {
+#if EMBENET_AES128_CCM_HW
+    if (NULL != ccmHandle) {
+        AESCCM_close(ccmHandle);
+        ccmHandle = NULL;
+    }
+#endif
     AESECB_close(handle);
     Power_releaseDependency(PowerCC26XX_PERIPH_CRYPTO);
 
-    memset(keyStorage, 0, sizeof(keyStorage));
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        memset(keySlots[i].keyStorage, 0, sizeof(keySlots[i].keyStorage));
+        keySlots[i].lastUse = 0;
+    }
 }
 
 void EMBENET_AES128_SetKey(uint8_t const key[16U]) {
-    memcpy(keyStorage, key, sizeof(keyStorage));
+    EMBENET_AES128_SelectKey(EMBENET_AES128_LoadKey(key));
+}
+
+EMBENET_AES128_KeyHandle EMBENET_AES128_LoadKey(uint8_t const key[16U]) {
+    size_t found  = EMBENET_AES128_KEY_SLOTS;
+    size_t oldest = 0;
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        // Every byte is compared, so the time does not depend on the key material
+        uint8_t difference = 0;
+        for (size_t j = 0; j < sizeof(keySlots[i].keyStorage); ++j) {
+            difference |= (uint8_t)(keySlots[i].keyStorage[j] ^ key[j]);
+        }
+        if ((0 == difference) && (0 != keySlots[i].lastUse)) {
+            found = i;
+        }
+        if (keySlots[i].lastUse < keySlots[oldest].lastUse) {
+            oldest = i;
+        }
+    }
+    if (EMBENET_AES128_KEY_SLOTS == found) {
+        found = oldest;
+        memcpy(keySlots[found].keyStorage, key, sizeof(keySlots[found].keyStorage));
+    }
+    keySlots[found].lastUse = ++keyUseCounter;
+    return (EMBENET_AES128_KeyHandle)found;
+}
+
+void EMBENET_AES128_SelectKey(EMBENET_AES128_KeyHandle keyHandle) {
+    if (keyHandle < EMBENET_AES128_KEY_SLOTS) {
+        currentKey                  = &keySlots[keyHandle].cryptoKey;
+        keySlots[keyHandle].lastUse = ++keyUseCounter;
+    }
 }
 
 void EMBENET_AES128_Encrypt(uint8_t data[16U]) {
@@ -64,7 +136,7 @@ void EMBENET_AES128_Encrypt(uint8_t data[16U]) {
     AESECB_Operation operation;
     AESECB_Operation_init(&operation);
 
-    operation.key         = &cryptoKey;
+    operation.key         = currentKey;
     operation.input       = plaintext;
     operation.output      = data;
     operation.inputLength = sizeof(plaintext);
@@ -84,7 +156,7 @@ void EMBENET_AES128_Decrypt(uint8_t data[16U]) {
     AESECB_Operation operation;
     AESECB_Operation_init(&operation);
 
-    operation.key         = &cryptoKey;
+    operation.key         = currentKey;
     operation.input       = ciphertext;
     operation.output      = data;
     operation.inputLength = sizeof(ciphertext);
@@ -95,3 +167,80 @@ void EMBENET_AES128_Decrypt(uint8_t data[16U]) {
         // handle error
     }
 }
+
+#if EMBENET_AES128_CCM_HW
+/**
+ * @brief Checks whether the accelerator takes the given lengths, the others are left to the software CCM*
+ *
+ * The decision is made before the accelerator is started, since it transforms the data in place and a failed operation cannot be repeated in software.
+ */
+static bool EMBENET_AES128_CcmHwSupports(size_t aadLength, size_t dataLength, size_t micLength) {
+    return (NULL != ccmHandle) && (0 != micLength) && ((0 != aadLength) || (0 != dataLength));
+}
+#endif
+
+bool EMBENET_AES128_CcmEncrypt(uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad, size_t aadLength, uint8_t* data, size_t dataLength,
+                               uint8_t* mic, size_t micLength) {
+    if (!EMBENET_AES128_CCM_CheckLengths(aadLength, dataLength, micLength)) {
+        return false;
+    }
+#if EMBENET_AES128_CCM_HW
+    if (EMBENET_AES128_CcmHwSupports(aadLength, dataLength, micLength)) {
+        AESCCM_OneStepOperation operation;
+        AESCCM_OneStepOperation_init(&operation);
+
+        operation.key         = currentKey;
+        operation.aad         = (uint8_t*)aad;
+        operation.aadLength   = aadLength;
+        operation.input       = data;
+        operation.output      = data;
+        operation.inputLength = dataLength;
+        operation.nonce       = (uint8_t*)nonce;
+        operation.nonceLength = EMBENET_AES128_CCM_NONCE_LENGTH;
+        operation.mac         = mic;
+        operation.macLength   = micLength;
+
+        if (AESCCM_STATUS_SUCCESS != AESCCM_oneStepEncrypt(ccmHandle, &operation)) {
+            // The data may be partly encrypted already, nothing of it may be sent
+            memset(data, 0, dataLength);
+            memset(mic, 0, micLength);
+            return false;
+        }
+        return true;
+    }
+#endif
+    EMBENET_AES128_CCM_Encrypt(EMBENET_AES128_Encrypt, nonce, aad, aadLength, data, dataLength, mic, micLength);
+    return true;
+}
+
+bool EMBENET_AES128_CcmDecrypt(uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad, size_t aadLength, uint8_t* data, size_t dataLength,
+                               uint8_t const* mic, size_t micLength) {
+    if (!EMBENET_AES128_CCM_CheckLengths(aadLength, dataLength, micLength)) {
+        return false;
+    }
+#if EMBENET_AES128_CCM_HW
+    if (EMBENET_AES128_CcmHwSupports(aadLength, dataLength, micLength)) {
+        AESCCM_OneStepOperation operation;
+        AESCCM_OneStepOperation_init(&operation);
+
+        operation.key         = currentKey;
+        operation.aad         = (uint8_t*)aad;
+        operation.aadLength   = aadLength;
+        operation.input       = data;
+        operation.output      = data;
+        operation.inputLength = dataLength;
+        operation.nonce       = (uint8_t*)nonce;
+        operation.nonceLength = EMBENET_AES128_CCM_NONCE_LENGTH;
+        operation.mac         = (uint8_t*)mic;
+        operation.macLength   = micLength;
+
+        if (AESCCM_STATUS_SUCCESS != AESCCM_oneStepDecrypt(ccmHandle, &operation)) {
+            // Invalid MIC or accelerator error, the data may be partly decrypted and is not authenticated
+            memset(data, 0, dataLength);
+            return false;
+        }
+        return true;
+    }
+#endif
+    return EMBENET_AES128_CCM_Decrypt(EMBENET_AES128_Encrypt, nonce, aad, aadLength, data, dataLength, mic, micLength);
+}
@@ -0,0 +1,135 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Software CCM* mode of operation on top of an AES-128 block cipher
+*/
+
+#include "embenet_aes128_ccm.h"
+
+#include <string.h>
+
+enum {
+    CCM_BLOCK_LENGTH    = 16,
+    CCM_LENGTH_FIELD    = 2,                                   ///< Size of the message length field (L) in bytes
+    CCM_MAX_DATA_LENGTH = 0xFFFF,                              ///< Largest length that fits in CCM_LENGTH_FIELD bytes
+    CCM_MAX_AAD_LENGTH  = 0xFEFF,                              ///< Longer aad needs a longer length encoding
+    CCM_FLAG_ADATA      = 0x40,                                ///< B0 flag of present additional authenticated data
+    CCM_FLAGS_L         = CCM_LENGTH_FIELD - 1,                ///< Encoding of L in the flags of B0 and Ai
+    CCM_NONCE_OFFSET    = 1,                                   ///< Position of the nonce in B0 and Ai
+    CCM_COUNTER_OFFSET  = CCM_BLOCK_LENGTH - CCM_LENGTH_FIELD, ///< Position of the length in B0 and of the counter in Ai
+};
+
+
+// Encrypts the counter block Ai
+static void EMBENET_AES128_CCM_CounterBlock(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint16_t counter,
+                                            uint8_t block[CCM_BLOCK_LENGTH]) {
+    block[0] = CCM_FLAGS_L;
+    memcpy(&block[CCM_NONCE_OFFSET], nonce, EMBENET_AES128_CCM_NONCE_LENGTH);
+    block[CCM_COUNTER_OFFSET]     = (uint8_t)(counter >> 8);
+    block[CCM_COUNTER_OFFSET + 1] = (uint8_t)counter;
+    cipher(block);
+}
+
+
+// XORs data with the key stream of blocks A1, A2, ...
+static void EMBENET_AES128_CCM_Ctr(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t* data,
+                                   size_t dataLength) {
+    uint8_t  stream[CCM_BLOCK_LENGTH];
+    uint16_t counter = 1;
+    while (dataLength > 0) {
+        EMBENET_AES128_CCM_CounterBlock(cipher, nonce, counter++, stream);
+        size_t length = (dataLength < CCM_BLOCK_LENGTH) ? dataLength : CCM_BLOCK_LENGTH;
+        for (size_t i = 0; i < length; ++i) {
+            data[i] ^= stream[i];
+        }
+        data += length;
+        dataLength -= length;
+    }
+}
+
+
+// Feeds bytes to the CBC-MAC, pos is the position within the current block, a completed block is encrypted
+static void EMBENET_AES128_CCM_MacUpdate(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t mac[CCM_BLOCK_LENGTH], size_t* pos, uint8_t const* bytes,
+                                         size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        mac[(*pos)++] ^= bytes[i];
+        if (CCM_BLOCK_LENGTH == *pos) {
+            cipher(mac);
+            *pos = 0;
+        }
+    }
+}
+
+
+// Computes the unencrypted authentication tag T of aad and plaintext data
+static void EMBENET_AES128_CCM_Mac(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad,
+                                   size_t aadLength, uint8_t const* data, size_t dataLength, size_t micLength, uint8_t mac[CCM_BLOCK_LENGTH]) {
+    // B0
+    mac[0] = (uint8_t)(((0 != aadLength) ? CCM_FLAG_ADATA : 0) | (((0 != micLength) ? (micLength - 2) / 2 : 0) << 3) | CCM_FLAGS_L);
+    memcpy(&mac[CCM_NONCE_OFFSET], nonce, EMBENET_AES128_CCM_NONCE_LENGTH);
+    mac[CCM_COUNTER_OFFSET]     = (uint8_t)(dataLength >> 8);
+    mac[CCM_COUNTER_OFFSET + 1] = (uint8_t)dataLength;
+    cipher(mac);
+
+    size_t pos = 0;
+    if (0 != aadLength) {
+        uint8_t const encodedLength[2] = {(uint8_t)(aadLength >> 8), (uint8_t)aadLength};
+        EMBENET_AES128_CCM_MacUpdate(cipher, mac, &pos, encodedLength, sizeof(encodedLength));
+        EMBENET_AES128_CCM_MacUpdate(cipher, mac, &pos, aad, aadLength);
+        if (0 != pos) { // zero padding
+            cipher(mac);
+            pos = 0;
+        }
+    }
+    EMBENET_AES128_CCM_MacUpdate(cipher, mac, &pos, data, dataLength);
+    if (0 != pos) {
+        cipher(mac);
+    }
+}
+
+
+bool EMBENET_AES128_CCM_CheckLengths(size_t aadLength, size_t dataLength, size_t micLength) {
+    bool micValid = (0 == micLength) || (4 == micLength) || (8 == micLength) || (16 == micLength);
+    return micValid && (aadLength <= CCM_MAX_AAD_LENGTH) && (dataLength <= CCM_MAX_DATA_LENGTH);
+}
+
+
+void EMBENET_AES128_CCM_Encrypt(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad,
+                                size_t aadLength, uint8_t* data, size_t dataLength, uint8_t* mic, size_t micLength) {
+    if (0 != micLength) {
+        uint8_t mac[CCM_BLOCK_LENGTH];
+        uint8_t s0[CCM_BLOCK_LENGTH];
+        EMBENET_AES128_CCM_Mac(cipher, nonce, aad, aadLength, data, dataLength, micLength, mac);
+        EMBENET_AES128_CCM_CounterBlock(cipher, nonce, 0, s0);
+        for (size_t i = 0; i < micLength; ++i) {
+            mic[i] = mac[i] ^ s0[i];
+        }
+    }
+    EMBENET_AES128_CCM_Ctr(cipher, nonce, data, dataLength);
+}
+
+
+bool EMBENET_AES128_CCM_Decrypt(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad,
+                                size_t aadLength, uint8_t* data, size_t dataLength, uint8_t const* mic, size_t micLength) {
+    EMBENET_AES128_CCM_Ctr(cipher, nonce, data, dataLength);
+    if (0 == micLength) {
+        return true;
+    }
+    uint8_t mac[CCM_BLOCK_LENGTH];
+    uint8_t s0[CCM_BLOCK_LENGTH];
+    EMBENET_AES128_CCM_Mac(cipher, nonce, aad, aadLength, data, dataLength, micLength, mac);
+    EMBENET_AES128_CCM_CounterBlock(cipher, nonce, 0, s0);
+    // Constant time comparison, so that the time does not reveal how many bytes of the MIC were right
+    uint8_t difference = 0;
+    for (size_t i = 0; i < micLength; ++i) {
+        difference |= (uint8_t)(mac[i] ^ s0[i] ^ mic[i]);
+    }
+    if (0 != difference) {
+        memset(data, 0, dataLength);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Software CCM* mode of operation on top of an AES-128 block cipher
+*/
+
+#ifndef EMBENET_AES128_CCM_H_
+#define EMBENET_AES128_CCM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "embenet_aes128_cc1312.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Block cipher used by CCM*, encrypts a single block in place with the current key
+ * @param[in,out] block 16 byte block to encrypt
+ */
+typedef void (*EMBENET_AES128_CCM_BlockCipher)(uint8_t block[16U]);
+
+
+/**
+ * @brief Checks whether CCM* supports the given lengths
+ *
+ * The message length field has 2 bytes, as in IEEE 802.15.4, and the MIC may have 0, 4, 8 or 16 bytes.
+ *
+ * @param[in] aadLength length of the additional authenticated data
+ * @param[in] dataLength length of the data
+ * @param[in] micLength length of the MIC
+ * @return true if the lengths are supported
+ */
+bool EMBENET_AES128_CCM_CheckLengths(size_t aadLength, size_t dataLength, size_t micLength);
+
+
+/**
+ * @brief Authenticates and encrypts data with CCM*
+ *
+ * The lengths must be checked with @ref EMBENET_AES128_CCM_CheckLengths. The function has no hardware dependencies.
+ *
+ * @param[in] cipher block cipher set up with the key
+ * @param[in] nonce nonce
+ * @param[in] aad additional authenticated data, may be NULL if aadLength is 0
+ * @param[in] aadLength length of aad
+ * @param[in,out] data plaintext, replaced by the ciphertext
+ * @param[in] dataLength length of data
+ * @param[out] mic MIC of aad and data
+ * @param[in] micLength length of mic, 0 for encryption only
+ */
+void EMBENET_AES128_CCM_Encrypt(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad,
+                                size_t aadLength, uint8_t* data, size_t dataLength, uint8_t* mic, size_t micLength);
+
+
+/**
+ * @brief Decrypts and verifies data with CCM*
+ *
+ * The lengths must be checked with @ref EMBENET_AES128_CCM_CheckLengths. The function has no hardware dependencies.
+ *
+ * @param[in] cipher block cipher set up with the key
+ * @param[in] nonce nonce
+ * @param[in] aad additional authenticated data, may be NULL if aadLength is 0
+ * @param[in] aadLength length of aad
+ * @param[in,out] data ciphertext, replaced by the plaintext, or by zeros if verification fails
+ * @param[in] dataLength length of data
+ * @param[in] mic received MIC
+ * @param[in] micLength length of mic, 0 for encryption only
+ * @return true if the MIC is valid
+ */
+bool EMBENET_AES128_CCM_Decrypt(EMBENET_AES128_CCM_BlockCipher cipher, uint8_t const nonce[EMBENET_AES128_CCM_NONCE_LENGTH], uint8_t const* aad,
+                                size_t aadLength, uint8_t* data, size_t dataLength, uint8_t const* mic, size_t micLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_AES128_CCM_H_ included
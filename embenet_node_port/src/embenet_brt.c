@@ -7,7 +7,9 @@
 @brief     Implementation of Border router communication interface for embeNET Node
 */
 
-#include <embenet_brt.h>
+#include "embenet_brt_crc.h"
+
+#include <embenet_brt_cc1312.h>
 #include <embenet_critical_section.h>
 
 
@@ -24,7 +26,23 @@ static UART2_Handle embenetUart;
 
 
 enum {
-    EMBENET_BRT_MAX_FRAME_SIZE = 256,
+    EMBENET_BRT_MAX_FRAME_SIZE  = 256,
+    EMBENET_BRT_TX_BUFFER_SIZE  = 2 * (EMBENET_BRT_MAX_FRAME_SIZE + 2) + 2, ///< Worst case encoded frame: every data and CRC byte escaped, plus two flags
+    EMBENET_BRT_TX_BUFFER_COUNT = 2,                                        ///< One buffer is drained by UART while the next one is being filled
+    EMBENET_BRT_RX_CHUNK_SIZE   = 128,                                      ///< Maximum number of bytes fetched from UART with a single read
+    EMBENET_BRT_RX_FRAME_COUNT  = 4,                                        ///< Number of decoded frames that may wait for EMBENET_BRT_Receive
+
+    EMBENET_BRT_DEFAULT_BAUD_RATE = 115200,  ///< Baud rate used after initialization and after fallback
+    EMBENET_BRT_MAX_BAUD_RATE     = 3000000, ///< UART clock (48MHz) divided by 16
+    EMBENET_BRT_FALLBACK_WINDOW   = 32,      ///< Number of received frames over which CRC errors are counted
+    EMBENET_BRT_FALLBACK_ERRORS   = 4,       ///< Number of CRC errors within the window that makes the link fall back to the default baud rate
+
+    EMBENET_BRT_CONTROL_MARKER        = 0x00, ///< Sent escaped right after the opening flag of link control frames, the encoder never escapes it in stack frames
+    EMBENET_BRT_CONTROL_FRAME_LENGTH  = 5,    ///< Command and 32-bit little-endian baud rate, the marker is not counted
+    EMBENET_BRT_CONTROL_BAUD_REQUEST  = 0x01, ///< root -> border router: proposes the baud rate carried in the frame
+    EMBENET_BRT_CONTROL_BAUD_ACCEPT   = 0x02, ///< border router -> root: both sides switch to the baud rate right after this frame
+    EMBENET_BRT_CONTROL_BAUD_REJECT   = 0x03, ///< border router -> root: the link stays at the current baud rate
+    EMBENET_BRT_CONTROL_BAUD_FALLBACK = 0x04, ///< either side: the sender returns to the default baud rate carried in the frame right after it
 
     HDLC_FLAG        = 0x7e,
     HDLC_ESCAPE      = 0x7d,
@@ -34,14 +52,62 @@ enum {
 };
 
 
+typedef struct {
+    uint8_t data[EMBENET_BRT_TX_BUFFER_SIZE];
+    size_t  length;
+} EMBENET_BRT_TxBuffer;
+
+static EMBENET_BRT_TxBuffer  txBuffers[EMBENET_BRT_TX_BUFFER_COUNT];
+static volatile size_t       txHead;  ///< Index of the buffer currently written out by UART
+static volatile size_t       txCount; ///< Number of buffers handed over to UART (in flight and pending)
+static size_t                txTail;  ///< Index of the next buffer to fill, only used by the producer
+static EMBENET_BRT_TxBuffer* txFill;  ///< Buffer currently being filled by the encoder, NULL if none
+
+typedef struct {
+    uint8_t data[EMBENET_BRT_MAX_FRAME_SIZE];
+    size_t  length;
+    bool    control; ///< true for link control frames, these are never passed to the stack
+} EMBENET_BRT_RxFrame;
+
+typedef struct {
+    uint32_t baudRate;          ///< Baud rate currently used by UART
+    uint32_t requestedBaudRate; ///< Baud rate proposed to the border router, 0 if no request is pending
+    uint32_t pendingBaudRate;   ///< Baud rate to switch to once UART drains the frames already queued, 0 if no switch is pending
+    unsigned frames;            ///< Frames with valid CRC received in the current window
+    unsigned errors;            ///< Frames with invalid CRC received in the current window
+} EMBENET_BRT_Link;
+
+static EMBENET_BRT_Link linkState;
+
+typedef struct {
+    bool     receiving;    ///< true when opening flag was received
+    bool     control;      ///< true when the frame started with the control marker
+    uint8_t  lastDataByte; ///< previous raw byte, used to detect escape sequences and repeated flags
+    uint16_t crc;          ///< CRC of the first crcLength bytes of the frame, including the trailing CRC bytes
+    size_t   crcLength;    ///< number of bytes already covered by crc
+    size_t   length;       ///< number of unescaped bytes received so far
+} EMBENET_BRT_Decoder;
+
+static EMBENET_BRT_RxFrame rxFrames[EMBENET_BRT_RX_FRAME_COUNT];
+static size_t              rxFrameHead;  ///< Index of the oldest decoded frame
+static size_t              rxFrameCount; ///< Number of decoded frames waiting for EMBENET_BRT_Receive
+static uint8_t             rxChunk[EMBENET_BRT_RX_CHUNK_SIZE];
+static size_t              rxChunkPosition; ///< Index of the first byte in rxChunk not yet passed to the decoder
+static size_t              rxChunkLength;   ///< Number of valid bytes in rxChunk
+static EMBENET_BRT_Decoder decoder;
+
+
 extern __attribute__((noreturn)) void EXPECT_OnAbortHandler(char const* why, char const* file, int line);
 
-void EMBENET_BRT_Init(void) {
+static void EMBENET_BRT_OnWriteDone(UART2_Handle handle, void* buffer, size_t count, void* userArg, int_fast16_t status);
+
+static void EMBENET_BRT_Open(uint32_t baudRate) {
     UART2_Params params;
     UART2_Params_init(&params);
-    params.baudRate  = 115200;
-    params.readMode  = UART2_Mode_NONBLOCKING;
-    params.writeMode = UART2_Mode_NONBLOCKING;
+    params.baudRate      = baudRate;
+    params.readMode      = UART2_Mode_NONBLOCKING;
+    params.writeMode     = UART2_Mode_CALLBACK; // whole frames are handed over to UART and drained by DMA
+    params.writeCallback = EMBENET_BRT_OnWriteDone;
 
     embenetUart = UART2_open(EMBENET_UART, &params);
     if (NULL == embenetUart) {
@@ -50,6 +116,48 @@ void EMBENET_BRT_Init(void) {
 
     // Enable receiver, inhibit low power mode
     UART2_rxEnable(embenetUart);
+
+    linkState.baudRate = baudRate;
+    linkState.frames   = 0;
+    linkState.errors   = 0;
+}
+
+static void EMBENET_BRT_SwitchBaudRate(uint32_t baudRate) {
+    // Frames already queued leave at the old baud rate, UART is reopened by EMBENET_BRT_ApplyBaudRate once they are drained
+    linkState.pendingBaudRate = baudRate;
+}
+
+// Performs the pending baud rate switch if UART is idle, returns false if the switch is still pending
+static bool EMBENET_BRT_ApplyBaudRate(void) {
+    if (0 == linkState.pendingBaudRate) {
+        return true;
+    }
+    if (EMBENET_BRT_IsBusy()) {
+        return false;
+    }
+    UART2_close(embenetUart);
+    EMBENET_BRT_Open(linkState.pendingBaudRate);
+    linkState.pendingBaudRate = 0;
+
+    // the bytes fetched after the control frame were sent at the new baud rate
+    rxChunkPosition   = rxChunkLength;
+    decoder.receiving = false;
+    return true;
+}
+
+void EMBENET_BRT_Init(void) {
+    txHead          = 0;
+    txCount         = 0;
+    txTail          = 0;
+    txFill          = NULL;
+    rxFrameHead     = 0;
+    rxFrameCount    = 0;
+    rxChunkPosition = 0;
+    rxChunkLength   = 0;
+    decoder         = (EMBENET_BRT_Decoder){.receiving = false};
+    linkState       = (EMBENET_BRT_Link){.requestedBaudRate = 0};
+
+    EMBENET_BRT_Open(EMBENET_BRT_DEFAULT_BAUD_RATE);
 }
 
 /**
@@ -57,6 +165,10 @@ void EMBENET_BRT_Init(void) {
  */
 void EMBENET_BRT_Deinit(void) {
     UART2_close(embenetUart);
+    txHead  = 0;
+    txCount = 0;
+    txTail  = 0;
+    txFill  = NULL;
 }
 
 /**
@@ -74,6 +186,29 @@ void EMBENET_BRT_Send(const void* packet, size_t packetLength);
  */
 size_t EMBENET_BRT_Receive(void* packetBuffer, size_t packetBufferSize);
 
+static void EMBENET_BRT_WriteFrame(bool control, const EMBENET_BRT_Segment* segments, size_t segmentCount);
+
+static void EMBENET_BRT_SendControl(uint8_t command, uint32_t baudRate) {
+    uint8_t const frame[EMBENET_BRT_CONTROL_FRAME_LENGTH] = {command, (uint8_t)(baudRate >> 0), (uint8_t)(baudRate >> 8), (uint8_t)(baudRate >> 16),
+                                                             (uint8_t)(baudRate >> 24)};
+    EMBENET_BRT_Segment const segment = {.data = frame, .length = sizeof(frame)};
+    EMBENET_BRT_WriteFrame(true, &segment, 1);
+}
+
+bool EMBENET_BRT_RequestBaudRate(uint32_t baudRate) {
+    if ((baudRate < EMBENET_BRT_DEFAULT_BAUD_RATE) || (baudRate > EMBENET_BRT_MAX_BAUD_RATE)) {
+        return false;
+    }
+
+    linkState.requestedBaudRate = baudRate; // a repeated request replaces the pending one
+    EMBENET_BRT_SendControl(EMBENET_BRT_CONTROL_BAUD_REQUEST, baudRate);
+    return true;
+}
+
+uint32_t EMBENET_BRT_GetBaudRate(void) {
+    return linkState.baudRate;
+}
+
 void EMBENET_BRT_Reset(void) {
        SysCtrlSystemReset();
        __builtin_unreachable();
@@ -81,134 +216,305 @@ void EMBENET_BRT_Reset(void) {
 
 
 static void     EMBENET_BRT_EncodeAndWrite(uint8_t data);
-static uint16_t EMBENET_BRT_CalculateCRC(uint16_t crc, uint8_t byte);
 static void     EMBENET_BRT_WriteByte(uint8_t data);
+static void     EMBENET_BRT_Flush(void);
 void            EMBENET_BRT_Send(const void* packet, size_t packetLength) {
+    EMBENET_BRT_Segment const segment = {.data = packet, .length = packetLength};
+    EMBENET_BRT_SendV(&segment, 1);
+}
+
+void EMBENET_BRT_SendV(const EMBENET_BRT_Segment* segments, size_t segmentCount) {
+    EMBENET_BRT_WriteFrame(false, segments, segmentCount);
+}
+
+static void EMBENET_BRT_WriteFrame(bool control, const EMBENET_BRT_Segment* segments, size_t segmentCount) {
+    // Frames queued after a baud rate switch was agreed on leave at the new baud rate
+    while (false == EMBENET_BRT_ApplyBaudRate()) {
+        ;
+    }
+
     uint16_t finalCrc = HDLC_CRCINIT;
 
-    uint8_t const* packetBytes = (uint8_t const*)packet;
     EMBENET_BRT_WriteByte(HDLC_FLAG);
-    for (size_t i = 0; i != packetLength; ++i) {
-        finalCrc = EMBENET_BRT_CalculateCRC(finalCrc, packetBytes[i]);
-        EMBENET_BRT_EncodeAndWrite(packetBytes[i]);
+    if (true == control) {
+        // an escaped byte that is neither a flag nor an escape cannot be produced by the encoder, so no stack frame looks like this
+        EMBENET_BRT_WriteByte(HDLC_ESCAPE);
+        EMBENET_BRT_WriteByte(EMBENET_BRT_CONTROL_MARKER);
+    }
+    for (size_t s = 0; s != segmentCount; ++s) {
+        uint8_t const* segmentBytes = (uint8_t const*)segments[s].data;
+        finalCrc                    = EMBENET_BRT_CRC_Update(finalCrc, segmentBytes, segments[s].length);
+        for (size_t i = 0; i != segments[s].length; ++i) {
+            EMBENET_BRT_EncodeAndWrite(segmentBytes[i]);
+        }
     }
     finalCrc = (uint16_t)(~finalCrc);
     EMBENET_BRT_EncodeAndWrite((uint8_t)((finalCrc >> 0) & 0xff));
     EMBENET_BRT_EncodeAndWrite((uint8_t)((finalCrc >> 8) & 0xff));
     EMBENET_BRT_WriteByte(HDLC_FLAG);
+    EMBENET_BRT_Flush();
 }
 //
 //
-size_t EMBENET_BRT_Receive(void* packetBuffer, size_t packetBufferSize) {
-    static uint8_t inputFrame[EMBENET_BRT_MAX_FRAME_SIZE];
-    static size_t  inputFrameDataIndex;
-    static bool    inputFrameReceiving;
-    static uint8_t lastDataByte;
+static void EMBENET_BRT_Decode(void);
+size_t      EMBENET_BRT_Receive(void* packetBuffer, size_t packetBufferSize) {
+    EMBENET_BRT_Decode();
+    if (0 == rxFrameCount) {
+        return 0;
+    }
+
+    // full frame has been received and its CRC verified, structure:
+    // - ID: 1B
+    // - data: variable bytes count
+    EMBENET_BRT_RxFrame const* frame      = &rxFrames[rxFrameHead];
+    size_t                     returnSize = frame->length;
+    if (packetBufferSize >= returnSize) {
+        memcpy(packetBuffer, frame->data, returnSize);
+    } else {
+        memcpy(packetBuffer, frame->data, packetBufferSize);
+        returnSize = 0;
+    }
+    rxFrameHead = (rxFrameHead + 1) % EMBENET_BRT_RX_FRAME_COUNT;
+    --rxFrameCount;
+    return returnSize;
+}
+
+
+void EMBENET_BRT_SendRaw(const void* data, size_t dataLength) {
+    uint8_t const* dataBytes = (uint8_t const*)data;
+    for(size_t i = 0; i < dataLength; ++i) {
+        EMBENET_BRT_WriteByte(dataBytes[i]);
+    }
+    EMBENET_BRT_Flush();
+}
+
+static size_t EMBENET_BRT_Read(void* data, size_t dataBufferSize);
+size_t        EMBENET_BRT_ReceiveRaw(void* data, size_t dataBufferSize) {
+    uint8_t* dataBytes = (uint8_t*)data;
 
+    // bytes already fetched for the HDLC decoder are delivered first
+    size_t pending = rxChunkLength - rxChunkPosition;
+    if (pending > dataBufferSize) {
+        pending = dataBufferSize;
+    }
+    memcpy(dataBytes, rxChunk + rxChunkPosition, pending);
+    rxChunkPosition += pending;
 
-    uint8_t dataByte;
-    bool    frameComplete = false;
+    return pending + EMBENET_BRT_Read(dataBytes + pending, dataBufferSize - pending);
+}
 
+bool EMBENET_BRT_IsBusy(void) {
+    return (txCount != 0) || (false == UART2Support_txDone(embenetUart->hwAttrs));
+}
 
-    while (UART2_getRxCount(embenetUart) > 0 && frameComplete == false) {
-        EMBENET_CRITICAL_SECTION_Enter();
-        UART2_read(embenetUart, &dataByte, sizeof(dataByte), NULL);
-        EMBENET_CRITICAL_SECTION_Exit();
-        if (false == inputFrameReceiving) {
-            if (HDLC_FLAG == dataByte) {
-                inputFrameReceiving = true;
-                inputFrameDataIndex = 0;
-            }
-        } else {
-            if (HDLC_FLAG == dataByte) {
-                if (HDLC_FLAG != lastDataByte) {
-                    // finished frame
-                    inputFrameReceiving = false;
-                    if (inputFrameDataIndex > 2) {
-                        frameComplete = true; // one frame at a time
+static void EMBENET_BRT_OnWriteDone(UART2_Handle handle, void* buffer, size_t count, void* userArg, int_fast16_t status) {
+    (void)buffer;  // warning suppress
+    (void)count;   // warning suppress
+    (void)userArg; // warning suppress
+    (void)status;  // warning suppress
+
+    // Called from interrupt context: release the drained buffer and start the pending one, if any
+    txHead = (txHead + 1) % EMBENET_BRT_TX_BUFFER_COUNT;
+    --txCount;
+    if (txCount != 0) {
+        UART2_write(handle, txBuffers[txHead].data, txBuffers[txHead].length, NULL);
+    }
+}
+
+static EMBENET_BRT_TxBuffer* EMBENET_BRT_AcquireTxBuffer(void) {
+    // Wait until UART releases one of the buffers. The tail is not touched by the interrupt, unlike txHead and txCount, which cannot be
+    // read together outside a critical section.
+    while (EMBENET_BRT_TX_BUFFER_COUNT == txCount) {
+        ;
+    }
+    EMBENET_BRT_TxBuffer* buffer = &txBuffers[txTail];
+    buffer->length               = 0;
+    return buffer;
+}
+
+static void EMBENET_BRT_Flush(void) {
+    if (NULL == txFill) {
+        return;
+    }
+
+    txTail = (txTail + 1) % EMBENET_BRT_TX_BUFFER_COUNT;
+    EMBENET_CRITICAL_SECTION_Enter();
+    bool startWrite = (0 == txCount);
+    ++txCount;
+    EMBENET_CRITICAL_SECTION_Exit();
+    txFill = NULL;
+
+    if (true == startWrite) {
+        UART2_write(embenetUart, txBuffers[txHead].data, txBuffers[txHead].length, NULL);
+    }
+}
+
+static void EMBENET_BRT_WriteByte(uint8_t data) {
+    if (NULL == txFill) {
+        txFill = EMBENET_BRT_AcquireTxBuffer();
+    }
+    txFill->data[txFill->length++] = data;
+    if (sizeof(txFill->data) == txFill->length) {
+        EMBENET_BRT_Flush(); // frames longer than the staging buffer are sent in chunks
+    }
+}
+
+static size_t EMBENET_BRT_Read(void* data, size_t dataBufferSize) {
+    size_t bytesRead = 0;
+
+    // Interrupts are masked once for the whole transfer, not for every byte
+    EMBENET_CRITICAL_SECTION_Enter();
+    size_t available = UART2_getRxCount(embenetUart);
+    if (available > dataBufferSize) {
+        available = dataBufferSize;
+    }
+    if (available > 0) {
+        UART2_read(embenetUart, data, available, &bytesRead);
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    return bytesRead;
+}
+
+// Folds the bytes decoded since the last update into the running CRC of the frame
+static void EMBENET_BRT_UpdateDecoderCRC(EMBENET_BRT_RxFrame const* frame) {
+    decoder.crc       = EMBENET_BRT_CRC_Update(decoder.crc, frame->data + decoder.crcLength, decoder.length - decoder.crcLength);
+    decoder.crcLength = decoder.length;
+}
+
+// Passes a single byte to the decoder, returns true when a frame with a valid CRC was completed
+static bool EMBENET_BRT_DecodeByte(EMBENET_BRT_RxFrame* frame, uint8_t dataByte) {
+    bool          frameComplete = false;
+    uint8_t const rawByte       = dataByte;
+
+    if (false == decoder.receiving) {
+        if (HDLC_FLAG == dataByte) {
+            decoder.receiving = true;
+            decoder.control   = false;
+            decoder.length    = 0;
+            decoder.crcLength = 0;
+            decoder.crc       = HDLC_CRCINIT;
+        }
+    } else {
+        if (HDLC_FLAG == dataByte) {
+            if (HDLC_FLAG != decoder.lastDataByte) {
+                // finished frame, the CRC computed over data and the trailing CRC bytes leaves a constant residue
+                decoder.receiving = false;
+                EMBENET_BRT_UpdateDecoderCRC(frame);
+                if (decoder.length > 2) {
+                    if (HDLC_CRCGOOD == decoder.crc) {
+                        frame->length  = decoder.length - 2; // two last bytes are CRC bytes
+                        frame->control = decoder.control;
+                        frameComplete  = true;
+                        ++linkState.frames;
+                    } else {
+                        ++linkState.errors;
                     }
-                } else {
-                    // two '~' at a time, repeating frame start
-                    inputFrameReceiving = true;
-                    inputFrameDataIndex = 0;
                 }
             } else {
-                // add byte to buffer
-                if (inputFrameDataIndex < sizeof(inputFrame)) {
-                    if (HDLC_ESCAPE != dataByte) {
-                        if (HDLC_ESCAPE != lastDataByte) {
-                            inputFrame[inputFrameDataIndex++] = dataByte;
-                        } else {
-                            inputFrame[inputFrameDataIndex++] = (dataByte ^ HDLC_ESCAPE_MASK);
-                        }
+                // two '~' at a time, repeating frame start
+                decoder.receiving = true;
+                decoder.control   = false;
+                decoder.length    = 0;
+                decoder.crcLength = 0;
+                decoder.crc       = HDLC_CRCINIT;
+            }
+        } else {
+            // add byte to buffer
+            if (decoder.length < sizeof(frame->data)) {
+                if (HDLC_ESCAPE != dataByte) {
+                    if (HDLC_ESCAPE != decoder.lastDataByte) {
+                        frame->data[decoder.length++] = dataByte;
+                    } else if ((0 == decoder.length) && (EMBENET_BRT_CONTROL_MARKER == dataByte)) {
+                        decoder.control = true; // the marker is neither part of the frame nor covered by its CRC
+                    } else {
+                        frame->data[decoder.length++] = dataByte ^ HDLC_ESCAPE_MASK;
                     }
-                } else {
-                    inputFrameReceiving = false;
-                    inputFrameDataIndex = 0;
                 }
-            }
-        }
-        lastDataByte = dataByte;
-    }
-
-    if (true == frameComplete && inputFrameDataIndex > 0) {
-        // full frame has been received, structure:
-        // - ID: 1B
-        // - data: variable bytes count
-        // - CRC: 2B
-        // check CRC
-        uint16_t crc = HDLC_CRCINIT;
-        for (size_t index = 0; index < inputFrameDataIndex - 2; ++index) { // two last bytes are CRC bytes
-            crc = EMBENET_BRT_CalculateCRC(crc, inputFrame[index]);
-        }
-        crc = (uint16_t)(~crc);
-        if ((((crc >> 0) & 0xff) == inputFrame[inputFrameDataIndex - 2]) && (((crc >> 8) & 0xff) == inputFrame[inputFrameDataIndex - 1])) { // two last bytes are CRC bytes
-            // CRC OK!
-            size_t returnSize = inputFrameDataIndex - 2; // data without ID and CRC
-            // copy data
-            if (packetBufferSize >= returnSize) { // data bytes count without ID and CRC
-                memcpy(packetBuffer, inputFrame, returnSize);
-                return returnSize;
             } else {
-                memcpy(packetBuffer, inputFrame, packetBufferSize);
-                return 0;
+                decoder.receiving = false;
+                decoder.length    = 0;
+                decoder.crcLength = 0;
             }
         }
     }
+    decoder.lastDataByte = rawByte; // kept across reads, so escape sequences split between two chunks are handled
 
-    return 0;
+    return frameComplete;
 }
 
+// Consumes link control frames, returns false for frames that should be passed to the stack
+static bool EMBENET_BRT_HandleControlFrame(EMBENET_BRT_RxFrame const* frame) {
+    if (false == frame->control) {
+        return false;
+    }
+    if (EMBENET_BRT_CONTROL_FRAME_LENGTH != frame->length) {
+        return true; // commands this port does not know are dropped
+    }
 
-void EMBENET_BRT_SendRaw(const void* data, size_t dataLength) {
-    uint8_t const* dataBytes = (uint8_t const*)data;
-    for(size_t i = 0; i < dataLength; ++i) {
-        EMBENET_BRT_WriteByte(dataBytes[i]);
+    uint8_t  command  = frame->data[0];
+    uint32_t baudRate = (uint32_t)frame->data[1] | ((uint32_t)frame->data[2] << 8) | ((uint32_t)frame->data[3] << 16) | ((uint32_t)frame->data[4] << 24);
+    if (EMBENET_BRT_CONTROL_BAUD_FALLBACK == command) {
+        linkState.requestedBaudRate = 0;
+        if ((EMBENET_BRT_DEFAULT_BAUD_RATE == baudRate) && (baudRate != linkState.baudRate)) {
+            EMBENET_BRT_SwitchBaudRate(baudRate);
+        }
+    } else if (baudRate == linkState.requestedBaudRate) {
+        linkState.requestedBaudRate = 0;
+        if (EMBENET_BRT_CONTROL_BAUD_ACCEPT == command) {
+            EMBENET_BRT_SwitchBaudRate(baudRate);
+        }
     }
+    return true;
 }
 
-size_t EMBENET_BRT_ReceiveRaw(void* data, size_t dataBufferSize) {
-    uint8_t* dataBytes = (uint8_t*)data;
-    
-    while(UART2_getRxCount(embenetUart) > 0) {
-        EMBENET_CRITICAL_SECTION_Enter();
-        UART2_read(embenetUart, dataBytes, sizeof(uint8_t), NULL);
-        EMBENET_CRITICAL_SECTION_Exit();
-        
-        ++dataBytes;
-        if(dataBytes >= (uint8_t*)data + dataBufferSize) {
-            break;
+// Returns to the default baud rate when too many frames are corrupted
+static void EMBENET_BRT_CheckLinkQuality(void) {
+    if ((linkState.frames + linkState.errors) < EMBENET_BRT_FALLBACK_WINDOW) {
+        return;
+    }
+    if ((linkState.errors >= EMBENET_BRT_FALLBACK_ERRORS) && (EMBENET_BRT_DEFAULT_BAUD_RATE != linkState.baudRate)) {
+        // The border router is told at the current baud rate, which it may still receive well. The check is repeated on the next
+        // call rather than waiting for UART to release a buffer.
+        if (txCount < EMBENET_BRT_TX_BUFFER_COUNT) {
+            EMBENET_BRT_SendControl(EMBENET_BRT_CONTROL_BAUD_FALLBACK, EMBENET_BRT_DEFAULT_BAUD_RATE);
+            EMBENET_BRT_SwitchBaudRate(EMBENET_BRT_DEFAULT_BAUD_RATE);
         }
+    } else {
+        linkState.frames = 0;
+        linkState.errors = 0;
     }
-    return (size_t)(dataBytes - (uint8_t*)data);
 }
 
-bool EMBENET_BRT_IsBusy(void) {
-    return false == UART2Support_txDone(embenetUart->hwAttrs);
-}
+// Decodes all bytes available in UART, as long as there is space for decoded frames
+static void EMBENET_BRT_Decode(void) {
+    while (rxFrameCount < EMBENET_BRT_RX_FRAME_COUNT) {
+        if (false == EMBENET_BRT_ApplyBaudRate()) {
+            break; // the bytes waiting in UART are read at the new baud rate
+        }
+        if (rxChunkPosition == rxChunkLength) {
+            rxChunkPosition = 0;
+            rxChunkLength   = EMBENET_BRT_Read(rxChunk, sizeof(rxChunk));
+            if (0 == rxChunkLength) {
+                break;
+            }
+        }
 
-static void EMBENET_BRT_WriteByte(uint8_t data) {
-    UART2_write(embenetUart, &data, sizeof(data), NULL);
+        // frames are decoded in place, directly into the first free slot of the queue
+        EMBENET_BRT_RxFrame* frame = &rxFrames[(rxFrameHead + rxFrameCount) % EMBENET_BRT_RX_FRAME_COUNT];
+        while (rxChunkPosition != rxChunkLength) {
+            if (EMBENET_BRT_DecodeByte(frame, rxChunk[rxChunkPosition++])) {
+                if (false == EMBENET_BRT_HandleControlFrame(frame)) {
+                    ++rxFrameCount;
+                }
+                break;
+            }
+        }
+        EMBENET_BRT_CheckLinkQuality();
+        if (true == decoder.receiving) {
+            EMBENET_BRT_UpdateDecoderCRC(frame); // CRC follows the incoming data chunk by chunk
+        }
+    }
 }
 
 static void EMBENET_BRT_EncodeAndWrite(uint8_t data) {
@@ -220,21 +526,3 @@ static void EMBENET_BRT_EncodeAndWrite(uint8_t data) {
         EMBENET_BRT_WriteByte(data);
     }
 }
-
-static uint16_t EMBENET_BRT_CalculateCRC(uint16_t crc, uint8_t byte) {
-    static const uint16_t lut[256] = {0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf, 0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7, 0x1081, 0x0108, 0x3393, 0x221a,
-                                      0x56a5, 0x472c, 0x75b7, 0x643e, 0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876, 0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
-                                      0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5, 0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c, 0xbdcb, 0xac42, 0x9ed9, 0x8f50,
-                                      0xfbef, 0xea66, 0xd8fd, 0xc974, 0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb, 0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
-                                      0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a, 0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72, 0x6306, 0x728f, 0x4014, 0x519d,
-                                      0x2522, 0x34ab, 0x0630, 0x17b9, 0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1, 0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
-                                      0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70, 0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7, 0x0840, 0x19c9, 0x2b52, 0x3adb,
-                                      0x4e64, 0x5fed, 0x6d76, 0x7cff, 0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036, 0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
-                                      0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5, 0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd, 0xb58b, 0xa402, 0x9699, 0x8710,
-                                      0xf3af, 0xe226, 0xd0bd, 0xc134, 0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c, 0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
-                                      0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb, 0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232, 0x5ac5, 0x4b4c, 0x79d7, 0x685e,
-                                      0x1ce1, 0x0d68, 0x3ff3, 0x2e7a, 0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1, 0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
-                                      0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330, 0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78};
-
-    return (crc >> 8) ^ lut[(crc ^ byte) & 0xff];
-}
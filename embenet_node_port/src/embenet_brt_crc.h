@@ -0,0 +1,38 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     CRC-16/X.25 kernel of the HDLC framing used on the border router link
+*/
+
+#ifndef EMBENET_BRT_CRC_H_
+#define EMBENET_BRT_CRC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Folds data into a running CRC-16/X.25.
+ *
+ * Start with 0xffff. The CRC sent after the data is the complement of the result, least significant byte first. A frame received together with its CRC
+ * leaves the residue 0xf0b8. Bytes are processed EMBENET_BRT_CRC_SLICES at a time (1, 4 or 8, set at build time), the result does not depend on
+ * the setting or on how the data is split between calls. The kernel has no hardware dependencies.
+ *
+ * @param[in] crc CRC of the preceding data
+ * @param[in] data data to fold
+ * @param[in] length number of bytes of data
+ * @return CRC of the preceding data followed by data
+ */
+uint16_t EMBENET_BRT_CRC_Update(uint16_t crc, void const* data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_BRT_CRC_H_ included
@@ -14,7 +14,7 @@
 
 const EMBENET_MAC_Timings embenetMacTimings = {
     .TsTxOffsetUs     = 2000,       //
-    .TsTxAckDelayUs   = 3000,       //
+    .TsTxAckDelayUs   = 3000,       // shared by every node of the network, the ACK is built by the stack after the end of frame callback
     .TsLongGTUs       = (1000 / 2), //
     .TsShortGTUs      = (1000 / 2), //
     .TsSlotDurationUs = 35000,      //
@@ -8,13 +8,17 @@
 */
 
 
-#include "embenet_radio.h"
+#include "embenet_radio_cc1312.h"
 
 #include "embenet_critical_section.h"
+#include "embenet_eui64.h"
+#include "embenet_radio_calibration.h"
+#include "embenet_timer_cc1312.h"
 // clang-format off
 #include <ti_drivers_config.h>
 #include <ti_radio_config.h>
 #include <ti/drivers/rf/RF.h>
+#include <ti/drivers/dpl/ClockP.h>
 #include DeviceFamily_constructPath(driverlib/rf_data_entry.h)
 #include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
 #include <ti/drivers/power/PowerCC26X2.h>
@@ -27,16 +31,26 @@
 
 enum {
     TX_BUFFER_LENGTH = EMBENET_RADIO_MAX_PSDU_LENGTH + 2 + 6, ///< added 2 extra bytes for packet length field and RSSI, the rest is dummy pool
-    RX_BUFFER_LENGTH = EMBENET_RADIO_MAX_PSDU_LENGTH + 2 + 6, ///< added 2 extra bytes for packet length field and RSSI, the rest is dummy pool
+    TX_BUFFER_COUNT  = 2, ///< Number of TX buffers, the next frame (e.g. ACK) can be built while the other one is transmitted
+    RX_BUFFER_LENGTH = EMBENET_RADIO_MAX_PSDU_LENGTH + 2 + 6, ///< added 2 extra bytes for packet length field and RSSI, 4 bytes of RX timestamp, the rest is dummy pool
+    RX_ENTRY_COUNT   = 4, ///< Number of RX data entries, frames lent to the stack stay untouched while the following ones are received
 
     SYNCWORD_LENGTH = 2,     ///< Length of synchronization sequence [Bytes]
     PREAMBLE_LENGTH = 8,     ///< Preamble length [Bytes]
-    RADIO_BITRATE   = 50000, ///< Modem bitrate [bps]
+    RADIO_BITRATE   = 50000, ///< Modem bitrate of the setup generated by SysConfig [bps]
+    CRC_LENGTH      = 2,     ///< Length of CRC appended to the frame [Bytes]
 
-    TX_DELAY            = 795,  ///< time between tranmsission trigger and the appearance of preamble
-    TX_START_CORRECTION = 550,  ///< after the transmission is trigerred, the start of frame callback is called 550us too early
-    TX_END_CORRECTION   = 330,  ///< transmitter triggers the end of frame interrupts 330us earlier than receiver which triggers end of frame reception interrupt
-    RX_START_CORRECTION = 1620, ///< transmission time of preamble and synchronization sequence plus extra time of interrupt delay
+    TX_DELAY            = 795,  ///< time between tranmsission trigger and the appearance of preamble, scheduled by RAT for triggered transmissions
+    RX_DELAY            = 180,  ///< time between reception trigger and the receiver listening, used until the synthesizer lock is measured
+    TX_START_CORRECTION = 550,  ///< after the transmission is trigerred, the start of frame callback is called 550us too early, used until calibrated
+    TX_END_CORRECTION   = 330,  ///< transmitter triggers the end of frame interrupts 330us earlier than receiver which triggers end of frame reception interrupt, used until calibrated
+    RX_START_LATENCY    = 20,   ///< extra time of interrupt delay after transmission of preamble and synchronization sequence, used until calibrated
+
+    MAX_CALIBRATION_SAMPLE = 5000, ///< Measured corrections above this value are caused by preemption and are not used for calibration
+    CCA_DURATION           = 250,  ///< Time for which the channel is sensed before transmission, if CCA is enabled [us]
+    SCAN_SAMPLE_PERIOD     = 100,  ///< Time between two RSSI samples of the energy scan [us]
+    LQI_RSSI_RANGE         = 40,   ///< RSSI above sensitivity mapped onto the whole LQI range [dB]
+    AUTO_ACK_MIN_DELAY     = 500,  ///< Shortest delay of the automatic ACK, the end of frame callback has to come and cancel the ACK before it starts [us]
 
 
     BAND_START_FREQUENCY = 863100, ///< Start frequency of transceiver band in kHz
@@ -44,9 +58,38 @@ enum {
     CHANNEL_WIDTH        = 100,  ///< Width of single radio channel in kHz
     KHZ_TO_HZ_RATIO      = 1000, ///< Coversion ratio from MHz to Hz
 
-    SENSITIVITY      = -100, /**< [dBm], does not consider as neighbor if RSSI will be lower */
     MIN_OUTPUT_POWER = 0,
     MAX_OUTPUT_POWER = 14,
+    LINK_TXP_COUNT   = 16, ///< Number of destinations with own transmission power
+    PATH_LOSS_WEIGHT = 4,  ///< Inverse of the weight of a new sample in the average path loss to a neighbor
+
+    FCF_LENGTH                = 2,      ///< Length of IEEE 802.15.4 frame control field
+    FCF_FRAME_TYPE_MASK       = 0x0007, ///< Frame type field of frame control field
+    FCF_SECURITY_ENABLED      = 0x0008, ///< Security enabled bit of frame control field
+    FCF_ACK_REQUEST           = 0x0020, ///< ACK request bit of frame control field
+    FCF_PAN_ID_COMPRESSION    = 0x0040, ///< PAN ID compression bit of frame control field
+    FCF_SEQ_NUMBER_SUPPRESSED = 0x0100, ///< Sequence number suppression bit of frame control field, valid for frame version 2
+    FCF_IE_PRESENT            = 0x0200, ///< IE present bit of frame control field, valid for frame version 2
+    FCF_DST_MODE_SHIFT        = 10,     ///< Position of destination addressing mode in frame control field
+    FCF_VERSION_SHIFT         = 12,     ///< Position of frame version in frame control field
+    FCF_SRC_MODE_SHIFT        = 14,     ///< Position of source addressing mode in frame control field
+    ADDR_MODE_NONE            = 0,
+    ADDR_MODE_SHORT           = 2,
+    ADDR_MODE_EXTENDED        = 3,
+    SHORT_ADDR_LENGTH         = 2,
+    EXTENDED_ADDR_LENGTH      = 8,
+    SHORT_ADDR_BROADCAST      = 0xffff,
+    FRAME_VERSION_2015        = 2,
+    FRAME_TYPE_ACK            = 2,
+    PAN_ID_LENGTH             = 2,
+    IE_DESCRIPTOR_LENGTH      = 2,    ///< Length of the descriptor of an information element
+    IE_LENGTH_MASK            = 0x7f, ///< Content length field of the descriptor of a header IE
+    IE_ID_SHIFT               = 7,    ///< Position of the element ID in the descriptor of a header IE
+    IE_ID_VENDOR              = 0x00, ///< Vendor specific header IE
+    IE_ID_TERMINATION_1       = 0x7e, ///< Header termination IE followed by payload IEs
+    IE_ID_TERMINATION_2       = 0x7f, ///< Header termination IE followed by payload
+    IE_OUI_LENGTH             = 3,    ///< Length of the OUI opening a vendor specific IE
+    ACK_TXP_IE_LENGTH         = 4,    ///< Vendor specific IE of ACKs: OUI of the EUI-64 of the sender and the transmit power in dBm
 };
 
 
@@ -56,31 +99,28 @@ static rfc_CMD_FS_OFF_t commonFsOff = {
     .condition.rule           = COND_NEVER,
 };
 
-static uint8_t                radioRxBuffer[RX_BUFFER_LENGTH];
-static rfc_dataEntryPointer_t rxItem = {
-    .config.type  = DATA_ENTRY_TYPE_PTR,
-    .config.lenSz = 0,
-    .length       = sizeof(radioRxBuffer),
-    .pNextEntry   = (uint8_t*)&rxItem,
-    .pData        = radioRxBuffer,
-    .status       = DATA_ENTRY_PENDING,
-};
+static uint8_t                          radioRxBuffers[RX_ENTRY_COUNT][RX_BUFFER_LENGTH];
+static rfc_dataEntryPointer_t           rxEntries[RX_ENTRY_COUNT]; ///< Circular queue of RX data entries, linked in EMBENET_RADIO_Init
+static size_t                           rxWriteIndex;              ///< Index of the entry that will be filled by the next received frame
+static rfc_dataEntryPointer_t* volatile rxLastEntry;               ///< Entry holding the last received frame, until it is taken by the stack
 
-static dataQueue_t rxQueue     = {.pCurrEntry = (uint8_t*)&rxItem};
+static dataQueue_t rxQueue     = {.pCurrEntry = (uint8_t*)&rxEntries[0], .pLastEntry = NULL};
 rfc_CMD_PROP_RX_t  rxChainDoRx = {
      .commandNo                = CMD_PROP_RX,
      .startTrigger.triggerType = TRIG_NOW,
      .condition.rule           = COND_NEVER,
      .pktConf.bUseCrc          = 1,
      .pktConf.bVarLen          = 1,
-     .pktConf.endType          = 1,
+     .pktConf.endType          = 0, // a frame being received when the listening window closes is completed
      .rxConf.bAutoFlushIgnored = 1,
      .rxConf.bAutoFlushCrcErr  = 1,
      .rxConf.bIncludeHdr       = 1,
      .rxConf.bAppendRssi       = 1,
+     .rxConf.bAppendTimestamp  = 1,
      .syncWord                 = 0x904E,
      .maxPktLen                = EMBENET_RADIO_MAX_PSDU_LENGTH,
-     .endTrigger.triggerType   = TRIG_NEVER,
+     .endTrigger.triggerType   = TRIG_NEVER, // set by setRxEndTrigger
+     .endTrigger.pastTrig      = 1,
      .pQueue                   = &rxQueue,
      .pOutput                  = 0,
 };
@@ -92,10 +132,20 @@ rfc_CMD_FS_t rxChainSetFs = {
     .condition.rule           = COND_STOP_ON_FALSE,
 };
 
+/// Ownership of a TX buffer
+typedef enum {
+    TX_BUFFER_FREE,    ///< Available for EMBENET_RADIO_GetTxBuffer
+    TX_BUFFER_LENT,    ///< Frame is being built by the stack
+    TX_BUFFER_READY,   ///< Frame is set up for transmission by EMBENET_RADIO_CommitTx
+    TX_BUFFER_SENDING, ///< Frame is being transmitted by the RF core
+} TxBufferState;
+
+static uint8_t                radioTxBuffers[TX_BUFFER_COUNT][TX_BUFFER_LENGTH];
+static volatile TxBufferState txBufferStates[TX_BUFFER_COUNT];
+
 /**
- * @brief Sends data set by EMBENET_RADIO_TxEnable, then turns off FS
+ * @brief Sends data set by EMBENET_RADIO_CommitTx, then turns off FS
  */
-static uint8_t           radioTxBuffer[TX_BUFFER_LENGTH];
 static rfc_CMD_PROP_TX_t txChainDoTx = {
     .commandNo                = CMD_PROP_TX,
     .startTrigger.triggerType = TRIG_NOW,
@@ -104,7 +154,29 @@ static rfc_CMD_PROP_TX_t txChainDoTx = {
     .pktConf.bUseCrc          = 0x1,
     .pktConf.bVarLen          = 0x1,
     .syncWord                 = 0x0000904E,
-    .pPkt                     = radioTxBuffer,
+    .pPkt                     = radioTxBuffers[0],
+};
+
+
+/**
+ * @brief Checks that the channel is clear before txChainDoTx, chained only if enabled by EMBENET_RADIO_SetCca
+ * Senses the channel for CCA_DURATION and stops the chain as soon as RSSI exceeds the threshold.
+ * The idle channel is sensed until the timeout, so that the transmission delay does not depend on CCA.
+ */
+static rfc_CMD_PROP_CS_t txChainCs = {
+    .commandNo                = CMD_PROP_CS,
+    .pNextOp                  = (RF_Op*)&txChainDoTx,
+    .startTrigger.triggerType = TRIG_NOW,
+    .condition.rule           = COND_STOP_ON_TRUE, // result is TRUE for busy channel
+    .csConf.bEnaRssi          = 1,
+    .csConf.bEnaCorr          = 0,
+    .csConf.busyOp            = 1, // end on busy channel
+    .csConf.idleOp            = 0, // continue on idle channel
+    .csConf.timeoutRes        = 0, // undetermined channel is treated as busy
+    .numRssiIdle              = 1,
+    .numRssiBusy              = 1,
+    .csEndTrigger.triggerType = TRIG_REL_START,
+    .csEndTime                = CCA_DURATION * RF_NUM_RAT_TICKS_IN_1_US,
 };
 
 
@@ -124,19 +196,102 @@ static rfc_CMD_FS_t txChainSetFs = {
 };
 
 
-static EMBENET_RADIO_CaptureCbt onStartOfFrameHandler; ///< Handler to method called when start of frame interrupt occurs
-static EMBENET_RADIO_CaptureCbt onEndOfFrameHandler;   ///< Handler to method called when end of frame interrupt occurs
-static void*                    handlersContext;       ///< Context passed to handlers
+static bool ccaEnabled;       ///< True if txChainCs is chained before txChainDoTx
+static bool txStartReported; ///< True if the start of frame callback was called for the current transmission
+static bool txScheduled;     ///< True if RAT starts txChainDoTx at a fixed time after the trigger, i.e. for EMBENET_RADIO_TxAt
+static bool txOnSchedule;    ///< True if the synthesizer was locked before the scheduled start, so the preamble appeared exactly on time
 
-static uint8_t rxPacket[RX_BUFFER_LENGTH];
+/**
+ * @brief Receiver test without synchronization, keeps the receiver running so that RSSI can be sampled for energy detection
+ */
+static rfc_CMD_RX_TEST_t scanChainDoRx = {
+    .commandNo                = CMD_RX_TEST,
+    .startTrigger.triggerType = TRIG_NOW,
+    .condition.rule           = COND_NEVER,
+    .config.bNoSync           = 1,
+    .endTrigger.triggerType   = TRIG_REL_START,
+};
+
+static rfc_CMD_FS_t scanChainSetFs = {
+    .commandNo                = CMD_FS,
+    .pNextOp                  = (RF_Op*)&scanChainDoRx,
+    .startTrigger.triggerType = TRIG_NOW,
+    .condition.rule           = COND_STOP_ON_FALSE,
+};
+
+/// Energy scan started by EMBENET_RADIO_StartEnergyScan
+typedef struct {
+    EMBENET_RADIO_Channel const*    channels;
+    size_t                          channelCount;
+    size_t                          scanned; ///< Number of channels finished, the next one is sampled
+    EMBENET_RADIO_EnergyScanResult* results;
+    EMBENET_RADIO_EnergyScanCbt     onDone;
+    void*                           context;
+    RF_CmdHandle                    transaction; ///< Command sampled on the current channel, RF_ALLOC_ERROR if no scan runs
+} EnergyScan;
 
-static int8_t rxPacketRssi;
-static size_t rxPacketLength;
+static EnergyScan    scan;
+static ClockP_Struct scanSampleClock; ///< Samples RSSI every SCAN_SAMPLE_PERIOD while the scan runs
 
 
+static uint8_t             autoAckBuffer[TX_BUFFER_LENGTH]; ///< ACK sent by the RF core after every valid frame, while auto-ACK is enabled
+static EMBENET_RADIO_Power autoAckTxp;                      ///< Power of the automatic ACK
+static bool                autoAckEnabled;                  ///< True if rxChainDoAck is chained after rxChainDoRx
+static EMBENET_TimeUs      autoAckDelay;                    ///< Time between the end of the received frame and the automatic ACK
+static uint64_t            ownEui;                          ///< Extended address of the node, frames addressed to another one are not acknowledged
+static uint16_t            ownShortAddress;                 ///< Short address set by EMBENET_RADIO_SetShortAddress, SHORT_ADDR_BROADCAST if none
+
+/**
+ * @brief Sends ACK set by EMBENET_RADIO_SetAutoAck, a fixed delay after the end of rxChainDoRx
+ * Executed by the RF core only if the frame was received with valid CRC. The synthesizer is already running after the reception,
+ * so there is no software involved between the end of frame and the ACK.
+ */
+static rfc_CMD_PROP_TX_t rxChainDoAck = {
+    .commandNo                = CMD_PROP_TX,
+    .startTrigger.triggerType = TRIG_REL_PREVEND,
+    .startTrigger.pastTrig    = 1,
+    .condition.rule           = COND_NEVER,
+    .pktConf.bFsOff           = 0,
+    .pktConf.bUseCrc          = 0x1,
+    .pktConf.bVarLen          = 0x1,
+    .syncWord                 = 0x0000904E,
+    .pPkt                     = autoAckBuffer,
+};
+
+
+/// PHY profile, each with its own setup validated on the board
+typedef struct {
+    rfc_CMD_PROP_RADIO_DIV_SETUP_t const* setup;       ///< Setup generated by SysConfig for the profile
+    uint32_t                              bitrate;     ///< Modem bitrate of the setup [bps]
+    EMBENET_RADIO_Power                   sensitivity; ///< [dBm], does not consider as neighbor if RSSI will be lower
+} PhyProfile;
+
+static const PhyProfile phyProfiles[EMBENET_RADIO_PHY_COUNT] = {
+    [EMBENET_RADIO_PHY_50KBPS] = {.setup = &RF_cmdPropRadioDivSetup_custom868_0, .bitrate = RADIO_BITRATE, .sensitivity = -100},
+};
+
+static rfc_CMD_PROP_RADIO_DIV_SETUP_t radioSetup; ///< Copy of the setup of the selected PHY, the RF driver keeps a pointer to it
+static EMBENET_RADIO_Phy              currentPhy; ///< PHY set in radioSetup
+
+
+static EMBENET_RADIO_CaptureCbt onStartOfFrameHandler; ///< Handler to method called when start of frame interrupt occurs
+static EMBENET_RADIO_CaptureCbt onEndOfFrameHandler;   ///< Handler to method called when end of frame interrupt occurs
+static void*                    handlersContext;       ///< Context passed to handlers
+
 static RF_CmdHandle txTransaction;
 static RF_CmdHandle rxTransaction;
 
+static EMBENET_RADIO_CALIBRATION_Estimator txStartEstimator; ///< Measures TX_START_CORRECTION
+static EMBENET_RADIO_CALIBRATION_Estimator txEndEstimator;   ///< Measures TX_END_CORRECTION
+static EMBENET_RADIO_CALIBRATION_Estimator rxStartEstimators[EMBENET_RADIO_PHY_COUNT]; ///< Measure start of frame correction, which depends on the PHY
+static EMBENET_RADIO_CALIBRATION_Estimator synthEstimator;   ///< Measures time between the trigger and the synthesizer lock, i.e. RX_DELAY
+static EMBENET_TimeUs                      txTriggerTime;    ///< Time at which the current transmission was triggered
+static EMBENET_TimeUs                      rxStartTime;      ///< Time of the start of frame callback of the frame being received
+static bool                                rxStartCaptured;  ///< True if rxStartTime belongs to the frame being received
+static EMBENET_TimeUs                      rxWindow;         ///< Maximum listening time without synchronization, 0 if not limited
+
+static EMBENET_RADIO_Counters counters; ///< Updated by the RF callbacks, read with EMBENET_RADIO_GetCounters
+
 static RF_Object     rfObject;
 static RF_Handle     rfHandle;
 static volatile bool idle;
@@ -144,20 +299,98 @@ static volatile bool idle;
 extern void EXPECT_OnAbortHandler(char const* why, char const* file, int line);
 
 
+/// Synthesizer settings of a single channel, as used by CMD_FS
+typedef struct {
+    uint16_t frequency; ///< Integer part of the channel frequency in MHz
+    uint16_t fractFreq; ///< Fractional part of the channel frequency in 1/65536 MHz
+} ChannelSynthSettings;
+
+static ChannelSynthSettings  channelSynthSettings[BAND_CHANNEL_COUNT]; ///< Filled by initChannelSynthSettings, indexed by channel
+static EMBENET_RADIO_Channel channelRemap[BAND_CHANNEL_COUNT];         ///< Channel used in place of the requested one, filled by EMBENET_RADIO_SetChannelMap
+
+
+/**
+ * @brief Computes synthesizer settings of all channels, so that no division is needed when the channel is set
+ * @note this function does not check, whether the given frequency is possible to set on this transceiver
+ */
+static void initChannelSynthSettings(void) {
+    for (uint32_t channel = 0; channel != BAND_CHANNEL_COUNT; ++channel) {
+        uint32_t f                              = BAND_START_FREQUENCY + (channel * CHANNEL_WIDTH);
+        channelSynthSettings[channel].frequency = (uint16_t)(f / KHZ_TO_HZ_RATIO);
+        channelSynthSettings[channel].fractFreq = (uint16_t)((((f % KHZ_TO_HZ_RATIO) * ((uint32_t)UINT16_MAX + 1)) + (KHZ_TO_HZ_RATIO / 2)) / KHZ_TO_HZ_RATIO);
+    }
+}
+
+
 /**
  * @brief In given FS cmd, sets frequency that corresponds with given channel
  * @param[in, out] cmd pointer do FS command to set the frequency
  * @param[in] channel channel to set
- * @note this function does not check, whether the given frequency is possible to set on this transceiver
  */
 static void setChannel(rfc_CMD_FS_t* cmd, EMBENET_RADIO_Channel channel) {
     if (channel >= BAND_CHANNEL_COUNT) {
         channel = BAND_CHANNEL_COUNT - 1; // clipping
     }
-    channel        = 0;
-    uint32_t f     = BAND_START_FREQUENCY + ((uint32_t)channel * CHANNEL_WIDTH);
-    cmd->frequency = (uint16_t)(f / KHZ_TO_HZ_RATIO);
-    cmd->fractFreq = (uint16_t)((f % KHZ_TO_HZ_RATIO) * ((uint32_t)(UINT16_MAX + 1) / KHZ_TO_HZ_RATIO));
+    cmd->frequency = channelSynthSettings[channel].frequency;
+    cmd->fractFreq = channelSynthSettings[channel].fractFreq;
+}
+
+
+static RF_TxPowerTable_Value txPowerValues[MAX_OUTPUT_POWER - MIN_OUTPUT_POWER + 1]; ///< Register values for every supported power, indexed by dBm - MIN_OUTPUT_POWER
+static EMBENET_RADIO_Power   appliedTxp;                                             ///< Power currently set in the radio, RF_TxPowerTable_INVALID_DBM if unknown
+
+/// Transmission power of frames sent to a single destination, set with EMBENET_RADIO_SetLinkTxPower
+typedef struct {
+    uint64_t            eui; ///< Extended address of the destination, 0 if the entry is free
+    EMBENET_RADIO_Power txp; ///< Power used instead of the one requested by the MAC
+} LinkTxPower;
+
+static LinkTxPower linkTxPowers[LINK_TXP_COUNT];
+
+/// Path loss to a single neighbor, measured with its ACKs
+typedef struct {
+    uint64_t eui;      ///< Extended address of the neighbor, 0 if the entry is free
+    int16_t  pathLoss; ///< Average path loss in 1/16 dB
+} LinkPathLoss;
+
+static LinkPathLoss linkPathLosses[LINK_TXP_COUNT];
+static size_t       linkPathLossNext; ///< Entry replaced when a new neighbor does not fit
+static uint64_t     ackExpectedFrom;  ///< Extended destination of the last frame sent with ACK request, 0 if no ACK is expected
+
+
+/**
+ * @brief Looks up register values of all supported output powers, so that RF_TxPowerTable_findValue is not called before every transmission
+ */
+static void initTxPowerValues(void) {
+    for (int txp = MIN_OUTPUT_POWER; txp <= MAX_OUTPUT_POWER; ++txp) {
+        int8_t tablePower = (int8_t)txp;
+        // Clamp txp to be sure that RF_TxPowerTable_findValue will always find some value
+        if (tablePower > txPowerTable_custom868_0[TX_POWER_TABLE_SIZE_custom868_0 - 1].power) {
+            tablePower = RF_TxPowerTable_MAX_DBM;
+        }
+
+        if (tablePower < txPowerTable_custom868_0[0].power) {
+            tablePower = RF_TxPowerTable_MIN_DBM;
+        }
+        txPowerValues[txp - MIN_OUTPUT_POWER] = RF_TxPowerTable_findValue(txPowerTable_custom868_0, tablePower);
+    }
+    appliedTxp = RF_TxPowerTable_INVALID_DBM;
+}
+
+
+/**
+ * @brief Clamps txp to the nearest supported value
+ * @param[in] txp transmit power in dBm
+ * @return power that is actually used for txp
+ */
+static EMBENET_RADIO_Power clampTxp(EMBENET_RADIO_Power txp) {
+    if (txp > MAX_OUTPUT_POWER) {
+        return MAX_OUTPUT_POWER;
+    }
+    if (txp < MIN_OUTPUT_POWER) {
+        return MIN_OUTPUT_POWER;
+    }
+    return txp;
 }
 
 
@@ -166,33 +399,552 @@ static void setChannel(rfc_CMD_FS_t* cmd, EMBENET_RADIO_Channel channel) {
  * @param[in] txp txp to set
  */
 static void setTxp(EMBENET_RADIO_Power txp) {
-    // Clamp txp to be sure that RF_TxPowerTable_findValue will always find some value
-    if (txp > txPowerTable_custom868_0[TX_POWER_TABLE_SIZE_custom868_0 - 1].power) {
-        txp = RF_TxPowerTable_MAX_DBM;
+    txp = clampTxp(txp);
+    if (txp != appliedTxp) {
+        if (RF_StatSuccess == RF_setTxPower(rfHandle, txPowerValues[txp - MIN_OUTPUT_POWER])) {
+            appliedTxp = txp;
+        }
+    }
+}
+
+
+/**
+ * @brief Reads destination address of IEEE 802.15.4 frame
+ * @param[in] psdu frame
+ * @param[in] psduLen frame length
+ * @param[out] address destination address, short or extended
+ * @return addressing mode of the destination, ADDR_MODE_NONE if the frame has no destination address or is too short to hold it
+ */
+static unsigned getDestination(uint8_t const* psdu, size_t psduLen, uint64_t* address) {
+    if (psduLen < FCF_LENGTH) {
+        return ADDR_MODE_NONE;
+    }
+    uint16_t fcf     = (uint16_t)(psdu[0] | (psdu[1] << 8));
+    unsigned dstMode = (fcf >> FCF_DST_MODE_SHIFT) & 0x3;
+    unsigned srcMode = (fcf >> FCF_SRC_MODE_SHIFT) & 0x3;
+    unsigned version = (fcf >> FCF_VERSION_SHIFT) & 0x3;
+    if ((ADDR_MODE_SHORT != dstMode) && (ADDR_MODE_EXTENDED != dstMode)) {
+        return ADDR_MODE_NONE;
+    }
+
+    size_t offset = FCF_LENGTH;
+    if ((FRAME_VERSION_2015 != version) || (0 == (fcf & FCF_SEQ_NUMBER_SUPPRESSED))) {
+        offset += 1;
+    }
+    // Since the 2015 revision the destination PAN ID is left out of compressed frames, unless both addresses are present and one of them is short
+    if ((FRAME_VERSION_2015 != version) || (0 == (fcf & FCF_PAN_ID_COMPRESSION)) ||
+        ((ADDR_MODE_SHORT == srcMode) || ((ADDR_MODE_SHORT == dstMode) && (ADDR_MODE_EXTENDED == srcMode)))) {
+        offset += 2;
+    }
+    size_t addressLength = (ADDR_MODE_EXTENDED == dstMode) ? EXTENDED_ADDR_LENGTH : SHORT_ADDR_LENGTH;
+    if (offset + addressLength > psduLen) {
+        return ADDR_MODE_NONE;
+    }
+    *address = 0;
+    for (size_t i = addressLength; i != 0; --i) {
+        *address = (*address << 8) | psdu[offset + i - 1];
+    }
+    return dstMode;
+}
+
+
+/**
+ * @brief Checks if received frame is to be acknowledged by this node
+ * @param[in] psdu frame
+ * @param[in] psduLen frame length
+ * @return true if the frame requests an ACK and is addressed to this node, either with its extended address or with the short address set by EMBENET_RADIO_SetShortAddress
+ */
+static bool isAckRequested(uint8_t const* psdu, size_t psduLen) {
+    if ((psduLen < FCF_LENGTH) || (0 == (psdu[0] & FCF_ACK_REQUEST))) {
+        return false;
+    }
+    uint64_t address;
+    switch (getDestination(psdu, psduLen, &address)) {
+        case ADDR_MODE_EXTENDED:
+            return address == ownEui;
+        case ADDR_MODE_SHORT:
+            return (SHORT_ADDR_BROADCAST != address) && (address == ownShortAddress);
+        default:
+            return false;
+    }
+}
+
+
+static bool isAck(uint8_t const* psdu, size_t psduLen) {
+    return (psduLen >= FCF_LENGTH) && (FRAME_TYPE_ACK == (psdu[0] & FCF_FRAME_TYPE_MASK));
+}
+
+
+static size_t getAddressLength(unsigned mode) {
+    return (ADDR_MODE_EXTENDED == mode) ? EXTENDED_ADDR_LENGTH : (ADDR_MODE_SHORT == mode) ? SHORT_ADDR_LENGTH : 0;
+}
+
+
+/**
+ * @brief Gets position of the header IEs of IEEE 802.15.4 frame
+ * Only unsecured frames of the 2015 revision are considered, IEs of older frames do not exist and those of secured frames are covered by the MIC.
+ * @param[in] psdu frame
+ * @param[in] psduLen frame length
+ * @return offset of the first header IE, i.e. the length of the addressing fields, 0 if the frame cannot carry IEs readable by the port
+ */
+static size_t getHeaderIeOffset(uint8_t const* psdu, size_t psduLen) {
+    if (psduLen < FCF_LENGTH) {
+        return 0;
+    }
+    uint16_t fcf     = (uint16_t)(psdu[0] | (psdu[1] << 8));
+    unsigned dstMode = (fcf >> FCF_DST_MODE_SHIFT) & 0x3;
+    unsigned srcMode = (fcf >> FCF_SRC_MODE_SHIFT) & 0x3;
+    unsigned version = (fcf >> FCF_VERSION_SHIFT) & 0x3;
+    if ((FRAME_VERSION_2015 != version) || (0 != (fcf & FCF_SECURITY_ENABLED)) || (1 == dstMode) || (1 == srcMode)) {
+        return 0;
+    }
+
+    // PAN IDs present with the given addressing modes and PAN ID compression, after table 7-2 of IEEE 802.15.4-2015
+    bool compression = 0 != (fcf & FCF_PAN_ID_COMPRESSION);
+    bool dstPanId;
+    bool srcPanId;
+    if ((ADDR_MODE_NONE == dstMode) || (ADDR_MODE_NONE == srcMode) || ((ADDR_MODE_EXTENDED == dstMode) && (ADDR_MODE_EXTENDED == srcMode))) {
+        dstPanId = (ADDR_MODE_NONE == dstMode) ? ((ADDR_MODE_NONE == srcMode) && compression) : !compression;
+        srcPanId = (ADDR_MODE_NONE == dstMode) && (ADDR_MODE_NONE != srcMode) && !compression;
+    } else {
+        dstPanId = true;
+        srcPanId = !compression;
+    }
+    size_t offset = FCF_LENGTH + ((0 == (fcf & FCF_SEQ_NUMBER_SUPPRESSED)) ? 1 : 0) + (dstPanId ? PAN_ID_LENGTH : 0) + getAddressLength(dstMode)
+                    + (srcPanId ? PAN_ID_LENGTH : 0) + getAddressLength(srcMode);
+    return (offset <= psduLen) ? offset : 0;
+}
+
+
+/**
+ * @brief Finds the header IE carrying the transmit power of an ACK
+ * @param[in] psdu frame
+ * @param[in] psduLen frame length
+ * @param[in] oui OUI of the EUI-64 of the sender, opening the IE
+ * @param[out] end offset of the end of the header IEs, psduLen if no payload follows them, 0 if they cannot be parsed
+ * @return offset of the content of the IE, 0 if the frame has none
+ */
+static size_t findAckTxpIe(uint8_t const* psdu, size_t psduLen, uint32_t oui, size_t* end) {
+    size_t offset = getHeaderIeOffset(psdu, psduLen);
+    *end          = offset;
+    if ((0 == offset) || (0 == (psdu[1] & (FCF_IE_PRESENT >> 8)))) {
+        return 0;
+    }
+    while (offset + IE_DESCRIPTOR_LENGTH <= psduLen) {
+        uint16_t descriptor = (uint16_t)(psdu[offset] | (psdu[offset + 1] << 8));
+        unsigned id         = (descriptor >> IE_ID_SHIFT) & 0xff;
+        size_t   length     = descriptor & IE_LENGTH_MASK;
+        size_t   content    = offset + IE_DESCRIPTOR_LENGTH;
+        if ((IE_ID_TERMINATION_1 == id) || (IE_ID_TERMINATION_2 == id) || (content + length > psduLen)) {
+            *end = (content + length > psduLen) ? 0 : offset;
+            return 0;
+        }
+        if ((IE_ID_VENDOR == id) && (ACK_TXP_IE_LENGTH == length) && (psdu[content] == (uint8_t)oui) && (psdu[content + 1] == (uint8_t)(oui >> 8)) &&
+            (psdu[content + 2] == (uint8_t)(oui >> 16))) {
+            *end = psduLen;
+            return content;
+        }
+        offset = content + length;
+    }
+    *end = (offset == psduLen) ? offset : 0;
+    return 0;
+}
+
+
+/**
+ * @brief Appends the transmit power to an ACK, so that the neighbor learns the path loss from its RSSI
+ * The power is carried in a vendor specific header IE opened by the OUI of the node. The IE is only added to unsecured enhanced ACKs
+ * without payload that have room for it, other ACKs are sent as they are.
+ * @param[in, out] psdu ACK, in a buffer of at least EMBENET_RADIO_MAX_PSDU_LENGTH bytes
+ * @param[in] psduLen ACK length
+ * @param[in] txp power the ACK is sent at
+ * @return new ACK length
+ */
+static size_t addAckTxpIe(uint8_t* psdu, size_t psduLen, EMBENET_RADIO_Power txp) {
+    uint32_t oui = (uint32_t)(ownEui >> 40);
+    size_t   end;
+    size_t   content = findAckTxpIe(psdu, psduLen, oui, &end);
+    if (0 != content) {
+        psdu[content + IE_OUI_LENGTH] = (uint8_t)txp; // the IE is already there, e.g. the stack passed an ACK sent before
+        return psduLen;
+    }
+    if ((psduLen != end) || (psduLen + IE_DESCRIPTOR_LENGTH + ACK_TXP_IE_LENGTH > EMBENET_RADIO_MAX_PSDU_LENGTH)) {
+        return psduLen;
+    }
+    uint16_t descriptor = (uint16_t)((IE_ID_VENDOR << IE_ID_SHIFT) | ACK_TXP_IE_LENGTH);
+    psdu[1] |= (uint8_t)(FCF_IE_PRESENT >> 8);
+    psdu[psduLen++] = (uint8_t)descriptor;
+    psdu[psduLen++] = (uint8_t)(descriptor >> 8);
+    psdu[psduLen++] = (uint8_t)oui;
+    psdu[psduLen++] = (uint8_t)(oui >> 8);
+    psdu[psduLen++] = (uint8_t)(oui >> 16);
+    psdu[psduLen++] = (uint8_t)txp;
+    return psduLen;
+}
+
+
+/**
+ * @brief Gets transmission power of given frame
+ * @param[in] psdu frame to send
+ * @param[in] psduLen frame length
+ * @param[in] txp power requested by the MAC
+ * @return power set for the destination of the frame with EMBENET_RADIO_SetLinkTxPower, txp if none was set
+ */
+static EMBENET_RADIO_Power getLinkTxp(uint8_t const* psdu, size_t psduLen, EMBENET_RADIO_Power txp) {
+    uint64_t eui;
+    if (ADDR_MODE_EXTENDED == getDestination(psdu, psduLen, &eui)) {
+        for (size_t i = 0; i != LINK_TXP_COUNT; ++i) {
+            if ((0 != eui) && (eui == linkTxPowers[i].eui)) {
+                return linkTxPowers[i].txp;
+            }
+        }
+    }
+    return txp;
+}
+
+
+/**
+ * @brief Gets the neighbor expected to acknowledge given frame
+ * @param[in] psdu frame to send
+ * @param[in] psduLen frame length
+ * @return extended destination of the frame if it requests an ACK, 0 otherwise
+ */
+static uint64_t getAckSource(uint8_t const* psdu, size_t psduLen) {
+    uint64_t eui;
+    if ((psduLen < FCF_LENGTH) || (0 == (psdu[0] & FCF_ACK_REQUEST)) || (ADDR_MODE_EXTENDED != getDestination(psdu, psduLen, &eui))) {
+        return 0;
+    }
+    return eui;
+}
+
+
+/**
+ * @brief Adds the path loss of received frame to the path loss to the neighbor the last frame was sent to, if the frame is an ACK carrying its power
+ * @param[in] psdu received frame
+ * @param[in] psduLen frame length
+ * @param[in] rssi RSSI of the frame
+ */
+static void recordAckPathLoss(uint8_t const* psdu, size_t psduLen, int8_t rssi) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    uint64_t eui = ackExpectedFrom;
+    if ((0 != eui) && isAck(psdu, psduLen)) {
+        ackExpectedFrom = 0; // a frame is acknowledged once
+        size_t end;
+        size_t content = findAckTxpIe(psdu, psduLen, (uint32_t)(eui >> 40), &end);
+        if (0 != content) {
+            int16_t       pathLoss = (int16_t)(((int8_t)psdu[content + IE_OUI_LENGTH] - rssi) * 16);
+            LinkPathLoss* entry    = NULL;
+            for (size_t i = 0; (i != LINK_TXP_COUNT) && (NULL == entry); ++i) {
+                if (eui == linkPathLosses[i].eui) {
+                    entry = &linkPathLosses[i];
+                }
+            }
+            if (NULL != entry) {
+                entry->pathLoss += (int16_t)((pathLoss - entry->pathLoss) / PATH_LOSS_WEIGHT);
+            } else {
+                entry            = &linkPathLosses[linkPathLossNext];
+                linkPathLossNext = (linkPathLossNext + 1) % LINK_TXP_COUNT;
+                *entry           = (LinkPathLoss){.eui = eui, .pathLoss = pathLoss};
+            }
+        }
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+
+/**
+ * @brief Gives the entry back to the RF core, so that it can be filled with a new frame
+ * @param[in] entry entry to release, NULL is ignored
+ */
+static void releaseRxEntry(rfc_dataEntryPointer_t* entry) {
+    if (entry != NULL) {
+        entry->status = DATA_ENTRY_PENDING;
+    }
+}
+
+
+/**
+ * @brief Points the RX queue at the first entry that is not lent to the stack.
+ * An entry is reused only after it was released, if all are lent the reception will fail on buffer overflow.
+ */
+static void rearmRxQueue(void) {
+    for (size_t i = 0; i != RX_ENTRY_COUNT; ++i) {
+        if (DATA_ENTRY_FINISHED != rxEntries[rxWriteIndex].status) {
+            rxEntries[rxWriteIndex].status = DATA_ENTRY_PENDING; // entry could have been left busy by an aborted reception
+            break;
+        }
+        rxWriteIndex = (rxWriteIndex + 1) % RX_ENTRY_COUNT;
+    }
+    rxQueue.pCurrEntry = (uint8_t*)&rxEntries[rxWriteIndex];
+}
+
+
+/**
+ * @brief Estimates link quality of a received frame
+ * The PROP RX commands report no correlation value, so the LQI grows linearly with the RSSI margin above the sensitivity of the current PHY.
+ * @param[in] rssi RSSI of the frame
+ * @return LQI, 0 at or below sensitivity, 255 at LQI_RSSI_RANGE above it or more
+ */
+static uint8_t getLqi(int8_t rssi) {
+    int margin = rssi - phyProfiles[currentPhy].sensitivity;
+    if (margin <= 0) {
+        return 0;
+    }
+    return (margin >= LQI_RSSI_RANGE) ? UINT8_MAX : (uint8_t)((margin * UINT8_MAX) / LQI_RSSI_RANGE);
+}
+
+
+/**
+ * @brief Takes over the last received frame from the RX callback
+ * @param[out] info information about the frame, crcValid is false if no valid frame was received
+ * @return entry holding the frame, NULL if there is no valid frame
+ */
+static rfc_dataEntryPointer_t* takeRxEntry(EMBENET_RADIO_RxInfo* info) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    rfc_dataEntryPointer_t* entry = rxLastEntry;
+    rxLastEntry                   = NULL;
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    *info = (EMBENET_RADIO_RxInfo){.crcValid = false, .lqi = 0, .mpduLength = 0, .rssi = 0};
+    if (entry != NULL) {
+        size_t length = entry->pData[0];
+        int8_t rssi   = (int8_t)entry->pData[length + 1];
+        *info         = (EMBENET_RADIO_RxInfo){.crcValid = true, .lqi = getLqi(rssi), .mpduLength = length, .rssi = rssi};
+        recordAckPathLoss(entry->pData + 1, length, rssi);
+    }
+    return entry;
+}
+
+
+/**
+ * @brief Changes state of all TX buffers being in one state to another
+ * @param[in] from state of buffers to change
+ * @param[in] to new state
+ */
+static void setTxBuffersState(TxBufferState from, TxBufferState to) {
+    for (size_t i = 0; i != TX_BUFFER_COUNT; ++i) {
+        if (from == txBufferStates[i]) {
+            txBufferStates[i] = to;
+        }
+    }
+}
+
+
+/**
+ * @brief Converts time expressed in the EMBENET_TIMER timebase to radio timer (RAT) time
+ * @param[in] t time in us, as returned by EMBENET_TIMER_ReadCounter
+ * @return corresponding RAT time
+ */
+static ratmr_t timerToRatTime(EMBENET_TimeUs t) {
+    // Both timers are sampled back to back, so the offset between them is not affected by interrupts
+    EMBENET_CRITICAL_SECTION_Enter();
+    uint32_t       ratNow   = RF_getCurrentTime();
+    EMBENET_TimeUs timerNow = EMBENET_TIMER_ReadCounter();
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    int32_t delta = (int32_t)(t - timerNow); // wraps correctly, as long as t is within +-2^31 us from now
+    return (ratmr_t)(ratNow + (uint32_t)delta * RF_NUM_RAT_TICKS_IN_1_US);
+}
+
+
+/**
+ * @brief Converts radio timer (RAT) time to the EMBENET_TIMER timebase
+ * @param[in] ratTime RAT time, e.g. a timestamp captured by the RF core
+ * @return corresponding time in us, as returned by EMBENET_TIMER_ReadCounter
+ */
+static EMBENET_TimeUs ratToTimerTime(ratmr_t ratTime) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    uint32_t       ratNow   = RF_getCurrentTime();
+    EMBENET_TimeUs timerNow = EMBENET_TIMER_ReadCounter();
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    int32_t delta = (int32_t)(ratTime - ratNow); // negative for timestamps from the past
+    return timerNow + (EMBENET_TimeUs)(delta / RF_NUM_RAT_TICKS_IN_1_US);
+}
+
+
+/**
+ * @brief Gets transmission time of a single byte
+ * @param[in] phy PHY profile
+ * @return transmission time in us
+ */
+static EMBENET_TimeUs getByteAirTime(EMBENET_RADIO_Phy phy) {
+    return (EMBENET_TimeUs)(8 * 1000000 / phyProfiles[phy].bitrate);
+}
+
+
+/**
+ * @brief Gets time between transmission trigger and the appearance of preamble
+ * @return TX_DELAY extended with the channel sensing, if CCA is enabled
+ */
+static EMBENET_TimeUs getTxDelay(void) {
+    return TX_DELAY + (ccaEnabled ? CCA_DURATION : 0);
+}
+
+
+/**
+ * @brief Gets time between reception trigger and the receiver listening
+ * The receiver listens as soon as the synthesizer is locked. The lock is seen by the start of frame callback of scheduled transmissions,
+ * which use the same synthesizer command, so the measured time includes the callback latency and errs on the early side of the trigger.
+ * @return calibrated time if available, RX_DELAY otherwise
+ */
+static EMBENET_TimeUs getRxDelay(void) {
+    return (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&synthEstimator, RX_DELAY);
+}
+
+
+/**
+ * @brief Gets time between the appearance of first bit of preamble and a call of start of frame callback during reception
+ * @param[in] phy PHY profile
+ * @return calibrated time if available, estimate from the preamble length otherwise
+ */
+static EMBENET_TimeUs getRxStartCorrection(EMBENET_RADIO_Phy phy) {
+    EMBENET_TimeUs estimate = (PREAMBLE_LENGTH + SYNCWORD_LENGTH) * getByteAirTime(phy) + RX_START_LATENCY;
+    return (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&rxStartEstimators[phy], (int32_t)estimate);
+}
+
+
+/**
+ * @brief Copies the setup of given PHY to radioSetup
+ * The setup carries its own output power, which the radio takes with the setup, so the power set before is no longer known.
+ * @param[in] phy PHY profile
+ */
+static void setPhy(EMBENET_RADIO_Phy phy) {
+    radioSetup = *phyProfiles[phy].setup;
+    currentPhy = phy;
+    appliedTxp = RF_TxPowerTable_INVALID_DBM;
+}
+
+
+/**
+ * @brief Gets the time of synchronization word detection captured by the RF core
+ * The RF core latches RAT time when the synchronization word is detected and appends it after RSSI.
+ * @param[in] entry entry holding a valid frame
+ * @return time of reception of the last bit of the synchronization word, in us
+ */
+static EMBENET_TimeUs getRxSyncTime(rfc_dataEntryPointer_t const* entry) {
+    size_t         length    = entry->pData[0];
+    uint8_t const* timestamp = &entry->pData[length + 2]; // after length field, PSDU and RSSI
+    ratmr_t syncTime = (ratmr_t)timestamp[0] | ((ratmr_t)timestamp[1] << 8) | ((ratmr_t)timestamp[2] << 16) | ((ratmr_t)timestamp[3] << 24);
+    return ratToTimerTime(syncTime);
+}
+
+
+/**
+ * @brief Adds measured correction to the estimator, unless it is implausible
+ * @param[in, out] estimator estimator to update
+ * @param[in] later time of the later of the two events, e.g. the callback for RX start or the on-air event for TX
+ * @param[in] earlier time of the earlier of the two events
+ */
+static void calibrate(EMBENET_RADIO_CALIBRATION_Estimator* estimator, EMBENET_TimeUs later, EMBENET_TimeUs earlier) {
+    int32_t correction = (int32_t)(later - earlier);
+    if ((correction >= 0) && (correction < MAX_CALIBRATION_SAMPLE)) {
+        EMBENET_RADIO_CALIBRATION_AddSample(estimator, correction);
     }
+}
+
+
+/**
+ * @brief Sets the start trigger of the first command of a chain
+ * @param[in, out] cmd first command of the chain
+ * @param[in] triggerType TRIG_NOW or TRIG_ABSTIME
+ * @param[in] startTime RAT time of the start, used with TRIG_ABSTIME
+ */
+static void setStartTrigger(rfc_CMD_FS_t* cmd, uint8_t triggerType, ratmr_t startTime) {
+    cmd->startTrigger.triggerType = triggerType;
+    cmd->startTrigger.pastTrig    = 1; // start at once, if the time has already passed
+    cmd->startTime                = startTime;
+}
+
 
-    if (txp < txPowerTable_custom868_0[0].power) {
-        txp = RF_TxPowerTable_MIN_DBM;
+/**
+ * @brief Closes the listening window of rxChainDoRx at rxWindow after the trigger, unless a frame is being received by then
+ * @param[in] triggerTime time of the listening trigger
+ */
+static void setRxEndTrigger(EMBENET_TimeUs triggerTime) {
+    if (0 == rxWindow) {
+        rxChainDoRx.endTrigger.triggerType = TRIG_NEVER;
+    } else {
+        rxChainDoRx.endTrigger.triggerType = TRIG_ABSTIME;
+        rxChainDoRx.endTime                = timerToRatTime(triggerTime + rxWindow);
     }
+}
+
 
-    RF_setTxPower(rfHandle, RF_TxPowerTable_findValue(txPowerTable_custom868_0, txp));
+/**
+ * @brief Counts a received frame and the delay of its end of frame callback
+ * @param[in] latency time between the end of the frame and the callback in us
+ */
+static void countRxLatency(int32_t latency) {
+    counters.rxFrames += 1;
+    if (latency < 0) {
+        latency = 0; // the end of frame is computed from the timestamp and may be off by the rounding of the air time
+    }
+    counters.rxLatencySum += (uint32_t)latency;
+    if ((EMBENET_TimeUs)latency > counters.rxLatencyMax) {
+        counters.rxLatencyMax = (EMBENET_TimeUs)latency;
+    }
 }
 
 
-static void rxProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
-static void txProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+static EMBENET_RADIO_Status postTx(EMBENET_TimeUs triggerTime);
+static EMBENET_RADIO_Status postRx(void);
+static void                 rxProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+static void                 txProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+static void                 scanProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+static void                 scanSampleCb(uintptr_t arg);
+static void                 stopScan(void);
 
 EMBENET_RADIO_Status EMBENET_RADIO_Init(void) {
     RF_Params rfParams;
     RF_Params_init(&rfParams);
-    txTransaction = RF_ALLOC_ERROR;
-    rxTransaction = RF_ALLOC_ERROR;
+    txTransaction    = RF_ALLOC_ERROR;
+    rxTransaction    = RF_ALLOC_ERROR;
+    scan.transaction = RF_ALLOC_ERROR;
+
+    ClockP_Params clockParams;
+    ClockP_Params_init(&clockParams);
+    clockParams.startFlag = false;
+    clockParams.period    = 0; // restarted by every sample, so that sampling stops with the scan
+    ClockP_construct(&scanSampleClock, scanSampleCb, (SCAN_SAMPLE_PERIOD + ClockP_getSystemTickPeriod() - 1) / ClockP_getSystemTickPeriod(), &clockParams);
+
+    for (size_t i = 0; i != RX_ENTRY_COUNT; ++i) {
+        rxEntries[i] = (rfc_dataEntryPointer_t){
+            .config.type  = DATA_ENTRY_TYPE_PTR,
+            .config.lenSz = 0,
+            .length       = sizeof(radioRxBuffers[i]),
+            .pNextEntry   = (uint8_t*)&rxEntries[(i + 1) % RX_ENTRY_COUNT],
+            .pData        = radioRxBuffers[i],
+            .status       = DATA_ENTRY_PENDING,
+        };
+    }
+    rxWriteIndex = 0;
+    rxLastEntry  = NULL;
+    rearmRxQueue();
+    ownEui          = EMBENET_EUI64_Get();
+    ownShortAddress = SHORT_ADDR_BROADCAST;
+
+    for (size_t i = 0; i != TX_BUFFER_COUNT; ++i) {
+        txBufferStates[i] = TX_BUFFER_FREE;
+    }
 
-    rfHandle = RF_open(&rfObject, &RF_prop_custom868_0, (RF_RadioSetup*)&RF_cmdPropRadioDivSetup_custom868_0, &rfParams);
+    initChannelSynthSettings();
+    EMBENET_RADIO_SetChannelMap(NULL);
+
+    setPhy(EMBENET_RADIO_PHY_50KBPS);
+
+    rfHandle = RF_open(&rfObject, &RF_prop_custom868_0, (RF_RadioSetup*)&radioSetup, &rfParams);
 
     if (NULL == rfHandle) {
         EXPECT_OnAbortHandler("radio initialization failure", __FILE__, __LINE__);
     }
+    initTxPowerValues();
+    memset(linkTxPowers, 0, sizeof(linkTxPowers));
+    memset(linkPathLosses, 0, sizeof(linkPathLosses));
+    linkPathLossNext = 0;
+    ackExpectedFrom = 0;
+    EMBENET_RADIO_ResetCalibration();
+    EMBENET_RADIO_ResetCounters();
     EMBENET_RADIO_Idle();
     return EMBENET_RADIO_STATUS_SUCCESS;
 }
@@ -209,71 +961,245 @@ void EMBENET_RADIO_Deinit(void) {
     if (rfHandle != NULL) {
         EMBENET_RADIO_Idle();
         RF_close(rfHandle);
+        ClockP_destruct(&scanSampleClock);
     }
 }
 
 
 EMBENET_RADIO_Status EMBENET_RADIO_Idle(void) {
+    stopScan();
     idle = true;
     RF_flushCmd(rfHandle, txTransaction, 0);
     RF_flushCmd(rfHandle, rxTransaction, 0);
     RF_postCmd(rfHandle, (RF_Op*)&commonFsOff, RF_PriorityHigh, NULL, 0);
+    txTransaction = RF_ALLOC_ERROR; // callbacks of the flushed commands are ignored
+    rxTransaction = RF_ALLOC_ERROR;
+
+    // None of the buffers is used by the RF core any more, the ones lent and not committed until now are taken back too, so that none leaks
+    setTxBuffersState(TX_BUFFER_LENT, TX_BUFFER_FREE);
+    setTxBuffersState(TX_BUFFER_READY, TX_BUFFER_FREE);
+    setTxBuffersState(TX_BUFFER_SENDING, TX_BUFFER_FREE);
 
     return EMBENET_RADIO_STATUS_SUCCESS;
 }
 
 EMBENET_RADIO_Status EMBENET_RADIO_TxEnable(EMBENET_RADIO_Channel channel, EMBENET_RADIO_Power txp, uint8_t const* psdu, size_t psduLen) {
-    idle = false;
+    if (psduLen > EMBENET_RADIO_MAX_PSDU_LENGTH) {
+        psduLen = EMBENET_RADIO_MAX_PSDU_LENGTH;
+    }
 
+    uint8_t* buffer = EMBENET_RADIO_GetTxBuffer();
+    if (NULL == buffer) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE;
+    }
+    memcpy(buffer, psdu, psduLen);
+
+    return EMBENET_RADIO_CommitTx(channel, txp, buffer, psduLen);
+}
+
+
+uint8_t* EMBENET_RADIO_GetTxBuffer(void) {
+    uint8_t* buffer = NULL;
+    EMBENET_CRITICAL_SECTION_Enter();
+    for (size_t i = 0; i != TX_BUFFER_COUNT; ++i) {
+        if (TX_BUFFER_FREE == txBufferStates[i]) {
+            txBufferStates[i] = TX_BUFFER_LENT;
+            buffer            = radioTxBuffers[i];
+            break;
+        }
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+    return buffer;
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_CommitTx(EMBENET_RADIO_Channel channel, EMBENET_RADIO_Power txp, uint8_t* psdu, size_t psduLen) {
+    size_t index = 0;
+    while ((index != TX_BUFFER_COUNT) && (psdu != radioTxBuffers[index])) {
+        ++index;
+    }
+    if ((TX_BUFFER_COUNT == index) || (TX_BUFFER_LENT != txBufferStates[index])) {
+        return EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS;
+    }
     if (psduLen > EMBENET_RADIO_MAX_PSDU_LENGTH) {
         psduLen = EMBENET_RADIO_MAX_PSDU_LENGTH;
     }
 
-    setTxp(txp);
-    setChannel(&txChainSetFs, channel);
+    stopScan();
+    idle = false;
+    EMBENET_RADIO_Power linkTxp = clampTxp(getLinkTxp(psdu, psduLen, txp));
+    if (isAck(psdu, psduLen)) {
+        psduLen = addAckTxpIe(psdu, psduLen, linkTxp);
+    }
+    setTxp(linkTxp);
+    ackExpectedFrom = getAckSource(psdu, psduLen);
+    setChannel(&txChainSetFs, EMBENET_RADIO_MapChannel(channel));
 
-    memcpy(radioTxBuffer, psdu, psduLen);
-    txChainDoTx.pktLen = (uint8_t)psduLen;
+    // A frame committed earlier but never triggered is replaced
+    setTxBuffersState(TX_BUFFER_READY, TX_BUFFER_FREE);
+    txBufferStates[index] = TX_BUFFER_READY;
+    txChainDoTx.pPkt      = psdu;
+    txChainDoTx.pktLen    = (uint8_t)psduLen;
 
     return EMBENET_RADIO_STATUS_SUCCESS;
 }
 
 
 EMBENET_RADIO_Status EMBENET_RADIO_TxNow(void) {
+    setStartTrigger(&txChainSetFs, TRIG_NOW, 0);
+    txChainDoTx.startTrigger.triggerType = TRIG_NOW;
+    txScheduled                          = false;
+    return postTx(EMBENET_TIMER_ReadCounter());
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_TxAt(EMBENET_TimeUs triggerTime) {
+    setStartTrigger(&txChainSetFs, TRIG_ABSTIME, timerToRatTime(triggerTime));
+    // The preamble does not follow the synthesizer lock, whose duration varies, but starts at a fixed time, known without any callback
+    txChainDoTx.startTrigger.triggerType = TRIG_ABSTIME;
+    txChainDoTx.startTrigger.pastTrig    = 1; // a late lock delays the frame instead of dropping it, such a frame is not used for calibration
+    txChainDoTx.startTime                = timerToRatTime(triggerTime + getTxDelay());
+    txScheduled                          = true;
+    return postTx(triggerTime);
+}
+
+
+static EMBENET_RADIO_Status postTx(EMBENET_TimeUs triggerTime) {
+    txTriggerTime      = triggerTime;
+    txStartReported    = false;
+    txOnSchedule       = false;
+    txChainCs.status   = IDLE; // commands skipped after busy channel keep their status
+    txChainDoTx.status = IDLE;
+    setTxBuffersState(TX_BUFFER_READY, TX_BUFFER_SENDING);
     txTransaction = RF_postCmd(rfHandle, (RF_Op*)&txChainSetFs, RF_PriorityHigh, txProcessCb, RF_EventCmdDone | RF_EventLastCmdDone);
-    return (RF_ALLOC_ERROR == txTransaction) ? EMBENET_RADIO_STATUS_GENERAL_ERROR : EMBENET_RADIO_STATUS_SUCCESS;
+    if (RF_ALLOC_ERROR == txTransaction) {
+        setTxBuffersState(TX_BUFFER_SENDING, TX_BUFFER_FREE);
+        return EMBENET_RADIO_STATUS_GENERAL_ERROR;
+    }
+    return EMBENET_RADIO_STATUS_SUCCESS;
 }
 
 
 EMBENET_RADIO_Status EMBENET_RADIO_RxEnable(EMBENET_RADIO_Channel channel) {
+    stopScan();
     idle = false;
     if (rxTransaction != RF_ALLOC_ERROR) {
         return EMBENET_RADIO_STATUS_WRONG_STATE;
     }
-    setChannel(&rxChainSetFs, channel);
+    setChannel(&rxChainSetFs, EMBENET_RADIO_MapChannel(channel));
+
+    // A frame that was not taken by the stack until now is dropped
+    EMBENET_RADIO_RxInfo info;
+    releaseRxEntry(takeRxEntry(&info));
+    rearmRxQueue();
 
     return EMBENET_RADIO_STATUS_SUCCESS;
 }
 
 
 EMBENET_RADIO_Status EMBENET_RADIO_RxNow(void) {
-    rxTransaction = RF_postCmd(rfHandle, (RF_Op*)&rxChainSetFs, RF_PriorityHigh, rxProcessCb, RF_EventMdmSoft | RF_EventRxOk | RF_EventRxNOk);
+    setStartTrigger(&rxChainSetFs, TRIG_NOW, 0);
+    setRxEndTrigger(EMBENET_TIMER_ReadCounter());
+    return postRx();
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_RxAt(EMBENET_TimeUs triggerTime) {
+    setStartTrigger(&rxChainSetFs, TRIG_ABSTIME, timerToRatTime(triggerTime));
+    setRxEndTrigger(triggerTime);
+    return postRx();
+}
+
+
+static EMBENET_RADIO_Status postRx(void) {
+    RF_EventMask events = RF_EventMdmSoft | RF_EventRxOk | RF_EventRxNOk | RF_EventLastCmdDone; // the chain ends after the ACK or when the window closes
+    if (autoAckEnabled) {
+        setTxp(autoAckTxp);
+    }
+    rxChainDoAck.status = IDLE; // tells whether the RF core started the ACK before it was cancelled
+    rxStartCaptured     = false;
+    rxTransaction = RF_postCmd(rfHandle, (RF_Op*)&rxChainSetFs, RF_PriorityHigh, rxProcessCb, events);
     return (RF_ALLOC_ERROR == rxTransaction) ? EMBENET_RADIO_STATUS_GENERAL_ERROR : EMBENET_RADIO_STATUS_SUCCESS;
 }
 
 
+EMBENET_RADIO_Status EMBENET_RADIO_SetRxWindow(EMBENET_TimeUs window) {
+    if (rxTransaction != RF_ALLOC_ERROR) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE;
+    }
+    rxWindow = window;
+    return EMBENET_RADIO_STATUS_SUCCESS;
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_SetAutoAck(uint8_t const* ack, size_t ackLen, EMBENET_RADIO_Power txp, EMBENET_TimeUs delay) {
+    if (rxTransaction != RF_ALLOC_ERROR) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE; // the chain must not be modified while the RF core executes it
+    }
+    if (NULL == ack) {
+        autoAckEnabled             = false;
+        rxChainDoRx.pNextOp        = NULL;
+        rxChainDoRx.condition.rule = COND_NEVER;
+        return EMBENET_RADIO_STATUS_SUCCESS;
+    }
+    if ((ackLen > EMBENET_RADIO_MAX_PSDU_LENGTH) || (delay < AUTO_ACK_MIN_DELAY)) {
+        return EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS;
+    }
+
+    memcpy(autoAckBuffer, ack, ackLen);
+    rxChainDoAck.pktLen        = (uint8_t)addAckTxpIe(autoAckBuffer, ackLen, clampTxp(txp));
+    rxChainDoAck.startTime     = (ratmr_t)(delay * RF_NUM_RAT_TICKS_IN_1_US);
+    autoAckDelay               = delay;
+    autoAckTxp                 = txp;
+    rxChainDoRx.pNextOp        = (RF_Op*)&rxChainDoAck;
+    rxChainDoRx.condition.rule = COND_STOP_ON_FALSE; // ACK only frames received with valid CRC
+    autoAckEnabled             = true;
+    return EMBENET_RADIO_STATUS_SUCCESS;
+}
+
+
+uint8_t* EMBENET_RADIO_GetAutoAck(void) {
+    return autoAckEnabled ? autoAckBuffer : NULL;
+}
+
+
+void EMBENET_RADIO_SetShortAddress(uint16_t address) {
+    ownShortAddress = address;
+}
+
+
 EMBENET_RADIO_RxInfo EMBENET_RADIO_GetReceivedFrame(uint8_t* buffer, size_t bufferLength) {
-    if (bufferLength < rxPacketLength) {
-        rxPacketLength = 0;
+    EMBENET_RADIO_RxInfo    info;
+    rfc_dataEntryPointer_t* entry = takeRxEntry(&info);
+    if (bufferLength < info.mpduLength) {
+        info = (EMBENET_RADIO_RxInfo){.crcValid = false, .lqi = 0, .mpduLength = 0, .rssi = info.rssi};
     }
-    EMBENET_RADIO_RxInfo info = {.crcValid = rxPacketLength != 0, .lqi = 0, .mpduLength = rxPacketLength, .rssi = rxPacketRssi};
-    if (rxPacketLength != 0) {
-        memcpy(buffer, rxPacket, rxPacketLength);
+    if (info.crcValid) {
+        memcpy(buffer, entry->pData + 1, info.mpduLength);
     }
+    releaseRxEntry(entry);
+    return info;
+}
+
+
+EMBENET_RADIO_RxInfo EMBENET_RADIO_LendReceivedFrame(uint8_t const** psdu) {
+    EMBENET_RADIO_RxInfo    info;
+    rfc_dataEntryPointer_t* entry = takeRxEntry(&info);
+    *psdu                         = (entry != NULL) ? entry->pData + 1 : NULL;
     return info;
 }
 
 
+void EMBENET_RADIO_ReleaseReceivedFrame(uint8_t const* psdu) {
+    for (size_t i = 0; i != RX_ENTRY_COUNT; ++i) {
+        if (psdu == rxEntries[i].pData + 1) {
+            releaseRxEntry(&rxEntries[i]);
+            return;
+        }
+    }
+}
+
+
 EMBENET_RADIO_Status EMBENET_RADIO_StartContinuousTx(EMBENET_RADIO_ContinuousTxMode mode, EMBENET_RADIO_Channel channel, EMBENET_RADIO_Power txp) {
     uint8_t              dummy  = 0;
     EMBENET_RADIO_Status result = EMBENET_RADIO_TxEnable(channel, txp, &dummy, 1);
@@ -285,77 +1211,420 @@ EMBENET_RADIO_Status EMBENET_RADIO_StartContinuousTx(EMBENET_RADIO_ContinuousTxM
 }
 
 
+EMBENET_RADIO_Status EMBENET_RADIO_SetCca(bool enabled, EMBENET_RADIO_Power threshold) {
+    if (!idle) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE;
+    }
+    if (enabled != ccaEnabled) {
+        EMBENET_RADIO_CALIBRATION_Reset(&txStartEstimator); // start of frame is reported after the channel sensing
+    }
+    txChainCs.rssiThr              = threshold;
+    txChainSetFs.pNextOp           = enabled ? (RF_Op*)&txChainCs : (RF_Op*)&txChainDoTx;
+    txChainSetFs.synthConf.bTxMode = enabled ? 0 : 1; // channel sensing needs synthesizer in RX mode
+    ccaEnabled                     = enabled;
+    return EMBENET_RADIO_STATUS_SUCCESS;
+}
+
+
+/**
+ * @brief Tunes to the next channel of the scan and keeps the receiver running for the dwell time
+ * @return false if the RF driver refused the command
+ */
+static bool postScan(void) {
+    scan.results[scan.scanned] = (EMBENET_RADIO_EnergyScanResult){.channel = scan.channels[scan.scanned], .noiseFloor = RF_GET_RSSI_ERROR_VAL, .peak = RF_GET_RSSI_ERROR_VAL};
+    setChannel(&scanChainSetFs, scan.channels[scan.scanned]);
+    scan.transaction = RF_postCmd(rfHandle, (RF_Op*)&scanChainSetFs, RF_PriorityHigh, scanProcessCb, RF_EventLastCmdDone);
+    return RF_ALLOC_ERROR != scan.transaction;
+}
+
+
+/**
+ * @brief Ends the scan and reports the channels finished until now
+ */
+static void endScan(void) {
+    scan.transaction = RF_ALLOC_ERROR; // the callback of a flushed command is ignored
+    ClockP_stop(ClockP_handle(&scanSampleClock));
+    scan.onDone(scan.context, scan.scanned);
+}
+
+
+/**
+ * @brief Stops the scan, if one runs, before the MAC takes the radio
+ */
+static void stopScan(void) {
+    if (RF_ALLOC_ERROR == scan.transaction) {
+        return;
+    }
+    RF_flushCmd(rfHandle, scan.transaction, 0);
+    endScan();
+}
+
+
+/**
+ * @brief Folds RSSI of the channel being scanned into its result
+ */
+static void scanSampleCb(uintptr_t arg) {
+    (void)arg; // warning suppress
+    if (RF_ALLOC_ERROR == scan.transaction) {
+        return;
+    }
+    int8_t rssi = RF_getRssi(rfHandle);
+    if (RF_GET_RSSI_ERROR_VAL != rssi) { // receiver is running
+        EMBENET_RADIO_EnergyScanResult* result = &scan.results[scan.scanned];
+        if ((RF_GET_RSSI_ERROR_VAL == result->noiseFloor) || (rssi < result->noiseFloor)) {
+            result->noiseFloor = rssi;
+        }
+        if (rssi > result->peak) {
+            result->peak = rssi;
+        }
+    }
+    ClockP_start(ClockP_handle(&scanSampleClock));
+}
+
+
+/**
+ * @brief Moves the scan to the next channel once the dwell time on the current one is over
+ */
+static void scanProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e) {
+    (void)h; // warning suppress
+    (void)e; // warning suppress
+    if (ch != scan.transaction) {
+        return; // scan stopped by the MAC
+    }
+    ++scan.scanned;
+    if ((scan.scanned != scan.channelCount) && postScan()) {
+        return;
+    }
+    RF_postCmd(rfHandle, (RF_Op*)&commonFsOff, RF_PriorityHigh, NULL, 0);
+    idle = true;
+    endScan();
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_StartEnergyScan(EMBENET_RADIO_Channel const* channels, size_t channelCount, EMBENET_TimeUs dwellTime,
+                                                   EMBENET_RADIO_EnergyScanResult* results, EMBENET_RADIO_EnergyScanCbt onDone, void* context) {
+    if ((0 == channelCount) || (NULL == onDone)) {
+        return EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS;
+    }
+    if (!idle) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE;
+    }
+
+    scanChainDoRx.endTime = (ratmr_t)(dwellTime * RF_NUM_RAT_TICKS_IN_1_US);
+    scan                  = (EnergyScan){.channels = channels, .channelCount = channelCount, .scanned = 0, .results = results, .onDone = onDone, .context = context,
+                                         .transaction = RF_ALLOC_ERROR};
+    if (!postScan()) {
+        return EMBENET_RADIO_STATUS_GENERAL_ERROR;
+    }
+    idle = false;
+    ClockP_start(ClockP_handle(&scanSampleClock));
+    return EMBENET_RADIO_STATUS_SUCCESS;
+}
+
+
+void EMBENET_RADIO_SetChannelMap(uint8_t const* allowed) {
+    EMBENET_RADIO_Channel allowedChannels[BAND_CHANNEL_COUNT];
+    size_t                allowedCount = 0;
+    for (size_t channel = 0; channel != BAND_CHANNEL_COUNT; ++channel) {
+        if ((NULL == allowed) || (0 != (allowed[channel / 8] & (1u << (channel % 8))))) {
+            allowedChannels[allowedCount++] = (EMBENET_RADIO_Channel)channel;
+        }
+    }
+    if (0 == allowedCount) {
+        EMBENET_RADIO_SetChannelMap(NULL);
+        return;
+    }
+
+    EMBENET_CRITICAL_SECTION_Enter();
+    size_t next = 0;
+    for (size_t channel = 0; channel != BAND_CHANNEL_COUNT; ++channel) {
+        if ((next != allowedCount) && (channel == allowedChannels[next])) {
+            channelRemap[channel] = (EMBENET_RADIO_Channel)channel;
+            ++next;
+        } else {
+            // excluded channels are spread over the allowed ones, so that no single channel takes over all the traffic
+            channelRemap[channel] = allowedChannels[channel % allowedCount];
+        }
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+
+EMBENET_RADIO_Channel EMBENET_RADIO_MapChannel(EMBENET_RADIO_Channel channel) {
+    return (channel < BAND_CHANNEL_COUNT) ? channelRemap[channel] : channel;
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_SetLinkTxPower(uint64_t eui, EMBENET_RADIO_Power txp) {
+    if (0 == eui) {
+        return EMBENET_RADIO_STATUS_PARAMETER_ARG1_OUT_OF_BOUNDS;
+    }
+    LinkTxPower* entry     = NULL;
+    LinkTxPower* freeEntry = NULL;
+    for (size_t i = 0; i != LINK_TXP_COUNT; ++i) {
+        if (eui == linkTxPowers[i].eui) {
+            entry = &linkTxPowers[i];
+        } else if ((NULL == freeEntry) && (0 == linkTxPowers[i].eui)) {
+            freeEntry = &linkTxPowers[i];
+        }
+    }
+
+    EMBENET_RADIO_Status status = EMBENET_RADIO_STATUS_SUCCESS;
+    EMBENET_CRITICAL_SECTION_Enter();
+    if (EMBENET_RADIO_LINK_TXP_DEFAULT == txp) {
+        if (NULL != entry) {
+            entry->eui = 0;
+        }
+    } else if ((NULL != entry) || (NULL != freeEntry)) {
+        entry      = (NULL != entry) ? entry : freeEntry;
+        entry->txp = (txp > MAX_OUTPUT_POWER) ? MAX_OUTPUT_POWER : ((txp < MIN_OUTPUT_POWER) ? MIN_OUTPUT_POWER : txp);
+        entry->eui = eui;
+    } else {
+        status = EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS;
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+    return status;
+}
+
+
+bool EMBENET_RADIO_GetLinkPathLoss(uint64_t eui, int16_t* pathLoss) {
+    bool found = false;
+    EMBENET_CRITICAL_SECTION_Enter();
+    for (size_t i = 0; (i != LINK_TXP_COUNT) && !found; ++i) {
+        if ((0 != eui) && (eui == linkPathLosses[i].eui)) {
+            *pathLoss = (int16_t)(linkPathLosses[i].pathLoss / 16);
+            found     = true;
+        }
+    }
+    EMBENET_CRITICAL_SECTION_Exit();
+    return found;
+}
+
+
+void EMBENET_RADIO_GetCounters(EMBENET_RADIO_Counters* radioCounters) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    *radioCounters = counters;
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+
+void EMBENET_RADIO_ResetCounters(void) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    counters = (EMBENET_RADIO_Counters){0};
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+
 EMBENET_RADIO_Capabilities const* EMBENET_RADIO_GetCapabilities(void) {
-    static EMBENET_RADIO_Capabilities timings = {.idleToTxReady   = 30,       //< TxEnable does a couple of calculations and sets pointers
-                                                 .idleToRxReady   = 30,       //< RxEnable does a couple of calculations and sets pointers
-                                                 .activeToTxReady = 30,       //< TxEnable does a couple of calculations and sets pointers
-                                                 .activeToRxReady = 30,       //< RxEnable does a couple of calculations and sets pointers
-                                                 .txDelay         = TX_DELAY, //< the time needed to prepare radio for transmission
-                                                 .rxDelay         = 180,      //< hard to obtain, let it be the same as for transmission
-                                                 .txRxStartDelay  = RX_START_CORRECTION,
-                                                 .sensitivity     = SENSITIVITY,
-                                                 .maxOutputPower  = MAX_OUTPUT_POWER,
-                                                 .minOutputPower  = MIN_OUTPUT_POWER};
-    return &timings;
+    return EMBENET_RADIO_GetPhyCapabilities(currentPhy);
+}
+
+
+EMBENET_RADIO_Capabilities const* EMBENET_RADIO_GetPhyCapabilities(EMBENET_RADIO_Phy phy) {
+    static EMBENET_RADIO_Capabilities timings[EMBENET_RADIO_PHY_COUNT];
+    if (phy >= EMBENET_RADIO_PHY_COUNT) {
+        return NULL;
+    }
+    // The stack does not lend TX buffers, its TxEnable still copies the PSDU and CommitTx adds the ACK power and sets channel and power,
+    // so the buffer lending leaves the TX budgets as they were until they are measured on the board
+    timings[phy] = (EMBENET_RADIO_Capabilities){.idleToTxReady   = 30,           //< TxEnable copies the PSDU, does a couple of calculations and sets pointers
+                                                .idleToRxReady   = 30,           //< RxEnable does a couple of calculations and sets pointers
+                                                .activeToTxReady = 30,           //< TxEnable copies the PSDU, does a couple of calculations and sets pointers
+                                                .activeToRxReady = 30,           //< RxEnable does a couple of calculations and sets pointers
+                                                .txDelay         = getTxDelay(), //< the time needed to prepare radio for transmission
+                                                .rxDelay         = getRxDelay(), //< the time needed to lock the synthesizer for reception
+                                                .txRxStartDelay  = getRxStartCorrection(phy),
+                                                .sensitivity     = phyProfiles[phy].sensitivity,
+                                                .maxOutputPower  = MAX_OUTPUT_POWER,
+                                                .minOutputPower  = MIN_OUTPUT_POWER};
+    return &timings[phy];
+}
+
+
+EMBENET_RADIO_Status EMBENET_RADIO_SetPhy(EMBENET_RADIO_Phy phy) {
+    if (phy >= EMBENET_RADIO_PHY_COUNT) {
+        return EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS;
+    }
+    if (!idle) {
+        return EMBENET_RADIO_STATUS_WRONG_STATE;
+    }
+    if (phy != currentPhy) {
+        setPhy(phy);
+        RF_control(rfHandle, RF_CTRL_UPDATE_SETUP_CMD, NULL); // the modified setup is used after the radio powers up again
+        if (RF_ALLOC_ERROR == RF_postCmd(rfHandle, (RF_Op*)&radioSetup, RF_PriorityHigh, NULL, 0)) {
+            return EMBENET_RADIO_STATUS_GENERAL_ERROR;
+        }
+    }
+    return EMBENET_RADIO_STATUS_SUCCESS;
+}
+
+
+EMBENET_RADIO_Phy EMBENET_RADIO_GetPhy(void) {
+    return currentPhy;
+}
+
+
+EMBENET_TimeUs EMBENET_RADIO_GetAirTime(EMBENET_RADIO_Phy phy, size_t psduLen) {
+    if (phy >= EMBENET_RADIO_PHY_COUNT) {
+        return 0;
+    }
+    return (EMBENET_TimeUs)((PREAMBLE_LENGTH + SYNCWORD_LENGTH + 1 + psduLen + CRC_LENGTH) * getByteAirTime(phy));
+}
+
+
+void EMBENET_RADIO_GetCalibration(EMBENET_RADIO_Calibration* calibration) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    *calibration = (EMBENET_RADIO_Calibration){
+        .txStartCorrection = (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&txStartEstimator, TX_START_CORRECTION),
+        .txEndCorrection   = (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&txEndEstimator, TX_END_CORRECTION),
+        .rxStartCorrection = getRxStartCorrection(currentPhy),
+        .rxDelay           = getRxDelay(),
+        .txStartDeviation  = (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetDeviation(&txStartEstimator),
+        .txEndDeviation    = (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetDeviation(&txEndEstimator),
+        .rxStartDeviation  = (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetDeviation(&rxStartEstimators[currentPhy]),
+        .calibrated        = EMBENET_RADIO_CALIBRATION_IsValid(&txStartEstimator) && EMBENET_RADIO_CALIBRATION_IsValid(&txEndEstimator)
+                      && EMBENET_RADIO_CALIBRATION_IsValid(&rxStartEstimators[currentPhy]),
+    };
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+
+void EMBENET_RADIO_ResetCalibration(void) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    EMBENET_RADIO_CALIBRATION_Reset(&txStartEstimator);
+    EMBENET_RADIO_CALIBRATION_Reset(&txEndEstimator);
+    for (size_t i = 0; i != EMBENET_RADIO_PHY_COUNT; ++i) {
+        EMBENET_RADIO_CALIBRATION_Reset(&rxStartEstimators[i]);
+    }
+    EMBENET_RADIO_CALIBRATION_Reset(&synthEstimator);
+    EMBENET_CRITICAL_SECTION_Exit();
 }
 
 
 static void rxProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e) {
-    (void)ch; // warning suppress
-    (void)h;  // warning suppress
-    if (idle) {
-        return; // do nothing if idled
+    (void)h; // warning suppress
+    if (idle || (ch != rxTransaction)) {
+        return; // do nothing if idled, or if the command was already finished or flushed, its callbacks can come after the next command was posted
     }
+    EMBENET_TIMER_SignalActivity(); // the stack handles the frame in the main loop, before the device may sleep
 
-    EMBENET_TimeUs t = EMBENET_TIMER_ReadCounter();
+    EMBENET_TimeUs now = EMBENET_TIMER_ReadCounter();
+    EMBENET_TimeUs t   = now;
     if ((e & RF_EventMdmSoft) != 0) { // RX started
+        rxStartTime     = t;
+        rxStartCaptured = true;
         if (onStartOfFrameHandler != NULL) {
-            onStartOfFrameHandler(handlersContext, t - RX_START_CORRECTION);
+            onStartOfFrameHandler(handlersContext, t - getRxStartCorrection(currentPhy));
         }
     } else if (((RF_EventRxOk | RF_EventRxNOk) & e) != 0) { // RX finished
         if ((rxChainDoRx.status == PROP_DONE_OK) || (rxChainDoRx.status == PROP_DONE_RXERR)) {
-            if ((PROP_DONE_OK == rxChainDoRx.status) && (radioRxBuffer[0] <= RX_BUFFER_LENGTH)) {
-                rxPacketLength = radioRxBuffer[0];
-                rxPacketRssi   = (int8_t)radioRxBuffer[rxPacketLength + 1];
-                memcpy(rxPacket, radioRxBuffer + 1, rxPacketLength);
+            releaseRxEntry(rxLastEntry); // the previous frame was not taken by the stack
+            rxLastEntry = NULL;
+
+            // The frame stays in place, the RF core moves on to the next entry of the circular queue
+            rfc_dataEntryPointer_t* entry = &rxEntries[rxWriteIndex];
+            if ((PROP_DONE_OK == rxChainDoRx.status) && (DATA_ENTRY_FINISHED == entry->status)) {
+                rxWriteIndex = (rxWriteIndex + 1) % RX_ENTRY_COUNT;
+                if (entry->pData[0] <= EMBENET_RADIO_MAX_PSDU_LENGTH) {
+                    rxLastEntry = entry;
+
+                    // Both ends of the frame are known from the timestamp, not affected by the callback latency
+                    size_t         length   = entry->pData[0];
+                    EMBENET_TimeUs syncTime = getRxSyncTime(entry);
+                    t                       = syncTime + (EMBENET_TimeUs)((1 + length + CRC_LENGTH) * getByteAirTime(currentPhy));
+                    if (rxStartCaptured) {
+                        calibrate(&rxStartEstimators[currentPhy], rxStartTime, syncTime - (PREAMBLE_LENGTH + SYNCWORD_LENGTH) * getByteAirTime(currentPhy));
+                    }
+                    countRxLatency((int32_t)(now - t));
+                } else {
+                    releaseRxEntry(entry);
+                    counters.rxOverflows += 1;
+                }
+            } else if (PROP_DONE_RXERR == rxChainDoRx.status) {
+                counters.rxCrcErrors += 1;
             } else {
-                rxPacketLength = 0;
-                rxPacketRssi   = 0;
+                counters.rxOverflows += 1; // no entry was free for the frame
+            }
+            rxStartCaptured = false;
+            if (autoAckEnabled && ((e & RF_EventLastCmdDone) == 0) && ((NULL == rxLastEntry) || !isAckRequested(rxLastEntry->pData + 1, rxLastEntry->pData[0]))) {
+                // The RF core acknowledges every frame with valid CRC, so the ACK is cancelled before its delay expires. The ACK went out
+                // anyway if the RF core already started it, or if the callback came so late that the flush ended after the trigger.
+                bool started = (IDLE != rxChainDoAck.status) && (PENDING != rxChainDoAck.status);
+                RF_flushCmd(rfHandle, rxTransaction, 0);
+                rxTransaction = RF_ALLOC_ERROR; // the callback of the flushed command is ignored
+                if (started || ((int32_t)(EMBENET_TIMER_ReadCounter() - t) >= (int32_t)autoAckDelay)) {
+                    counters.ackFlushMisses += 1;
+                }
+            } else if (!autoAckEnabled || ((e & RF_EventLastCmdDone) != 0)) {
+                rxTransaction = RF_ALLOC_ERROR; // Clear current op handle, unless the ACK is still to be sent
             }
-            rxItem.status = DATA_ENTRY_PENDING;
-            rxTransaction = RF_ALLOC_ERROR; // Clear current op handle
             if (onEndOfFrameHandler != NULL) {
-                onEndOfFrameHandler(handlersContext, t);
+                onEndOfFrameHandler(handlersContext, t); // ACK fields can be patched here, before the ACK delay expires
             }
         }
+    } else if ((e & RF_EventLastCmdDone) != 0) { // Automatic ACK sent, or listening window closed without a frame
+        rxTransaction = RF_ALLOC_ERROR; // Clear current op handle, the receiver is already off
+        if (PROP_DONE_RXTIMEOUT == rxChainDoRx.status) {
+            counters.rxSyncMisses += 1;
+        } else if ((PROP_ERROR_RXBUF == rxChainDoRx.status) || (PROP_ERROR_RXFULL == rxChainDoRx.status)) {
+            counters.rxOverflows += 1;
+        }
     } else { // Transaction error
-        rxItem.status = DATA_ENTRY_PENDING;
         rxTransaction = RF_ALLOC_ERROR; // Clear current op handle
+        counters.rxErrors += 1;
     }
 }
 
 static void txProcessCb(RF_Handle h, RF_CmdHandle ch, RF_EventMask e) {
-    (void)h;  // warning suppress
-    (void)ch; // warning suppress
-    if (idle) {
-        return; // do nothing if idled
+    (void)h; // warning suppress
+    if (idle || (ch != txTransaction)) {
+        return; // do nothing if idled, or if the command was already finished or flushed
     }
+    EMBENET_TIMER_SignalActivity();
     EMBENET_TimeUs t = EMBENET_TIMER_ReadCounter();
 
     if ((e & RF_EventLastCmdDone) != 0) { // End of transmission
         txTransaction = RF_ALLOC_ERROR;
+        setTxBuffersState(TX_BUFFER_SENDING, TX_BUFFER_FREE);
         if ((PROP_DONE_OK == txChainDoTx.status) || (DONE_OK == txChainDoTx.status)) {
+            // A frame started on schedule ends exactly its air time later, the end of other frames is estimated from the callback
+            EMBENET_TimeUs end = txTriggerTime + getTxDelay() + EMBENET_RADIO_GetAirTime(currentPhy, txChainDoTx.pktLen);
+            if (txOnSchedule) {
+                calibrate(&txEndEstimator, end, t);
+            } else {
+                end = t + (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&txEndEstimator, TX_END_CORRECTION);
+            }
             if (onEndOfFrameHandler != NULL) {
-                onEndOfFrameHandler(handlersContext, t + TX_END_CORRECTION);
+                onEndOfFrameHandler(handlersContext, end);
             }
+            counters.txFrames += 1;
+        } else if (ccaEnabled && (PROP_DONE_BUSY == txChainCs.status)) {
+            counters.txCcaBusy += 1;
+        } else {
+            counters.txAborts += 1;
         }
     } else if (e & RF_EventCmdDone) { // synthesizer set and probably running, packet TX will start soon
-        if ((e & RF_EventCmdDone) != 0) {
+        if (ccaEnabled && (PROP_DONE_IDLETIMEOUT != txChainCs.status)) {
+            return; // packet TX will start only after the channel is found clear
+        }
+        if (!txStartReported) {
+            txStartReported = true;
+            // A callback before the scheduled start proves that the synthesizer was locked in time, as the callback only comes later than the lock
+            EMBENET_TimeUs start = txTriggerTime + getTxDelay();
+            txOnSchedule         = txScheduled && ((int32_t)(start - t) >= 0);
+            if (txOnSchedule) {
+                calibrate(&txStartEstimator, start, t);
+                calibrate(&synthEstimator, t - (ccaEnabled ? CCA_DURATION : 0), txTriggerTime);
+            } else {
+                start = t + (EMBENET_TimeUs)EMBENET_RADIO_CALIBRATION_GetMean(&txStartEstimator, TX_START_CORRECTION);
+            }
             if (onStartOfFrameHandler != NULL) {
-                onStartOfFrameHandler(handlersContext, EMBENET_TIMER_ReadCounter() + TX_START_CORRECTION);
+                onStartOfFrameHandler(handlersContext, start);
             }
         }
     } else { // Transaction error
         txTransaction = RF_ALLOC_ERROR;
+        setTxBuffersState(TX_BUFFER_SENDING, TX_BUFFER_FREE);
+        counters.txAborts += 1;
     }
 }
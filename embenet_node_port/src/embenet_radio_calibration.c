@@ -0,0 +1,77 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Statistical estimator of radio delays used by runtime timing calibration
+*/
+
+#include "embenet_radio_calibration.h"
+
+
+/**
+ * @brief Calculates integer square root
+ * @param[in] value value to calculate root of
+ * @return square root rounded down
+ */
+static uint32_t squareRoot(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t bit  = (uint64_t)1 << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+
+void EMBENET_RADIO_CALIBRATION_Reset(EMBENET_RADIO_CALIBRATION_Estimator* estimator) {
+    *estimator = (EMBENET_RADIO_CALIBRATION_Estimator){.count = 0, .sum = 0, .sumSq = 0};
+}
+
+
+void EMBENET_RADIO_CALIBRATION_AddSample(EMBENET_RADIO_CALIBRATION_Estimator* estimator, int32_t sample) {
+    if (EMBENET_RADIO_CALIBRATION_WINDOW == estimator->count) {
+        estimator->count /= 2;
+        estimator->sum /= 2;
+        estimator->sumSq /= 2;
+    }
+    estimator->count += 1;
+    estimator->sum += sample;
+    estimator->sumSq += (int64_t)sample * sample;
+}
+
+
+bool EMBENET_RADIO_CALIBRATION_IsValid(EMBENET_RADIO_CALIBRATION_Estimator const* estimator) {
+    return estimator->count >= EMBENET_RADIO_CALIBRATION_MIN_SAMPLES;
+}
+
+
+int32_t EMBENET_RADIO_CALIBRATION_GetMean(EMBENET_RADIO_CALIBRATION_Estimator const* estimator, int32_t fallback) {
+    if (!EMBENET_RADIO_CALIBRATION_IsValid(estimator)) {
+        return fallback;
+    }
+    int64_t halfCount = estimator->count / 2;
+    int64_t sum       = estimator->sum;
+    return (int32_t)((sum >= 0) ? ((sum + halfCount) / estimator->count) : ((sum - halfCount) / estimator->count));
+}
+
+
+uint32_t EMBENET_RADIO_CALIBRATION_GetDeviation(EMBENET_RADIO_CALIBRATION_Estimator const* estimator) {
+    if (!EMBENET_RADIO_CALIBRATION_IsValid(estimator)) {
+        return 0;
+    }
+    // n * sum(x^2) - sum(x)^2 is n^2 times the variance, halving keeps it non-negative up to rounding
+    int64_t n      = estimator->count;
+    int64_t scaled = n * estimator->sumSq - estimator->sum * estimator->sum;
+    return (scaled > 0) ? squareRoot((uint64_t)scaled) / estimator->count : 0;
+}
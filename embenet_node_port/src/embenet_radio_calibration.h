@@ -0,0 +1,81 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Statistical estimator of radio delays used by runtime timing calibration
+*/
+
+#ifndef EMBENET_RADIO_CALIBRATION_H_
+#define EMBENET_RADIO_CALIBRATION_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Number of samples after which the estimate is considered valid
+#define EMBENET_RADIO_CALIBRATION_MIN_SAMPLES 16u
+/// Number of samples after which the accumulated statistics are halved, so that the estimate follows slow drift
+#define EMBENET_RADIO_CALIBRATION_WINDOW 64u
+
+/**
+ * @brief Running estimate of a single delay.
+ *
+ * Samples are accumulated over a window. Once the window is full, the accumulators are halved, so older samples
+ * gradually lose weight. The estimator has no hardware dependencies.
+ */
+typedef struct {
+    uint32_t count; ///< Weight of accumulated samples
+    int64_t  sum;   ///< Sum of samples
+    int64_t  sumSq; ///< Sum of squared samples
+} EMBENET_RADIO_CALIBRATION_Estimator;
+
+
+/**
+ * @brief Clears all samples
+ * @param[out] estimator estimator to clear
+ */
+void EMBENET_RADIO_CALIBRATION_Reset(EMBENET_RADIO_CALIBRATION_Estimator* estimator);
+
+
+/**
+ * @brief Adds measured delay
+ * @param[in, out] estimator estimator to update
+ * @param[in] sample measured delay in us
+ */
+void EMBENET_RADIO_CALIBRATION_AddSample(EMBENET_RADIO_CALIBRATION_Estimator* estimator, int32_t sample);
+
+
+/**
+ * @brief Checks whether enough samples were collected to use the estimate
+ * @param[in] estimator estimator to check
+ * @return true if at least EMBENET_RADIO_CALIBRATION_MIN_SAMPLES samples were collected
+ */
+bool EMBENET_RADIO_CALIBRATION_IsValid(EMBENET_RADIO_CALIBRATION_Estimator const* estimator);
+
+
+/**
+ * @brief Gets mean of collected samples
+ * @param[in] estimator estimator to read
+ * @param[in] fallback value returned if the estimate is not valid
+ * @return mean delay in us, rounded to nearest
+ */
+int32_t EMBENET_RADIO_CALIBRATION_GetMean(EMBENET_RADIO_CALIBRATION_Estimator const* estimator, int32_t fallback);
+
+
+/**
+ * @brief Gets standard deviation of collected samples
+ * @param[in] estimator estimator to read
+ * @return standard deviation in us, rounded down, 0 if the estimate is not valid
+ */
+uint32_t EMBENET_RADIO_CALIBRATION_GetDeviation(EMBENET_RADIO_CALIBRATION_Estimator const* estimator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_RADIO_CALIBRATION_H_ included
@@ -7,38 +7,134 @@
 @brief     Implementation of Timer interface for the embeNET Node
 */
 
-#include "embenet_timer.h"
+#include "embenet_timer_cc1312.h"
 
+#include "embenet_critical_section.h"
+#include "embenet_timer_sleep.h"
+#include "embenet_timer_timebase.h"
+#include "embenet_timer_wheel.h"
 
 // clang-format off
 #include <ti_drivers_config.h>
+#include <ti/drivers/Power.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+#include <ti/drivers/dpl/ClockP.h>
 #include <ti/drivers/timer/GPTimerCC26XX.h>
 #include <ti/devices/DeviceFamily.h>
+#include DeviceFamily_constructPath(driverlib/aon_rtc.h)
 #include DeviceFamily_constructPath(driverlib/prcm.h)
 // clang-format on
 
+#include <string.h>
+
+#ifndef EMBENET_TIMER_LATENCY_STATS
+#    define EMBENET_TIMER_LATENCY_STATS 0 ///< Set to 1 to collect statistics of compare event delays, see EMBENET_TIMER_GetLatencyStats
+#endif
+
 typedef struct {
     EMBENET_TIMER_CompareCallback callback;
     void*                         context;
     GPTimerCC26XX_Handle          hTimer;
+    uint64_t                      compareTime;  ///< Time of the compare requested by the stack in us
+    bool                          compareArmed; ///< true if the stack waits for the compare
+    bool                          inInterrupt;  ///< true while the interrupt is handled, the hardware compare is then set once at its end
 } EMBENET_TIMER_Descriptor;
 
 static EMBENET_TIMER_Descriptor embenetTimerDescriptor;
+static EMBENET_TIMER_WHEEL_Wheel embenetTimerWheel;
+
+/// State of the handoff to the RTC during standby
+typedef struct {
+    ClockP_Struct                        wakeClock;  ///< Clock that wakes the device up, ClockP runs from the RTC
+    bool                                 activity;   ///< true if an interrupt left work for the main loop since the last attempt to sleep
+    bool                                 handedOver; ///< true while the timer is stopped and the RTC keeps time
+    uint64_t                             syncRtc;    ///< RTC value at the last synchronization of the timer with the RTC
+    uint64_t                             syncTicks;  ///< Timer ticks since initialization at the last synchronization
+    uint64_t                             wakeTime;   ///< Planned time of the wake-up in us, valid while handedOver
+    EMBENET_TIMER_SLEEP_DriftEstimator   drift;      ///< Rate of the RTC against the timer
+    EMBENET_TIMER_SLEEP_LatencyEstimator latency;    ///< Time needed to wake up
+} EMBENET_TIMER_SleepState;
+
+static EMBENET_TIMER_SleepState embenetTimerSleep;
+
+#if EMBENET_TIMER_LATENCY_STATS
+static EMBENET_TIMER_LatencyStats embenetTimerLatencyStats;
+
+// Adds the delay of a compare event to the histogram, delay <= 0 means on time
+static void EMBENET_TIMER_RecordLatency(int64_t delay) {
+    unsigned bucket = 0;
+    if (delay > 0) {
+        EMBENET_TimeUs latency = (delay > UINT32_MAX) ? UINT32_MAX : (EMBENET_TimeUs)delay;
+        bucket                 = (unsigned)(32 - __builtin_clz(latency));
+        if (bucket >= EMBENET_TIMER_LATENCY_BUCKETS) {
+            bucket = EMBENET_TIMER_LATENCY_BUCKETS - 1;
+        }
+        if (latency > embenetTimerLatencyStats.maxLatency) {
+            embenetTimerLatencyStats.maxLatency = latency;
+        }
+    }
+    embenetTimerLatencyStats.histogram[bucket]++;
+    embenetTimerLatencyStats.events++;
+}
+#endif
 
 enum {
     EMBENET_TIMER_MAX_COMPARE_DURATION   = 0x7FFFFFFF,
     EMBENET_TIMER_EVENT_GUARD_TIME_TICKS = 40, // Equivalent of 30us. Minimal duration between current time and scheduled event. If the
                                                // duration is smaller, the event handling routine will be triggered immediately.
+    EMBENET_TIMER_EVENT_GUARD_TIME_US    = 54, // EMBENET_TIMER_EVENT_GUARD_TIME_TICKS rounded up to us
+    EMBENET_TIMER_MAX_SOFT_TIMER_WAIT_US = 0x40000000, // Software timers further in the future are served in steps, as the compare reaches only 2^31 ticks ahead
+    EMBENET_TIMER_SLEEP_MIN_US           = 2000, // Shortest standby worth the synchronization with the RTC
+    EMBENET_TIMER_SLEEP_WAKE_LATENCY_US  = 1000, // Initial estimate of the wake-up latency, refined with every wake-up
+    EMBENET_TIMER_SLEEP_WAKE_MARGIN_US   = 100,  // Extra time between the wake-up and the next event
 };
 
-// Converts ticks to microseconds
-static inline uint32_t EMBENET_TIMER_TicksToUs(uint32_t ticks) {
-    return (uint32_t)((uint64_t)ticks * 4 / 3);
+static EMBENET_TIMER_TIMEBASE_Timebase embenetTimerTimebase;
+
+static void EMBENET_TIMER_TakeOverFromRtc(void);
+
+// Reads the hardware counter and returns time in us since initialization, optionally together with the counter value.
+// Must be called at least once per hardware period (~95 minutes), which is guaranteed by the timeout interrupt.
+static uint64_t EMBENET_TIMER_ReadTime(uint32_t* ticks) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    if (embenetTimerSleep.handedOver) {
+        // an interrupt handled before the device entered standby or right after it woke up needs the timer running
+        EMBENET_TIMER_TakeOverFromRtc();
+    }
+    uint32_t hwTicks = GPTimerCC26XX_getFreeRunValue(embenetTimerDescriptor.hTimer);
+    uint64_t time    = EMBENET_TIMER_TIMEBASE_Update(&embenetTimerTimebase, hwTicks);
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    if (NULL != ticks) {
+        *ticks = hwTicks;
+    }
+    return time;
+}
+
+// Makes the given hardware counter value correspond to the given number of ticks since initialization.
+// The time is kept in ticks, as the conversion to us truncates and any error would add up over sleeps.
+static void EMBENET_TIMER_SetTicks(uint64_t ticks, uint32_t hwTicks) {
+    EMBENET_TIMER_TIMEBASE_SetTicks(&embenetTimerTimebase, ticks, hwTicks);
+}
+
+// Waits for the next tick of the RTC and reads the timer right after it, so that both clocks are read at the same instant.
+// Returns the timer ticks since initialization, which are only valid while the timer runs uninterrupted.
+static uint64_t EMBENET_TIMER_SyncToRtc(uint64_t* rtc, uint32_t* ticks) {
+    uint64_t previous = AONRTCCurrent64BitValueGet();
+    do {
+        *rtc = AONRTCCurrent64BitValueGet();
+    } while (*rtc == previous);
+    uint32_t hwTicks;
+    (void)EMBENET_TIMER_ReadTime(&hwTicks);
+    if (NULL != ticks) {
+        *ticks = hwTicks;
+    }
+    return EMBENET_TIMER_TIMEBASE_GetTicks(&embenetTimerTimebase, hwTicks);
 }
 
-// Converts microseconds to ticks
-static inline uint32_t EMBENET_TIMER_UsToTicks(uint32_t time) {
-    return (uint32_t)((uint64_t)time * 3 / 4);
+// Wake-up clock callback, the wake-up itself is all that is needed
+static void EMBENET_TIMER_WakeClockCallback(uintptr_t arg) {
+    (void)arg;
 }
 
 void EMBENET_TIMER_ISR_Handler(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask interruptMask);
@@ -47,7 +143,16 @@ void EMBENET_TIMER_Init(EMBENET_TIMER_CompareCallback compareCallback, void* con
     EMBENET_TIMER_Deinit();
 
 
-    embenetTimerDescriptor = (EMBENET_TIMER_Descriptor){.callback = compareCallback, .context = context};
+    embenetTimerDescriptor = (EMBENET_TIMER_Descriptor){.callback = compareCallback, .context = context, .compareArmed = false, .inInterrupt = false};
+
+    ClockP_Params clockParams;
+    ClockP_Params_init(&clockParams);
+    clockParams.startFlag = false;
+    clockParams.period    = 0;
+    ClockP_construct(&embenetTimerSleep.wakeClock, EMBENET_TIMER_WakeClockCallback, 1, &clockParams);
+    embenetTimerSleep.activity = false;
+    EMBENET_TIMER_SLEEP_ResetDrift(&embenetTimerSleep.drift);
+    EMBENET_TIMER_SLEEP_ResetLatency(&embenetTimerSleep.latency, EMBENET_TIMER_SLEEP_WAKE_LATENCY_US);
 
     PRCMGPTimerClockDivisionSet(PRCM_CLOCK_DIV_64); // 48MHz clock gives 1,(3)us per tick, so 3 ticks equals 4us
 
@@ -65,12 +170,16 @@ void EMBENET_TIMER_Init(EMBENET_TIMER_CompareCallback compareCallback, void* con
         while (1)
             ;
     }
-    // timer will shorten the duration by 0,33us on every ~72 minutes
-    GPTimerCC26XX_setLoadValue(embenetTimerDescriptor.hTimer, 3221225471 /* (2^32-1)*3/4=3221225471,25 */);
-    GPTimerCC26XX_registerInterrupt(embenetTimerDescriptor.hTimer, EMBENET_TIMER_ISR_Handler, 0);
+    // The counter runs through the whole 32-bit range, wraps are accounted for by EMBENET_TIMER_ReadTime
+    EMBENET_TIMER_TIMEBASE_Init(&embenetTimerTimebase);
+    EMBENET_TIMER_WHEEL_Init(&embenetTimerWheel, 0);
+    GPTimerCC26XX_setLoadValue(embenetTimerDescriptor.hTimer, UINT32_MAX);
+    GPTimerCC26XX_registerInterrupt(embenetTimerDescriptor.hTimer, EMBENET_TIMER_ISR_Handler, GPT_INT_TIMEOUT);
 
     // Start the timer
     GPTimerCC26XX_start(embenetTimerDescriptor.hTimer);
+    // The first interval for measurement of the RTC drift starts now
+    embenetTimerSleep.syncTicks = EMBENET_TIMER_SyncToRtc(&embenetTimerSleep.syncRtc, NULL);
 }
 
 void EMBENET_TIMER_Deinit(void) {
@@ -78,14 +187,42 @@ void EMBENET_TIMER_Deinit(void) {
         GPTimerCC26XX_stop(embenetTimerDescriptor.hTimer);
         GPTimerCC26XX_unregisterInterrupt(embenetTimerDescriptor.hTimer);
         GPTimerCC26XX_close(embenetTimerDescriptor.hTimer);
+        ClockP_destruct(&embenetTimerSleep.wakeClock);
         embenetTimerDescriptor.hTimer = NULL;
     }
 }
 
-void EMBENET_TIMER_SetCompare(EMBENET_TimeUs compareValue) {
-    EMBENET_TimeUs currentValue = GPTimerCC26XX_getFreeRunValue(embenetTimerDescriptor.hTimer);
-    // All time manipulations are valid only on us
-    compareValue = EMBENET_TIMER_UsToTicks(compareValue);
+// Gets the earlier of the stack compare and the next event of software timers, returns false if there is none
+static bool EMBENET_TIMER_GetNextEvent(uint64_t currentTime, uint64_t* time) {
+    *time      = embenetTimerDescriptor.compareTime;
+    bool armed = embenetTimerDescriptor.compareArmed;
+    uint64_t wheelTime;
+    if (EMBENET_TIMER_WHEEL_GetNextEvent(&embenetTimerWheel, &wheelTime)) {
+        if (wheelTime > currentTime + EMBENET_TIMER_MAX_SOFT_TIMER_WAIT_US) {
+            wheelTime = currentTime + EMBENET_TIMER_MAX_SOFT_TIMER_WAIT_US;
+        }
+        if (!armed || (wheelTime < *time)) {
+            *time = wheelTime;
+            armed = true;
+        }
+    }
+    return armed;
+}
+
+// Sets the hardware compare to the earlier of the stack compare and the next event of software timers.
+// Must be called in a critical section.
+static void EMBENET_TIMER_ScheduleCompare(void) {
+    if ((NULL == embenetTimerDescriptor.hTimer) || embenetTimerDescriptor.inInterrupt) {
+        return;
+    }
+    uint32_t currentValue;
+    uint64_t currentTime = EMBENET_TIMER_ReadTime(&currentValue);
+    uint64_t compareTime;
+    if (!EMBENET_TIMER_GetNextEvent(currentTime, &compareTime)) {
+        GPTimerCC26XX_disableInterrupt(embenetTimerDescriptor.hTimer, GPT_INT_MATCH);
+        return;
+    }
+    uint32_t compareValue = EMBENET_TIMER_TIMEBASE_GetCounterValue(&embenetTimerTimebase, compareTime);
 
     // Check whether the next compare value is really near current value. If so,
     // forcefully trigger interrupt at once
@@ -94,11 +231,28 @@ void EMBENET_TIMER_SetCompare(EMBENET_TimeUs compareValue) {
         GPTimerCC26XX_setMatchValue(embenetTimerDescriptor.hTimer, compareValue);
     } else {
         IntPendSet(embenetTimerDescriptor.hTimer->hwAttrs->intNum); // Yup. this is kinda awfull, however now we can use whatever timer we like (or configure externally)
+#if EMBENET_TIMER_LATENCY_STATS
+        embenetTimerLatencyStats.forcedPends++;
+#endif
     }
 }
 
+void EMBENET_TIMER_SetCompare(EMBENET_TimeUs compareValue) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    uint64_t currentTime = EMBENET_TIMER_ReadTime(NULL);
+    // The compare value is within +-2^31 us from now
+    embenetTimerDescriptor.compareTime  = currentTime + (int32_t)(compareValue - (EMBENET_TimeUs)currentTime);
+    embenetTimerDescriptor.compareArmed = true;
+    EMBENET_TIMER_ScheduleCompare();
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
 EMBENET_TimeUs EMBENET_TIMER_ReadCounter(void) {
-    return EMBENET_TIMER_TicksToUs(GPTimerCC26XX_getFreeRunValue(embenetTimerDescriptor.hTimer));
+    return (EMBENET_TimeUs)EMBENET_TIMER_ReadTime(NULL);
+}
+
+uint64_t EMBENET_TIMER_ReadCounter64(void) {
+    return EMBENET_TIMER_ReadTime(NULL);
 }
 
 EMBENET_TimeUs EMBENET_TIMER_GetMaxCompareDuration(void) {
@@ -106,9 +260,183 @@ EMBENET_TimeUs EMBENET_TIMER_GetMaxCompareDuration(void) {
 }
 
 void EMBENET_TIMER_ISR_Handler(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask interruptMask) {
+    if (0 != (interruptMask & GPT_INT_TIMEOUT)) {
+        EMBENET_CRITICAL_SECTION_Enter();
+        // A timeout left pending by a timer stopped for standby is stale, the time is taken over from the RTC instead
+        if (!embenetTimerSleep.handedOver) {
+            // the wrap is counted even if nobody read the counter during the whole period
+            EMBENET_TIMER_TIMEBASE_OnTimeout(&embenetTimerTimebase, GPTimerCC26XX_getFreeRunValue(handle));
+        }
+        EMBENET_CRITICAL_SECTION_Exit();
+    }
+    uint64_t now = EMBENET_TIMER_ReadTime(NULL);
+    if (GPT_INT_TIMEOUT == interruptMask) {
+        return;
+    }
     GPTimerCC26XX_disableInterrupt(handle, GPT_INT_MATCH);
+    embenetTimerDescriptor.inInterrupt = true;
+    embenetTimerSleep.activity         = true;
 
-    if (embenetTimerDescriptor.callback != NULL) {
-        embenetTimerDescriptor.callback(embenetTimerDescriptor.context);
+    // The stack takes precedence over software timers. The interrupt comes early when the compare was closer than the guard time
+    // to be set in hardware, or when it was set for a software timer just before the compare, so the rest is waited out here.
+    if (embenetTimerDescriptor.compareArmed && ((int64_t)(embenetTimerDescriptor.compareTime - now) < EMBENET_TIMER_EVENT_GUARD_TIME_US)) {
+        while ((int64_t)(embenetTimerDescriptor.compareTime - now) > 0) {
+            now = EMBENET_TIMER_ReadTime(NULL);
+        }
+        embenetTimerDescriptor.compareArmed = false;
+#if EMBENET_TIMER_LATENCY_STATS
+        EMBENET_TIMER_RecordLatency((int64_t)(now - embenetTimerDescriptor.compareTime));
+#endif
+        if (embenetTimerDescriptor.callback != NULL) {
+            embenetTimerDescriptor.callback(embenetTimerDescriptor.context);
+        }
     }
+    EMBENET_TIMER_WHEEL_Advance(&embenetTimerWheel, EMBENET_TIMER_ReadTime(NULL));
+
+    embenetTimerDescriptor.inInterrupt = false;
+    EMBENET_TIMER_ScheduleCompare();
+}
+
+void EMBENET_TIMER_SoftTimerInit(EMBENET_TIMER_SoftTimer* timer, EMBENET_TIMER_SoftTimerCallback callback, void* context) {
+    EMBENET_TIMER_WHEEL_InitTimer(timer);
+    timer->callback = callback;
+    timer->context  = context;
+}
+
+void EMBENET_TIMER_SoftTimerStart(EMBENET_TIMER_SoftTimer* timer, uint64_t expiry, uint32_t period) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    EMBENET_TIMER_WHEEL_Remove(&embenetTimerWheel, timer);
+    timer->expiry = expiry;
+    timer->period = period;
+    EMBENET_TIMER_WHEEL_Insert(&embenetTimerWheel, timer);
+    EMBENET_TIMER_ScheduleCompare();
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+void EMBENET_TIMER_SoftTimerStop(EMBENET_TIMER_SoftTimer* timer) {
+    EMBENET_CRITICAL_SECTION_Enter();
+    EMBENET_TIMER_WHEEL_Remove(&embenetTimerWheel, timer);
+    // The hardware compare is left as it is, an interrupt without expired timers does no harm
+    EMBENET_CRITICAL_SECTION_Exit();
+}
+
+bool EMBENET_TIMER_SoftTimerIsRunning(EMBENET_TIMER_SoftTimer const* timer) {
+    return EMBENET_TIMER_WHEEL_IsRunning(timer);
+}
+
+// Restarts the timer after standby and sets it to the time kept by the RTC. Must be called in a critical section.
+static void EMBENET_TIMER_TakeOverFromRtc(void) {
+    if (!embenetTimerSleep.handedOver) {
+        return;
+    }
+    embenetTimerSleep.handedOver = false;
+
+    // The driver restores the configuration of the timer after standby
+    ClockP_stop(ClockP_handle(&embenetTimerSleep.wakeClock));
+    GPTimerCC26XX_setLoadValue(embenetTimerDescriptor.hTimer, UINT32_MAX);
+    GPTimerCC26XX_enableInterrupt(embenetTimerDescriptor.hTimer, GPT_INT_TIMEOUT);
+    GPTimerCC26XX_start(embenetTimerDescriptor.hTimer);
+    uint64_t rtcEnd;
+    uint32_t hwTicksEnd;
+    (void)EMBENET_TIMER_SyncToRtc(&rtcEnd, &hwTicksEnd);
+    uint64_t ticksEnd = embenetTimerSleep.syncTicks
+                        + EMBENET_TIMER_SLEEP_Compensate(&embenetTimerSleep.drift, EMBENET_TIMER_SLEEP_RtcToTicks(rtcEnd - embenetTimerSleep.syncRtc));
+    EMBENET_TIMER_SetTicks(ticksEnd, hwTicksEnd);
+    embenetTimerSleep.syncRtc   = rtcEnd;
+    embenetTimerSleep.syncTicks = ticksEnd;
+    uint64_t timeEnd            = EMBENET_TIMER_TIMEBASE_TicksToUs(ticksEnd);
+
+    // A wake-up by another interrupt before the planned time says nothing about the latency
+    if (timeEnd >= embenetTimerSleep.wakeTime) {
+        EMBENET_TIMER_SLEEP_AddLatency(&embenetTimerSleep.latency, (uint32_t)(timeEnd - embenetTimerSleep.wakeTime));
+    }
+    EMBENET_TIMER_ScheduleCompare();
+}
+
+bool EMBENET_TIMER_Sleep(void) {
+    if (NULL == embenetTimerDescriptor.hTimer) {
+        return false;
+    }
+    EMBENET_CRITICAL_SECTION_Enter();
+    if (embenetTimerSleep.activity) {
+        embenetTimerSleep.activity = false;
+        EMBENET_CRITICAL_SECTION_Exit();
+        return false;
+    }
+    uint64_t now = EMBENET_TIMER_ReadTime(NULL);
+    uint64_t next;
+    if (!EMBENET_TIMER_GetNextEvent(now, &next)) {
+        next = now + EMBENET_TIMER_MAX_SOFT_TIMER_WAIT_US;
+    }
+    uint64_t wakeLead = (uint64_t)embenetTimerSleep.latency.latency + EMBENET_TIMER_SLEEP_WAKE_MARGIN_US;
+    if (next < now + wakeLead + EMBENET_TIMER_SLEEP_MIN_US) {
+        EMBENET_CRITICAL_SECTION_Exit();
+        return false;
+    }
+    uint64_t wake = next - wakeLead;
+
+    // The running timer holds one standby constraint itself, any other one comes from a driver that needs the device awake
+    Power_releaseConstraint(PowerCC26XX_DISALLOW_STANDBY);
+    bool standbyAllowed = 0 == (Power_getConstraintMask() & (1u << PowerCC26XX_DISALLOW_STANDBY));
+    Power_setConstraint(PowerCC26XX_DISALLOW_STANDBY);
+    if (!standbyAllowed) {
+        EMBENET_CRITICAL_SECTION_Exit();
+        return false;
+    }
+
+    // Hand the time over to the RTC. The awake interval since the previous synchronization measures the RTC drift.
+    uint64_t rtcStart;
+    uint64_t ticksStart = EMBENET_TIMER_SyncToRtc(&rtcStart, NULL);
+    uint64_t timeStart  = EMBENET_TIMER_TIMEBASE_TicksToUs(ticksStart);
+    EMBENET_TIMER_SLEEP_AddInterval(&embenetTimerSleep.drift, EMBENET_TIMER_SLEEP_RtcToUs(rtcStart - embenetTimerSleep.syncRtc),
+                                    timeStart - EMBENET_TIMER_TIMEBASE_TicksToUs(embenetTimerSleep.syncTicks));
+    embenetTimerSleep.syncRtc   = rtcStart;
+    embenetTimerSleep.syncTicks = ticksStart;
+    embenetTimerSleep.wakeTime  = wake;
+    ClockP_setTimeout(ClockP_handle(&embenetTimerSleep.wakeClock), (uint32_t)((wake - timeStart) / ClockP_getSystemTickPeriod()));
+    ClockP_start(ClockP_handle(&embenetTimerSleep.wakeClock));
+    GPTimerCC26XX_disableInterrupt(embenetTimerDescriptor.hTimer, GPT_INT_MATCH);
+    GPTimerCC26XX_stop(embenetTimerDescriptor.hTimer); // releases the standby constraint of the timer
+    embenetTimerSleep.handedOver = true;
+    EMBENET_CRITICAL_SECTION_Exit();
+
+    // The power policy enters standby with interrupts disabled and leaves it on the wake-up clock or on any other interrupt, which is
+    // then handled as usual. If an interrupt handled in between already took the time over, the restarted timer disallows standby
+    // and the policy only idles until the next interrupt.
+    Power_idleFunc();
+
+    EMBENET_CRITICAL_SECTION_Enter();
+    EMBENET_TIMER_TakeOverFromRtc();
+    EMBENET_CRITICAL_SECTION_Exit();
+    return true;
+}
+
+void EMBENET_TIMER_SignalActivity(void) {
+    embenetTimerSleep.activity = true;
+}
+
+EMBENET_TimeUs EMBENET_TIMER_GetWakeLatency(void) {
+    return embenetTimerSleep.latency.latency;
+}
+
+int32_t EMBENET_TIMER_GetRtcDrift(void) {
+    return EMBENET_TIMER_SLEEP_GetDrift(&embenetTimerSleep.drift);
+}
+
+void EMBENET_TIMER_GetLatencyStats(EMBENET_TIMER_LatencyStats* stats) {
+#if EMBENET_TIMER_LATENCY_STATS
+    EMBENET_CRITICAL_SECTION_Enter();
+    *stats = embenetTimerLatencyStats;
+    EMBENET_CRITICAL_SECTION_Exit();
+#else
+    memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void EMBENET_TIMER_ResetLatencyStats(void) {
+#if EMBENET_TIMER_LATENCY_STATS
+    EMBENET_CRITICAL_SECTION_Enter();
+    memset(&embenetTimerLatencyStats, 0, sizeof(embenetTimerLatencyStats));
+    EMBENET_CRITICAL_SECTION_Exit();
+#endif
 }
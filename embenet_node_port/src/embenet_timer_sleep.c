@@ -0,0 +1,83 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Arithmetic of the handoff between the timer and the RTC during sleep
+*/
+
+#include "embenet_timer_sleep.h"
+
+enum {
+    LATENCY_DECAY_SHIFT = 3, ///< A shorter sample moves the latency estimate by 1/8 of the difference
+};
+
+
+uint64_t EMBENET_TIMER_SLEEP_RtcToUs(uint64_t rtc) {
+    // 10^6 / 2^32 = 15625 / 2^26, seconds and fractions are converted separately to avoid overflow
+    uint64_t seconds  = rtc >> 32;
+    uint64_t fraction = rtc & UINT32_MAX;
+    return seconds * 1000000u + ((fraction * 15625u + ((uint64_t)1 << 25)) >> 26);
+}
+
+
+uint64_t EMBENET_TIMER_SLEEP_RtcToTicks(uint64_t rtc) {
+    // 750000 / 2^32 = 46875 / 2^28
+    uint64_t seconds  = rtc >> 32;
+    uint64_t fraction = rtc & UINT32_MAX;
+    return seconds * 750000u + ((fraction * 46875u + ((uint64_t)1 << 27)) >> 28);
+}
+
+
+void EMBENET_TIMER_SLEEP_ResetDrift(EMBENET_TIMER_SLEEP_DriftEstimator* estimator) {
+    *estimator = (EMBENET_TIMER_SLEEP_DriftEstimator){.rtcSum = 0, .errorSum = 0};
+}
+
+
+void EMBENET_TIMER_SLEEP_AddInterval(EMBENET_TIMER_SLEEP_DriftEstimator* estimator, uint64_t rtcUs, uint64_t timerUs) {
+    int64_t error = (int64_t)(timerUs - rtcUs);
+    if (rtcUs > EMBENET_TIMER_SLEEP_DRIFT_WINDOW_US) {
+        // much longer than the window, e.g. the node was idle but could not sleep; keep the ratio, drop the weight.
+        // Only the error is scaled, the product of the whole interval and the window overflows after a few hours
+        error = error * (int64_t)EMBENET_TIMER_SLEEP_DRIFT_WINDOW_US / (int64_t)rtcUs;
+        rtcUs = EMBENET_TIMER_SLEEP_DRIFT_WINDOW_US;
+    }
+    estimator->rtcSum += rtcUs;
+    estimator->errorSum += error;
+    if (estimator->rtcSum > EMBENET_TIMER_SLEEP_DRIFT_WINDOW_US) {
+        estimator->rtcSum /= 2;
+        estimator->errorSum /= 2;
+    }
+}
+
+
+uint64_t EMBENET_TIMER_SLEEP_Compensate(EMBENET_TIMER_SLEEP_DriftEstimator const* estimator, uint64_t rtcUs) {
+    if (estimator->rtcSum < EMBENET_TIMER_SLEEP_DRIFT_MIN_US) {
+        return rtcUs;
+    }
+    int64_t correction = (int64_t)rtcUs * estimator->errorSum / (int64_t)estimator->rtcSum;
+    return rtcUs + (uint64_t)correction;
+}
+
+
+int32_t EMBENET_TIMER_SLEEP_GetDrift(EMBENET_TIMER_SLEEP_DriftEstimator const* estimator) {
+    if (estimator->rtcSum < EMBENET_TIMER_SLEEP_DRIFT_MIN_US) {
+        return 0;
+    }
+    return (int32_t)(estimator->errorSum * 1000000000 / (int64_t)estimator->rtcSum);
+}
+
+
+void EMBENET_TIMER_SLEEP_ResetLatency(EMBENET_TIMER_SLEEP_LatencyEstimator* estimator, uint32_t latency) {
+    estimator->latency = latency;
+}
+
+
+void EMBENET_TIMER_SLEEP_AddLatency(EMBENET_TIMER_SLEEP_LatencyEstimator* estimator, uint32_t latency) {
+    if (latency >= estimator->latency) {
+        estimator->latency = latency;
+    } else {
+        estimator->latency -= (estimator->latency - latency) >> LATENCY_DECAY_SHIFT;
+    }
+}
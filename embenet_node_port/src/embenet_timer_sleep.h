@@ -0,0 +1,114 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Arithmetic of the handoff between the timer and the RTC during sleep
+*/
+
+#ifndef EMBENET_TIMER_SLEEP_H_
+#define EMBENET_TIMER_SLEEP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/// RTC time of awake intervals in us above which the accumulated drift statistics are halved, so that the estimate follows temperature
+#define EMBENET_TIMER_SLEEP_DRIFT_WINDOW_US 600000000u
+/// RTC time of awake intervals in us needed before the drift estimate is used
+#define EMBENET_TIMER_SLEEP_DRIFT_MIN_US 1000000u
+
+/**
+ * @brief Running estimate of the rate of the RTC against the timer.
+ *
+ * The timer runs from the high frequency crystal, which the radio also depends on, so it is taken as the reference. Intervals
+ * when both clocks run are measured with both of them, and sleep durations measured with the RTC are scaled by the ratio.
+ */
+typedef struct {
+    uint64_t rtcSum;   ///< Sum of intervals measured with the RTC in us
+    int64_t  errorSum; ///< Sum of the same intervals measured with the timer, minus rtcSum, in us
+} EMBENET_TIMER_SLEEP_DriftEstimator;
+
+
+/**
+ * @brief Estimate of the time from the planned wake-up until the timer runs again.
+ *
+ * Rises at once to every longer sample and decays slowly towards shorter ones, so it rarely underestimates.
+ */
+typedef struct {
+    uint32_t latency; ///< Current estimate in us
+} EMBENET_TIMER_SLEEP_LatencyEstimator;
+
+
+/**
+ * @brief Converts a difference of RTC values to us
+ * @param[in] rtc difference of RTC values in 2^-32 s units
+ * @return the difference in us, rounded to nearest
+ */
+uint64_t EMBENET_TIMER_SLEEP_RtcToUs(uint64_t rtc);
+
+
+/**
+ * @brief Converts a difference of RTC values to ticks of the timer
+ * @param[in] rtc difference of RTC values in 2^-32 s units
+ * @return the difference in ticks of 4/3 us, rounded to nearest
+ */
+uint64_t EMBENET_TIMER_SLEEP_RtcToTicks(uint64_t rtc);
+
+
+/**
+ * @brief Clears the drift estimate
+ * @param[out] estimator estimator to clear
+ */
+void EMBENET_TIMER_SLEEP_ResetDrift(EMBENET_TIMER_SLEEP_DriftEstimator* estimator);
+
+
+/**
+ * @brief Adds an interval measured with both clocks
+ * @param[in, out] estimator estimator to update
+ * @param[in] rtcUs length of the interval measured with the RTC in us
+ * @param[in] timerUs length of the interval measured with the timer in us
+ */
+void EMBENET_TIMER_SLEEP_AddInterval(EMBENET_TIMER_SLEEP_DriftEstimator* estimator, uint64_t rtcUs, uint64_t timerUs);
+
+
+/**
+ * @brief Converts a duration measured with the RTC to the time of the timer
+ * @param[in] estimator estimator to use
+ * @param[in] rtcUs duration measured with the RTC in us, or in ticks of the timer
+ * @return the duration in the same unit of the timer, equal to rtcUs until EMBENET_TIMER_SLEEP_DRIFT_MIN_US were measured
+ */
+uint64_t EMBENET_TIMER_SLEEP_Compensate(EMBENET_TIMER_SLEEP_DriftEstimator const* estimator, uint64_t rtcUs);
+
+
+/**
+ * @brief Gets the drift of the RTC
+ * @param[in] estimator estimator to read
+ * @return drift of the RTC against the timer in parts per billion, positive if the RTC runs slow, 0 if not yet known
+ */
+int32_t EMBENET_TIMER_SLEEP_GetDrift(EMBENET_TIMER_SLEEP_DriftEstimator const* estimator);
+
+
+/**
+ * @brief Sets the latency estimate
+ * @param[out] estimator estimator to initialize
+ * @param[in] latency initial estimate in us
+ */
+void EMBENET_TIMER_SLEEP_ResetLatency(EMBENET_TIMER_SLEEP_LatencyEstimator* estimator, uint32_t latency);
+
+
+/**
+ * @brief Adds measured wake-up latency
+ * @param[in, out] estimator estimator to update
+ * @param[in] latency measured latency in us
+ */
+void EMBENET_TIMER_SLEEP_AddLatency(EMBENET_TIMER_SLEEP_LatencyEstimator* estimator, uint32_t latency);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_TIMER_SLEEP_H_ included
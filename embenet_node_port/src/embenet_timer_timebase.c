@@ -0,0 +1,82 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extension of the 32-bit tick counter of the timer to a 64-bit time in us
+*/
+
+#include "embenet_timer_timebase.h"
+
+enum {
+    TICKS_PER_WRAP_DIV_3 = 1431655765, ///< 2^32 ticks of a full hardware period are 3 * 1431655765 + 1
+};
+
+
+// 2^32 ticks passed since the start of the current hardware period
+static void EMBENET_TIMER_TIMEBASE_AddWrap(EMBENET_TIMER_TIMEBASE_Timebase* timebase) {
+    uint32_t phase = timebase->wrapPhase + 1;
+    uint32_t carry = (3 == phase) ? 1 : 0;
+    timebase->wrapUs += 4 * ((uint64_t)TICKS_PER_WRAP_DIV_3 + carry);
+    timebase->wrapPhase   = phase - 3 * carry;
+    timebase->wrapCounted = true;
+}
+
+
+void EMBENET_TIMER_TIMEBASE_Init(EMBENET_TIMER_TIMEBASE_Timebase* timebase) {
+    *timebase = (EMBENET_TIMER_TIMEBASE_Timebase){.lastTicks = 0, .wrapUs = 0, .wrapPhase = 0, .wrapCounted = false};
+}
+
+
+uint64_t EMBENET_TIMER_TIMEBASE_Update(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint32_t hwTicks) {
+    if (hwTicks < timebase->lastTicks) {
+        EMBENET_TIMER_TIMEBASE_AddWrap(timebase);
+    }
+    timebase->lastTicks = hwTicks;
+
+    uint32_t quotient  = EMBENET_TIMER_TIMEBASE_DivideBy3(hwTicks);
+    uint32_t remainder = hwTicks - 3 * quotient + timebase->wrapPhase; // up to 4
+    if (remainder >= 3) {
+        quotient += 1;
+        remainder -= 3;
+    }
+    return timebase->wrapUs + 4 * (uint64_t)quotient + remainder;
+}
+
+
+void EMBENET_TIMER_TIMEBASE_OnTimeout(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint32_t hwTicks) {
+    (void)EMBENET_TIMER_TIMEBASE_Update(timebase, hwTicks);
+    if (!timebase->wrapCounted) {
+        EMBENET_TIMER_TIMEBASE_AddWrap(timebase);
+    }
+    timebase->wrapCounted = false;
+}
+
+
+void EMBENET_TIMER_TIMEBASE_SetTicks(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint64_t ticks, uint32_t hwTicks) {
+    int64_t wrapTicks = (int64_t)(ticks - hwTicks);
+    int64_t wrapCount = wrapTicks / 3;
+    int64_t wrapPhase = wrapTicks % 3;
+    if (wrapPhase < 0) {
+        wrapCount -= 1;
+        wrapPhase += 3;
+    }
+    timebase->lastTicks   = hwTicks;
+    timebase->wrapUs      = (uint64_t)(4 * wrapCount);
+    timebase->wrapPhase   = (uint32_t)wrapPhase;
+    timebase->wrapCounted = false;
+}
+
+
+uint64_t EMBENET_TIMER_TIMEBASE_GetTicks(EMBENET_TIMER_TIMEBASE_Timebase const* timebase, uint32_t hwTicks) {
+    return (uint64_t)(3 * ((int64_t)timebase->wrapUs / 4)) + timebase->wrapPhase + hwTicks;
+}
+
+
+uint32_t EMBENET_TIMER_TIMEBASE_GetCounterValue(EMBENET_TIMER_TIMEBASE_Timebase const* timebase, uint64_t time) {
+    // The time is wrapUs + floor(4 * (ticks + wrapPhase) / 3), so the first tick at which it reaches the given time is
+    // ceil(3 * (time - wrapUs) / 4) - wrapPhase.
+    int64_t sinceWrap = (int64_t)(time - timebase->wrapUs);
+    return (uint32_t)((sinceWrap * 3 + 3) >> 2) - timebase->wrapPhase;
+}
@@ -0,0 +1,117 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Extension of the 32-bit tick counter of the timer to a 64-bit time in us
+*/
+
+#ifndef EMBENET_TIMER_TIMEBASE_H_
+#define EMBENET_TIMER_TIMEBASE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Extension of the 32-bit hardware tick counter.
+ *
+ * The timer runs at 3/4 MHz, so the time in us is floor(4 * ticks / 3) of the total tick count. The total count is split into
+ * 3 * A + phase, accumulated at every wrap of the hardware counter, and the current hardware value. This keeps the conversion exact
+ * over any number of wraps, while only a 32-bit division by 3, done as a multiplication by the reciprocal, is needed per read.
+ * The timebase has no hardware dependencies.
+ */
+typedef struct {
+    uint32_t lastTicks;   ///< Hardware counter value at the previous update, a lower value means the counter wrapped
+    uint64_t wrapUs;      ///< Time in us at the start of the current hardware period, without the phase, i.e. 4 * A
+    uint32_t wrapPhase;   ///< Total ticks at the start of the current hardware period modulo 3
+    bool     wrapCounted; ///< true if a wrap was accounted for since the last timeout of the counter
+} EMBENET_TIMER_TIMEBASE_Timebase;
+
+
+/**
+ * @brief Divides by 3 with a 32x32 bit multiplication, exact for every 32-bit value
+ * @param[in] value dividend
+ * @return value / 3
+ */
+static inline uint32_t EMBENET_TIMER_TIMEBASE_DivideBy3(uint32_t value) {
+    return (uint32_t)(((uint64_t)value * UINT32_C(0xAAAAAAAB)) >> 33);
+}
+
+
+/**
+ * @brief Converts ticks since initialization to time in us, the same way as @ref EMBENET_TIMER_TIMEBASE_Update
+ * @param[in] ticks ticks of 4/3 us
+ * @return floor(4 * ticks / 3)
+ */
+static inline uint64_t EMBENET_TIMER_TIMEBASE_TicksToUs(uint64_t ticks) {
+    return 4 * (ticks / 3) + ticks % 3;
+}
+
+
+/**
+ * @brief Starts the time at 0 with the hardware counter at 0
+ * @param[out] timebase timebase to initialize
+ */
+void EMBENET_TIMER_TIMEBASE_Init(EMBENET_TIMER_TIMEBASE_Timebase* timebase);
+
+
+/**
+ * @brief Takes a new value of the hardware counter into account and converts it to time
+ *
+ * Must be called at least once per hardware period (~95 minutes), which is guaranteed by @ref EMBENET_TIMER_TIMEBASE_OnTimeout.
+ * @param[in, out] timebase timebase to update
+ * @param[in] hwTicks current value of the hardware counter
+ * @return time in us since initialization
+ */
+uint64_t EMBENET_TIMER_TIMEBASE_Update(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint32_t hwTicks);
+
+
+/**
+ * @brief Accounts for the wrap signalled by the timeout interrupt of the counter
+ *
+ * A counter that was not read during the whole period shows no lower value at the timeout than at the previous one, so the wrap is
+ * counted here unless a read already did.
+ * @param[in, out] timebase timebase to update
+ * @param[in] hwTicks current value of the hardware counter, read in the timeout interrupt
+ */
+void EMBENET_TIMER_TIMEBASE_OnTimeout(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint32_t hwTicks);
+
+
+/**
+ * @brief Makes the given hardware counter value correspond to the given number of ticks since initialization
+ *
+ * The counter restarts from an arbitrary value after standby, so the ticks at the start of the hardware period, and wrapUs, may be negative.
+ * @param[in, out] timebase timebase to set
+ * @param[in] ticks ticks since initialization
+ * @param[in] hwTicks current value of the hardware counter
+ */
+void EMBENET_TIMER_TIMEBASE_SetTicks(EMBENET_TIMER_TIMEBASE_Timebase* timebase, uint64_t ticks, uint32_t hwTicks);
+
+
+/**
+ * @brief Gets the ticks since initialization
+ * @param[in] timebase timebase, updated with hwTicks
+ * @param[in] hwTicks current value of the hardware counter
+ * @return ticks since initialization
+ */
+uint64_t EMBENET_TIMER_TIMEBASE_GetTicks(EMBENET_TIMER_TIMEBASE_Timebase const* timebase, uint32_t hwTicks);
+
+
+/**
+ * @brief Gets the hardware counter value at which the time reaches the given time
+ * @param[in] timebase timebase, updated at most 2^31 ticks before the given time
+ * @param[in] time time in us since initialization
+ * @return the first counter value at which @ref EMBENET_TIMER_TIMEBASE_Update returns at least the given time
+ */
+uint32_t EMBENET_TIMER_TIMEBASE_GetCounterValue(EMBENET_TIMER_TIMEBASE_Timebase const* timebase, uint64_t time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_TIMER_TIMEBASE_H_ included
@@ -0,0 +1,218 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Hierarchical timer wheel holding software timers
+*/
+
+#include "embenet_timer_wheel.h"
+
+#include <stddef.h>
+
+enum {
+    LEVEL_OVERFLOW = EMBENET_TIMER_WHEEL_LEVELS,     ///< Timer waits on the overflow list
+    LEVEL_DETACHED = EMBENET_TIMER_WHEEL_LEVELS + 1, ///< Timer was taken out of its slot and waits to be processed
+    LEVEL_IDLE     = UINT8_MAX,                      ///< Timer does not run
+};
+
+
+/**
+ * @brief Gets bits of time resolved by a level
+ * @param[in] time time in us
+ * @param[in] level level of the wheel
+ * @return slot of the level
+ */
+static unsigned getSlot(uint64_t time, unsigned level) {
+    return (unsigned)(time >> (level * EMBENET_TIMER_WHEEL_LEVEL_BITS)) & (EMBENET_TIMER_WHEEL_SLOTS - 1);
+}
+
+
+static void linkTimer(EMBENET_TIMER_SoftTimer** head, EMBENET_TIMER_SoftTimer* timer) {
+    timer->next = *head;
+    if (NULL != timer->next) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head        = timer;
+}
+
+
+static void unlinkTimer(EMBENET_TIMER_SoftTimer* timer) {
+    *timer->pprev = timer->next;
+    if (NULL != timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next  = NULL;
+    timer->pprev = NULL;
+}
+
+
+/**
+ * @brief Finds the earliest time at which the wheel has to process a slot
+ *
+ * Timers on a lower level always precede the timers on a higher level, so the first non-empty level holds the next event.
+ *
+ * @param[in] wheel wheel to check
+ * @param[out] time time of the event
+ * @param[out] level level holding the slot to process, LEVEL_OVERFLOW for the overflow list
+ * @return true if the wheel holds any timer
+ */
+static bool findNextEvent(EMBENET_TIMER_WHEEL_Wheel const* wheel, uint64_t* time, unsigned* level) {
+    for (unsigned l = 0; l != EMBENET_TIMER_WHEEL_LEVELS; ++l) {
+        if (0 != wheel->occupied[l]) {
+            // only slots from the current one onwards may be occupied
+            unsigned shift = l * EMBENET_TIMER_WHEEL_LEVEL_BITS;
+            uint64_t base  = (wheel->now >> shift) & ~(uint64_t)(EMBENET_TIMER_WHEEL_SLOTS - 1);
+            *time          = (base | (uint64_t)__builtin_ctzll(wheel->occupied[l])) << shift;
+            *level         = l;
+            return true;
+        }
+    }
+    if (NULL != wheel->overflow) {
+        unsigned shift = EMBENET_TIMER_WHEEL_LEVELS * EMBENET_TIMER_WHEEL_LEVEL_BITS;
+        *time          = ((wheel->now >> shift) + 1) << shift;
+        *level         = LEVEL_OVERFLOW;
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Restarts a periodic timer and invokes the callback of an expired timer
+ * @param[in, out] wheel wheel the timer expired in
+ * @param[in, out] timer expired timer, already out of the wheel
+ * @param[in] now time up to which the wheel is being advanced
+ */
+static void expireTimer(EMBENET_TIMER_WHEEL_Wheel* wheel, EMBENET_TIMER_SoftTimer* timer, uint64_t now) {
+    if (0 != timer->period) {
+        uint64_t expiry = timer->expiry + timer->period;
+        if (expiry <= now) {
+            // the wheel was advanced late, skip the periods that passed in the meantime
+            expiry += ((now - expiry) / timer->period + 1) * timer->period;
+        }
+        timer->expiry = expiry;
+        EMBENET_TIMER_WHEEL_Insert(wheel, timer);
+    }
+    if (NULL != timer->callback) {
+        timer->callback(timer, timer->context);
+    }
+}
+
+
+/**
+ * @brief Marks all timers of a list as not running
+ * @param[in, out] head first timer of the list, cleared on return
+ */
+static void dropTimers(EMBENET_TIMER_SoftTimer** head) {
+    while (NULL != *head) {
+        EMBENET_TIMER_SoftTimer* timer = *head;
+        unlinkTimer(timer);
+        timer->level = LEVEL_IDLE;
+    }
+}
+
+
+void EMBENET_TIMER_WHEEL_Init(EMBENET_TIMER_WHEEL_Wheel* wheel, uint64_t now) {
+    wheel->now = now;
+    for (unsigned l = 0; l != EMBENET_TIMER_WHEEL_LEVELS; ++l) {
+        wheel->occupied[l] = 0;
+        for (unsigned s = 0; s != EMBENET_TIMER_WHEEL_SLOTS; ++s) {
+            dropTimers(&wheel->slots[l][s]);
+        }
+    }
+    dropTimers(&wheel->overflow);
+}
+
+
+void EMBENET_TIMER_WHEEL_InitTimer(EMBENET_TIMER_SoftTimer* timer) {
+    timer->next  = NULL;
+    timer->pprev = NULL;
+    timer->level = LEVEL_IDLE;
+    timer->slot  = 0;
+}
+
+
+void EMBENET_TIMER_WHEEL_Insert(EMBENET_TIMER_WHEEL_Wheel* wheel, EMBENET_TIMER_SoftTimer* timer) {
+    if (timer->expiry < wheel->now) {
+        timer->expiry = wheel->now;
+    }
+    uint64_t diff  = timer->expiry ^ wheel->now;
+    unsigned level = (0 == diff) ? 0 : (unsigned)(63 - __builtin_clzll(diff)) / EMBENET_TIMER_WHEEL_LEVEL_BITS;
+    if (level >= EMBENET_TIMER_WHEEL_LEVELS) {
+        timer->level = LEVEL_OVERFLOW;
+        linkTimer(&wheel->overflow, timer);
+        return;
+    }
+    unsigned slot = getSlot(timer->expiry, level);
+    timer->level  = (uint8_t)level;
+    timer->slot   = (uint8_t)slot;
+    linkTimer(&wheel->slots[level][slot], timer);
+    wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+
+void EMBENET_TIMER_WHEEL_Remove(EMBENET_TIMER_WHEEL_Wheel* wheel, EMBENET_TIMER_SoftTimer* timer) {
+    if (LEVEL_IDLE == timer->level) {
+        return;
+    }
+    unlinkTimer(timer);
+    if ((timer->level < EMBENET_TIMER_WHEEL_LEVELS) && (NULL == wheel->slots[timer->level][timer->slot])) {
+        wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+    }
+    timer->level = LEVEL_IDLE;
+}
+
+
+bool EMBENET_TIMER_WHEEL_IsRunning(EMBENET_TIMER_SoftTimer const* timer) {
+    return LEVEL_IDLE != timer->level;
+}
+
+
+bool EMBENET_TIMER_WHEEL_GetNextEvent(EMBENET_TIMER_WHEEL_Wheel const* wheel, uint64_t* time) {
+    unsigned level;
+    return findNextEvent(wheel, time, &level);
+}
+
+
+void EMBENET_TIMER_WHEEL_Advance(EMBENET_TIMER_WHEEL_Wheel* wheel, uint64_t now) {
+    uint64_t time;
+    unsigned level;
+    while (findNextEvent(wheel, &time, &level) && (time <= now)) {
+        wheel->now = time;
+
+        // Take the whole slot out of the wheel, as callbacks may add timers to it
+        EMBENET_TIMER_SoftTimer* pending;
+        if (LEVEL_OVERFLOW == level) {
+            pending         = wheel->overflow;
+            wheel->overflow = NULL;
+        } else {
+            unsigned slot             = getSlot(time, level);
+            pending                   = wheel->slots[level][slot];
+            wheel->slots[level][slot] = NULL;
+            wheel->occupied[level] &= ~((uint64_t)1 << slot);
+        }
+        pending->pprev = &pending;
+        for (EMBENET_TIMER_SoftTimer* timer = pending; NULL != timer; timer = timer->next) {
+            timer->level = LEVEL_DETACHED;
+        }
+
+        // A callback may also stop any of the pending timers, which unlinks it from the list
+        while (NULL != pending) {
+            EMBENET_TIMER_SoftTimer* timer = pending;
+            unlinkTimer(timer);
+            timer->level = LEVEL_IDLE;
+            if (0 == level) {
+                expireTimer(wheel, timer, now);
+            } else {
+                // the timer moves to a lower level, or to the current slot of level 0 if it expires right now
+                EMBENET_TIMER_WHEEL_Insert(wheel, timer);
+            }
+        }
+    }
+    if (now > wheel->now) {
+        wheel->now = now;
+    }
+}
@@ -0,0 +1,107 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port
+@brief     Hierarchical timer wheel holding software timers
+*/
+
+#ifndef EMBENET_TIMER_WHEEL_H_
+#define EMBENET_TIMER_WHEEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "embenet_timer_cc1312.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/// Number of bits of time resolved by a single level of the wheel
+#define EMBENET_TIMER_WHEEL_LEVEL_BITS 6u
+/// Number of slots in a single level of the wheel
+#define EMBENET_TIMER_WHEEL_SLOTS (1u << EMBENET_TIMER_WHEEL_LEVEL_BITS)
+/// Number of levels of the wheel, timers further in the future than 2^(LEVELS * LEVEL_BITS) us wait on a separate list
+#define EMBENET_TIMER_WHEEL_LEVELS 6u
+
+/**
+ * @brief Hierarchical timer wheel.
+ *
+ * Level L holds timers whose time of expiry first differs from the current time of the wheel on bits [6L, 6L + 6), in a slot
+ * selected by these bits. Starting and stopping a timer therefore takes constant time. When the time reaches the slot of a higher
+ * level, its timers are moved to lower levels, so every timer is moved at most once per level. Bitmaps of occupied slots let
+ * the wheel skip directly to the next event. The wheel has no hardware dependencies.
+ */
+typedef struct {
+    uint64_t                 now;                                                        ///< Current time of the wheel in us
+    uint64_t                 occupied[EMBENET_TIMER_WHEEL_LEVELS];                       ///< Bitmaps of non-empty slots of every level
+    EMBENET_TIMER_SoftTimer* slots[EMBENET_TIMER_WHEEL_LEVELS][EMBENET_TIMER_WHEEL_SLOTS]; ///< Timers of every slot
+    EMBENET_TIMER_SoftTimer* overflow;                                                   ///< Timers beyond the range of the top level
+} EMBENET_TIMER_WHEEL_Wheel;
+
+
+/**
+ * @brief Empties the wheel, stopping all timers it holds
+ * @param[in, out] wheel wheel to initialize, either zeroed or initialized before
+ * @param[in] now current time in us
+ */
+void EMBENET_TIMER_WHEEL_Init(EMBENET_TIMER_WHEEL_Wheel* wheel, uint64_t now);
+
+
+/**
+ * @brief Marks the timer as not running
+ * @param[out] timer timer to initialize
+ */
+void EMBENET_TIMER_WHEEL_InitTimer(EMBENET_TIMER_SoftTimer* timer);
+
+
+/**
+ * @brief Adds the timer to the wheel
+ * @param[in, out] wheel wheel to add the timer to
+ * @param[in, out] timer timer that is not running, with expiry and period already set; an expiry in the past is moved to the current time
+ */
+void EMBENET_TIMER_WHEEL_Insert(EMBENET_TIMER_WHEEL_Wheel* wheel, EMBENET_TIMER_SoftTimer* timer);
+
+
+/**
+ * @brief Removes the timer from the wheel, if it is running
+ * @param[in, out] wheel wheel holding the timer
+ * @param[in, out] timer timer to remove
+ */
+void EMBENET_TIMER_WHEEL_Remove(EMBENET_TIMER_WHEEL_Wheel* wheel, EMBENET_TIMER_SoftTimer* timer);
+
+
+/**
+ * @brief Checks whether the timer is in the wheel
+ * @param[in] timer timer to check
+ * @return true if the timer is running
+ */
+bool EMBENET_TIMER_WHEEL_IsRunning(EMBENET_TIMER_SoftTimer const* timer);
+
+
+/**
+ * @brief Gets time up to which the wheel may be left alone
+ * @param[in] wheel wheel to check
+ * @param[out] time time at which a timer expires or has to be moved to a lower level
+ * @return true if the wheel holds any timer, false if it is empty and time is not set
+ */
+bool EMBENET_TIMER_WHEEL_GetNextEvent(EMBENET_TIMER_WHEEL_Wheel const* wheel, uint64_t* time);
+
+
+/**
+ * @brief Advances the wheel to the given time, invoking callbacks of all timers that expired on the way
+ *
+ * Callbacks may start and stop any timer, including the one that expired. Periodic timers are restarted before their callback is invoked.
+ *
+ * @param[in, out] wheel wheel to advance
+ * @param[in] now current time in us, earlier times are ignored
+ */
+void EMBENET_TIMER_WHEEL_Advance(EMBENET_TIMER_WHEEL_Wheel* wheel, uint64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EMBENET_TIMER_WHEEL_H_ included
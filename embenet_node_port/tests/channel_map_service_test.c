@@ -0,0 +1,317 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Channel map service of the demo, simulated in a network with a synthetic interferer
+
+The root runs the service, the other nodes of the network are synthetic: their link statistics are drawn by the test and
+their reports are delivered to the root socket. Every node hops with the map set in the radio, as if the map multicast
+by the root reached them. Latency is counted in transmissions per delivered frame, each retransmission waits for the
+next cell to the same neighbor.
+*/
+
+#include "embenet_test.h"
+#include "sim_node.h"
+
+#include <channel_map_service.h>
+#include <embenet_port_capabilities.h>
+#include <embenet_radio_cc1312.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    TEST_NODES             = 8,     ///< Nodes reporting to the root, including the root
+    TEST_FRAMES_PER_PERIOD = 1500,  ///< Unicast data frames sent by every node in a period of the service
+    TEST_MAX_TX            = 4,     ///< Transmissions of a frame before the MAC drops it
+    TEST_PERIOD            = 60000, ///< Period of the service in ms
+    TEST_PERIODS           = 6,     ///< Periods simulated in a run
+    TEST_INTERFERER_FIRST  = 30,    ///< First channel covered by the interferer
+    TEST_INTERFERER_LAST   = 39,    ///< Last channel covered by the interferer
+    TEST_CLEAN_LOSS_PCT    = 5,     ///< Loss of a transmission on a clean channel in percent
+    TEST_JAMMED_LOSS_PCT   = 90,    ///< Loss of a transmission on a channel covered by the interferer in percent
+    TEST_MIN_ATTEMPTS      = 10,    ///< Attempts on a channel needed to report it, as in the service
+    TEST_MIN_PDR           = 70,    ///< Delivery ratio in percent below which a channel is reported, as in the service
+    TEST_PORT              = 1240,  ///< UDP port of the service
+    TEST_GROUP             = 1240,  ///< Multicast group of the service
+
+    MSG_REPORT        = 1,
+    MSG_MAP           = 2,
+    MSG_MAP_REQUEST   = 3,
+    MSG_MAP_REPLY     = 4,
+    MSG_REPORT_LENGTH = 1 + EMBENET_RADIO_CHANNEL_MAP_SIZE,
+    MSG_MAP_LENGTH    = 10 + EMBENET_RADIO_CHANNEL_MAP_SIZE,
+};
+
+/// Link statistics of a node in a period
+typedef struct {
+    uint16_t attempts[EMBENET_RADIO_CHANNEL_MAP_SIZE * 8];
+    uint16_t acked[EMBENET_RADIO_CHANNEL_MAP_SIZE * 8];
+} TestNodeStats;
+
+/// Traffic of the whole network in a period
+typedef struct {
+    uint32_t frames;        ///< Frames sent
+    uint32_t delivered;     ///< Frames acknowledged within TEST_MAX_TX transmissions
+    uint32_t transmissions; ///< Transmissions of all frames
+    uint32_t acked;         ///< Acknowledged transmissions
+    uint32_t deliveredTx;   ///< Transmissions of the delivered frames
+} TestTraffic;
+
+/// Nodes that suffer from the interferer, bit n stands for node n, the root is node 0
+static uint32_t testJammedNodes;
+/// Channels covered by the interferer
+static uint8_t  testInterfererFirst = TEST_INTERFERER_FIRST;
+static uint8_t  testInterfererLast  = TEST_INTERFERER_LAST;
+static uint64_t testAsn;
+static uint32_t testRandomState;
+
+static EMBENET_IPV6 const testCoordinatorAddress = {{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10}};
+static EMBENET_IPV6 const testNeighborAddress    = {{0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x20}};
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+/// Deterministic generator, so that every run simulates the same traffic
+static uint32_t TestRandom(void) {
+    testRandomState ^= testRandomState << 13;
+    testRandomState ^= testRandomState >> 17;
+    testRandomState ^= testRandomState << 5;
+    return testRandomState;
+}
+
+static bool TestIsJammed(size_t node, uint8_t channel) {
+    return (0 != (testJammedNodes & (1u << node))) && (channel >= testInterfererFirst) && (channel <= testInterfererLast);
+}
+
+static bool TestIsAdvChannel(uint8_t channel) {
+    for (size_t i = 0; i != embenetMacAdvChannelListSize; ++i) {
+        if (channel == embenetMacAdvChannelList[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sends one unicast frame of a node with retransmissions, on the channels the MAC hops to
+ * @return number of transmissions until the frame was acknowledged, 0 if it was dropped
+ */
+static unsigned TestSendFrame(size_t node, TestNodeStats* stats, TestTraffic* traffic) {
+    for (unsigned tx = 1; tx <= TEST_MAX_TX; ++tx) {
+        testAsn += 1 + (TestRandom() % 101); // next cell to the neighbor
+        EMBENET_TRACE_LinkLayerTelemetry event = {
+            .cellEvent     = EMBENET_TRACE_CELL_EVENT_TX,
+            .cellRole      = EMBENET_TRACE_CELL_ROLE_AUTO_UP,
+            .frameType     = EMBENET_TRACE_FRAME_TYPE_DATA,
+            .channelOffset = 0,
+            .asn           = testAsn,
+            .dst           = UINT64_C(0x00124b0000000100) + node,
+        };
+        uint8_t channel = EMBENET_RADIO_MapChannel(embenetMacChannelList[testAsn % embenetMacChannelListSize]);
+        bool    acked   = (TestRandom() % 100) >= (TestIsJammed(node, channel) ? TEST_JAMMED_LOSS_PCT : TEST_CLEAN_LOSS_PCT);
+
+        traffic->transmissions += 1;
+        traffic->acked += acked ? 1 : 0;
+        if (0 == node) {
+            channel_map_service_on_link_layer_event(&event);
+            if (acked) {
+                event.cellEvent     = EMBENET_TRACE_CELL_EVENT_RX;
+                event.frameType     = EMBENET_TRACE_FRAME_TYPE_ACK;
+                event.rssiOrTxPower = -80;
+                channel_map_service_on_link_layer_event(&event);
+            }
+        } else {
+            stats->attempts[channel] += 1;
+            stats->acked[channel] += acked ? 1 : 0;
+        }
+        if (acked) {
+            return tx;
+        }
+    }
+    return 0;
+}
+
+/// Sends the traffic of all nodes in a period and delivers the reports of the synthetic nodes to the root
+static void TestRunPeriod(TestTraffic* traffic) {
+    *traffic = (TestTraffic){0};
+    for (size_t node = 0; node != TEST_NODES; ++node) {
+        TestNodeStats stats;
+        memset(&stats, 0, sizeof(stats));
+        for (unsigned frame = 0; frame != TEST_FRAMES_PER_PERIOD; ++frame) {
+            unsigned tx = TestSendFrame(node, &stats, traffic);
+            traffic->frames += 1;
+            traffic->delivered += (0 != tx) ? 1 : 0;
+            traffic->deliveredTx += tx;
+        }
+        if (0 != node) {
+            uint8_t report[MSG_REPORT_LENGTH] = {MSG_REPORT};
+            for (size_t channel = 0; channel != EMBENET_RADIO_CHANNEL_MAP_SIZE * 8; ++channel) {
+                if ((stats.attempts[channel] >= TEST_MIN_ATTEMPTS) && (stats.acked[channel] * 100u < stats.attempts[channel] * (unsigned)TEST_MIN_PDR)) {
+                    report[1 + channel / 8] |= (uint8_t)(1u << (channel % 8));
+                }
+            }
+            EMBENET_IPV6 source = testNeighborAddress;
+            source.val[15]      = (uint8_t)node;
+            SIM_NODE_Deliver(&source, TEST_PORT, report, sizeof(report));
+        }
+    }
+}
+
+/// Runs the root of a network where the given nodes suffer from the interferer, prints and returns the traffic of every period
+static void TestRunNetwork(uint32_t jammedNodes, TestTraffic* traffic) {
+    SIM_NODE_Reset();
+    EMBENET_RADIO_SetChannelMap(NULL);
+    testJammedNodes = jammedNodes;
+    testAsn         = 0;
+    testRandomState = 0x2545f491;
+
+    channel_map_service_init(NULL, true);
+    channel_map_service_start();
+    printf("period    PDR  delivered  tx/frame  channels\n");
+    for (size_t period = 0; period != TEST_PERIODS; ++period) {
+        // the traffic falls in the middle of the period, after the map announced at the start of the period took effect
+        SIM_NODE_RunUntil(period * TEST_PERIOD + TEST_PERIOD / 2);
+        TestRunPeriod(&traffic[period]);
+        SIM_NODE_RunUntil((period + 1) * TEST_PERIOD);
+        printf("%6u  %4.1f%%     %5.1f%%     %5.2f  %8d\n", (unsigned)period, 100.0 * traffic[period].acked / traffic[period].transmissions,
+               100.0 * traffic[period].delivered / traffic[period].frames, (double)traffic[period].deliveredTx / traffic[period].delivered,
+               SIM_NODE_GetServiceState("chmap"));
+    }
+}
+
+/// Returns the last datagram sent, checking that it is a message of the given type and length
+static SIM_NODE_Datagram const* TestGetLastSent(uint8_t type, size_t length) {
+    size_t count = SIM_NODE_GetSentCount();
+    TEST_CHECK(0 != count);
+    if (0 == count) {
+        return NULL;
+    }
+    SIM_NODE_Datagram const* datagram = SIM_NODE_GetSent(((count < SIM_NODE_MAX_SENT) ? count : SIM_NODE_MAX_SENT) - 1);
+    TEST_CHECK(TEST_PORT == datagram->port);
+    TEST_CHECK(length == datagram->size);
+    TEST_CHECK(type == datagram->data[0]);
+    return datagram;
+}
+
+static void TestInterfererIsAvoided(void) {
+    TestTraffic traffic[TEST_PERIODS];
+    TestRunNetwork(UINT32_MAX, traffic);
+
+    size_t jammed = TEST_INTERFERER_LAST - TEST_INTERFERER_FIRST + 1;
+    for (size_t i = 0; i != embenetMacChannelListSize; ++i) {
+        uint8_t channel = embenetMacChannelList[i];
+        uint8_t used    = EMBENET_RADIO_MapChannel(channel);
+        TEST_CHECK((channel >= TEST_INTERFERER_FIRST && channel <= TEST_INTERFERER_LAST) ? (used != channel) : (used == channel));
+        TEST_CHECK(!TestIsJammed(0, used));
+    }
+    TEST_CHECK_RANGE(SIM_NODE_GetServiceState("chmap"), embenetMacChannelListSize - jammed, embenetMacChannelListSize - jammed);
+
+    SIM_NODE_Datagram const* map = TestGetLastSent(MSG_MAP, MSG_MAP_LENGTH);
+    if (NULL != map) {
+        TEST_CHECK(SIM_NODE_IsGroupAddress(&map->destination, TEST_GROUP));
+        for (size_t i = 0; i != embenetMacAdvChannelListSize; ++i) {
+            uint8_t channel = embenetMacAdvChannelList[i];
+            TEST_CHECK(0 != (map->data[10 + channel / 8] & (1u << (channel % 8))));
+        }
+    }
+
+    // the first period runs with all channels, the map excluding the interferer is used from the second one
+    for (size_t period = 1; period != TEST_PERIODS; ++period) {
+        TEST_CHECK(traffic[period].acked * 1000u / traffic[period].transmissions >= traffic[0].acked * 1000u / traffic[0].transmissions + 80);
+        TEST_CHECK(traffic[period].deliveredTx * 100u / traffic[period].delivered + 10 <= traffic[0].deliveredTx * 100u / traffic[0].delivered);
+        TEST_CHECK(traffic[period].delivered >= traffic[0].delivered);
+    }
+}
+
+static void TestSingleReporterExcludesNothing(void) {
+    TestTraffic traffic[TEST_PERIODS];
+    TestRunNetwork(1u << 3, traffic); // the interferer is close to a single node, its neighbors hear it too weakly
+
+    for (size_t i = 0; i != embenetMacChannelListSize; ++i) {
+        TEST_CHECK(embenetMacChannelList[i] == EMBENET_RADIO_MapChannel(embenetMacChannelList[i]));
+    }
+    TEST_CHECK_RANGE(SIM_NODE_GetServiceState("chmap"), embenetMacChannelListSize, embenetMacChannelListSize);
+}
+
+static void TestTwoReportersExcludeChannels(void) {
+    TestTraffic traffic[TEST_PERIODS];
+    TestRunNetwork((1u << 3) | (1u << 4), traffic);
+
+    for (uint8_t channel = TEST_INTERFERER_FIRST; channel <= TEST_INTERFERER_LAST; ++channel) {
+        TEST_CHECK(channel != EMBENET_RADIO_MapChannel(channel));
+    }
+}
+
+static void TestJoiningNodeRequestsMap(void) {
+    SIM_NODE_Reset();
+    EMBENET_RADIO_SetChannelMap(NULL);
+    channel_map_service_init(NULL, false);
+    TEST_CHECK_RANGE(SIM_NODE_GetServiceState("chmap"), embenetMacChannelListSize, embenetMacChannelListSize);
+
+    channel_map_service_start();
+    SIM_NODE_Datagram const* request = TestGetLastSent(MSG_MAP_REQUEST, 1);
+    EMBENET_IPV6             parent  = SIM_NODE_GetParentAddress();
+    TEST_CHECK((NULL != request) && (0 == memcmp(&request->destination, &parent, sizeof(parent))));
+
+    // the parent replies with the map in use, which excludes the interferer
+    uint8_t reply[MSG_MAP_LENGTH] = {MSG_MAP_REPLY, 7};
+    memset(&reply[10], 0xff, EMBENET_RADIO_CHANNEL_MAP_SIZE);
+    for (uint8_t channel = TEST_INTERFERER_FIRST; channel <= TEST_INTERFERER_LAST; ++channel) {
+        reply[10 + channel / 8] &= (uint8_t)~(1u << (channel % 8));
+    }
+    SIM_NODE_Deliver(&parent, TEST_PORT, reply, sizeof(reply));
+    for (uint8_t channel = TEST_INTERFERER_FIRST; channel <= TEST_INTERFERER_LAST; ++channel) {
+        TEST_CHECK(channel != EMBENET_RADIO_MapChannel(channel));
+    }
+    size_t used = embenetMacChannelListSize - (TEST_INTERFERER_LAST - TEST_INTERFERER_FIRST + 1);
+    TEST_CHECK_RANGE(SIM_NODE_GetServiceState("chmap"), used, used);
+
+    // the coordinator is not known before its first multicast, so nothing is reported
+    SIM_NODE_ClearSent();
+    SIM_NODE_RunUntil(TEST_PERIOD);
+    TEST_CHECK(0 == SIM_NODE_GetSentCount());
+
+    reply[0] = MSG_MAP;
+    SIM_NODE_Deliver(&testCoordinatorAddress, TEST_PORT, reply, sizeof(reply));
+    SIM_NODE_RunUntil(2 * TEST_PERIOD);
+    SIM_NODE_Datagram const* report = TestGetLastSent(MSG_REPORT, MSG_REPORT_LENGTH);
+    TEST_CHECK((NULL != report) && (0 == memcmp(&report->destination, &testCoordinatorAddress, sizeof(testCoordinatorAddress))));
+
+    // a node that joins later gets the map from this node
+    uint8_t mapRequest = MSG_MAP_REQUEST;
+    SIM_NODE_Deliver(&testNeighborAddress, TEST_PORT, &mapRequest, sizeof(mapRequest));
+    SIM_NODE_Datagram const* mapReply = TestGetLastSent(MSG_MAP_REPLY, MSG_MAP_LENGTH);
+    TEST_CHECK((NULL != mapReply) && (0 == memcmp(&mapReply->destination, &testNeighborAddress, sizeof(testNeighborAddress))));
+    TEST_CHECK((NULL != mapReply) && (0 == memcmp(&mapReply->data[1], &reply[1], MSG_MAP_LENGTH - 1)));
+
+    channel_map_service_stop();
+    TEST_CHECK(TEST_INTERFERER_FIRST == EMBENET_RADIO_MapChannel(TEST_INTERFERER_FIRST));
+    TEST_CHECK_RANGE(SIM_NODE_GetServiceState("chmap"), embenetMacChannelListSize, embenetMacChannelListSize);
+}
+
+static void TestAdvChannelsAreNeverExcluded(void) {
+    // the interferer covers an advertisement channel, which joining nodes need to hear the network
+    testInterfererFirst = embenetMacAdvChannelList[1] - 4;
+    testInterfererLast  = embenetMacAdvChannelList[1] + 4;
+    TestTraffic traffic[TEST_PERIODS];
+    TestRunNetwork(UINT32_MAX, traffic);
+    for (uint8_t channel = testInterfererFirst; channel <= testInterfererLast; ++channel) {
+        TEST_CHECK(TestIsAdvChannel(channel) == (channel == EMBENET_RADIO_MapChannel(channel)));
+    }
+    testInterfererFirst = TEST_INTERFERER_FIRST;
+    testInterfererLast  = TEST_INTERFERER_LAST;
+}
+
+int main(void) {
+    TEST_RUN(TestInterfererIsAvoided);
+    TEST_RUN(TestSingleReporterExcludesNothing);
+    TEST_RUN(TestTwoReportersExcludeChannels);
+    TEST_RUN(TestJoiningNodeRequestsMap);
+    TEST_RUN(TestAdvChannelsAreNeverExcluded);
+    return TEST_RESULT();
+}
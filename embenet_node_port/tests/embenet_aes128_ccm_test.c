@@ -0,0 +1,258 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     CCM* of the AES port against the IEEE 802.15.4 test vectors and against OpenSSL
+*/
+
+#include "embenet_test.h"
+#include "sim_crypto.h"
+
+#include <embenet_aes128_ccm.h>
+#include <embenet_aes128_cc1312.h>
+#include <ti/drivers/AESCCM.h>
+
+#include <openssl/evp.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    TEST_MAX_AAD_LENGTH  = 40,
+    TEST_MAX_DATA_LENGTH = 130, ///< Longer than a frame, so that the last block of the data is partial or full
+    TEST_RANDOM_CASES    = 2000,
+};
+
+/// Test vector of IEEE 802.15.4-2006 Annex C.2, each was also checked with OpenSSL
+typedef struct {
+    char const* name;
+    uint8_t     nonce[EMBENET_AES128_CCM_NONCE_LENGTH];
+    uint8_t     aad[32];
+    size_t      aadLength;
+    uint8_t     plaintext[4];
+    uint8_t     ciphertext[4];
+    size_t      dataLength;
+    uint8_t     mic[16];
+    size_t      micLength;
+} TestVector;
+
+static uint8_t const testKey[16] = {0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF};
+
+static TestVector const testVectors[] = {
+    {
+        .name       = "C.2.1 beacon frame, MIC-64",
+        .nonce      = {0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x02},
+        .aad        = {0x08, 0xD0, 0x84, 0x21, 0x43, 0x01, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC, 0x02, 0x05, 0x00, 0x00, 0x00, 0x55, 0xCF, 0x00, 0x00, 0x51, 0x52,
+                       0x53, 0x54},
+        .aadLength  = 26,
+        .dataLength = 0,
+        .mic        = {0x22, 0x3B, 0xC1, 0xEC, 0x84, 0x1A, 0xB5, 0x53},
+        .micLength  = 8,
+    },
+    {
+        .name       = "C.2.2 data frame, ENC",
+        .nonce      = {0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x04},
+        .aad        = {0x69, 0xDC, 0x84, 0x21, 0x43, 0x02, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC, 0x01, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC, 0x04, 0x05, 0x00,
+                       0x00, 0x00},
+        .aadLength  = 26,
+        .plaintext  = {0x61, 0x62, 0x63, 0x64},
+        .ciphertext = {0xD4, 0x3E, 0x02, 0x2B},
+        .dataLength = 4,
+        .micLength  = 0,
+    },
+    {
+        .name       = "C.2.3 MAC command frame, ENC-MIC-64",
+        .nonce      = {0xAC, 0xDE, 0x48, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x06},
+        .aad        = {0x2B, 0xDC, 0x84, 0x21, 0x43, 0x02, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC, 0xFF, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x48, 0xDE, 0xAC, 0x06,
+                       0x05, 0x00, 0x00, 0x00, 0x01},
+        .aadLength  = 29,
+        .plaintext  = {0xCE},
+        .ciphertext = {0xD8},
+        .dataLength = 1,
+        .mic        = {0x4F, 0xDE, 0x52, 0x90, 0x61, 0xF9, 0xC6, 0xF1},
+        .micLength  = 8,
+    },
+};
+
+static uint32_t testRandom = 2463534242u;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static void TestRandomBytes(uint8_t* bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        bytes[i] = (uint8_t)TestRandom();
+    }
+}
+
+// CCM* of OpenSSL, CCM for a MIC and CTR from counter 1 for encryption only, which OpenSSL CCM does not offer
+static void TestOpenSslEncrypt(uint8_t const key[16], uint8_t const* nonce, uint8_t const* aad, size_t aadLength, uint8_t* data, size_t dataLength,
+                               uint8_t* mic, size_t micLength) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int             length;
+    if (0 == micLength) {
+        uint8_t counter[16] = {0x01};
+        memcpy(&counter[1], nonce, EMBENET_AES128_CCM_NONCE_LENGTH);
+        counter[15] = 0x01;
+        EVP_EncryptInit_ex(ctx, EVP_aes_128_ctr(), NULL, key, counter);
+        EVP_EncryptUpdate(ctx, data, &length, data, (int)dataLength);
+    } else {
+        EVP_EncryptInit_ex(ctx, EVP_aes_128_ccm(), NULL, NULL, NULL);
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_IVLEN, EMBENET_AES128_CCM_NONCE_LENGTH, NULL);
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_TAG, (int)micLength, NULL);
+        EVP_EncryptInit_ex(ctx, NULL, NULL, key, nonce);
+        EVP_EncryptUpdate(ctx, NULL, &length, NULL, (int)dataLength);
+        if (0 != aadLength) {
+            EVP_EncryptUpdate(ctx, NULL, &length, aad, (int)aadLength);
+        }
+        EVP_EncryptUpdate(ctx, data, &length, data, (int)dataLength);
+        EVP_EncryptFinal_ex(ctx, data + length, &length);
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_GET_TAG, (int)micLength, mic);
+    }
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+static void TestInit(void) {
+    EMBENET_AES128_Init();
+    EMBENET_AES128_SetKey(testKey);
+}
+
+// The vectors are run through the port, i.e. the accelerator when it takes the parameters, and through the software CCM* alone
+static void TestIeeeVectors(void) {
+    TestInit();
+    for (size_t i = 0; i < sizeof(testVectors) / sizeof(testVectors[0]); ++i) {
+        TestVector const* vector = &testVectors[i];
+        for (int software = 0; software < 2; ++software) {
+            uint8_t data[sizeof(vector->plaintext)];
+            uint8_t mic[sizeof(vector->mic)] = {0};
+            memcpy(data, vector->plaintext, vector->dataLength);
+            if (software) {
+                EMBENET_AES128_CCM_Encrypt(EMBENET_AES128_Encrypt, vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, mic, vector->micLength);
+            } else {
+                TEST_CHECK(EMBENET_AES128_CcmEncrypt(vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, mic, vector->micLength));
+            }
+            if ((0 != memcmp(data, vector->ciphertext, vector->dataLength)) || (0 != memcmp(mic, vector->mic, vector->micLength))) {
+                fprintf(stderr, "%s encrypted wrong in %s\n", vector->name, software ? "software" : "the port");
+                TEST_CHECK(false);
+            }
+
+            bool valid;
+            if (software) {
+                valid = EMBENET_AES128_CCM_Decrypt(EMBENET_AES128_Encrypt, vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, mic,
+                                                   vector->micLength);
+            } else {
+                valid = EMBENET_AES128_CcmDecrypt(vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, mic, vector->micLength);
+            }
+            if (!valid || (0 != memcmp(data, vector->plaintext, vector->dataLength))) {
+                fprintf(stderr, "%s decrypted wrong in %s\n", vector->name, software ? "software" : "the port");
+                TEST_CHECK(false);
+            }
+        }
+    }
+    EMBENET_AES128_Deinit();
+}
+
+// Random lengths around the block boundaries, every MIC length, each checked against OpenSSL and with a flipped bit
+static void TestOpenSslCrossCheck(void) {
+    static size_t const micLengths[] = {0, 4, 8, 16};
+    TestInit();
+    for (unsigned i = 0; i < TEST_RANDOM_CASES; ++i) {
+        uint8_t key[16];
+        uint8_t nonce[EMBENET_AES128_CCM_NONCE_LENGTH];
+        uint8_t aad[TEST_MAX_AAD_LENGTH];
+        uint8_t plaintext[TEST_MAX_DATA_LENGTH];
+        uint8_t data[TEST_MAX_DATA_LENGTH];
+        uint8_t expected[TEST_MAX_DATA_LENGTH];
+        uint8_t mic[16];
+        uint8_t expectedMic[16];
+        size_t  aadLength  = TestRandom() % (TEST_MAX_AAD_LENGTH + 1);
+        size_t  dataLength = TestRandom() % (TEST_MAX_DATA_LENGTH + 1);
+        size_t  micLength  = micLengths[i % (sizeof(micLengths) / sizeof(micLengths[0]))];
+        TestRandomBytes(key, sizeof(key));
+        TestRandomBytes(nonce, sizeof(nonce));
+        TestRandomBytes(aad, aadLength);
+        TestRandomBytes(plaintext, dataLength);
+        EMBENET_AES128_SetKey(key);
+
+        memcpy(expected, plaintext, dataLength);
+        TestOpenSslEncrypt(key, nonce, aad, aadLength, expected, dataLength, expectedMic, micLength);
+        memcpy(data, plaintext, dataLength);
+        TEST_CHECK(EMBENET_AES128_CcmEncrypt(nonce, aad, aadLength, data, dataLength, mic, micLength));
+        if ((0 != memcmp(data, expected, dataLength)) || (0 != memcmp(mic, expectedMic, micLength))) {
+            fprintf(stderr, "case %u (aad %zu, data %zu, MIC %zu) differs from OpenSSL\n", i, aadLength, dataLength, micLength);
+            TEST_CHECK(false);
+        }
+
+        memcpy(data, expected, dataLength);
+        EMBENET_AES128_CCM_Encrypt(EMBENET_AES128_Encrypt, nonce, aad, aadLength, data, dataLength, mic, micLength);
+        TEST_CHECK(0 == memcmp(data, plaintext, dataLength)); // CTR is its own inverse
+
+        memcpy(data, expected, dataLength);
+        TEST_CHECK(EMBENET_AES128_CcmDecrypt(nonce, aad, aadLength, data, dataLength, expectedMic, micLength));
+        TEST_CHECK(0 == memcmp(data, plaintext, dataLength));
+
+        if ((0 != micLength) && ((0 != aadLength) || (0 != dataLength))) {
+            size_t bit = TestRandom() % (8 * (aadLength + dataLength));
+            memcpy(data, expected, dataLength);
+            if (bit < 8 * aadLength) {
+                aad[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            } else {
+                data[bit / 8 - aadLength] ^= (uint8_t)(1u << (bit % 8));
+            }
+            TEST_CHECK(!EMBENET_AES128_CcmDecrypt(nonce, aad, aadLength, data, dataLength, expectedMic, micLength));
+            for (size_t j = 0; j < dataLength; ++j) {
+                TEST_CHECK(0 == data[j]);
+            }
+        }
+    }
+    EMBENET_AES128_Deinit();
+}
+
+// A failed accelerator leaves the data partly transformed in place, it must not be taken over by the software path
+static void TestAcceleratorFailure(void) {
+    static int_fast16_t const statuses[] = {AESCCM_STATUS_ERROR, AESCCM_STATUS_RESOURCE_UNAVAILABLE};
+    TestVector const*         vector     = &testVectors[2];
+    TestInit();
+    for (size_t i = 0; i < sizeof(statuses) / sizeof(statuses[0]); ++i) {
+        uint8_t data[sizeof(vector->plaintext)];
+        uint8_t mic[sizeof(vector->mic)];
+        memcpy(data, vector->plaintext, vector->dataLength);
+        unsigned blocks = SIM_AESECB_GetBlockCount();
+        SIM_AESCCM_FailNext(statuses[i]);
+        TEST_CHECK(!EMBENET_AES128_CcmEncrypt(vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, mic, vector->micLength));
+        TEST_CHECK(0 == data[0]);
+        for (size_t j = 0; j < vector->micLength; ++j) {
+            TEST_CHECK(0 == mic[j]);
+        }
+
+        memcpy(data, vector->ciphertext, vector->dataLength);
+        SIM_AESCCM_FailNext(statuses[i]);
+        TEST_CHECK(!EMBENET_AES128_CcmDecrypt(vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, vector->mic, vector->micLength));
+        TEST_CHECK(0 == data[0]);
+        TEST_CHECK(blocks == SIM_AESECB_GetBlockCount()); // no software retry
+
+        memcpy(data, vector->ciphertext, vector->dataLength);
+        TEST_CHECK(EMBENET_AES128_CcmDecrypt(vector->nonce, vector->aad, vector->aadLength, data, vector->dataLength, vector->mic, vector->micLength));
+        TEST_CHECK(0 == memcmp(data, vector->plaintext, vector->dataLength));
+    }
+    EMBENET_AES128_Deinit();
+}
+
+int main(void) {
+    TEST_RUN(TestIeeeVectors);
+    TEST_RUN(TestOpenSslCrossCheck);
+    TEST_RUN(TestAcceleratorFailure);
+    return TEST_RESULT();
+}
@@ -0,0 +1,215 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Key slots of the AES port checked against OpenSSL, with the cost of switching keys as the stack does between join traffic and data
+*/
+
+#include "embenet_test.h"
+#include "sim_crypto.h"
+
+#include <embenet_aes128_cc1312.h>
+
+#include <openssl/evp.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+    TEST_KEY_K1        = 0,      ///< Key of the network, authenticates the beacons
+    TEST_KEY_PSK       = 1,      ///< Pre-shared key of the joining node, used by the join proxy
+    TEST_KEY_LINK      = 2,      ///< First of the per-link keys
+    TEST_KEY_COUNT     = 5,      ///< One key more than the slots of the port
+    TEST_SWITCHES      = 1000,   ///< Key switches checked against OpenSSL
+    TEST_BENCH_COUNT   = 200000, ///< Key switches per benchmark measurement
+    TEST_BENCH_REPEATS = 5,      ///< Every measurement is repeated, the fastest run is taken
+};
+
+static uint8_t testKeys[TEST_KEY_COUNT][16];
+static uint8_t testPattern[TEST_BENCH_COUNT];
+static uint8_t testKeyStorage[16]; ///< Single key storage the port copied every key into before it kept slots
+
+static uint32_t testRandom = 2463534242u;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static double TestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void TestInit(void) {
+    for (size_t i = 0; i < TEST_KEY_COUNT; ++i) {
+        for (size_t j = 0; j < sizeof(testKeys[i]); ++j) {
+            testKeys[i][j] = (uint8_t)TestRandom();
+        }
+    }
+    EMBENET_AES128_Init();
+}
+
+// Encrypts a random block with the selected key of the port and with OpenSSL, true if both agree
+static bool TestEncryptsWith(uint8_t const key[16]) {
+    uint8_t block[16];
+    uint8_t expected[16];
+    int     length;
+    for (size_t i = 0; i < sizeof(block); ++i) {
+        block[i] = (uint8_t)TestRandom();
+    }
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    EVP_EncryptInit_ex(ctx, EVP_aes_128_ecb(), NULL, key, NULL);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_EncryptUpdate(ctx, expected, &length, block, sizeof(block));
+    EVP_CIPHER_CTX_free(ctx);
+
+    EMBENET_AES128_Encrypt(block);
+    return 0 == memcmp(block, expected, sizeof(block));
+}
+
+// Keys switched by handle or by value, in any order, are the ones used for encryption, as long as they fit in the slots
+static void TestSwitchedKeyIsUsed(void) {
+    EMBENET_AES128_KeyHandle handles[EMBENET_AES128_KEY_SLOTS];
+    TestInit();
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        handles[i] = EMBENET_AES128_LoadKey(testKeys[i]);
+        TEST_CHECK(handles[i] < EMBENET_AES128_KEY_SLOTS);
+        for (size_t previous = 0; previous < i; ++previous) {
+            TEST_CHECK(handles[previous] != handles[i]);
+        }
+    }
+    for (unsigned i = 0; i < TEST_SWITCHES; ++i) {
+        size_t key = TestRandom() % EMBENET_AES128_KEY_SLOTS;
+        if (0 == (i % 2)) {
+            EMBENET_AES128_SelectKey(handles[key]);
+        } else {
+            EMBENET_AES128_SetKey(testKeys[key]);
+        }
+        TEST_CHECK(TestEncryptsWith(testKeys[key]));
+    }
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        TEST_CHECK(handles[i] == EMBENET_AES128_LoadKey(testKeys[i])); // none was replaced
+    }
+    EMBENET_AES128_Deinit();
+}
+
+// A new key replaces the least recently used one, the other handles stay valid
+static void TestLeastRecentlyUsedIsReplaced(void) {
+    EMBENET_AES128_KeyHandle handles[EMBENET_AES128_KEY_SLOTS];
+    TestInit();
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        handles[i] = EMBENET_AES128_LoadKey(testKeys[i]);
+    }
+    EMBENET_AES128_SelectKey(handles[TEST_KEY_K1]);
+    EMBENET_AES128_KeyHandle replacing = EMBENET_AES128_LoadKey(testKeys[EMBENET_AES128_KEY_SLOTS]);
+    TEST_CHECK(handles[TEST_KEY_PSK] == replacing);
+    EMBENET_AES128_SelectKey(replacing);
+    TEST_CHECK(TestEncryptsWith(testKeys[EMBENET_AES128_KEY_SLOTS]));
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        if (TEST_KEY_PSK != i) {
+            EMBENET_AES128_SelectKey(handles[i]);
+            TEST_CHECK(TestEncryptsWith(testKeys[i]));
+        }
+    }
+
+    // Handles out of range leave the selected key in place
+    EMBENET_AES128_SelectKey(EMBENET_AES128_KEY_SLOTS);
+    TEST_CHECK(TestEncryptsWith(testKeys[EMBENET_AES128_KEY_SLOTS - 1]));
+    EMBENET_AES128_Deinit();
+}
+
+// Every slot is cleared on deinitialization, the keys do not stay in memory
+static void TestDeinitClearsKeys(void) {
+    uint8_t const* storage[EMBENET_AES128_KEY_SLOTS];
+    TestInit();
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        EMBENET_AES128_SetKey(testKeys[i]);
+        TEST_CHECK(TestEncryptsWith(testKeys[i]));
+        storage[i] = SIM_AESECB_GetLastKey();
+        TEST_CHECK(0 == memcmp(storage[i], testKeys[i], sizeof(testKeys[i])));
+    }
+    EMBENET_AES128_Deinit();
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        for (size_t j = 0; j < sizeof(testKeys[i]); ++j) {
+            TEST_CHECK(0 == storage[i][j]);
+        }
+    }
+}
+
+// Returns the fastest host wall-clock time of a key switch in ns, over the key sequence of testPattern
+static double TestBenchmark(void (*switchKey)(size_t key, EMBENET_AES128_KeyHandle const* handles), EMBENET_AES128_KeyHandle const* handles) {
+    double best = 0;
+    for (unsigned repeat = 0; repeat < TEST_BENCH_REPEATS; ++repeat) {
+        double start = TestNow();
+        for (size_t i = 0; i < TEST_BENCH_COUNT; ++i) {
+            switchKey(testPattern[i], handles);
+        }
+        double time = TestNow() - start;
+        best        = ((0 == repeat) || (time < best)) ? time : best;
+    }
+    return best / TEST_BENCH_COUNT;
+}
+
+static void TestCopyKey(size_t key, EMBENET_AES128_KeyHandle const* handles) {
+    (void)handles;
+    memcpy(testKeyStorage, testKeys[key], sizeof(testKeyStorage));
+}
+
+static void TestSetKey(size_t key, EMBENET_AES128_KeyHandle const* handles) {
+    (void)handles;
+    EMBENET_AES128_SetKey(testKeys[key]);
+}
+
+static void TestSelectKey(size_t key, EMBENET_AES128_KeyHandle const* handles) {
+    EMBENET_AES128_SelectKey(handles[key]);
+}
+
+// Prints the cost of a key switch as the port did before, copying every key into one storage, and with the slots, by value and by handle.
+// The pattern follows a node serving as join proxy: beacons with K1, data with the keys of two links, join traffic with the PSK.
+// The copied bytes are derived, not counted: the former port copied every key, the slots copy a key only when it is loaded, which the
+// check after the measurement shows did not happen during it.
+static void TestKeySwitchCost(void) {
+    EMBENET_AES128_KeyHandle handles[EMBENET_AES128_KEY_SLOTS];
+    TestInit();
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        handles[i] = EMBENET_AES128_LoadKey(testKeys[i]);
+    }
+    for (size_t i = 0; i < TEST_BENCH_COUNT; ++i) {
+        uint32_t share = TestRandom() % 100;
+        testPattern[i] = (share < 25) ? TEST_KEY_K1 : (share < 35) ? TEST_KEY_PSK : (share < 75) ? TEST_KEY_LINK : TEST_KEY_LINK + 1;
+    }
+
+    double copy   = TestBenchmark(TestCopyKey, handles);
+    double set    = TestBenchmark(TestSetKey, handles);
+    double select = TestBenchmark(TestSelectKey, handles);
+    printf("| key switch                   | time [host ns] | copied [B], derived |\n");
+    printf("| copy into one storage        | %14.2f | %19zu |\n", copy, sizeof(testKeyStorage));
+    printf("| EMBENET_AES128_SetKey        | %14.2f | %19d |\n", set, 0);
+    printf("| EMBENET_AES128_SelectKey     | %14.2f | %19d |\n", select, 0);
+
+    for (size_t i = 0; i < EMBENET_AES128_KEY_SLOTS; ++i) {
+        TEST_CHECK(handles[i] == EMBENET_AES128_LoadKey(testKeys[i])); // the pattern fits in the slots, no key was copied
+    }
+    EMBENET_AES128_Deinit();
+}
+
+int main(void) {
+    TEST_RUN(TestSwitchedKeyIsUsed);
+    TEST_RUN(TestLeastRecentlyUsedIsReplaced);
+    TEST_RUN(TestDeinitClearsKeys);
+    TEST_RUN(TestKeySwitchCost);
+    return TEST_RESULT();
+}
@@ -0,0 +1,162 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     CRC kernel of the border router link checked against the bytewise lookup over random frames, with a micro-benchmark of both
+*/
+
+#include "embenet_test.h"
+
+#include <embenet_brt_crc.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+    TEST_FRAMES     = 20000,  ///< Random frames checked against the reference
+    TEST_MAX_LENGTH = 300,    ///< Longer than the longest frame of the link, so that every tail length of the slicing loop is covered
+    TEST_MAX_OFFSET = 8,      ///< Frames start at every alignment up to this offset
+    TEST_BENCH_MS   = 50,     ///< Time of a single benchmark measurement
+    TEST_CRC_INIT   = 0xffff, ///< CRC before the first byte of a frame
+    TEST_CRC_GOOD   = 0xf0b8, ///< Residue of a frame followed by its CRC
+};
+
+static uint16_t testTable[256];
+static uint8_t  testBuffer[TEST_MAX_LENGTH + TEST_MAX_OFFSET + 2];
+static uint32_t testRandom = 12345;
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static double TestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Builds the table of the byte-at-a-time lookup the link used before, from the reflected polynomial
+static void TestInitTable(void) {
+    for (unsigned byte = 0; byte < 256; ++byte) {
+        uint16_t crc = (uint16_t)byte;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+        }
+        testTable[byte] = crc;
+    }
+}
+
+static uint16_t TestCrcBytewise(uint16_t crc, uint8_t const* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        crc = (uint16_t)((crc >> 8) ^ testTable[(crc ^ data[i]) & 0xff]);
+    }
+    return crc;
+}
+
+static void TestFillRandom(uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = (uint8_t)TestRandom();
+    }
+}
+
+// The check value of CRC-16/X.25 and the table the link used before
+static void TestKnownValues(void) {
+    static uint8_t const check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_CHECK((0x906e ^ 0xffff) == EMBENET_BRT_CRC_Update(TEST_CRC_INIT, check, sizeof(check))); // complemented when sent
+    TEST_CHECK(TEST_CRC_INIT == EMBENET_BRT_CRC_Update(TEST_CRC_INIT, check, 0));
+    TEST_CHECK(0x1189 == testTable[1]);
+    TEST_CHECK(0x0f78 == testTable[255]);
+}
+
+// Random frames at random alignments and with random preceding CRC give the same CRC as the bytewise lookup
+static void TestRandomFramesMatchBytewise(void) {
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        size_t   length = TestRandom() % (TEST_MAX_LENGTH + 1);
+        size_t   offset = TestRandom() % TEST_MAX_OFFSET;
+        uint16_t crc    = (0 == (i % 2)) ? TEST_CRC_INIT : (uint16_t)TestRandom();
+        TestFillRandom(testBuffer + offset, length);
+        uint16_t expected = TestCrcBytewise(crc, testBuffer + offset, length);
+        uint16_t actual   = EMBENET_BRT_CRC_Update(crc, testBuffer + offset, length);
+        TEST_CHECK(expected == actual);
+        if (expected != actual) {
+            return;
+        }
+    }
+}
+
+// A frame followed by its complemented CRC, least significant byte first, leaves the residue checked by the decoder
+static void TestFrameWithCrcLeavesResidue(void) {
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        size_t length = 1 + TestRandom() % TEST_MAX_LENGTH;
+        TestFillRandom(testBuffer, length);
+        uint16_t crc           = (uint16_t)~EMBENET_BRT_CRC_Update(TEST_CRC_INIT, testBuffer, length);
+        testBuffer[length]     = (uint8_t)(crc >> 0);
+        testBuffer[length + 1] = (uint8_t)(crc >> 8);
+        TEST_CHECK(TEST_CRC_GOOD == EMBENET_BRT_CRC_Update(TEST_CRC_INIT, testBuffer, length + 2));
+
+        testBuffer[TestRandom() % (length + 2)] ^= (uint8_t)(1u << (TestRandom() % 8)); // any single bit error is detected
+        TEST_CHECK(TEST_CRC_GOOD != EMBENET_BRT_CRC_Update(TEST_CRC_INIT, testBuffer, length + 2));
+    }
+}
+
+// The decoder folds the frame chunk by chunk, the result does not depend on where the chunks end
+static void TestSplitDoesNotMatter(void) {
+    size_t const length = TEST_MAX_LENGTH;
+    TestFillRandom(testBuffer, length);
+    uint16_t whole = EMBENET_BRT_CRC_Update(TEST_CRC_INIT, testBuffer, length);
+    for (size_t first = 0; first <= length; ++first) {
+        for (size_t second = first; second <= length; second += 7) {
+            uint16_t crc = EMBENET_BRT_CRC_Update(TEST_CRC_INIT, testBuffer, first);
+            crc          = EMBENET_BRT_CRC_Update(crc, testBuffer + first, second - first);
+            crc          = EMBENET_BRT_CRC_Update(crc, testBuffer + second, length - second);
+            TEST_CHECK(whole == crc);
+        }
+    }
+}
+
+// Returns the time of folding a frame of the given length in ns per byte, with the kernel or the bytewise lookup
+static double TestBenchmark(size_t length, bool kernel) {
+    volatile uint16_t sink  = 0;
+    unsigned          runs  = 0;
+    double            start = TestNow();
+    double            end   = start + TEST_BENCH_MS * 1e6;
+    double            now   = start;
+    while (now < end) {
+        for (unsigned i = 0; i < 100; ++i) {
+            sink = kernel ? EMBENET_BRT_CRC_Update(sink, testBuffer, length) : TestCrcBytewise(sink, testBuffer, length);
+        }
+        runs += 100;
+        now = TestNow();
+    }
+    (void)sink;
+    return (now - start) / ((double)runs * (double)length);
+}
+
+// Prints the cost of the kernel and of the bytewise lookup for short, typical and the longest frames of the link
+static void TestThroughput(void) {
+    static size_t const lengths[] = {8, 64, 256};
+    TestFillRandom(testBuffer, TEST_MAX_LENGTH);
+    printf("EMBENET_BRT_CRC_SLICES %d\n", EMBENET_BRT_CRC_SLICES);
+    printf("| length [B] | bytewise [ns/B] | kernel [ns/B] | speedup |\n");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        double bytewise = TestBenchmark(lengths[i], false);
+        double kernel   = TestBenchmark(lengths[i], true);
+        printf("| %10zu | %15.2f | %13.2f | %7.2f |\n", lengths[i], bytewise, kernel, bytewise / kernel);
+    }
+}
+
+int main(void) {
+    TestInitTable();
+    TEST_RUN(TestKnownValues);
+    TEST_RUN(TestRandomFramesMatchBytewise);
+    TEST_RUN(TestFrameWithCrcLeavesResidue);
+    TEST_RUN(TestSplitDoesNotMatter);
+    TEST_RUN(TestThroughput);
+    return TEST_RESULT();
+}
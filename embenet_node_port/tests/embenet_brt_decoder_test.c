@@ -0,0 +1,271 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Decoder of the border router link fed with byte streams over a pseudo terminal, with the cost of decoding a recorded stream
+*/
+
+#define _DEFAULT_SOURCE // usleep
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_uart.h"
+
+#include <embenet_brt.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+enum {
+    TEST_MAX_FRAME     = 256, ///< Longest frame accepted by the port
+    TEST_TOO_LONG      = 300, ///< Frame dropped by the port for its length
+    TEST_QUEUE_LENGTH  = 4,   ///< Decoded frames that may wait for EMBENET_BRT_Receive
+    TEST_POLL_US       = 100, ///< Real time between two checks of the pseudo terminal
+    TEST_POLLS         = 10000,
+    TEST_STREAM_FRAMES = 4000, ///< Frames of the recorded stream
+    TEST_STREAM_BLOCK  = 2048, ///< Bytes written to the pseudo terminal at once, below the size of its buffer
+
+    HDLC_FLAG   = 0x7e,
+    HDLC_ESCAPE = 0x7d,
+};
+
+static uint8_t  testStream[TEST_STREAM_BLOCK + 2 * (TEST_MAX_FRAME + 2) + 2];
+static uint32_t testRandom = 12345;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static double TestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// CRC-16/X.25 computed bit by bit, as sent after the data
+static uint16_t TestCrc(uint8_t const* data, size_t length) {
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+        }
+    }
+    return (uint16_t)~crc;
+}
+
+static size_t TestEscape(uint8_t* out, uint8_t byte) {
+    if ((HDLC_FLAG == byte) || (HDLC_ESCAPE == byte)) {
+        out[0] = HDLC_ESCAPE;
+        out[1] = byte ^ 0x20;
+        return 2;
+    }
+    out[0] = byte;
+    return 1;
+}
+
+// Encodes a frame between two flags, as the border router does, returns the number of bytes written to out
+static size_t TestEncode(uint8_t* out, uint8_t const* data, size_t length, bool corrupt) {
+    size_t   size = 0;
+    uint16_t crc  = TestCrc(data, length) ^ (corrupt ? 0x0001 : 0x0000);
+    out[size++]   = HDLC_FLAG;
+    for (size_t i = 0; i < length; ++i) {
+        size += TestEscape(out + size, data[i]);
+    }
+    size += TestEscape(out + size, (uint8_t)(crc >> 0));
+    size += TestEscape(out + size, (uint8_t)(crc >> 8));
+    out[size++] = HDLC_FLAG;
+    return size;
+}
+
+// Frame content depending on its sequence number, every byte value including flags and escapes appears across frames
+static void TestFill(uint8_t* data, size_t length, uint8_t sequence) {
+    data[0] = sequence;
+    for (size_t i = 1; i < length; ++i) {
+        data[i] = (uint8_t)(sequence + i * 37);
+    }
+}
+
+static bool TestIsFrame(uint8_t const* frame, size_t frameLength, size_t length, uint8_t sequence) {
+    uint8_t expected[TEST_MAX_FRAME];
+    TestFill(expected, length, sequence);
+    return (length == frameLength) && (0 == memcmp(frame, expected, length));
+}
+
+// Writes bytes to the master side, as the border router does, and waits until all of them can be read by the port
+static void TestPeerSend(uint8_t const* data, size_t size) {
+    size_t pending = SIM_UART_GetPending();
+    TEST_CHECK(write(SIM_UART_GetPeer(), data, size) == (ssize_t)size);
+    for (unsigned i = 0; (i < TEST_POLLS) && (SIM_UART_GetPending() != pending + size); ++i) {
+        usleep(TEST_POLL_US);
+    }
+    TEST_CHECK(SIM_UART_GetPending() == pending + size);
+}
+
+static void TestPeerSendFrame(uint8_t const* data, size_t length, bool corrupt) {
+    uint8_t frame[2 * (TEST_TOO_LONG + 2) + 2];
+    TestPeerSend(frame, TestEncode(frame, data, length, corrupt));
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_UART_Reset();
+    EMBENET_BRT_Init();
+}
+
+// Several frames fetched with a single read are all decoded and queued, then returned one per call in the order of arrival
+static void TestBurstIsDecodedFromOneRead(void) {
+    enum { BURST = TEST_QUEUE_LENGTH + 2, LENGTH = 8 };
+    uint8_t stream[BURST * (2 * (LENGTH + 2) + 2)];
+    size_t  size = 0;
+    TestInit();
+
+    for (uint8_t sequence = 0; sequence < BURST; ++sequence) {
+        uint8_t data[LENGTH];
+        TestFill(data, sizeof(data), sequence);
+        size += TestEncode(stream + size, data, sizeof(data), false);
+    }
+    TEST_CHECK(size <= 128); // fits a single chunk of the decoder
+    TestPeerSend(stream, size);
+
+    for (uint8_t sequence = 0; sequence < BURST; ++sequence) {
+        uint8_t frame[TEST_MAX_FRAME];
+        size_t  length = EMBENET_BRT_Receive(frame, sizeof(frame));
+        TEST_CHECK(TestIsFrame(frame, length, LENGTH, sequence));
+        TEST_CHECK(0 == SIM_UART_GetPending());
+        TEST_CHECK(1 == SIM_UART_GetReadCount());
+    }
+    uint8_t frame[TEST_MAX_FRAME];
+    TEST_CHECK(0 == EMBENET_BRT_Receive(frame, sizeof(frame)));
+}
+
+// A frame arriving in two parts is decoded whatever the split, including inside an escape sequence, the CRC or a chunk boundary of the decoder
+static void TestFrameSplitAnywhere(void) {
+    uint8_t data[200];
+    uint8_t encoded[2 * (sizeof(data) + 2) + 2];
+    TestFill(data, sizeof(data), HDLC_FLAG);
+    size_t size = TestEncode(encoded, data, sizeof(data), false);
+    TestInit();
+
+    for (size_t split = 1; split < size; ++split) {
+        uint8_t frame[TEST_MAX_FRAME];
+        TestPeerSend(encoded, split);
+        TEST_CHECK(0 == EMBENET_BRT_Receive(frame, sizeof(frame)));
+        TestPeerSend(encoded + split, size - split);
+        TEST_CHECK(TestIsFrame(frame, EMBENET_BRT_Receive(frame, sizeof(frame)), sizeof(data), HDLC_FLAG));
+    }
+}
+
+// Noise, frames with invalid CRC, too short and too long frames are dropped without affecting the frames around them
+static void TestInvalidFramesAreDropped(void) {
+    static uint8_t const noise[]    = {0x01, 0x02, HDLC_ESCAPE, 0x03};
+    static uint8_t const tooShort[] = {HDLC_FLAG, 0x01, 0x02, HDLC_FLAG};
+    static uint8_t const flags[]    = {HDLC_FLAG, HDLC_FLAG, HDLC_FLAG};
+    uint8_t              data[TEST_TOO_LONG];
+    uint8_t              frame[TEST_MAX_FRAME];
+    TestInit();
+
+    TestPeerSend(noise, sizeof(noise));
+    TestFill(data, 10, 1);
+    TestPeerSendFrame(data, 10, false);
+    TestFill(data, 10, 2);
+    TestPeerSendFrame(data, 10, true);
+    TestPeerSend(tooShort, sizeof(tooShort));
+    TestPeerSend(flags, sizeof(flags));
+    TestFill(data, sizeof(data), 3);
+    TestPeerSendFrame(data, sizeof(data), false);
+    TestFill(data, TEST_MAX_FRAME - 2, 4); // the longest frame, its CRC fills the buffer of the decoder
+    TestPeerSendFrame(data, TEST_MAX_FRAME - 2, false);
+
+    TEST_CHECK(TestIsFrame(frame, EMBENET_BRT_Receive(frame, sizeof(frame)), 10, 1));
+    TEST_CHECK(TestIsFrame(frame, EMBENET_BRT_Receive(frame, sizeof(frame)), TEST_MAX_FRAME - 2, 4));
+    TEST_CHECK(0 == EMBENET_BRT_Receive(frame, sizeof(frame)));
+}
+
+// With the queue full the decoder stops reading, the following frames wait in UART instead of being dropped
+static void TestFullQueueLeavesBytesInUart(void) {
+    enum { COUNT = 3 * TEST_QUEUE_LENGTH, LENGTH = 100 };
+    uint8_t data[LENGTH];
+    uint8_t frame[TEST_MAX_FRAME];
+    TestInit();
+
+    for (uint8_t sequence = 0; sequence < COUNT; ++sequence) {
+        TestFill(data, sizeof(data), sequence);
+        TestPeerSendFrame(data, sizeof(data), false);
+    }
+    TEST_CHECK(TestIsFrame(frame, EMBENET_BRT_Receive(frame, sizeof(frame)), LENGTH, 0));
+    TEST_CHECK(SIM_UART_GetPending() > (COUNT - TEST_QUEUE_LENGTH - 1) * LENGTH);
+    for (uint8_t sequence = 1; sequence < COUNT; ++sequence) {
+        TEST_CHECK(TestIsFrame(frame, EMBENET_BRT_Receive(frame, sizeof(frame)), LENGTH, sequence));
+    }
+    TEST_CHECK(0 == SIM_UART_GetPending());
+    TEST_CHECK(0 == EMBENET_BRT_Receive(frame, sizeof(frame)));
+}
+
+// Decodes a recorded downlink stream of frames with random lengths and prints the cost per byte and the frames per second.
+// Only the time spent in EMBENET_BRT_Receive is measured, including the reads from the pseudo terminal.
+static void TestRecordedStreamThroughput(void) {
+    uint8_t  data[TEST_MAX_FRAME];
+    uint8_t  frame[TEST_MAX_FRAME];
+    size_t   lengths[TEST_STREAM_BLOCK];
+    double   receiveNs = 0;
+    uint64_t bytes     = 0;
+    unsigned frames    = 0;
+    TestInit();
+
+    for (unsigned sent = 0; sent < TEST_STREAM_FRAMES;) {
+        // The stream is written block by block, the pseudo terminal buffers a few kilobytes only
+        size_t   size  = 0;
+        unsigned first = sent;
+        while ((size < TEST_STREAM_BLOCK) && (sent < TEST_STREAM_FRAMES)) {
+            size_t length         = 3 + TestRandom() % (TEST_MAX_FRAME - 4);
+            lengths[sent - first] = length;
+            TestFill(data, length, (uint8_t)sent);
+            size += TestEncode(testStream + size, data, length, false);
+            ++sent;
+        }
+        TestPeerSend(testStream, size);
+        bytes += size;
+
+        for (unsigned received = first; received < sent;) {
+            double start  = TestNow();
+            size_t length = EMBENET_BRT_Receive(frame, sizeof(frame));
+            receiveNs += TestNow() - start;
+            TEST_CHECK(0 != length);
+            if (0 == length) {
+                return;
+            }
+            TEST_CHECK(TestIsFrame(frame, length, lengths[received - first], (uint8_t)received));
+            ++received;
+            ++frames;
+        }
+    }
+    TEST_CHECK(TEST_STREAM_FRAMES == frames);
+    TEST_CHECK(SIM_UART_GetReadCount() <= bytes / 128 + TEST_STREAM_FRAMES / 8); // bulk reads, not one per byte or per frame
+
+    printf("| frames | bytes   | reads | receive [ms] | per byte [ns] | frames/s |\n");
+    printf("| %6u | %7llu | %5u | %12.3f | %13.1f | %8.0f |\n", frames, (unsigned long long)bytes, SIM_UART_GetReadCount(), receiveNs / 1e6,
+           receiveNs / (double)bytes, (double)frames * 1e9 / receiveNs);
+}
+
+int main(void) {
+    TEST_RUN(TestBurstIsDecodedFromOneRead);
+    TEST_RUN(TestFrameSplitAnywhere);
+    TEST_RUN(TestInvalidFramesAreDropped);
+    TEST_RUN(TestFullQueueLeavesBytesInUart);
+    TEST_RUN(TestRecordedStreamThroughput);
+    return TEST_RESULT();
+}
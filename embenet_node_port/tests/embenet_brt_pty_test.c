@@ -0,0 +1,330 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Border router link over a pseudo terminal, the test plays the border router on its master side
+*/
+
+#define _DEFAULT_SOURCE // usleep
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_uart.h"
+
+#include <embenet_brt_cc1312.h>
+
+#include <poll.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+    TEST_MAX_FRAME     = 256,
+    TEST_TIMEOUT_MS    = 1000,     ///< Time the pseudo terminal is given to pass bytes to the other side
+    TEST_POLL_US       = 1000,     ///< Real time between two polls of the receiver
+    TEST_POLLS         = 1000,     ///< Number of polls before a frame is considered lost
+    TEST_POLL_NS       = 100000,   ///< Simulated time between two polls of the receiver
+    TEST_DRAIN_NS      = 50000000, ///< Enough for UART to shift out the longest frame at the default baud rate
+    TEST_RAISED_BAUD   = 921600,
+    TEST_DEFAULT_BAUD  = 115200,
+    TEST_WINDOW        = 32, ///< Frames over which the port counts CRC errors
+    TEST_FALLBACK_EACH = 8,  ///< Every n-th frame of the window is corrupted, enough to make the link fall back
+
+    HDLC_FLAG      = 0x7e,
+    HDLC_ESCAPE    = 0x7d,
+    CONTROL_MARKER = 0x00,
+
+    CONTROL_BAUD_REQUEST  = 0x01,
+    CONTROL_BAUD_ACCEPT   = 0x02,
+    CONTROL_BAUD_FALLBACK = 0x04,
+};
+
+/// Decoder of the border router, written independently of the port
+static struct {
+    uint8_t data[TEST_MAX_FRAME + 2];
+    size_t  length;
+    bool    receiving;
+    bool    escape;
+    bool    control;
+} testPeer;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+// CRC-16/X.25 computed bit by bit, as sent after the data
+static uint16_t TestCrc(uint8_t const* data, size_t length) {
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= data[i];
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+        }
+    }
+    return (uint16_t)~crc;
+}
+
+static size_t TestEscape(uint8_t* out, uint8_t byte) {
+    if ((HDLC_FLAG == byte) || (HDLC_ESCAPE == byte)) {
+        out[0] = HDLC_ESCAPE;
+        out[1] = byte ^ 0x20;
+        return 2;
+    }
+    out[0] = byte;
+    return 1;
+}
+
+// Writes a frame to the master side, as the border router does
+static void TestPeerWrite(bool control, uint8_t const* data, size_t length, bool corrupt) {
+    uint8_t  frame[2 * (TEST_MAX_FRAME + 2) + 4];
+    size_t   size = 0;
+    uint16_t crc  = TestCrc(data, length) ^ (corrupt ? 0x0001 : 0x0000);
+
+    frame[size++] = HDLC_FLAG;
+    if (control) {
+        frame[size++] = HDLC_ESCAPE;
+        frame[size++] = CONTROL_MARKER;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        size += TestEscape(frame + size, data[i]);
+    }
+    size += TestEscape(frame + size, (uint8_t)(crc >> 0));
+    size += TestEscape(frame + size, (uint8_t)(crc >> 8));
+    frame[size++] = HDLC_FLAG;
+    TEST_CHECK(write(SIM_UART_GetPeer(), frame, size) == (ssize_t)size);
+}
+
+static void TestPeerWriteControl(uint8_t command, uint32_t baudRate) {
+    uint8_t const frame[] = {command, (uint8_t)(baudRate >> 0), (uint8_t)(baudRate >> 8), (uint8_t)(baudRate >> 16), (uint8_t)(baudRate >> 24)};
+    TestPeerWrite(true, frame, sizeof(frame), false);
+}
+
+// Reads the master side until a frame with a valid CRC is decoded, returns its length or -1 if none arrives in time
+static int TestPeerRead(uint8_t* data, bool* control) {
+    struct pollfd peer = {.fd = SIM_UART_GetPeer(), .events = POLLIN};
+    uint8_t       byte;
+    while ((1 == poll(&peer, 1, TEST_TIMEOUT_MS)) && (1 == read(peer.fd, &byte, 1))) {
+        if (HDLC_FLAG == byte) {
+            if (testPeer.receiving && (testPeer.length > 2)) {
+                size_t   length = testPeer.length - 2;
+                uint16_t crc    = (uint16_t)(testPeer.data[length] | (testPeer.data[length + 1] << 8));
+                if (crc == TestCrc(testPeer.data, length)) {
+                    memcpy(data, testPeer.data, length);
+                    *control           = testPeer.control;
+                    testPeer.receiving = false;
+                    return (int)length;
+                }
+            }
+            testPeer.receiving = true;
+            testPeer.length    = 0;
+            testPeer.escape    = false;
+            testPeer.control   = false;
+        } else if (!testPeer.receiving || (testPeer.length == sizeof(testPeer.data))) {
+            testPeer.receiving = false;
+        } else if (HDLC_ESCAPE == byte) {
+            testPeer.escape = true;
+        } else if (testPeer.escape) {
+            testPeer.escape = false;
+            if ((0 == testPeer.length) && (CONTROL_MARKER == byte)) {
+                testPeer.control = true;
+            } else {
+                testPeer.data[testPeer.length++] = byte ^ 0x20;
+            }
+        } else {
+            testPeer.data[testPeer.length++] = byte;
+        }
+    }
+    return -1;
+}
+
+// Lets UART shift out the queued frames, they reach the master side
+static void TestDrain(void) {
+    SIM_Advance(TEST_DRAIN_NS);
+    TEST_CHECK(!EMBENET_BRT_IsBusy());
+}
+
+// Polls the port until it returns a frame, the pseudo terminal passes the bytes asynchronously
+static size_t TestReceive(uint8_t* buffer, size_t size) {
+    for (unsigned i = 0; i < TEST_POLLS; ++i) {
+        size_t length = EMBENET_BRT_Receive(buffer, size);
+        if (0 != length) {
+            return length;
+        }
+        usleep(TEST_POLL_US);
+    }
+    return 0;
+}
+
+// Polls the port until the link uses the given baud rate, no frame may reach the stack meanwhile
+static bool TestWaitForBaudRate(uint32_t baudRate) {
+    for (unsigned i = 0; (i < TEST_POLLS) && (baudRate != EMBENET_BRT_GetBaudRate()); ++i) {
+        uint8_t buffer[TEST_MAX_FRAME];
+        TEST_CHECK(0 == EMBENET_BRT_Receive(buffer, sizeof(buffer)));
+        SIM_Advance(TEST_POLL_NS);
+        usleep(TEST_POLL_US);
+    }
+    return (baudRate == EMBENET_BRT_GetBaudRate()) && (baudRate == SIM_UART_GetBaudRate());
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_UART_Reset();
+    memset(&testPeer, 0, sizeof(testPeer));
+    EMBENET_BRT_Init();
+}
+
+// Raises the baud rate of the link, as agreed with the border router
+static void TestSwitchTo(uint32_t baudRate) {
+    uint8_t frame[TEST_MAX_FRAME];
+    bool    control = false;
+    TEST_CHECK(EMBENET_BRT_RequestBaudRate(baudRate));
+    TestDrain();
+    TEST_CHECK(5 == TestPeerRead(frame, &control));
+    TEST_CHECK(control && (CONTROL_BAUD_REQUEST == frame[0]));
+    TestPeerWriteControl(CONTROL_BAUD_ACCEPT, baudRate);
+    TEST_CHECK(TestWaitForBaudRate(baudRate));
+}
+
+// Frames of the stack pass unchanged in both directions, whatever they contain, including the layout of the former control frames
+static void TestStackFramesPassThrough(void) {
+    static uint8_t const frames[][6] = {
+        {0xff, CONTROL_BAUD_ACCEPT, 0x00, 0x10, 0x0e, 0x00}, // ID 0xff followed by an accepted 921600
+        {0xff, CONTROL_BAUD_FALLBACK, 0x00, 0xc2, 0x01, 0x00},
+        {HDLC_ESCAPE, CONTROL_MARKER, HDLC_FLAG, HDLC_ESCAPE, 0x20, 0x5e},
+        {CONTROL_MARKER, CONTROL_BAUD_REQUEST, 0x00, 0x10, 0x0e, 0x00},
+    };
+    TestInit();
+
+    for (size_t i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i) {
+        uint8_t frame[TEST_MAX_FRAME];
+        bool    control = true;
+
+        TestPeerWrite(false, frames[i], sizeof(frames[i]), false);
+        TEST_CHECK(sizeof(frames[i]) == TestReceive(frame, sizeof(frame)));
+        TEST_CHECK(0 == memcmp(frame, frames[i], sizeof(frames[i])));
+
+        EMBENET_BRT_Send(frames[i], sizeof(frames[i]));
+        TestDrain();
+        TEST_CHECK((int)sizeof(frames[i]) == TestPeerRead(frame, &control));
+        TEST_CHECK(0 == memcmp(frame, frames[i], sizeof(frames[i])));
+        TEST_CHECK(!control);
+    }
+    TEST_CHECK(TEST_DEFAULT_BAUD == EMBENET_BRT_GetBaudRate());
+    TEST_CHECK(1 == SIM_UART_GetOpenCount());
+}
+
+// The link switches once the border router accepts the request and keeps passing frames at the new baud rate
+static void TestBaudRateSwitch(void) {
+    static uint8_t const payload[] = {0x01, 0x7e, 0x02, 0x7d, 0x03};
+    uint8_t              frame[TEST_MAX_FRAME];
+    bool                 control = true;
+    TestInit();
+
+    TEST_CHECK(!EMBENET_BRT_RequestBaudRate(TEST_DEFAULT_BAUD - 1));
+    TEST_CHECK(!EMBENET_BRT_RequestBaudRate(4000000));
+    TEST_CHECK(EMBENET_BRT_RequestBaudRate(TEST_RAISED_BAUD));
+    TestDrain();
+    TEST_CHECK(5 == TestPeerRead(frame, &control));
+    TEST_CHECK(control);
+    TEST_CHECK(CONTROL_BAUD_REQUEST == frame[0]);
+    TEST_CHECK(TEST_RAISED_BAUD == (frame[1] | (frame[2] << 8) | (frame[3] << 16) | ((uint32_t)frame[4] << 24)));
+
+    TestPeerWriteControl(CONTROL_BAUD_ACCEPT, TEST_RAISED_BAUD);
+    TEST_CHECK(TestWaitForBaudRate(TEST_RAISED_BAUD));
+    TEST_CHECK(2 == SIM_UART_GetOpenCount());
+
+    TestPeerWrite(false, payload, sizeof(payload), false);
+    TEST_CHECK(sizeof(payload) == TestReceive(frame, sizeof(frame)));
+    TEST_CHECK(0 == memcmp(frame, payload, sizeof(payload)));
+    EMBENET_BRT_Send(payload, sizeof(payload));
+    TestDrain();
+    TEST_CHECK((int)sizeof(payload) == TestPeerRead(frame, &control));
+    TEST_CHECK(!control && (0 == memcmp(frame, payload, sizeof(payload))));
+}
+
+// A frame still shifted out when the border router accepts is completed at the old baud rate, the receiver does not wait for it
+static void TestSwitchWaitsForQueuedFrame(void) {
+    uint8_t payload[200];
+    uint8_t frame[TEST_MAX_FRAME];
+    bool    control = true;
+    TestInit();
+
+    TEST_CHECK(EMBENET_BRT_RequestBaudRate(TEST_RAISED_BAUD));
+    TestDrain();
+    TEST_CHECK(5 == TestPeerRead(frame, &control));
+
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = (uint8_t)(i * 7);
+    }
+    EMBENET_BRT_Send(payload, sizeof(payload)); // about 18ms at the default baud rate
+    TestPeerWriteControl(CONTROL_BAUD_ACCEPT, TEST_RAISED_BAUD);
+
+    uint64_t start = SIM_Now();
+    for (unsigned i = 0; i < 50; ++i) {
+        TEST_CHECK(0 == EMBENET_BRT_Receive(frame, sizeof(frame)));
+        usleep(TEST_POLL_US);
+    }
+    TEST_CHECK_RANGE(SIM_Now() - start, 0, 100000);
+    TEST_CHECK(EMBENET_BRT_IsBusy());
+    TEST_CHECK(TEST_DEFAULT_BAUD == EMBENET_BRT_GetBaudRate());
+
+    TEST_CHECK(TestWaitForBaudRate(TEST_RAISED_BAUD));
+    TEST_CHECK((int)sizeof(payload) == TestPeerRead(frame, &control));
+    TEST_CHECK(!control && (0 == memcmp(frame, payload, sizeof(payload))));
+}
+
+// Corrupted frames at the raised baud rate make the port tell the border router and return to the default baud rate
+static void TestFallbackNotifiesPeer(void) {
+    uint8_t frame[TEST_MAX_FRAME];
+    bool    control = false;
+    TestInit();
+    TestSwitchTo(TEST_RAISED_BAUD);
+
+    for (unsigned i = 0; i < TEST_WINDOW; ++i) {
+        uint8_t const payload[] = {0x10, (uint8_t)i};
+        bool          corrupt   = (TEST_FALLBACK_EACH - 1) == (i % TEST_FALLBACK_EACH);
+        TestPeerWrite(false, payload, sizeof(payload), corrupt);
+        if (!corrupt) {
+            TEST_CHECK(sizeof(payload) == TestReceive(frame, sizeof(frame)));
+            TEST_CHECK(i == frame[1]);
+        }
+    }
+    TEST_CHECK(TestWaitForBaudRate(TEST_DEFAULT_BAUD));
+
+    TEST_CHECK(5 == TestPeerRead(frame, &control));
+    TEST_CHECK(control);
+    TEST_CHECK(CONTROL_BAUD_FALLBACK == frame[0]);
+    TEST_CHECK(TEST_DEFAULT_BAUD == (frame[1] | (frame[2] << 8) | (frame[3] << 16) | ((uint32_t)frame[4] << 24)));
+}
+
+// The border router may fall back on its own, unknown control frames are dropped
+static void TestPeerFallback(void) {
+    static uint8_t const unknown[] = {0x55};
+    static uint8_t const payload[] = {0x20, 0x21};
+    uint8_t              frame[TEST_MAX_FRAME];
+    TestInit();
+    TestSwitchTo(TEST_RAISED_BAUD);
+
+    TestPeerWriteControl(CONTROL_BAUD_FALLBACK, TEST_DEFAULT_BAUD);
+    TEST_CHECK(TestWaitForBaudRate(TEST_DEFAULT_BAUD));
+    TEST_CHECK(3 == SIM_UART_GetOpenCount());
+
+    TestPeerWrite(true, unknown, sizeof(unknown), false);
+    TestPeerWrite(false, payload, sizeof(payload), false);
+    TEST_CHECK(sizeof(payload) == TestReceive(frame, sizeof(frame)));
+    TEST_CHECK(0 == memcmp(frame, payload, sizeof(payload)));
+    TEST_CHECK(TEST_DEFAULT_BAUD == EMBENET_BRT_GetBaudRate());
+}
+
+int main(void) {
+    TEST_RUN(TestStackFramesPassThrough);
+    TEST_RUN(TestBaudRateSwitch);
+    TEST_RUN(TestSwitchWaitsForQueuedFrame);
+    TEST_RUN(TestFallbackNotifiesPeer);
+    TEST_RUN(TestPeerFallback);
+    return TEST_RESULT();
+}
@@ -0,0 +1,190 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Scatter-gather send of the border router link, checked against the single buffer send, with the cost of forwarding a packet either way
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_uart.h"
+
+#include <embenet_brt_cc1312.h>
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+enum {
+    TEST_MAX_FRAME     = 256,
+    TEST_MAX_ENCODED   = 2 * (TEST_MAX_FRAME + 2) + 2, ///< Every data and CRC byte escaped, plus two flags
+    TEST_MAX_SEGMENTS  = 4,
+    TEST_FRAMES        = 500,      ///< Random frames sent both ways and compared
+    TEST_TIMEOUT_MS    = 1000,     ///< Time the pseudo terminal is given to pass bytes to the other side
+    TEST_DRAIN_NS      = 50000000, ///< Enough for UART to shift out the longest frame at the default baud rate
+    TEST_ID_LENGTH     = 1,        ///< Packet ID preceding every packet of the link
+    TEST_HEADER_LENGTH = 40,       ///< IPv6 header the root puts in front of the forwarded payload
+    TEST_BENCH_PACKETS = 2000,     ///< Packets forwarded per benchmark measurement
+    TEST_BENCH_REPEATS = 3,        ///< Every measurement is repeated, the fastest run is taken
+
+    HDLC_FLAG   = 0x7e,
+    HDLC_ESCAPE = 0x7d,
+};
+
+/// Cost of forwarding a packet
+typedef struct {
+    double sendNs;      ///< Fastest host wall-clock time of a send in ns
+    size_t copiedBytes; ///< Bytes copied per packet before the packet reaches the encoder
+} TestCost;
+
+static uint8_t  testData[TEST_MAX_FRAME];
+static uint8_t  testPacket[TEST_MAX_FRAME];
+static uint32_t testRandom = 12345;
+static size_t   testCopiedBytes; ///< Bytes copied with TestCopy
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static double TestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Random bytes, with flags and escapes frequent enough for every segment boundary to meet them
+static void TestFillRandom(uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        uint32_t random = TestRandom();
+        data[i]         = ((random & 0x700) == 0) ? HDLC_FLAG : ((random & 0x700) == 0x100) ? HDLC_ESCAPE : (uint8_t)random;
+    }
+}
+
+static void TestCopy(uint8_t* destination, uint8_t const* source, size_t length) {
+    memcpy(destination, source, length);
+    testCopiedBytes += length;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_UART_Reset();
+    EMBENET_BRT_Init();
+}
+
+// Lets UART shift out the queued frame and reads it from the master side as it was sent, flags and escapes included.
+// Returns the number of bytes, 0 if the frame did not arrive in time
+static size_t TestPeerReadEncoded(uint8_t* data, size_t size) {
+    SIM_Advance(TEST_DRAIN_NS);
+    TEST_CHECK(!EMBENET_BRT_IsBusy());
+
+    struct pollfd peer   = {.fd = SIM_UART_GetPeer(), .events = POLLIN};
+    size_t        length = 0;
+    unsigned      flags  = 0;
+    while ((flags < 2) && (length < size) && (1 == poll(&peer, 1, TEST_TIMEOUT_MS))) {
+        ssize_t result = read(peer.fd, data + length, size - length);
+        if (result <= 0) {
+            return 0;
+        }
+        for (size_t i = length; i < length + (size_t)result; ++i) {
+            flags += (HDLC_FLAG == data[i]) ? 1 : 0;
+        }
+        length += (size_t)result;
+    }
+    return (2 == flags) ? length : 0;
+}
+
+// A packet scattered over segments is sent exactly as the same packet in a single buffer, whatever the segment boundaries
+static void TestSegmentsMatchSend(void) {
+    uint8_t scattered[TEST_MAX_ENCODED];
+    uint8_t gathered[TEST_MAX_ENCODED];
+    TestInit();
+
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        EMBENET_BRT_Segment segments[TEST_MAX_SEGMENTS];
+        size_t              segmentCount = TestRandom() % (TEST_MAX_SEGMENTS + 1);
+        size_t              length       = 0;
+        for (size_t s = 0; s < segmentCount; ++s) {
+            size_t segmentLength = TestRandom() % (TEST_MAX_FRAME / TEST_MAX_SEGMENTS + 1); // empty segments included
+            segments[s].data     = testData + length;
+            segments[s].length   = segmentLength;
+            length += segmentLength;
+        }
+        TestFillRandom(testData, length);
+
+        EMBENET_BRT_SendV(segments, segmentCount);
+        size_t scatteredLength = TestPeerReadEncoded(scattered, sizeof(scattered));
+        EMBENET_BRT_Send(testData, length);
+        size_t gatheredLength = TestPeerReadEncoded(gathered, sizeof(gathered));
+        TEST_CHECK((0 != gatheredLength) && (scatteredLength == gatheredLength) && (0 == memcmp(scattered, gathered, gatheredLength)));
+        if ((scatteredLength != gatheredLength) || (0 != memcmp(scattered, gathered, gatheredLength))) {
+            return;
+        }
+    }
+}
+
+// Forwards packets made of the packet ID, the header and the payload, kept in separate buffers as on the root, either gathering them into one
+// buffer for EMBENET_BRT_Send or passing the segments to EMBENET_BRT_SendV. Returns the fastest time per packet and the bytes copied per packet
+static TestCost TestBenchmark(size_t payloadLength, bool scatter) {
+    static uint8_t const id[TEST_ID_LENGTH] = {0x01};
+    uint8_t              header[TEST_HEADER_LENGTH];
+    uint8_t              payload[TEST_MAX_FRAME];
+    uint8_t              encoded[TEST_MAX_ENCODED];
+    TestFillRandom(header, sizeof(header));
+    TestFillRandom(payload, payloadLength);
+    EMBENET_BRT_Segment const segments[] = {{.data = id, .length = sizeof(id)}, {.data = header, .length = sizeof(header)}, {.data = payload, .length = payloadLength}};
+
+    double best     = 0;
+    testCopiedBytes = 0;
+    for (unsigned repeat = 0; repeat < TEST_BENCH_REPEATS; ++repeat) {
+        double sendNs = 0;
+        for (unsigned i = 0; i < TEST_BENCH_PACKETS; ++i) {
+            double start = TestNow();
+            if (scatter) {
+                EMBENET_BRT_SendV(segments, sizeof(segments) / sizeof(segments[0]));
+            } else {
+                TestCopy(testPacket, id, sizeof(id));
+                TestCopy(testPacket + sizeof(id), header, sizeof(header));
+                TestCopy(testPacket + sizeof(id) + sizeof(header), payload, payloadLength);
+                EMBENET_BRT_Send(testPacket, sizeof(id) + sizeof(header) + payloadLength);
+            }
+            sendNs += TestNow() - start;
+            TEST_CHECK(0 != TestPeerReadEncoded(encoded, sizeof(encoded)));
+        }
+        best = ((0 == repeat) || (sendNs < best)) ? sendNs : best;
+    }
+    return (TestCost){.sendNs = best / TEST_BENCH_PACKETS, .copiedBytes = testCopiedBytes / (TEST_BENCH_REPEATS * TEST_BENCH_PACKETS)};
+}
+
+// Prints the cost of forwarding short, typical and the longest packets of the link, in host wall-clock time, and the bytes copied before the
+// packet reaches the encoder, counted as they are copied
+static void TestForwardingCost(void) {
+    static size_t const payloadLengths[] = {16, 80, TEST_MAX_FRAME - TEST_ID_LENGTH - TEST_HEADER_LENGTH};
+    TestInit();
+    printf("| payload [B] | gathered [host ns] | copied [B] | scattered [host ns] | copied [B] | speedup |\n");
+    for (size_t i = 0; i < sizeof(payloadLengths) / sizeof(payloadLengths[0]); ++i) {
+        TestCost gathered  = TestBenchmark(payloadLengths[i], false);
+        TestCost scattered = TestBenchmark(payloadLengths[i], true);
+        TEST_CHECK(gathered.copiedBytes == TEST_ID_LENGTH + TEST_HEADER_LENGTH + payloadLengths[i]);
+        TEST_CHECK(0 == scattered.copiedBytes);
+        printf("| %11zu | %18.1f | %10zu | %19.1f | %10zu | %7.2f |\n", payloadLengths[i], gathered.sendNs, gathered.copiedBytes, scattered.sendNs,
+               scattered.copiedBytes, gathered.sendNs / scattered.sendNs);
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestSegmentsMatchSend);
+    TEST_RUN(TestForwardingCost);
+    return TEST_RESULT();
+}
@@ -0,0 +1,211 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     UART2 driver calls and throughput of the border router link, with frames staged in buffers and written one byte per call as before
+*/
+
+#include "embenet_brt_crc.h"
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_uart.h"
+
+#include <embenet_brt_cc1312.h>
+#include <ti/drivers/UART2.h>
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+enum {
+    TEST_MAX_FRAME   = 256,
+    TEST_MAX_ENCODED = 2 * (TEST_MAX_FRAME + 2) + 2, ///< Every data and CRC byte escaped, plus two flags
+    TEST_FRAMES      = 200,                          ///< Frames sent per measurement
+    TEST_TIMEOUT_MS  = 1000,                         ///< Time the pseudo terminal is given to pass bytes to the other side
+    TEST_BAUD_RATE   = 115200,                       ///< Baud rate of the link after initialization
+    TEST_UART_INDEX  = 0,
+    TEST_NS_PER_S    = 1000000000,
+
+    HDLC_FLAG        = 0x7e,
+    HDLC_ESCAPE      = 0x7d,
+    HDLC_ESCAPE_MASK = 0x20,
+    HDLC_CRCINIT     = 0xffff,
+};
+
+/// Cost of sending TEST_FRAMES frames
+typedef struct {
+    unsigned writes; ///< UART2_write calls
+    size_t   bytes;  ///< Bytes passed to UART2_write, flags and escapes included
+    uint64_t heldNs; ///< Simulated time the caller spent in the send functions
+    uint64_t lineNs; ///< Simulated time from the start of every frame until its last byte was shifted out
+} TestCost;
+
+static uint8_t       testFrame[TEST_MAX_FRAME];
+static uint8_t       testStaged[TEST_MAX_ENCODED];
+static uint8_t       testPerByte[TEST_MAX_ENCODED];
+static uint32_t      testRandom = 2463534242u;
+static volatile bool testByteDone;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+// Reads the frame sent to the border router from the master side, flags and escapes included. Returns the number of bytes, 0 if the frame
+// did not arrive in time
+static size_t TestPeerReadEncoded(uint8_t* data, size_t size) {
+    struct pollfd peer   = {.fd = SIM_UART_GetPeer(), .events = POLLIN};
+    size_t        length = 0;
+    unsigned      flags  = 0;
+    while ((flags < 2) && (length < size) && (1 == poll(&peer, 1, TEST_TIMEOUT_MS))) {
+        ssize_t result = read(peer.fd, data + length, size - length);
+        if (result <= 0) {
+            return 0;
+        }
+        for (size_t i = length; i < length + (size_t)result; ++i) {
+            flags += (HDLC_FLAG == data[i]) ? 1 : 0;
+        }
+        length += (size_t)result;
+    }
+    return (2 == flags) ? length : 0;
+}
+
+static void TestOnByteWritten(UART2_Handle handle, void* buffer, size_t count, void* userArg, int_fast16_t status) {
+    (void)handle;
+    (void)buffer;
+    (void)count;
+    (void)userArg;
+    (void)status;
+    testByteDone = true;
+}
+
+// One UART2_write per byte, the caller waits for every byte as with the blocking writes the port used before the staging buffers
+static void TestWriteByte(UART2_Handle uart, uint8_t byte) {
+    testByteDone = false;
+    TEST_CHECK(UART2_STATUS_SUCCESS == UART2_write(uart, &byte, sizeof(byte), NULL));
+    while (!testByteDone) {
+        SIM_AdvanceTo(SIM_NextEvent());
+    }
+}
+
+static void TestEncodeAndWriteByte(UART2_Handle uart, uint8_t byte) {
+    if ((HDLC_FLAG == byte) || (HDLC_ESCAPE == byte)) {
+        TestWriteByte(uart, HDLC_ESCAPE);
+        TestWriteByte(uart, byte ^ HDLC_ESCAPE_MASK);
+    } else {
+        TestWriteByte(uart, byte);
+    }
+}
+
+// The frame encoded as by EMBENET_BRT_Send before the staging buffers
+static void TestSendPerByte(UART2_Handle uart, uint8_t const* frame, size_t length) {
+    uint16_t crc = (uint16_t)~EMBENET_BRT_CRC_Update(HDLC_CRCINIT, frame, length);
+    TestWriteByte(uart, HDLC_FLAG);
+    for (size_t i = 0; i != length; ++i) {
+        TestEncodeAndWriteByte(uart, frame[i]);
+    }
+    TestEncodeAndWriteByte(uart, (uint8_t)(crc >> 0));
+    TestEncodeAndWriteByte(uart, (uint8_t)(crc >> 8));
+    TestWriteByte(uart, HDLC_FLAG);
+}
+
+// Sends the same random frames of given length through EMBENET_BRT_Send and byte by byte, checks that the border router receives the same bytes
+// and returns the cost of either way
+static void TestMeasure(size_t length, TestCost* staged, TestCost* perByte) {
+    SIM_Reset();
+    SIM_UART_Reset();
+    EMBENET_BRT_Init();
+    uint32_t seed         = testRandom;
+    uint16_t stagedOutput = HDLC_CRCINIT; // checksum of everything the border router received
+    *staged               = (TestCost){.writes = 0};
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        for (size_t b = 0; b < length; ++b) {
+            testFrame[b] = (uint8_t)TestRandom();
+        }
+        unsigned writes = SIM_UART_GetWriteCount();
+        size_t   bytes  = SIM_UART_GetWrittenBytes();
+        uint64_t start  = SIM_Now();
+        EMBENET_BRT_Send(testFrame, length);
+        staged->heldNs += SIM_Now() - start;
+        while (EMBENET_BRT_IsBusy()) {
+            SIM_AdvanceTo(SIM_NextEvent());
+        }
+        staged->lineNs += SIM_Now() - start;
+        staged->writes += SIM_UART_GetWriteCount() - writes;
+        staged->bytes += SIM_UART_GetWrittenBytes() - bytes;
+        size_t received = TestPeerReadEncoded(testStaged, sizeof(testStaged));
+        TEST_CHECK(0 != received);
+        stagedOutput = EMBENET_BRT_CRC_Update(stagedOutput, testStaged, received);
+    }
+    EMBENET_BRT_Deinit();
+
+    // The same frames, written with the driver opened as the test needs it, the fake supports callback writes only
+    UART2_Params params;
+    UART2_Params_init(&params);
+    params.baudRate      = TEST_BAUD_RATE;
+    params.readMode      = UART2_Mode_NONBLOCKING;
+    params.writeMode     = UART2_Mode_CALLBACK;
+    params.writeCallback = TestOnByteWritten;
+    UART2_Handle uart    = UART2_open(TEST_UART_INDEX, &params);
+    TEST_CHECK(NULL != uart);
+    testRandom             = seed;
+    uint16_t perByteOutput = HDLC_CRCINIT;
+    *perByte               = (TestCost){.writes = 0};
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        for (size_t b = 0; b < length; ++b) {
+            testFrame[b] = (uint8_t)TestRandom();
+        }
+        unsigned writes = SIM_UART_GetWriteCount();
+        size_t   bytes  = SIM_UART_GetWrittenBytes();
+        uint64_t start  = SIM_Now();
+        TestSendPerByte(uart, testFrame, length);
+        perByte->heldNs += SIM_Now() - start;
+        perByte->lineNs += SIM_Now() - start;
+        perByte->writes += SIM_UART_GetWriteCount() - writes;
+        perByte->bytes += SIM_UART_GetWrittenBytes() - bytes;
+        size_t received = TestPeerReadEncoded(testPerByte, sizeof(testPerByte));
+        TEST_CHECK(0 != received);
+        perByteOutput = EMBENET_BRT_CRC_Update(perByteOutput, testPerByte, received);
+    }
+    UART2_close(uart);
+    TEST_CHECK((staged->bytes == perByte->bytes) && (stagedOutput == perByteOutput)); // the same encoding either way
+}
+
+// Prints the driver calls per frame, the time the caller is held by a send and the payload throughput, both in simulated time at the default
+// baud rate. The fake driver takes no time per call, so the throughput is bound by the line either way; on the device every call adds the
+// driver overhead and an interrupt, which the byte count per call shows
+static void TestUartCost(void) {
+    static size_t const lengths[] = {16, 80, TEST_MAX_FRAME};
+    printf("| frame [B] | sender    | UART2_write / frame | B / write | caller held [us / frame] | payload [B/s] |\n");
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        TestCost staged;
+        TestCost perByte;
+        TestMeasure(lengths[i], &staged, &perByte);
+        TEST_CHECK(staged.writes == TEST_FRAMES); // a frame fits one staging buffer
+        TEST_CHECK(perByte.writes == perByte.bytes);
+        TEST_CHECK(0 == staged.heldNs);
+
+        TestCost const* costs[]   = {&staged, &perByte};
+        char const*     senders[] = {"staged", "per byte"};
+        for (size_t c = 0; c < 2; ++c) {
+            printf("| %9zu | %-9s | %19.1f | %9.1f | %24.1f | %13.0f |\n", lengths[i], senders[c], (double)costs[c]->writes / TEST_FRAMES,
+                   (double)costs[c]->bytes / costs[c]->writes, (double)costs[c]->heldNs / TEST_FRAMES / 1000,
+                   (double)lengths[i] * TEST_FRAMES * TEST_NS_PER_S / (double)costs[c]->lineNs);
+        }
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestUartCost);
+    return TEST_RESULT();
+}
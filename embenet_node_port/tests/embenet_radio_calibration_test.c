@@ -0,0 +1,245 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Estimator of radio delays fed with synthetic traces, and the transmissions whose delays it measures
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_radio_calibration.h>
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+
+#include <math.h>
+#include <stdlib.h>
+
+enum {
+    TEST_TRACE_MEAN      = 500,  ///< Mean of the synthetic delay in us
+    TEST_TRACE_SPREAD    = 60,   ///< Width of the uniform noise of the synthetic delay in us
+    TEST_TRACE_STEP      = 300,  ///< Change of the delay the estimator has to follow
+    TEST_FRAMES          = 40,   ///< Frames sent per test, more than needed for a valid estimate
+    TEST_TRIGGER_AHEAD   = 1000, ///< Time between the call of EMBENET_RADIO_TxAt and the trigger in us
+    TEST_SYNTH_MIN_LOCK  = 150,  ///< Shortest lock time of the simulated synthesizer in us
+    TEST_SYNTH_SPREAD    = 300,  ///< Spread of the lock time of the simulated synthesizer in us
+    TEST_CALLBACK_US     = 20,   ///< Latency of the callbacks of the RF driver
+    TEST_TIME_TOLERANCE  = 2,    ///< Rounding of the conversions between the timer, RAT and the simulated time in us
+    TEST_RAT_TICKS_IN_US = 4,
+};
+
+static uint8_t const testFrame[] = {0x41, 0xd8, 0x01, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+static uint32_t      testRandom  = 2463534242u;
+
+static struct {
+    EMBENET_TimeUs start; ///< Time passed to the last start of frame callback
+    EMBENET_TimeUs end;   ///< Time passed to the last end of frame callback
+} testRadio;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestStartOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    testRadio.start = t;
+}
+
+static void TestEndOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    testRadio.end = t;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    EMBENET_RADIO_SetCallbacks(TestStartOfFrame, TestEndOfFrame, NULL);
+    EMBENET_RADIO_ResetCalibration();
+}
+
+static bool TestNear(EMBENET_TimeUs actual, EMBENET_TimeUs expected) {
+    int32_t error = (int32_t)(actual - expected);
+    return (error >= -TEST_TIME_TOLERANCE) && (error <= TEST_TIME_TOLERANCE);
+}
+
+// A noisy trace gives its mean and deviation once enough samples were added, the fallback before
+static void TestEstimatorTrace(void) {
+    EMBENET_RADIO_CALIBRATION_Estimator estimator;
+    EMBENET_RADIO_CALIBRATION_Reset(&estimator);
+    double sum   = 0;
+    double sumSq = 0;
+    for (unsigned i = 0; i < EMBENET_RADIO_CALIBRATION_WINDOW; ++i) {
+        TEST_CHECK(EMBENET_RADIO_CALIBRATION_IsValid(&estimator) == (i >= EMBENET_RADIO_CALIBRATION_MIN_SAMPLES));
+        if (!EMBENET_RADIO_CALIBRATION_IsValid(&estimator)) {
+            TEST_CHECK(-7 == EMBENET_RADIO_CALIBRATION_GetMean(&estimator, -7));
+            TEST_CHECK(0 == EMBENET_RADIO_CALIBRATION_GetDeviation(&estimator));
+        }
+        int32_t sample = TEST_TRACE_MEAN - TEST_TRACE_SPREAD / 2 + (int32_t)(TestRandom() % (TEST_TRACE_SPREAD + 1));
+        EMBENET_RADIO_CALIBRATION_AddSample(&estimator, sample);
+        sum += sample;
+        sumSq += (double)sample * sample;
+    }
+
+    // Up to the first halving, the estimate is exactly the mean and the population deviation of the trace
+    double mean      = sum / EMBENET_RADIO_CALIBRATION_WINDOW;
+    double deviation = sqrt(sumSq / EMBENET_RADIO_CALIBRATION_WINDOW - mean * mean);
+    TEST_CHECK(lround(mean) == EMBENET_RADIO_CALIBRATION_GetMean(&estimator, 0));
+    TEST_CHECK(fabs(deviation - EMBENET_RADIO_CALIBRATION_GetDeviation(&estimator)) < 1);
+}
+
+// After a step of the delay, the halving of the accumulators lets the estimate follow it within a few windows
+static void TestEstimatorFollowsStep(void) {
+    EMBENET_RADIO_CALIBRATION_Estimator estimator;
+    EMBENET_RADIO_CALIBRATION_Reset(&estimator);
+    for (unsigned i = 0; i < 4 * EMBENET_RADIO_CALIBRATION_WINDOW; ++i) {
+        EMBENET_RADIO_CALIBRATION_AddSample(&estimator, TEST_TRACE_MEAN);
+    }
+    int32_t previous = TEST_TRACE_MEAN;
+    for (unsigned window = 0; window < 8; ++window) {
+        for (unsigned i = 0; i < EMBENET_RADIO_CALIBRATION_WINDOW / 2; ++i) {
+            EMBENET_RADIO_CALIBRATION_AddSample(&estimator, TEST_TRACE_MEAN + TEST_TRACE_STEP);
+        }
+        // every half window halves the weight of the samples before the step
+        int32_t mean = EMBENET_RADIO_CALIBRATION_GetMean(&estimator, 0);
+        TEST_CHECK((mean > previous) && (mean <= TEST_TRACE_MEAN + TEST_TRACE_STEP));
+        TEST_CHECK(abs(TEST_TRACE_MEAN + TEST_TRACE_STEP - mean) <= (TEST_TRACE_STEP >> (window + 1)) + 1);
+        previous = mean;
+    }
+    TEST_CHECK(abs(TEST_TRACE_MEAN + TEST_TRACE_STEP - previous) <= 1);
+    TEST_CHECK(EMBENET_RADIO_CALIBRATION_GetDeviation(&estimator) <= (TEST_TRACE_STEP >> 4)); // the step weighs 1/256 of the samples
+}
+
+// The mean is rounded to nearest with halves away from zero, for negative delays too, and a constant trace has no deviation
+static void TestEstimatorRounding(void) {
+    EMBENET_RADIO_CALIBRATION_Estimator positive;
+    EMBENET_RADIO_CALIBRATION_Estimator negative;
+    EMBENET_RADIO_CALIBRATION_Reset(&positive);
+    EMBENET_RADIO_CALIBRATION_Reset(&negative);
+    for (unsigned i = 0; i < EMBENET_RADIO_CALIBRATION_MIN_SAMPLES; ++i) {
+        EMBENET_RADIO_CALIBRATION_AddSample(&positive, (i % 2) ? 2 : 1);
+        EMBENET_RADIO_CALIBRATION_AddSample(&negative, (i % 2) ? -2 : -1);
+    }
+    TEST_CHECK(2 == EMBENET_RADIO_CALIBRATION_GetMean(&positive, 0));
+    TEST_CHECK(-2 == EMBENET_RADIO_CALIBRATION_GetMean(&negative, 0));
+
+    EMBENET_RADIO_CALIBRATION_Reset(&positive);
+    for (unsigned i = 0; i < 3 * EMBENET_RADIO_CALIBRATION_WINDOW; ++i) {
+        EMBENET_RADIO_CALIBRATION_AddSample(&positive, 4999);
+    }
+    TEST_CHECK(4999 == EMBENET_RADIO_CALIBRATION_GetMean(&positive, 0));
+    TEST_CHECK(0 == EMBENET_RADIO_CALIBRATION_GetDeviation(&positive));
+}
+
+/**
+ * @brief Sends testFrame with the synthesizer locking after given time and the RF driver reporting the lock and the end of the frame
+ * The RF driver calls the callbacks TEST_CALLBACK_US after the events.
+ * @param[in] scheduled true to trigger the frame with EMBENET_RADIO_TxAt, false for EMBENET_RADIO_TxNow
+ * @param[in] lock time between the trigger and the lock of the synthesizer in us
+ * @return trigger time of the frame
+ */
+static EMBENET_TimeUs TestSend(bool scheduled, EMBENET_TimeUs lock) {
+    EMBENET_RADIO_Capabilities const* capabilities = EMBENET_RADIO_GetCapabilities();
+    EMBENET_TimeUs                    airTime      = EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), sizeof(testFrame));
+    EMBENET_TimeUs                    trigger      = EMBENET_TIMER_ReadCounter() + (scheduled ? TEST_TRIGGER_AHEAD : 0);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == (scheduled ? EMBENET_RADIO_TxAt(trigger) : EMBENET_RADIO_TxNow()));
+
+    RF_CmdHandle             tx = SIM_RF_GetLastCommand();
+    rfc_CMD_FS_t const*      fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(tx, CMD_FS);
+    rfc_CMD_PROP_TX_t const* op = (rfc_CMD_PROP_TX_t const*)SIM_RF_FindOp(tx, CMD_PROP_TX);
+    if (scheduled) {
+        // RAT starts the frame txDelay after the trigger
+        TEST_CHECK((TRIG_ABSTIME == fs->startTrigger.triggerType) && (TRIG_ABSTIME == op->startTrigger.triggerType));
+        TEST_CHECK(TestNear((EMBENET_TimeUs)((op->startTime - fs->startTime) / TEST_RAT_TICKS_IN_US), capabilities->txDelay));
+    } else {
+        TEST_CHECK((TRIG_NOW == fs->startTrigger.triggerType) && (TRIG_NOW == op->startTrigger.triggerType));
+    }
+
+    SIM_Advance((uint64_t)(trigger + lock - EMBENET_TIMER_ReadCounter()) * 1000);
+    SIM_RF_Callback(tx, RF_EventCmdDone, TEST_CALLBACK_US * 1000);
+    SIM_Advance(TEST_CALLBACK_US * 1000);
+    EMBENET_TimeUs end = (scheduled && (lock < capabilities->txDelay)) ? capabilities->txDelay + airTime : lock + airTime;
+    SIM_Advance((uint64_t)(trigger + end - EMBENET_TIMER_ReadCounter()) * 1000);
+    SIM_RF_SetStatus(tx, CMD_PROP_TX, PROP_DONE_OK);
+    SIM_RF_Callback(tx, RF_EventLastCmdDone, TEST_CALLBACK_US * 1000);
+    SIM_Advance(TEST_CALLBACK_US * 1000);
+    return trigger;
+}
+
+// A scheduled frame is reported at its scheduled times, whatever the lock time, which is measured as the receiver delay
+static void TestScheduledTransmission(void) {
+    TestInit();
+    EMBENET_RADIO_Calibration defaults;
+    EMBENET_RADIO_GetCalibration(&defaults);
+    EMBENET_TimeUs txDelay = EMBENET_RADIO_GetCapabilities()->txDelay;
+    EMBENET_TimeUs airTime = EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), sizeof(testFrame));
+    EMBENET_TimeUs lockSum = 0;
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        EMBENET_TimeUs lock    = TEST_SYNTH_MIN_LOCK + TestRandom() % TEST_SYNTH_SPREAD;
+        EMBENET_TimeUs trigger = TestSend(true, lock);
+        TEST_CHECK(TestNear(testRadio.start, trigger + txDelay));
+        TEST_CHECK(TestNear(testRadio.end, trigger + txDelay + airTime));
+        lockSum += lock;
+    }
+
+    EMBENET_RADIO_Calibration calibration;
+    EMBENET_RADIO_GetCalibration(&calibration);
+    EMBENET_TimeUs lockMean = lockSum / TEST_FRAMES + TEST_CALLBACK_US; // the lock is seen by the callback
+    TEST_CHECK(TestNear(calibration.rxDelay, lockMean));
+    TEST_CHECK(calibration.rxDelay != defaults.rxDelay);
+    TEST_CHECK(calibration.rxDelay == EMBENET_RADIO_GetCapabilities()->rxDelay);
+    TEST_CHECK(TestNear(calibration.txStartCorrection, txDelay - lockMean));
+    TEST_CHECK((calibration.txStartDeviation > TEST_SYNTH_SPREAD / 5) && (calibration.txStartDeviation < TEST_SYNTH_SPREAD / 2)); // uniform noise: spread / sqrt(12)
+    TEST_CHECK(calibration.txEndDeviation <= TEST_TIME_TOLERANCE);
+}
+
+// A frame whose synthesizer locked after the scheduled start, and a frame sent at once, have no reference and give no samples
+static void TestUnscheduledTransmission(void) {
+    TestInit();
+    EMBENET_RADIO_Calibration defaults;
+    EMBENET_RADIO_GetCalibration(&defaults);
+    EMBENET_TimeUs txDelay = EMBENET_RADIO_GetCapabilities()->txDelay;
+    EMBENET_TimeUs airTime = EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), sizeof(testFrame));
+    for (unsigned i = 0; i < TEST_FRAMES; ++i) {
+        bool           scheduled = 0 == (i % 2);
+        EMBENET_TimeUs lock      = scheduled ? txDelay + 50 : TEST_SYNTH_MIN_LOCK;
+        EMBENET_TimeUs trigger   = TestSend(scheduled, lock);
+        TEST_CHECK(TestNear(testRadio.start, trigger + lock + TEST_CALLBACK_US + defaults.txStartCorrection));
+        TEST_CHECK(TestNear(testRadio.end, trigger + lock + airTime + TEST_CALLBACK_US + defaults.txEndCorrection));
+    }
+
+    EMBENET_RADIO_Calibration calibration;
+    EMBENET_RADIO_GetCalibration(&calibration);
+    TEST_CHECK(!calibration.calibrated);
+    TEST_CHECK((calibration.txStartCorrection == defaults.txStartCorrection) && (calibration.txEndCorrection == defaults.txEndCorrection));
+    TEST_CHECK(calibration.rxDelay == defaults.rxDelay);
+    TEST_CHECK((0 == calibration.txStartDeviation) && (0 == calibration.txEndDeviation));
+}
+
+int main(void) {
+    TEST_RUN(TestEstimatorTrace);
+    TEST_RUN(TestEstimatorFollowsStep);
+    TEST_RUN(TestEstimatorRounding);
+    TEST_RUN(TestScheduledTransmission);
+    TEST_RUN(TestUnscheduledTransmission);
+    return TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Synthesizer settings of every channel, checked against the frequency plan of the band
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_port_capabilities.h>
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+
+#include <stdlib.h>
+
+enum {
+    TEST_BAND_START_HZ      = 863100000, ///< Frequency of channel 0
+    TEST_CHANNEL_WIDTH_HZ   = 100000,    ///< Spacing of the channels
+    TEST_BAND_CHANNEL_COUNT = 69,        ///< Channels of the band, up to 869.9 MHz
+    TEST_FRACT_FREQ_STEPS   = 65536,     ///< fractFreq counts the fraction of MHz in these steps
+};
+
+static uint8_t const testFrame[] = {0x41, 0xd8, 0x01, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(NULL, 0, 0, 0));
+}
+
+// Returns the frequency the synthesizer of the command is tuned to, in 1/65536 Hz so that no rounding is involved
+static int64_t TestGetTunedFrequency(RF_CmdHandle ch) {
+    rfc_CMD_FS_t const* fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(ch, CMD_FS);
+    TEST_CHECK(NULL != fs);
+    return (NULL != fs) ? ((int64_t)fs->frequency * TEST_FRACT_FREQ_STEPS + fs->fractFreq) * 1000000 : 0;
+}
+
+// The frequency of the channel is set within half of the fractFreq step, the closest the synthesizer can get
+static void TestCheckFrequency(RF_CmdHandle ch, EMBENET_RADIO_Channel channel) {
+    int64_t intended = ((int64_t)TEST_BAND_START_HZ + (int64_t)channel * TEST_CHANNEL_WIDTH_HZ) * TEST_FRACT_FREQ_STEPS;
+    int64_t error    = TestGetTunedFrequency(ch) - intended;
+    TEST_CHECK_RANGE(error, -1000000 / 2, 1000000 / 2);
+}
+
+static RF_CmdHandle TestTransmit(EMBENET_RADIO_Channel channel) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(channel, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    RF_CmdHandle ch = SIM_RF_GetLastCommand();
+    EMBENET_RADIO_Idle();
+    return ch;
+}
+
+static RF_CmdHandle TestListen(EMBENET_RADIO_Channel channel) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(channel));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    RF_CmdHandle ch = SIM_RF_GetLastCommand();
+    EMBENET_RADIO_Idle();
+    return ch;
+}
+
+// Every channel of the band is tuned to 863.1 MHz + 100 kHz per channel, for transmission and for reception
+static void TestEveryChannelHasItsFrequency(void) {
+    TestInit();
+    for (EMBENET_RADIO_Channel channel = 0; channel < TEST_BAND_CHANNEL_COUNT; ++channel) {
+        TestCheckFrequency(TestTransmit(channel), channel);
+        TestCheckFrequency(TestListen(channel), channel);
+    }
+    // 100 kHz is not a whole number of fractFreq steps, so the rounding is checked on exact values as well
+    rfc_CMD_FS_t const* fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(TestTransmit(1), CMD_FS);
+    TEST_CHECK((863 == fs->frequency) && (13107 == fs->fractFreq)); // 863.2 MHz, 0.2 * 65536 = 13107.2
+    fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(TestTransmit(2), CMD_FS);
+    TEST_CHECK((863 == fs->frequency) && (19661 == fs->fractFreq)); // 863.3 MHz, 0.3 * 65536 = 19660.8
+    fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(TestTransmit(9), CMD_FS);
+    TEST_CHECK((864 == fs->frequency) && (0 == fs->fractFreq)); // 864.0 MHz
+}
+
+// Channels above the band are clipped to its last channel
+static void TestChannelAboveBandIsClipped(void) {
+    TestInit();
+    TestCheckFrequency(TestTransmit(TEST_BAND_CHANNEL_COUNT), TEST_BAND_CHANNEL_COUNT - 1);
+    TestCheckFrequency(TestListen(UINT8_MAX), TEST_BAND_CHANNEL_COUNT - 1);
+}
+
+// Hopping over every channel offset of the MAC channel list visits distinct frequencies, so that TSCH gets its channel diversity
+static void TestMacChannelListHops(void) {
+    TestInit();
+    int64_t previous = 0;
+    for (size_t offset = 0; offset != embenetMacChannelListSize; ++offset) {
+        EMBENET_RADIO_Channel channel = embenetMacChannelList[offset];
+        RF_CmdHandle          ch      = TestTransmit(channel);
+        TestCheckFrequency(ch, channel);
+        TEST_CHECK(TestGetTunedFrequency(ch) != previous);
+        previous = TestGetTunedFrequency(ch);
+    }
+    for (size_t offset = 0; offset != embenetMacAdvChannelListSize; ++offset) {
+        TestCheckFrequency(TestListen(embenetMacAdvChannelList[offset]), embenetMacAdvChannelList[offset]);
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestEveryChannelHasItsFrequency);
+    TEST_RUN(TestChannelAboveBandIsClipped);
+    TEST_RUN(TestMacChannelListHops);
+    return TEST_RESULT();
+}
@@ -0,0 +1,387 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Handling of the RF driver events by the radio, against a fake RF driver playing the RF core
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+// clang-format off
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+// clang-format on
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    TEST_BYTE_AIR_TIME_NS = 160000, ///< Air time of a byte at 50 kbps
+    TEST_CRC_LENGTH       = 2,
+    TEST_CALLBACK_NS      = 50000, ///< Delay of the end of frame callback after the end of the frame
+};
+
+static uint8_t const testFrame[]      = {0x41, 0xd8, 0x01, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+// Data frame requesting an ACK, from 0x8877665544332211 to SIM_EUI64
+static uint8_t const testAckedFrame[] = {0x61, 0xdc, 0x02, 0xcd, 0xab, 0xc3, 0xb2, 0xa1, 0x00, 0x00, 0x4b, 0x12, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+// As above, but addressed to another node
+static uint8_t const testOtherFrame[] = {0x61, 0xdc, 0x03, 0xcd, 0xab, 0xc4, 0xb2, 0xa1, 0x00, 0x00, 0x4b, 0x12, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+// As above, but addressed to the short address 0x1234
+static uint8_t const testShortFrame[] = {0x61, 0xd8, 0x04, 0xcd, 0xab, 0x34, 0x12, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+static uint8_t const testAck[]        = {0x02, 0x22, 0x01};
+// Enhanced ACK carrying its transmit power of 10 dBm in the vendor specific IE with the OUI of TEST_OTHER_EUI64
+static uint8_t const testAckWithTxp[] = {0x02, 0x22, 0x01, 0x04, 0x00, 0x4b, 0x12, 0x00, 0x0a};
+
+#define TEST_OTHER_EUI64 UINT64_C(0x00124b0000a1b2c4) ///< Destination of testOtherFrame
+
+static struct {
+    unsigned startCount; ///< Number of start of frame callbacks
+    unsigned endCount;   ///< Number of end of frame callbacks
+} testRadio;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestStartOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    (void)t;
+    testRadio.startCount++;
+}
+
+static void TestEndOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    (void)t;
+    testRadio.endCount++;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    testRadio.startCount = 0;
+    testRadio.endCount   = 0;
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    EMBENET_RADIO_SetCallbacks(TestStartOfFrame, TestEndOfFrame, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(NULL, 0, 0, 0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(0));
+}
+
+static RF_CmdHandle TestListen(void) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    return SIM_RF_GetLastCommand();
+}
+
+static RF_CmdHandle TestTransmit(void) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    return SIM_RF_GetLastCommand();
+}
+
+// The RF core synchronizes now and receives the frame, then the RF driver reports the end of the frame with the given events
+static void TestReceiveFrame(RF_CmdHandle ch, uint8_t const* psdu, size_t length, RF_EventMask endEvents) {
+    ratmr_t syncTime = RF_getCurrentTime();
+    SIM_RF_Callback(ch, RF_EventMdmSoft, 0);
+    SIM_Advance((1 + length + TEST_CRC_LENGTH) * TEST_BYTE_AIR_TIME_NS);
+    TEST_CHECK(SIM_RF_ReceiveFrame(ch, psdu, length, -60, syncTime));
+    SIM_RF_SetStatus(ch, CMD_PROP_RX, PROP_DONE_OK);
+    SIM_RF_Callback(ch, endEvents, TEST_CALLBACK_NS);
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+}
+
+static void TestReceive(RF_CmdHandle ch, RF_EventMask endEvents) {
+    TestReceiveFrame(ch, testFrame, sizeof(testFrame), endEvents);
+}
+
+static void TestCheckReceivedFrame(void) {
+    uint8_t              buffer[EMBENET_RADIO_MAX_PSDU_LENGTH];
+    EMBENET_RADIO_RxInfo info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+    TEST_CHECK(info.crcValid);
+    TEST_CHECK(sizeof(testFrame) == info.mpduLength);
+    TEST_CHECK(0 == memcmp(buffer, testFrame, sizeof(testFrame)));
+}
+
+// The callback of the listening flushed by Idle comes after the next listening was posted, and must not end it
+static void TestFlushedListeningIsIgnored(void) {
+    TestInit();
+    RF_CmdHandle flushed = TestListen();
+    EMBENET_RADIO_Idle();
+    RF_CmdHandle current = TestListen();
+    TEST_CHECK(current != flushed);
+    SIM_Advance(2 * SIM_RF_CALLBACK_LATENCY_NS);
+
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(0 == counters.rxErrors);
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_RxEnable(0)); // still listening
+
+    TestReceive(current, RF_EventRxOk | RF_EventLastCmdDone);
+    TEST_CHECK(1 == testRadio.startCount);
+    TEST_CHECK(1 == testRadio.endCount);
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(1 == counters.rxFrames);
+    TestCheckReceivedFrame();
+}
+
+// The last event of a listening already handed over to the stack comes after the next listening was posted, and must not end it
+static void TestLateEndOfFinishedListeningIsIgnored(void) {
+    TestInit();
+    RF_CmdHandle finished = TestListen();
+    TestReceive(finished, RF_EventRxOk);
+    TEST_CHECK(1 == testRadio.endCount);
+    TestCheckReceivedFrame();
+
+    RF_CmdHandle current = TestListen();
+    SIM_RF_Callback(finished, RF_EventLastCmdDone, 0);
+    SIM_Advance(TEST_CALLBACK_NS);
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_RxEnable(0)); // still listening
+
+    TestReceive(current, RF_EventRxOk | RF_EventLastCmdDone);
+    TEST_CHECK(2 == testRadio.endCount);
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(2 == counters.rxFrames);
+    TEST_CHECK(0 == counters.rxSyncMisses);
+    TEST_CHECK(0 == counters.rxErrors);
+}
+
+// The listening window is closed by the RF core at the end trigger, the radio is then ready for the next listening
+static void TestWindowClosesWithoutFrame(void) {
+    TestInit();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(2000));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxAt(EMBENET_TIMER_ReadCounter() + 1000));
+    RF_CmdHandle       ch = SIM_RF_GetLastCommand();
+    rfc_CMD_FS_t*      fs = (rfc_CMD_FS_t*)SIM_RF_FindOp(ch, CMD_FS);
+    rfc_CMD_PROP_RX_t* rx = (rfc_CMD_PROP_RX_t*)SIM_RF_FindOp(ch, CMD_PROP_RX);
+    TEST_CHECK(TRIG_ABSTIME == fs->startTrigger.triggerType);
+    TEST_CHECK(TRIG_ABSTIME == rx->endTrigger.triggerType);
+    // Both ends are converted separately, each within a us of the RAT
+    TEST_CHECK_RANGE((int32_t)(rx->endTime - fs->startTime), 2000 * RF_NUM_RAT_TICKS_IN_1_US - 4, 2000 * RF_NUM_RAT_TICKS_IN_1_US + 4);
+
+    SIM_Advance(3000000);
+    SIM_RF_SetStatus(ch, CMD_PROP_RX, PROP_DONE_RXTIMEOUT);
+    SIM_RF_Callback(ch, RF_EventLastCmdDone, TEST_CALLBACK_NS);
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+    TEST_CHECK(0 == testRadio.startCount);
+    TEST_CHECK(0 == testRadio.endCount);
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(1 == counters.rxSyncMisses);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+}
+
+// With automatic ACK the listening ends only after the ACK was sent
+static void TestListeningEndsAfterAutoAck(void) {
+    TestInit();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 0, 1000));
+    RF_CmdHandle ch = TestListen();
+    TestReceiveFrame(ch, testAckedFrame, sizeof(testAckedFrame), RF_EventRxOk);
+    TEST_CHECK(1 == testRadio.endCount);
+    TEST_CHECK(SIM_RF_IsActive(ch));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_RxEnable(0)); // ACK not sent yet
+
+    SIM_RF_Callback(ch, RF_EventLastCmdDone, 1000000);
+    SIM_Advance(2000000);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(1 == counters.rxFrames);
+    TEST_CHECK(0 == counters.rxErrors);
+}
+
+// The RF core would acknowledge every frame with valid CRC, the ACK is cancelled for frames not requesting it from this node
+static void TestAutoAckOnlyWhenRequested(void) {
+    static struct {
+        uint8_t const* psdu;
+        size_t         length;
+    } const frames[] = {
+        {testFrame,      sizeof(testFrame)     }, // broadcast without ACK request
+        {testOtherFrame, sizeof(testOtherFrame)},
+    };
+    for (size_t i = 0; i != sizeof(frames) / sizeof(frames[0]); ++i) {
+        TestInit();
+        TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 0, 1000));
+        RF_CmdHandle ch = TestListen();
+        TestReceiveFrame(ch, frames[i].psdu, frames[i].length, RF_EventRxOk);
+        TEST_CHECK(1 == testRadio.endCount);
+        TEST_CHECK(!SIM_RF_IsActive(ch));
+        TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+
+        RF_CmdHandle next = TestListen();
+        SIM_Advance(2 * SIM_RF_CALLBACK_LATENCY_NS); // the flushed command ends after the next one was posted
+        TEST_CHECK(SIM_RF_IsActive(next));
+        EMBENET_RADIO_Counters counters;
+        EMBENET_RADIO_GetCounters(&counters);
+        TEST_CHECK(1 == counters.rxFrames);
+        TEST_CHECK(0 == counters.rxErrors);
+        TEST_CHECK(0 == counters.ackFlushMisses);
+        TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_RxEnable(0));
+    }
+}
+
+// A frame to a short address is acknowledged only once the stack set it as the address of the node
+static void TestAutoAckToShortAddress(void) {
+    for (unsigned set = 0; set < 2; ++set) {
+        TestInit();
+        if (1 == set) {
+            EMBENET_RADIO_SetShortAddress(0x1234);
+        }
+        TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 0, 1000));
+        RF_CmdHandle ch = TestListen();
+        TestReceiveFrame(ch, testShortFrame, sizeof(testShortFrame), RF_EventRxOk);
+        TEST_CHECK((1 == set) == SIM_RF_IsActive(ch));
+    }
+}
+
+// An ACK the callback could not cancel in time, as it came after the ACK delay or the RF core already started the ACK, is counted
+static void TestLateAutoAckCancelIsCounted(void) {
+    static struct {
+        uint64_t callbackNs; ///< Delay of the end of frame callback
+        uint16_t ackStatus;  ///< Status of the ACK command when the callback comes
+    } const cases[] = {
+        {TEST_CALLBACK_NS, IDLE   },
+        {TEST_CALLBACK_NS, PENDING},
+        {600000,           PENDING},
+        {TEST_CALLBACK_NS, ACTIVE },
+    };
+    TestInit();
+    TEST_CHECK(EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 0, 499));
+    TEST_CHECK(NULL == EMBENET_RADIO_GetAutoAck());
+    for (size_t i = 0; i != sizeof(cases) / sizeof(cases[0]); ++i) {
+        TestInit();
+        TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 0, 500));
+        RF_CmdHandle ch       = TestListen();
+        ratmr_t      syncTime = RF_getCurrentTime();
+        SIM_RF_Callback(ch, RF_EventMdmSoft, 0);
+        SIM_Advance((1 + sizeof(testOtherFrame) + TEST_CRC_LENGTH) * TEST_BYTE_AIR_TIME_NS);
+        TEST_CHECK(SIM_RF_ReceiveFrame(ch, testOtherFrame, sizeof(testOtherFrame), -60, syncTime));
+        SIM_RF_SetStatus(ch, CMD_PROP_RX, PROP_DONE_OK);
+        SIM_RF_SetStatus(ch, CMD_PROP_TX, cases[i].ackStatus);
+        SIM_RF_Callback(ch, RF_EventRxOk, cases[i].callbackNs);
+        SIM_Advance(2 * cases[i].callbackNs);
+        TEST_CHECK(!SIM_RF_IsActive(ch));
+
+        EMBENET_RADIO_Counters counters;
+        EMBENET_RADIO_GetCounters(&counters);
+        TEST_CHECK((i >= 2) == (1 == counters.ackFlushMisses));
+    }
+}
+
+// The callback of the transmission flushed by Idle comes after the next transmission was posted, and must not end it
+static void TestFlushedTransmissionIsIgnored(void) {
+    TestInit();
+    RF_CmdHandle flushed = TestTransmit();
+    EMBENET_RADIO_Idle();
+    RF_CmdHandle current = TestTransmit();
+    SIM_Advance(2 * SIM_RF_CALLBACK_LATENCY_NS);
+
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(0 == counters.txAborts);
+    TEST_CHECK(SIM_RF_FindOp(flushed, CMD_PROP_TX) == SIM_RF_FindOp(current, CMD_PROP_TX));
+
+    SIM_RF_SetStatus(current, CMD_PROP_TX, PROP_DONE_OK);
+    SIM_RF_Callback(current, RF_EventLastCmdDone, 0);
+    SIM_Advance(TEST_CALLBACK_NS);
+    TEST_CHECK(1 == testRadio.endCount);
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(1 == counters.txFrames);
+    TEST_CHECK(0 == counters.txAborts);
+}
+
+// Buffers lent for building a frame and never committed are taken back by Idle, so that they do not leak
+static void TestIdleTakesBackLentBuffers(void) {
+    TestInit();
+    uint8_t* first  = EMBENET_RADIO_GetTxBuffer();
+    uint8_t* second = EMBENET_RADIO_GetTxBuffer();
+    TEST_CHECK((NULL != first) && (NULL != second));
+    TEST_CHECK(NULL == EMBENET_RADIO_GetTxBuffer());
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+
+    EMBENET_RADIO_Idle();
+    TEST_CHECK(EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS == EMBENET_RADIO_CommitTx(0, 0, first, sizeof(testFrame)));
+    uint8_t* buffer = EMBENET_RADIO_GetTxBuffer();
+    TEST_CHECK(NULL != buffer);
+    memcpy(buffer, testFrame, sizeof(testFrame));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_CommitTx(0, 0, buffer, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+}
+
+// ACKs are sent at the power of the link and carry it, so that the neighbor learns the path loss from their RSSI
+static void TestAckPowerAndPathLoss(void) {
+    TestInit();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetLinkTxPower(TEST_OTHER_EUI64, 2));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 10, testOtherFrame, sizeof(testOtherFrame)));
+    TEST_CHECK(2 == SIM_RF_GetTxPower());
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    RF_CmdHandle tx = SIM_RF_GetLastCommand();
+    SIM_RF_SetStatus(tx, CMD_PROP_TX, PROP_DONE_OK);
+    SIM_RF_Callback(tx, RF_EventLastCmdDone, 0);
+    SIM_Advance(TEST_CALLBACK_NS);
+
+    // An ACK without its power gives no path loss
+    int16_t pathLoss = 0;
+    TestReceiveFrame(TestListen(), testAck, sizeof(testAck), RF_EventRxOk | RF_EventLastCmdDone);
+    uint8_t buffer[EMBENET_RADIO_MAX_PSDU_LENGTH];
+    TEST_CHECK(EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer)).crcValid);
+    TEST_CHECK(!EMBENET_RADIO_GetLinkPathLoss(TEST_OTHER_EUI64, &pathLoss));
+    EMBENET_RADIO_Idle();
+
+    // An ACK sent at 10 dBm and received at -60 dBm, with the OUI of the neighbor
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 10, testOtherFrame, sizeof(testOtherFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    tx = SIM_RF_GetLastCommand();
+    SIM_RF_SetStatus(tx, CMD_PROP_TX, PROP_DONE_OK);
+    SIM_RF_Callback(tx, RF_EventLastCmdDone, 0);
+    SIM_Advance(TEST_CALLBACK_NS);
+    TestReceiveFrame(TestListen(), testAckWithTxp, sizeof(testAckWithTxp), RF_EventRxOk | RF_EventLastCmdDone);
+    TEST_CHECK(EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer)).crcValid);
+    TEST_CHECK(EMBENET_RADIO_GetLinkPathLoss(TEST_OTHER_EUI64, &pathLoss));
+    TEST_CHECK(70 == pathLoss);
+    TEST_CHECK(!EMBENET_RADIO_GetLinkPathLoss(SIM_EUI64, &pathLoss));
+    EMBENET_RADIO_Idle();
+
+    // An ACK is sent at the power requested by the MAC, which it carries with the OUI of the node
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 3, testAck, sizeof(testAck)));
+    TEST_CHECK(3 == SIM_RF_GetTxPower());
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    rfc_CMD_PROP_TX_t const* ack = (rfc_CMD_PROP_TX_t const*)SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_PROP_TX);
+    uint8_t const            sentAck[] = {0x02, 0x22, 0x01, 0x04, 0x00, 0x4b, 0x12, 0x00, 0x03};
+    TEST_CHECK((sizeof(sentAck) == ack->pktLen) && (0 == memcmp(sentAck, ack->pPkt, sizeof(sentAck))));
+    EMBENET_RADIO_Idle();
+
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_GetCapabilities()->minOutputPower == SIM_RF_GetTxPower());
+    EMBENET_RADIO_Idle();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(testAck, sizeof(testAck), 5, 1000));
+    RF_CmdHandle rx = TestListen();
+    TEST_CHECK(5 == SIM_RF_GetTxPower()); // the automatic ACK is sent at the power requested by the MAC and carries it
+    ack = (rfc_CMD_PROP_TX_t const*)SIM_RF_FindOp(rx, CMD_PROP_TX);
+    TEST_CHECK((sizeof(sentAck) == ack->pktLen) && (0 == memcmp(sentAck, ack->pPkt, sizeof(sentAck) - 1)) && (5 == ack->pPkt[sizeof(sentAck) - 1]));
+}
+
+int main(void) {
+    TEST_RUN(TestFlushedListeningIsIgnored);
+    TEST_RUN(TestLateEndOfFinishedListeningIsIgnored);
+    TEST_RUN(TestWindowClosesWithoutFrame);
+    TEST_RUN(TestListeningEndsAfterAutoAck);
+    TEST_RUN(TestAutoAckOnlyWhenRequested);
+    TEST_RUN(TestAutoAckToShortAddress);
+    TEST_RUN(TestLateAutoAckCancelIsCounted);
+    TEST_RUN(TestFlushedTransmissionIsIgnored);
+    TEST_RUN(TestIdleTakesBackLentBuffers);
+    TEST_RUN(TestAckPowerAndPathLoss);
+    return TEST_RESULT();
+}
@@ -0,0 +1,205 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Ownership of the RX data entries of the radio, against a fake RF driver filling the data queue as the RF core does
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+// clang-format off
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+// clang-format on
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    TEST_BYTE_AIR_TIME_NS = 160000, ///< Air time of a byte at 50 kbps
+    TEST_CRC_LENGTH       = 2,
+    TEST_CALLBACK_NS      = 50000, ///< Delay of the end of frame callback after the end of the frame
+    TEST_RX_ENTRY_COUNT   = 4,     ///< Number of RX data entries of the radio
+    TEST_SEQUENCE_INDEX   = 2,     ///< Position of the sequence number in testFrame, distinguishes the received frames
+};
+
+static uint8_t const testFrame[] = {0x41, 0xd8, 0x00, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+static struct {
+    unsigned endCount; ///< Number of end of frame callbacks
+} testRadio;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestEndOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    (void)t;
+    testRadio.endCount++;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    testRadio.endCount = 0;
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    EMBENET_RADIO_SetCallbacks(NULL, TestEndOfFrame, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(NULL, 0, 0, 0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(0));
+}
+
+static bool TestIsFrame(uint8_t const* psdu, uint8_t sequence) {
+    return (psdu[TEST_SEQUENCE_INDEX] == sequence) && (0 == memcmp(psdu, testFrame, TEST_SEQUENCE_INDEX)) &&
+           (0 == memcmp(psdu + TEST_SEQUENCE_INDEX + 1, testFrame + TEST_SEQUENCE_INDEX + 1, sizeof(testFrame) - TEST_SEQUENCE_INDEX - 1));
+}
+
+// The radio listens, the RF core synchronizes and stores the frame with the given sequence number in the current data entry of the queue.
+// Returns false if the RF core found no free entry, the reception then ends on buffer overflow
+static bool TestReceive(uint8_t sequence) {
+    uint8_t psdu[sizeof(testFrame)];
+    memcpy(psdu, testFrame, sizeof(testFrame));
+    psdu[TEST_SEQUENCE_INDEX] = sequence;
+
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    RF_CmdHandle ch       = SIM_RF_GetLastCommand();
+    ratmr_t      syncTime = RF_getCurrentTime();
+    SIM_RF_Callback(ch, RF_EventMdmSoft, 0);
+    SIM_Advance((1 + sizeof(psdu) + TEST_CRC_LENGTH) * TEST_BYTE_AIR_TIME_NS);
+    bool stored = SIM_RF_ReceiveFrame(ch, psdu, sizeof(psdu), -60, syncTime);
+    if (stored) {
+        SIM_RF_SetStatus(ch, CMD_PROP_RX, PROP_DONE_OK);
+        SIM_RF_Callback(ch, RF_EventRxOk | RF_EventLastCmdDone, TEST_CALLBACK_NS);
+    } else {
+        SIM_RF_SetStatus(ch, CMD_PROP_RX, PROP_ERROR_RXBUF);
+        SIM_RF_Callback(ch, RF_EventLastCmdDone, TEST_CALLBACK_NS);
+    }
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+    return stored;
+}
+
+// A received frame is handed over once, whether copied or lent
+static void TestFrameIsConsumedOnce(void) {
+    TestInit();
+    uint8_t buffer[EMBENET_RADIO_MAX_PSDU_LENGTH];
+    TEST_CHECK(TestReceive(1));
+    EMBENET_RADIO_RxInfo info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+    TEST_CHECK(info.crcValid && (sizeof(testFrame) == info.mpduLength));
+    TEST_CHECK(TestIsFrame(buffer, 1));
+    info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+    TEST_CHECK(!info.crcValid && (0 == info.mpduLength));
+
+    uint8_t const* psdu = NULL;
+    info                = EMBENET_RADIO_LendReceivedFrame(&psdu);
+    TEST_CHECK(!info.crcValid && (NULL == psdu));
+
+    TEST_CHECK(TestReceive(2));
+    info = EMBENET_RADIO_LendReceivedFrame(&psdu);
+    TEST_CHECK(info.crcValid && (sizeof(testFrame) == info.mpduLength));
+    TEST_CHECK((NULL != psdu) && TestIsFrame(psdu, 2));
+    uint8_t const* again = NULL;
+    info                 = EMBENET_RADIO_LendReceivedFrame(&again);
+    TEST_CHECK(!info.crcValid && (NULL == again));
+    info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+    TEST_CHECK(!info.crcValid);
+    EMBENET_RADIO_ReleaseReceivedFrame(psdu);
+}
+
+// A frame too long for the buffer of the caller is dropped, not truncated, and its entry is reused
+static void TestTooLongFrameIsDropped(void) {
+    TestInit();
+    uint8_t buffer[sizeof(testFrame) - 1];
+    for (uint8_t sequence = 0; sequence < 2 * TEST_RX_ENTRY_COUNT; ++sequence) {
+        TEST_CHECK(TestReceive(sequence));
+        EMBENET_RADIO_RxInfo info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+        TEST_CHECK(!info.crcValid && (0 == info.mpduLength));
+    }
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(0 == counters.rxOverflows);
+}
+
+// Frames lent to the stack stay untouched while the following ones are received into the other entries.
+// With every entry lent the next frame is lost, a released entry is filled again
+static void TestLentFramesStayInPlace(void) {
+    TestInit();
+    uint8_t const* lent[TEST_RX_ENTRY_COUNT];
+    for (uint8_t sequence = 0; sequence < TEST_RX_ENTRY_COUNT; ++sequence) {
+        TEST_CHECK(TestReceive(sequence));
+        TEST_CHECK(EMBENET_RADIO_LendReceivedFrame(&lent[sequence]).crcValid);
+        for (uint8_t previous = 0; previous < sequence; ++previous) {
+            TEST_CHECK(lent[previous] != lent[sequence]);
+        }
+    }
+    for (uint8_t sequence = 0; sequence < TEST_RX_ENTRY_COUNT; ++sequence) {
+        TEST_CHECK(TestIsFrame(lent[sequence], sequence));
+    }
+
+    TEST_CHECK(!TestReceive(TEST_RX_ENTRY_COUNT));
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(1 == counters.rxOverflows);
+    TEST_CHECK(TEST_RX_ENTRY_COUNT == counters.rxFrames);
+    TEST_CHECK(TEST_RX_ENTRY_COUNT == testRadio.endCount);
+
+    // Only the released entry is reused
+    EMBENET_RADIO_ReleaseReceivedFrame(lent[1]);
+    TEST_CHECK(TestReceive(TEST_RX_ENTRY_COUNT + 1));
+    uint8_t const* psdu = NULL;
+    TEST_CHECK(EMBENET_RADIO_LendReceivedFrame(&psdu).crcValid);
+    TEST_CHECK(lent[1] == psdu);
+    TEST_CHECK(TestIsFrame(psdu, TEST_RX_ENTRY_COUNT + 1));
+    TEST_CHECK(TestIsFrame(lent[0], 0));
+    TEST_CHECK(TestIsFrame(lent[2], 2));
+    TEST_CHECK(TestIsFrame(lent[3], 3));
+
+    // Pointers the radio did not lend are ignored
+    EMBENET_RADIO_ReleaseReceivedFrame(NULL);
+    EMBENET_RADIO_ReleaseReceivedFrame(testFrame);
+    TEST_CHECK(!TestReceive(TEST_RX_ENTRY_COUNT + 2));
+
+    for (uint8_t sequence = 0; sequence < TEST_RX_ENTRY_COUNT; ++sequence) {
+        EMBENET_RADIO_ReleaseReceivedFrame(lent[sequence]);
+    }
+    for (uint8_t sequence = 0; sequence < 2 * TEST_RX_ENTRY_COUNT; ++sequence) {
+        TEST_CHECK(TestReceive(sequence));
+    }
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(2 == counters.rxOverflows);
+}
+
+// A frame the stack does not take is dropped by the next listening, so entries never run out without frames being lent
+static void TestFrameNotTakenIsReused(void) {
+    TestInit();
+    for (uint8_t sequence = 0; sequence < 3 * TEST_RX_ENTRY_COUNT; ++sequence) {
+        TEST_CHECK(TestReceive(sequence));
+    }
+    uint8_t              buffer[EMBENET_RADIO_MAX_PSDU_LENGTH];
+    EMBENET_RADIO_RxInfo info = EMBENET_RADIO_GetReceivedFrame(buffer, sizeof(buffer));
+    TEST_CHECK(info.crcValid && TestIsFrame(buffer, 3 * TEST_RX_ENTRY_COUNT - 1));
+
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(0 == counters.rxOverflows);
+    TEST_CHECK(3 * TEST_RX_ENTRY_COUNT == counters.rxFrames);
+}
+
+int main(void) {
+    TEST_RUN(TestFrameIsConsumedOnce);
+    TEST_RUN(TestTooLongFrameIsDropped);
+    TEST_RUN(TestLentFramesStayInPlace);
+    TEST_RUN(TestFrameNotTakenIsReused);
+    return TEST_RESULT();
+}
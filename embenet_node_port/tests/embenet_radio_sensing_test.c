@@ -0,0 +1,269 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Clear channel assessment and energy scan of the radio, against a fake RF driver playing the RF core with simulated RSSI
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+// clang-format off
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+// clang-format on
+
+#include <stdlib.h>
+
+enum {
+    TEST_CCA_THRESHOLD = -90,
+    TEST_CALLBACK_NS   = 10000,  ///< Delay of the RF driver callbacks after the end of an operation
+    TEST_SAMPLE_NS     = 100000, ///< RSSI sampling period of the energy scan
+    TEST_DWELL_US      = 400,    ///< Time of sampling on a single channel, TEST_SAMPLE_COUNT sampling periods
+    TEST_SAMPLE_COUNT  = 4,
+    TEST_CHANNEL_COUNT = 3,
+};
+
+static uint8_t const testFrame[] = {0x41, 0xd8, 0x01, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+static EMBENET_RADIO_Channel const testChannels[TEST_CHANNEL_COUNT] = {0, 34, 68};
+
+static struct {
+    unsigned startCount; ///< Number of start of frame callbacks
+    unsigned endCount;   ///< Number of end of frame callbacks
+} testRadio;
+
+static struct {
+    unsigned doneCount; ///< Number of onDone callbacks of the energy scan
+    size_t   scanned;   ///< Channels reported by the last onDone
+} testScan;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestStartOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    (void)t;
+    testRadio.startCount++;
+}
+
+static void TestEndOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    (void)t;
+    testRadio.endCount++;
+}
+
+static void TestScanDone(void* context, size_t scanned) {
+    TEST_CHECK(&testScan == context);
+    testScan.doneCount++;
+    testScan.scanned = scanned;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    testRadio.startCount = 0;
+    testRadio.endCount   = 0;
+    testScan.doneCount   = 0;
+    testScan.scanned     = 0;
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    EMBENET_RADIO_SetCallbacks(TestStartOfFrame, TestEndOfFrame, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetAutoAck(NULL, 0, 0, 0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(0));
+}
+
+// The RF core tunes the synthesizer, senses the channel at the given RSSI if CCA is enabled and sends the frame if the channel is clear.
+// Returns true if the frame was sent
+static bool TestTransmitAt(int8_t rssi) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_SetCca(false, TEST_CCA_THRESHOLD));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxNow());
+    RF_CmdHandle ch = SIM_RF_GetLastCommand();
+    SIM_RF_SetStatus(ch, CMD_FS, DONE_OK);
+    SIM_RF_Callback(ch, RF_EventCmdDone, TEST_CALLBACK_NS);
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+
+    SIM_RF_SetRssi(rssi);
+    bool busy = SIM_RF_SenseChannel(ch);
+    if (!busy) {
+        SIM_RF_Callback(ch, RF_EventCmdDone, TEST_CALLBACK_NS);
+        SIM_Advance(2 * TEST_CALLBACK_NS);
+        SIM_RF_SetStatus(ch, CMD_PROP_TX, PROP_DONE_OK);
+    }
+    SIM_RF_Callback(ch, RF_EventLastCmdDone, TEST_CALLBACK_NS);
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+    EMBENET_RADIO_Idle(); // as the MAC does at the end of the slot
+    return !busy;
+}
+
+// The frame is sent only when RSSI sensed by the RF core does not exceed the threshold, an undetermined channel is treated as busy
+static void TestCcaThreshold(void) {
+    static int8_t const rssis[] = {RF_GET_RSSI_ERROR_VAL, -110, TEST_CCA_THRESHOLD - 1, TEST_CCA_THRESHOLD, TEST_CCA_THRESHOLD + 1, -40};
+    static bool const   sent[]  = {false, true, true, true, false, false};
+
+    TestInit();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetCca(true, TEST_CCA_THRESHOLD));
+    for (size_t i = 0; i < sizeof(rssis) / sizeof(rssis[0]); ++i) {
+        unsigned startCount = testRadio.startCount;
+        unsigned endCount   = testRadio.endCount;
+        TEST_CHECK(sent[i] == TestTransmitAt(rssis[i]));
+        TEST_CHECK(startCount + (sent[i] ? 1 : 0) == testRadio.startCount);
+        TEST_CHECK(endCount + (sent[i] ? 1 : 0) == testRadio.endCount);
+        rfc_CMD_PROP_CS_t const* cs = (rfc_CMD_PROP_CS_t const*)SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_PROP_CS);
+        TEST_CHECK((NULL != cs) && (TEST_CCA_THRESHOLD == cs->rssiThr));
+    }
+
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(3 == counters.txFrames);
+    TEST_CHECK(3 == counters.txCcaBusy);
+    TEST_CHECK(0 == counters.txAborts);
+
+    // Without CCA the channel is not sensed at all
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetCca(false, TEST_CCA_THRESHOLD));
+    TEST_CHECK(TestTransmitAt(-40));
+    TEST_CHECK(NULL == SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_PROP_CS));
+    EMBENET_RADIO_GetCounters(&counters);
+    TEST_CHECK(4 == counters.txFrames);
+    TEST_CHECK(3 == counters.txCcaBusy);
+}
+
+// The RF core keeps the receiver on the channel being scanned, RSSI follows the given samples, one per sampling period, then the dwell time is over
+static void TestScanChannel(EMBENET_RADIO_Channel channel, int8_t const samples[TEST_SAMPLE_COUNT]) {
+    RF_CmdHandle ch = SIM_RF_GetLastCommand();
+    TEST_CHECK(SIM_RF_IsActive(ch));
+    rfc_CMD_FS_t const*      fs = (rfc_CMD_FS_t const*)SIM_RF_FindOp(ch, CMD_FS);
+    rfc_CMD_RX_TEST_t const* rx = (rfc_CMD_RX_TEST_t const*)SIM_RF_FindOp(ch, CMD_RX_TEST);
+    TEST_CHECK((NULL != fs) && (863 + (channel + 1) / 10 == fs->frequency)); // 863.1 MHz + 100 kHz per channel
+    TEST_CHECK((NULL != rx) && (TEST_DWELL_US * RF_NUM_RAT_TICKS_IN_1_US == rx->endTime));
+
+    for (size_t i = 0; i < TEST_SAMPLE_COUNT; ++i) {
+        SIM_RF_SetRssi(samples[i]);
+        SIM_Advance(TEST_SAMPLE_NS);
+    }
+    SIM_RF_SetRssi(RF_GET_RSSI_ERROR_VAL); // receiver off
+    SIM_RF_Callback(ch, RF_EventLastCmdDone, TEST_CALLBACK_NS);
+    SIM_Advance(2 * TEST_CALLBACK_NS);
+}
+
+static void TestCheckResult(EMBENET_RADIO_EnergyScanResult const* result, EMBENET_RADIO_Channel channel, EMBENET_RADIO_Power noiseFloor, EMBENET_RADIO_Power peak) {
+    TEST_CHECK(channel == result->channel);
+    TEST_CHECK(noiseFloor == result->noiseFloor);
+    TEST_CHECK(peak == result->peak);
+}
+
+// Every channel gets the lowest and the highest RSSI sampled during its dwell time, samples taken while the receiver is off are skipped
+static void TestScanReportsNoiseFloorAndPeak(void) {
+    static int8_t const quiet[TEST_SAMPLE_COUNT]    = {-105, -103, -107, -104};
+    static int8_t const burst[TEST_SAMPLE_COUNT]    = {-104, -60, -102, -106};
+    static int8_t const settling[TEST_SAMPLE_COUNT] = {RF_GET_RSSI_ERROR_VAL, -99, RF_GET_RSSI_ERROR_VAL, -101};
+
+    TestInit();
+    EMBENET_RADIO_EnergyScanResult results[TEST_CHANNEL_COUNT];
+    uint64_t                       startTime = SIM_Now();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    TEST_CHECK(SIM_Now() - startTime < TEST_SAMPLE_NS); // returns at once
+    TEST_CHECK(0 == testScan.doneCount);
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_SetCca(false, TEST_CCA_THRESHOLD));
+
+    TestScanChannel(testChannels[0], quiet);
+    TestScanChannel(testChannels[1], burst);
+    TEST_CHECK(0 == testScan.doneCount);
+    TestScanChannel(testChannels[2], settling);
+    TEST_CHECK(1 == testScan.doneCount);
+    TEST_CHECK(TEST_CHANNEL_COUNT == testScan.scanned);
+    TestCheckResult(&results[0], testChannels[0], -107, -103);
+    TestCheckResult(&results[1], testChannels[1], -106, -60);
+    TestCheckResult(&results[2], testChannels[2], -101, -99);
+
+    // Sampling stops with the scan and the radio is idle again
+    SIM_RF_SetRssi(-20);
+    SIM_Advance(10 * TEST_SAMPLE_NS);
+    TestCheckResult(&results[2], testChannels[2], -101, -99);
+    TEST_CHECK(1 == testScan.doneCount);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetCca(false, TEST_CCA_THRESHOLD));
+}
+
+// A channel on which no RSSI could be sampled is reported as such
+static void TestScanWithoutSamples(void) {
+    static int8_t const off[TEST_SAMPLE_COUNT] = {RF_GET_RSSI_ERROR_VAL, RF_GET_RSSI_ERROR_VAL, RF_GET_RSSI_ERROR_VAL, RF_GET_RSSI_ERROR_VAL};
+
+    TestInit();
+    EMBENET_RADIO_EnergyScanResult result;
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_StartEnergyScan(testChannels, 1, TEST_DWELL_US, &result, TestScanDone, &testScan));
+    TestScanChannel(testChannels[0], off);
+    TEST_CHECK(1 == testScan.doneCount);
+    TEST_CHECK(1 == testScan.scanned);
+    TestCheckResult(&result, testChannels[0], -128, -128);
+}
+
+// The MAC takes the radio from the scan at once, the channels finished until then are reported and the flushed scan does not disturb the MAC
+static void TestScanGivesWayToMac(void) {
+    static int8_t const quiet[TEST_SAMPLE_COUNT] = {-105, -103, -107, -104};
+
+    TestInit();
+    EMBENET_RADIO_EnergyScanResult results[TEST_CHANNEL_COUNT];
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    TestScanChannel(testChannels[0], quiet);
+    RF_CmdHandle scanning = SIM_RF_GetLastCommand();
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(1 == testScan.doneCount);
+    TEST_CHECK(1 == testScan.scanned);
+    TEST_CHECK(!SIM_RF_IsActive(scanning));
+    TestCheckResult(&results[0], testChannels[0], -107, -103);
+
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    RF_CmdHandle listening = SIM_RF_GetLastCommand();
+    SIM_Advance(2 * SIM_RF_CALLBACK_LATENCY_NS + 10 * TEST_SAMPLE_NS);
+    TEST_CHECK(1 == testScan.doneCount);
+    TEST_CHECK(SIM_RF_IsActive(listening));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_RxEnable(0)); // still listening
+    EMBENET_RADIO_Idle();
+
+    // Stopped before any channel was finished
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    EMBENET_RADIO_Idle();
+    TEST_CHECK(2 == testScan.doneCount);
+    TEST_CHECK(0 == testScan.scanned);
+
+    // Stopped by a transmission
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(3 == testScan.doneCount);
+    TEST_CHECK(0 == testScan.scanned);
+    EMBENET_RADIO_Idle();
+    SIM_Advance(2 * SIM_RF_CALLBACK_LATENCY_NS);
+    TEST_CHECK(3 == testScan.doneCount);
+}
+
+static void TestScanArguments(void) {
+    TestInit();
+    EMBENET_RADIO_EnergyScanResult results[TEST_CHANNEL_COUNT];
+    TEST_CHECK(EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS == EMBENET_RADIO_StartEnergyScan(testChannels, 0, TEST_DWELL_US, results, TestScanDone, &testScan));
+    TEST_CHECK(EMBENET_RADIO_STATUS_PARAMETER_ARGS_OUT_OF_BOUNDS == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, NULL, &testScan));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_StartEnergyScan(testChannels, TEST_CHANNEL_COUNT, TEST_DWELL_US, results, TestScanDone, &testScan));
+    EMBENET_RADIO_Idle();
+    TEST_CHECK(0 == testScan.doneCount);
+}
+
+int main(void) {
+    TEST_RUN(TestCcaThreshold);
+    TEST_RUN(TestScanReportsNoiseFloorAndPeak);
+    TEST_RUN(TestScanWithoutSamples);
+    TEST_RUN(TestScanGivesWayToMac);
+    TEST_RUN(TestScanArguments);
+    return TEST_RESULT();
+}
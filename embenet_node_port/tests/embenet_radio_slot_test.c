@@ -0,0 +1,121 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Slot template of every PHY profile, printed as a table and checked against the MAC timings of the port
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_port_capabilities.h>
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+
+#include <stdlib.h>
+
+enum {
+    TEST_BYTE_AIR_TIME_US = 160, ///< Air time of a byte at 50 kbps
+    TEST_FRAME_OVERHEAD   = 13,  ///< Preamble (8), synchronization word (2), length field (1) and CRC (2) in bytes
+    // Enhanced ACK: frame control (2), sequence number (1), destination PAN ID (2), extended destination address (8), time correction IE (4)
+    TEST_ACK_PSDU_LENGTH = 17,
+};
+
+/// Times of the slot template from the start of the slot in us, for the longest frame and both guard times used up
+typedef struct {
+    EMBENET_TimeUs txTrigger;  ///< Transmission of the frame is triggered
+    EMBENET_TimeUs frameStart; ///< First bit of preamble of the frame on air, as expected by the receiver
+    EMBENET_TimeUs rxStart;    ///< Receiver listens, TsLongGT before the expected frame
+    EMBENET_TimeUs frameEnd;   ///< Last bit of the frame on air, if it came TsLongGT late
+    EMBENET_TimeUs ackTrigger; ///< Transmission of the ACK is triggered
+    EMBENET_TimeUs ackStart;   ///< First bit of preamble of the ACK on air
+    EMBENET_TimeUs ackEnd;     ///< Last bit of the ACK on air, if it came TsShortGT late
+} TestSlotTemplate;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static TestSlotTemplate TestGetSlotTemplate(EMBENET_RADIO_Phy phy) {
+    EMBENET_MAC_Timings const*        mac   = &embenetMacTimings;
+    EMBENET_RADIO_Capabilities const* radio = EMBENET_RADIO_GetPhyCapabilities(phy);
+    TestSlotTemplate                  slot;
+    slot.frameStart = mac->TsTxOffsetUs;
+    slot.txTrigger  = slot.frameStart - radio->txDelay;
+    slot.rxStart    = slot.frameStart - mac->TsLongGTUs - radio->rxDelay;
+    slot.frameEnd   = slot.frameStart + mac->TsLongGTUs + EMBENET_RADIO_GetAirTime(phy, EMBENET_RADIO_MAX_PSDU_LENGTH);
+    slot.ackStart   = slot.frameEnd + mac->TsTxAckDelayUs;
+    slot.ackTrigger = slot.ackStart - radio->txDelay;
+    slot.ackEnd     = slot.ackStart + mac->TsShortGTUs + EMBENET_RADIO_GetAirTime(phy, TEST_ACK_PSDU_LENGTH);
+    return slot;
+}
+
+static void TestPrintSlotTemplate(EMBENET_RADIO_Phy phy, TestSlotTemplate const* slot) {
+    printf("PHY %u, %u B frame %" PRIu32 " us, %u B ACK %" PRIu32 " us\n", (unsigned)phy, (unsigned)EMBENET_RADIO_MAX_PSDU_LENGTH,
+           EMBENET_RADIO_GetAirTime(phy, EMBENET_RADIO_MAX_PSDU_LENGTH), (unsigned)TEST_ACK_PSDU_LENGTH, EMBENET_RADIO_GetAirTime(phy, TEST_ACK_PSDU_LENGTH));
+    printf("  | event       | time [us] |\n");
+    printf("  | rx start    | %9" PRIu32 " |\n", slot->rxStart);
+    printf("  | tx trigger  | %9" PRIu32 " |\n", slot->txTrigger);
+    printf("  | frame start | %9" PRIu32 " |\n", slot->frameStart);
+    printf("  | frame end   | %9" PRIu32 " |\n", slot->frameEnd);
+    printf("  | ack trigger | %9" PRIu32 " |\n", slot->ackTrigger);
+    printf("  | ack start   | %9" PRIu32 " |\n", slot->ackStart);
+    printf("  | ack end     | %9" PRIu32 " |\n", slot->ackEnd);
+    printf("  | slot end    | %9" PRIu32 " |\n", embenetMacTimings.TsSlotDurationUs);
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+}
+
+// The air time covers preamble, synchronization word, length field, PSDU and CRC
+static void TestAirTime(void) {
+    TestInit();
+    TEST_CHECK((TEST_FRAME_OVERHEAD + EMBENET_RADIO_MAX_PSDU_LENGTH) * TEST_BYTE_AIR_TIME_US == EMBENET_RADIO_GetAirTime(EMBENET_RADIO_PHY_50KBPS, EMBENET_RADIO_MAX_PSDU_LENGTH));
+    TEST_CHECK(TEST_FRAME_OVERHEAD * TEST_BYTE_AIR_TIME_US == EMBENET_RADIO_GetAirTime(EMBENET_RADIO_PHY_50KBPS, 0));
+    TEST_CHECK(0 == EMBENET_RADIO_GetAirTime(EMBENET_RADIO_PHY_COUNT, 0));
+}
+
+// Every PHY profile fits the slot template of the MAC, also with CCA, which delays the transmission
+static void TestEveryPhyFitsSlot(void) {
+    TestInit();
+    for (int cca = 0; cca <= 1; ++cca) {
+        TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetCca(1 == cca, -90));
+        for (EMBENET_RADIO_Phy phy = 0; phy < EMBENET_RADIO_PHY_COUNT; ++phy) {
+            EMBENET_MAC_Timings const*        mac   = &embenetMacTimings;
+            EMBENET_RADIO_Capabilities const* radio = EMBENET_RADIO_GetPhyCapabilities(phy);
+            TestSlotTemplate                  slot  = TestGetSlotTemplate(phy);
+            if (0 == cca) {
+                TestPrintSlotTemplate(phy, &slot);
+            }
+            // The radio is triggered and listens within the slot, after the previous slot ended
+            TEST_CHECK(radio->txDelay + radio->idleToTxReady < mac->TsTxOffsetUs);
+            TEST_CHECK(mac->TsLongGTUs + radio->rxDelay + radio->idleToRxReady < mac->TsTxOffsetUs);
+            TEST_CHECK(radio->txDelay <= mac->wdRadioTxUs);
+            // The ACK is triggered by software after the end of frame callback
+            TEST_CHECK(radio->activeToTxReady + radio->txDelay < mac->TsTxAckDelayUs);
+            // The longest frame and the ACK fit their watchdogs and the slot
+            TEST_CHECK(EMBENET_RADIO_GetAirTime(phy, EMBENET_RADIO_MAX_PSDU_LENGTH) <= mac->wdDataDurationUs);
+            TEST_CHECK(EMBENET_RADIO_GetAirTime(phy, TEST_ACK_PSDU_LENGTH) <= mac->wdAckDurationUs);
+            TEST_CHECK(slot.ackEnd <= mac->TsSlotDurationUs);
+        }
+    }
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetCca(false, -90));
+}
+
+int main(void) {
+    TEST_RUN(TestAirTime);
+    TEST_RUN(TestEveryPhyFitsSlot);
+    return TEST_RESULT();
+}
@@ -0,0 +1,270 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Triggers and listening windows of the radio commands converted from the timer to RAT time and RX timestamps converted back, across
+           the wraps of either clock and for times in the past
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <embenet_radio_cc1312.h>
+#include <embenet_timer_cc1312.h>
+
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+
+#include <stdlib.h>
+
+enum {
+    TEST_TRIGGER_AHEAD    = 1000, ///< Time between the call and the trigger in us
+    TEST_TRIGGER_LATE     = 2000, ///< Time by which a trigger in the past is late in us, longer than txDelay
+    TEST_TIME_TOLERANCE   = 1,    ///< Rounding of the conversions between the timer, RAT and the simulated time in us
+    TEST_RX_WINDOW        = 1500, ///< Listening window in us, shorter than TEST_TRIGGER_LATE
+    TEST_CRC_LENGTH       = 2,
+    TEST_CALLBACK_US      = 20,   ///< Latency of the callbacks of the RF driver, as usual
+    TEST_LATE_CALLBACK_US = 3000, ///< Latency of the callbacks of the RF driver held by other interrupts
+    TEST_RAT_TICKS_IN_US  = 4,
+    TEST_NS_IN_RAT_TICK   = 1000 / TEST_RAT_TICKS_IN_US,
+};
+
+/// Distances in us between the call and the wrap of a clock, the trigger comes before, around and after the wrap
+static EMBENET_TimeUs const testBeforeWrap[] = {2 * TEST_TRIGGER_AHEAD, TEST_TRIGGER_AHEAD + 1, TEST_TRIGGER_AHEAD, TEST_TRIGGER_AHEAD - 1, 400, 1};
+
+static uint8_t const testFrame[] = {0x41, 0xd8, 0x01, 0xcd, 0xab, 0xff, 0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+
+static struct {
+    EMBENET_TimeUs start; ///< Time passed to the last start of frame callback
+    EMBENET_TimeUs end;   ///< Time passed to the last end of frame callback
+} testRadio;
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+}
+
+static void TestStartOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    testRadio.start = t;
+}
+
+static void TestEndOfFrame(void* context, EMBENET_TimeUs t) {
+    (void)context;
+    testRadio.end = t;
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_RF_Reset();
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Init());
+    EMBENET_RADIO_SetCallbacks(TestStartOfFrame, TestEndOfFrame, NULL);
+}
+
+static bool TestNear(EMBENET_TimeUs actual, EMBENET_TimeUs expected) {
+    int32_t error = (int32_t)(actual - expected);
+    return (error >= -TEST_TIME_TOLERANCE) && (error <= TEST_TIME_TOLERANCE);
+}
+
+/// Runs the simulation until the timer reads the given time, up to a wrap of the timer ahead
+static void TestRunUntilTimer(EMBENET_TimeUs t) {
+    SIM_Advance((uint64_t)(t - EMBENET_TIMER_ReadCounter()) * 1000);
+    TEST_CHECK(TestNear(EMBENET_TIMER_ReadCounter(), t));
+}
+
+/// Runs the simulation until RAT reaches the given time, up to a wrap of RAT ahead, and returns the timer read then, i.e. the time at which
+/// the RF core starts a command triggered at the given RAT time
+static EMBENET_TimeUs TestRunUntilRat(ratmr_t t) {
+    uint32_t ahead = (uint32_t)(t - RF_getCurrentTime()); // the read takes simulated time, so it comes before SIM_Now
+    SIM_AdvanceTo((SIM_Now() / TEST_NS_IN_RAT_TICK + ahead) * TEST_NS_IN_RAT_TICK);
+    TEST_CHECK(t == RF_getCurrentTime());
+    return EMBENET_TIMER_ReadCounter();
+}
+
+/// Returns true if the command starts at its RAT start time, or at once if the time is in the past
+static bool TestTriggeredByRat(RF_Op const* op) {
+    return (TRIG_ABSTIME == op->startTrigger.triggerType) && (1 == op->startTrigger.pastTrig);
+}
+
+/// Sends testFrame at the trigger and checks that RAT starts the synthesizer at the trigger and the frame txDelay later
+static void TestTxAt(EMBENET_TimeUs trigger) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxAt(trigger));
+    RF_CmdHandle tx = SIM_RF_GetLastCommand();
+    RF_Op const* fs = SIM_RF_FindOp(tx, CMD_FS);
+    RF_Op const* op = SIM_RF_FindOp(tx, CMD_PROP_TX);
+    TEST_CHECK(TestTriggeredByRat(fs) && TestTriggeredByRat(op));
+    TEST_CHECK(TestNear(TestRunUntilRat(fs->startTime), trigger));
+    TEST_CHECK(TestNear(TestRunUntilRat(op->startTime), trigger + EMBENET_RADIO_GetCapabilities()->txDelay));
+}
+
+/// Listens from the trigger and checks that RAT starts the synthesizer at the trigger
+static void TestRxAt(EMBENET_TimeUs trigger) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxAt(trigger));
+    RF_Op const* fs = SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_FS);
+    TEST_CHECK(TestTriggeredByRat(fs));
+    TEST_CHECK(TestNear(TestRunUntilRat(fs->startTime), trigger));
+}
+
+// The timer counter wraps after 2^32 us, between the call and the trigger, or between the trigger and the start of the frame
+static void TestTriggersAcrossTimerWrap(void) {
+    for (size_t i = 0; i < sizeof(testBeforeWrap) / sizeof(testBeforeWrap[0]); ++i) {
+        TestInit();
+        TestRunUntilTimer(0u - testBeforeWrap[i]);
+        TestTxAt(EMBENET_TIMER_ReadCounter() + TEST_TRIGGER_AHEAD);
+
+        TestInit();
+        TestRunUntilTimer(0u - testBeforeWrap[i]);
+        TestRxAt(EMBENET_TIMER_ReadCounter() + TEST_TRIGGER_AHEAD);
+    }
+}
+
+// RAT wraps after 2^32 ticks, at a timer time of no particular value
+static void TestTriggersAcrossRatWrap(void) {
+    for (size_t i = 0; i < sizeof(testBeforeWrap) / sizeof(testBeforeWrap[0]); ++i) {
+        TestInit();
+        TestRunUntilRat(0u - testBeforeWrap[i] * TEST_RAT_TICKS_IN_US);
+        TestTxAt(EMBENET_TIMER_ReadCounter() + TEST_TRIGGER_AHEAD);
+
+        TestInit();
+        TestRunUntilRat(0u - testBeforeWrap[i] * TEST_RAT_TICKS_IN_US);
+        TestRxAt(EMBENET_TIMER_ReadCounter() + TEST_TRIGGER_AHEAD);
+    }
+}
+
+// A trigger in the past is converted to a RAT time in the past, which the RF core takes as a start at once, instead of a time a wrap ahead
+static void TestTriggerInPast(void) {
+    TestInit();
+    TestRunUntilTimer(0u - TEST_TRIGGER_LATE / 2); // the late trigger is before the wrap
+    EMBENET_TimeUs trigger = EMBENET_TIMER_ReadCounter() - TEST_TRIGGER_LATE;
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxEnable(0, 0, testFrame, sizeof(testFrame)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_TxAt(trigger));
+    RF_CmdHandle tx = SIM_RF_GetLastCommand();
+    RF_Op const* fs = SIM_RF_FindOp(tx, CMD_FS);
+    RF_Op const* op = SIM_RF_FindOp(tx, CMD_PROP_TX);
+    TEST_CHECK(TestTriggeredByRat(fs) && TestTriggeredByRat(op));
+    int32_t fsLate = (int32_t)(RF_getCurrentTime() - fs->startTime) / TEST_RAT_TICKS_IN_US;
+    int32_t opLate = (int32_t)(RF_getCurrentTime() - op->startTime) / TEST_RAT_TICKS_IN_US;
+    TEST_CHECK(TestNear((EMBENET_TimeUs)fsLate, TEST_TRIGGER_LATE));
+    TEST_CHECK(TestNear((EMBENET_TimeUs)opLate, TEST_TRIGGER_LATE - EMBENET_RADIO_GetCapabilities()->txDelay));
+
+    TestInit();
+    TestRunUntilTimer(TEST_TRIGGER_LATE / 2); // the late trigger is below zero, RAT time too
+    trigger = EMBENET_TIMER_ReadCounter() - TEST_TRIGGER_LATE;
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxAt(trigger));
+    fs = SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_FS);
+    TEST_CHECK(TestTriggeredByRat(fs));
+    fsLate = (int32_t)(RF_getCurrentTime() - fs->startTime) / TEST_RAT_TICKS_IN_US;
+    TEST_CHECK(TestNear((EMBENET_TimeUs)fsLate, TEST_TRIGGER_LATE));
+}
+
+/**
+ * @brief Listens from the trigger within TEST_RX_WINDOW and checks that RAT closes the window its length after the trigger
+ * @param[in] now true to listen with EMBENET_RADIO_RxNow, whose trigger is the call, false to listen with EMBENET_RADIO_RxAt
+ * @param[in] trigger time of the trigger, ignored if now is true
+ */
+static void TestRxWindow(bool now, EMBENET_TimeUs trigger) {
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(TEST_RX_WINDOW));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    if (now) {
+        trigger = EMBENET_TIMER_ReadCounter();
+    }
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == (now ? EMBENET_RADIO_RxNow() : EMBENET_RADIO_RxAt(trigger)));
+    TEST_CHECK(EMBENET_RADIO_STATUS_WRONG_STATE == EMBENET_RADIO_SetRxWindow(0)); // the chain is executed by the RF core
+    rfc_CMD_PROP_RX_t const* rx = (rfc_CMD_PROP_RX_t const*)SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_PROP_RX);
+    TEST_CHECK((TRIG_ABSTIME == rx->endTrigger.triggerType) && (1 == rx->endTrigger.pastTrig));
+    EMBENET_TimeUs timerNow = EMBENET_TIMER_ReadCounter();
+    int32_t        ahead    = (int32_t)(rx->endTime - RF_getCurrentTime()) / TEST_RAT_TICKS_IN_US;
+    if (ahead < 0) {
+        // the RF core ends at once, the end is compared in another sample of both clocks, which adds its rounding
+        TEST_CHECK_RANGE((int32_t)(timerNow + (EMBENET_TimeUs)ahead - (trigger + TEST_RX_WINDOW)), -2 * TEST_TIME_TOLERANCE, 2 * TEST_TIME_TOLERANCE);
+    } else {
+        TEST_CHECK(TestNear(TestRunUntilRat(rx->endTime), trigger + TEST_RX_WINDOW));
+    }
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_Idle());
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_SetRxWindow(0));
+}
+
+// The window closes its length after the trigger, across the wraps of either clock and for a trigger so late that the window is over.
+// Without a window the listening has no end trigger.
+static void TestRxWindowEnd(void) {
+    for (unsigned clock = 0; clock < 3; ++clock) {
+        for (unsigned trigger = 0; trigger < 3; ++trigger) {
+            TestInit();
+            if (1 == clock) {
+                TestRunUntilTimer(0u - TEST_RX_WINDOW / 2); // the timer wraps within the window
+            } else if (2 == clock) {
+                TestRunUntilRat(0u - TEST_RX_WINDOW / 2 * TEST_RAT_TICKS_IN_US); // RAT wraps within the window
+            }
+            EMBENET_TimeUs now = EMBENET_TIMER_ReadCounter();
+            TestRxWindow(0 == trigger, (1 == trigger) ? now + TEST_TRIGGER_AHEAD : now - TEST_TRIGGER_LATE);
+        }
+    }
+
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    rfc_CMD_PROP_RX_t const* rx = (rfc_CMD_PROP_RX_t const*)SIM_RF_FindOp(SIM_RF_GetLastCommand(), CMD_PROP_RX);
+    TEST_CHECK(TRIG_NEVER == rx->endTrigger.triggerType);
+}
+
+/**
+ * @brief Listens at once and receives testFrame synchronized now, whose timestamp the RF core appends in RAT time.
+ * The RF driver calls the start and end of frame callbacks the given latency after the synchronization and the end of the frame.
+ * @param[in] latency latency of the callbacks in us
+ * @return timer time of the synchronization
+ */
+static EMBENET_TimeUs TestReceive(EMBENET_TimeUs latency) {
+    EMBENET_TimeUs byteAirTime = EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), 1) - EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), 0);
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxEnable(0));
+    TEST_CHECK(EMBENET_RADIO_STATUS_SUCCESS == EMBENET_RADIO_RxNow());
+    RF_CmdHandle   rx       = SIM_RF_GetLastCommand();
+    ratmr_t        syncTime = RF_getCurrentTime();
+    EMBENET_TimeUs sync     = EMBENET_TIMER_ReadCounter();
+    SIM_RF_Callback(rx, RF_EventMdmSoft, (uint64_t)latency * 1000);
+    SIM_Advance((uint64_t)(1 + sizeof(testFrame) + TEST_CRC_LENGTH) * byteAirTime * 1000);
+    TEST_CHECK(SIM_RF_ReceiveFrame(rx, testFrame, sizeof(testFrame), -60, syncTime));
+    SIM_RF_SetStatus(rx, CMD_PROP_RX, PROP_DONE_OK);
+    SIM_RF_Callback(rx, RF_EventRxOk | RF_EventLastCmdDone, (uint64_t)latency * 1000);
+    SIM_Advance((uint64_t)latency * 1000);
+    return sync;
+}
+
+// The end of a received frame follows from the RAT timestamp of the synchronization, however late the callback and across the wraps of
+// either clock, while the start of frame is taken in software and moves with the callback
+static void TestRxTimestamps(void) {
+    EMBENET_TimeUs byteAirTime = EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), 1) - EMBENET_RADIO_GetAirTime(EMBENET_RADIO_GetPhy(), 0);
+    EMBENET_TimeUs syncToEnd   = (EMBENET_TimeUs)(1 + sizeof(testFrame) + TEST_CRC_LENGTH) * byteAirTime;
+    for (unsigned clock = 0; clock < 3; ++clock) {
+        for (EMBENET_TimeUs latency = TEST_CALLBACK_US; latency <= TEST_LATE_CALLBACK_US; latency += TEST_LATE_CALLBACK_US - TEST_CALLBACK_US) {
+            TestInit();
+            if (1 == clock) {
+                TestRunUntilTimer(0u - latency); // the timer wraps between the synchronization and the callbacks
+            } else if (2 == clock) {
+                TestRunUntilRat(0u - latency * TEST_RAT_TICKS_IN_US); // RAT wraps between the synchronization and the callbacks
+            }
+            EMBENET_RADIO_Calibration calibration;
+            EMBENET_RADIO_GetCalibration(&calibration);
+            EMBENET_TimeUs sync = TestReceive(latency);
+            TEST_CHECK(TestNear(testRadio.end, sync + syncToEnd));
+            TEST_CHECK(TestNear(testRadio.start, sync + latency - calibration.rxStartCorrection));
+        }
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestTriggersAcrossTimerWrap);
+    TEST_RUN(TestTriggersAcrossRatWrap);
+    TEST_RUN(TestTriggerInPast);
+    TEST_RUN(TestRxTimestamps);
+    TEST_RUN(TestRxWindowEnd);
+    return TEST_RESULT();
+}
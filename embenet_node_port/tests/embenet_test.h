@@ -0,0 +1,50 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Minimal checks shared by the tests of the port
+*/
+
+#ifndef EMBENET_TEST_H_
+#define EMBENET_TEST_H_
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+
+static unsigned testFailures;
+
+/// Reports a failure if the condition does not hold
+#define TEST_CHECK(cond)                                                             \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            testFailures++;                                                          \
+        }                                                                            \
+    } while (0)
+
+/// Reports a failure, together with the value, if the value is not within [min, max]
+#define TEST_CHECK_RANGE(value, min, max)                                                                                         \
+    do {                                                                                                                          \
+        int64_t testValue = (int64_t)(value);                                                                                     \
+        if ((testValue < (int64_t)(min)) || (testValue > (int64_t)(max))) {                                                       \
+            fprintf(stderr, "%s:%d: %s = %" PRId64 " not in [%" PRId64 ", %" PRId64 "]\n", __FILE__, __LINE__, #value, testValue, \
+                    (int64_t)(min), (int64_t)(max));                                                                              \
+            testFailures++;                                                                                                       \
+        }                                                                                                                         \
+    } while (0)
+
+/// Runs a test case and reports its name
+#define TEST_RUN(test)                                                        \
+    do {                                                                      \
+        unsigned before = testFailures;                                       \
+        test();                                                               \
+        printf("%s %s\n", (before == testFailures) ? "PASS" : "FAIL", #test); \
+    } while (0)
+
+/// Exit code of the test executable
+#define TEST_RESULT() ((0 == testFailures) ? 0 : 1)
+
+#endif // EMBENET_TEST_H_ included
@@ -0,0 +1,89 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Timing of the stack compare and software timers sharing the timer interrupt, against a simulated timer
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+
+#include <embenet_timer_cc1312.h>
+
+enum {
+    TEST_MAX_DELAY_US = 2, ///< Allowed delay of a callback, the interrupt and the read of the time take about a us
+};
+
+typedef struct {
+    unsigned compareCount;   ///< Number of stack compare callbacks
+    uint64_t compareValue;   ///< Time read by the last stack compare callback
+    unsigned softTimerCount; ///< Number of software timer callbacks
+    uint64_t softTimerValue; ///< Time read by the last software timer callback
+} TestTimer;
+
+static TestTimer testTimer;
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+    testTimer.compareCount++;
+    testTimer.compareValue = EMBENET_TIMER_ReadCounter64();
+}
+
+static void TestSoftTimerCallback(EMBENET_TIMER_SoftTimer* timer, void* context) {
+    (void)timer;
+    (void)context;
+    testTimer.softTimerCount++;
+    testTimer.softTimerValue = EMBENET_TIMER_ReadCounter64();
+}
+
+static void TestInit(void) {
+    SIM_Reset();
+    SIM_GPTIMER_SetValueAfterStandby(0);
+    testTimer = (TestTimer){0};
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+}
+
+// Runs until the stack compare fires
+static void TestRunUntilCompare(void) {
+    for (unsigned i = 0; (i < 100000) && (0 == testTimer.compareCount); ++i) {
+        SIM_Advance(1000);
+    }
+    TEST_CHECK(1 == testTimer.compareCount);
+}
+
+// A compare closer than the guard time is forced at once, the callback still waits for the time
+static void TestCompareWithinGuardTime(void) {
+    for (uint64_t ahead = 0; ahead < 60; ahead += 7) {
+        TestInit();
+        SIM_Advance(12345);
+        uint64_t compare = EMBENET_TIMER_ReadCounter64() + ahead;
+        EMBENET_TIMER_SetCompare((EMBENET_TimeUs)compare);
+        TestRunUntilCompare();
+        TEST_CHECK_RANGE(testTimer.compareValue - compare, 0, TEST_MAX_DELAY_US);
+    }
+}
+
+// A software timer expiring shortly before the stack compare does not bring the stack callback forward
+static void TestSoftTimerBeforeCompare(void) {
+    for (uint64_t gap = 1; gap < 60; gap += 5) {
+        TestInit();
+        EMBENET_TIMER_SoftTimer timer;
+        EMBENET_TIMER_SoftTimerInit(&timer, TestSoftTimerCallback, NULL);
+        uint64_t expiry  = EMBENET_TIMER_ReadCounter64() + 1000;
+        uint64_t compare = expiry + gap;
+        EMBENET_TIMER_SoftTimerStart(&timer, expiry, 0);
+        EMBENET_TIMER_SetCompare((EMBENET_TimeUs)compare);
+        TestRunUntilCompare();
+        TEST_CHECK(1 == testTimer.softTimerCount);
+        TEST_CHECK_RANGE(testTimer.softTimerValue - expiry, 0, gap + TEST_MAX_DELAY_US); // served after the stack, if the stack came first
+        TEST_CHECK_RANGE(testTimer.compareValue - compare, 0, TEST_MAX_DELAY_US);
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestCompareWithinGuardTime);
+    TEST_RUN(TestSoftTimerBeforeCompare);
+    return TEST_RESULT();
+}
@@ -0,0 +1,159 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Timekeeping of the timer across standby, against a simulated timer and RTC
+*/
+
+#include "embenet_test.h"
+#include "sim.h"
+
+#include <embenet_timer_cc1312.h>
+
+enum {
+    TEST_STANDBY_ERROR_NS = 1334, ///< Allowed error added by one standby, the phase of the timer within a tick (4/3 us) is lost
+    TEST_MEASURE_ERROR_NS = 300,  ///< Uncertainty of the measured error of the time
+    TEST_MEASURE_READS    = 32,   ///< Number of reads averaged to measure the error of the time
+};
+
+static struct {
+    uint64_t offset;       ///< Simulated time in ns at which the timer read 0
+    unsigned compareCount; ///< Number of stack compare callbacks
+    uint64_t compareValue; ///< Time read by the last stack compare callback
+} testTimer;
+
+static void TestCompareCallback(void* context) {
+    (void)context;
+    testTimer.compareCount++;
+    testTimer.compareValue = EMBENET_TIMER_ReadCounter64();
+}
+
+// Error in ns of the given time read at the given simulated time
+static int64_t TestTimeError(uint64_t value, uint64_t at) {
+    return (int64_t)(value * 1000) - (int64_t)(at - testTimer.offset);
+}
+
+// Mean error in ns of the time, the reads are spread over the ticks of the timer to average out their truncation
+static int64_t TestMeasureError(void) {
+    int64_t sum = 0;
+    for (unsigned i = 0; i < TEST_MEASURE_READS; ++i) {
+        uint64_t at = SIM_Now();
+        sum += TestTimeError(EMBENET_TIMER_ReadCounter64(), at);
+        SIM_Advance(1777);
+    }
+    return sum / TEST_MEASURE_READS;
+}
+
+static void TestInit(uint32_t valueAfterStandby, int32_t rtcDrift, uint64_t wakeLatency) {
+    SIM_Reset();
+    SIM_GPTIMER_SetValueAfterStandby(valueAfterStandby);
+    SIM_RTC_SetDrift(rtcDrift);
+    SIM_POWER_SetWakeLatency(wakeLatency);
+    testTimer.compareCount = 0;
+    EMBENET_TIMER_Init(TestCompareCallback, NULL);
+    // The mean error of the reads is 0 by definition
+    testTimer.offset = SIM_Now();
+    testTimer.offset -= (uint64_t)TestMeasureError();
+}
+
+// Sets the stack compare the given time ahead and runs the main loop, sleeping whenever possible, until the compare fires.
+// Checks that the callback comes when the time reaches the compare and that each standby moved the time by at most a tick.
+static void TestSleepUntilCompare(uint64_t ahead, int64_t maxDelay) {
+    unsigned standby = SIM_POWER_GetStandbyCount();
+    int64_t  error   = TestMeasureError();
+    uint64_t compare = EMBENET_TIMER_ReadCounter64() + ahead;
+    EMBENET_TIMER_SetCompare((EMBENET_TimeUs)compare);
+    unsigned count = testTimer.compareCount;
+    while (count == testTimer.compareCount) {
+        if (!EMBENET_TIMER_Sleep()) {
+            SIM_Advance(10000); // the main loop runs
+        }
+    }
+    TEST_CHECK_RANGE(testTimer.compareValue - compare, 0, maxDelay);
+    int64_t tolerance = (int64_t)(SIM_POWER_GetStandbyCount() - standby) * TEST_STANDBY_ERROR_NS + TEST_MEASURE_ERROR_NS;
+    TEST_CHECK_RANGE(TestMeasureError() - error, -tolerance, tolerance);
+}
+
+// The timer restarts from an arbitrary value after standby, here shortly before the wrap of the counter
+static void TestCompareAfterStandbyAcrossWrap(void) {
+    TestInit(0xFFFFFE00u, 0, 0);
+    for (unsigned i = 0; i < 5; ++i) {
+        unsigned standby = SIM_POWER_GetStandbyCount();
+        TestSleepUntilCompare(100000, 2);
+        TEST_CHECK(SIM_POWER_GetStandbyCount() == standby + 1);
+    }
+}
+
+// The RTC runs 50 ppm fast, i.e. 50 us per second of standby, which the drift measured while awake compensates
+static void TestRtcDriftCompensation(void) {
+    TestInit(0, 50000, 0);
+    SIM_Advance(20000000000u);
+    for (unsigned i = 0; i < 5; ++i) {
+        TestSleepUntilCompare(1000000, 2);
+    }
+    TEST_CHECK_RANGE(EMBENET_TIMER_GetRtcDrift(), -50500, -49500);
+}
+
+// The node stays awake for hours before its first standby, the interval is longer than the window of the drift estimate
+static void TestDriftAfterHoursAwake(void) {
+    TestInit(0, 50000, 0);
+    SIM_Advance(10 * 3600 * 1000000000ull);
+    for (unsigned i = 0; i < 5; ++i) {
+        TestSleepUntilCompare(1000000, 2);
+    }
+    TEST_CHECK_RANGE(EMBENET_TIMER_GetRtcDrift(), -50500, -49500);
+}
+
+static struct {
+    uint64_t at;    ///< Simulated time of the interrupt
+    int64_t  error; ///< Error of the time read by its handler in ns
+    bool     handled;
+} testInterrupt;
+
+static uint64_t TestInterruptNext(void) {
+    return testInterrupt.at;
+}
+
+// The first read after standby waits for a tick of the RTC to take the time over, so the time is compared to the end of the read
+static void TestInterruptService(void) {
+    testInterrupt.at      = SIM_NEVER;
+    uint64_t value        = EMBENET_TIMER_ReadCounter64();
+    testInterrupt.error   = TestTimeError(value, SIM_Now());
+    testInterrupt.handled = true;
+}
+
+static SIM_Source const testInterruptSource = {.next = TestInterruptNext, .service = TestInterruptService};
+
+// Another interrupt wakes the device up and its handler reads the time, then the device sleeps again until the compare
+static void TestInterruptDuringStandby(void) {
+    TestInit(0x12345678u, 0, 200000);
+    unsigned standby = SIM_POWER_GetStandbyCount();
+    testInterrupt.at      = SIM_Now() + 40000000u;
+    testInterrupt.handled = false;
+    SIM_AddSource(&testInterruptSource);
+    TestSleepUntilCompare(100000, 2);
+    TEST_CHECK(testInterrupt.handled);
+    TEST_CHECK_RANGE(testInterrupt.error, -TEST_STANDBY_ERROR_NS - 1000, TEST_STANDBY_ERROR_NS + 1000); // and the truncation to us
+    TEST_CHECK(SIM_POWER_GetStandbyCount() == standby + 2);
+}
+
+// The wake-up takes longer than initially estimated, so the first compare comes late but the estimate learns
+static void TestWakeLatencyIsLearned(void) {
+    TestInit(0, 0, 1500000);
+    TestSleepUntilCompare(20000, 500);
+    TEST_CHECK(EMBENET_TIMER_GetWakeLatency() >= 1500);
+    for (unsigned i = 0; i < 3; ++i) {
+        TestSleepUntilCompare(20000, 2);
+    }
+}
+
+int main(void) {
+    TEST_RUN(TestCompareAfterStandbyAcrossWrap);
+    TEST_RUN(TestRtcDriftCompensation);
+    TEST_RUN(TestDriftAfterHoursAwake);
+    TEST_RUN(TestInterruptDuringStandby);
+    TEST_RUN(TestWakeLatencyIsLearned);
+    return TEST_RESULT();
+}
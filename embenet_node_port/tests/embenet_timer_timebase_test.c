@@ -0,0 +1,177 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Extension of the timer counter checked against exact arithmetic across wraps, with the cost of a read compared to a 64-bit division
+*/
+
+#include "embenet_test.h"
+
+#include <embenet_timer_timebase.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+    TEST_RANDOM_VALUES = 1000000, ///< Random dividends checked against the division
+    TEST_EDGE_VALUES   = 100000,  ///< Dividends checked at either end of the 32-bit range
+    TEST_WRAPS         = 7,       ///< Hardware periods stepped through, more than the phase needs to repeat
+    TEST_BENCH_COUNT   = 1000000, ///< Reads per benchmark measurement
+    TEST_BENCH_REPEATS = 5,       ///< Every measurement is repeated, the fastest run is taken
+};
+
+static uint32_t testRandom = 2463534242u;
+static uint32_t testTicks[TEST_BENCH_COUNT];
+
+void EXPECT_OnAbortHandler(char const* why, char const* file, int line) {
+    fprintf(stderr, "%s:%d: %s\n", file, line, why);
+    abort();
+}
+
+static uint32_t TestRandom(void) {
+    testRandom ^= testRandom << 13;
+    testRandom ^= testRandom >> 17;
+    testRandom ^= testRandom << 5;
+    return testRandom;
+}
+
+static double TestNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// The time in us of the given ticks since initialization, as the port computed it before the timebase
+static uint64_t TestTicksToUs(uint64_t ticks) {
+    return ticks * 4 / 3;
+}
+
+// The reciprocal gives the quotient of the division by 3 near 0, near UINT32_MAX and in between
+static void TestDivideBy3(void) {
+    for (uint32_t i = 0; i < TEST_EDGE_VALUES; ++i) {
+        TEST_CHECK(i / 3 == EMBENET_TIMER_TIMEBASE_DivideBy3(i));
+        TEST_CHECK((UINT32_MAX - i) / 3 == EMBENET_TIMER_TIMEBASE_DivideBy3(UINT32_MAX - i));
+    }
+    for (uint32_t i = 0; i < TEST_RANDOM_VALUES; ++i) {
+        uint32_t value = TestRandom();
+        TEST_CHECK(value / 3 == EMBENET_TIMER_TIMEBASE_DivideBy3(value));
+    }
+}
+
+// Stepping the counter through several wraps gives floor(4 * ticks / 3) of the total ticks, around every wrap and in every phase
+static void TestTimeAcrossWraps(void) {
+    EMBENET_TIMER_TIMEBASE_Timebase timebase;
+    EMBENET_TIMER_TIMEBASE_Init(&timebase);
+    for (uint64_t wrap = 0; wrap < TEST_WRAPS; ++wrap) {
+        uint64_t wrapTicks = wrap << 32;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            TEST_CHECK(TestTicksToUs(wrapTicks + i) == EMBENET_TIMER_TIMEBASE_Update(&timebase, i));
+        }
+        uint32_t hwTicks = 1000;
+        for (unsigned i = 0; i < 100; ++i) {
+            hwTicks += TestRandom() % (UINT32_MAX / 100);
+            TEST_CHECK(TestTicksToUs(wrapTicks + hwTicks) == EMBENET_TIMER_TIMEBASE_Update(&timebase, hwTicks));
+        }
+        for (uint32_t i = 1000; i > 0; --i) {
+            TEST_CHECK(TestTicksToUs(wrapTicks + UINT32_MAX - i + 1) == EMBENET_TIMER_TIMEBASE_Update(&timebase, UINT32_MAX - i + 1));
+        }
+        TEST_CHECK(EMBENET_TIMER_TIMEBASE_TicksToUs(wrapTicks + UINT32_MAX) == EMBENET_TIMER_TIMEBASE_Update(&timebase, UINT32_MAX));
+    }
+}
+
+// A counter read by nobody between the timeouts still counts every wrap, and a wrap seen by a read is not counted again by the timeout
+static void TestWrapAtTimeout(void) {
+    EMBENET_TIMER_TIMEBASE_Timebase timebase;
+    EMBENET_TIMER_TIMEBASE_Init(&timebase);
+    uint64_t wrapTicks = 0;
+    for (unsigned wrap = 0; wrap < TEST_WRAPS; ++wrap) {
+        // the counter passed 0, the interrupt reads it still at 0, the same value as at the previous timeout
+        wrapTicks += (uint64_t)1 << 32;
+        EMBENET_TIMER_TIMEBASE_OnTimeout(&timebase, 0);
+        TEST_CHECK(TestTicksToUs(wrapTicks) == EMBENET_TIMER_TIMEBASE_Update(&timebase, 0));
+    }
+
+    // A read late in the period, then a read after the wrap before the delayed interrupt
+    TEST_CHECK(TestTicksToUs(wrapTicks + UINT32_MAX - 10) == EMBENET_TIMER_TIMEBASE_Update(&timebase, UINT32_MAX - 10));
+    wrapTicks += (uint64_t)1 << 32;
+    TEST_CHECK(TestTicksToUs(wrapTicks + 5) == EMBENET_TIMER_TIMEBASE_Update(&timebase, 5));
+    EMBENET_TIMER_TIMEBASE_OnTimeout(&timebase, 7);
+    TEST_CHECK(TestTicksToUs(wrapTicks + 8) == EMBENET_TIMER_TIMEBASE_Update(&timebase, 8));
+
+    // A read late in the period, with the interrupt as the first to see the wrap
+    TEST_CHECK(TestTicksToUs(wrapTicks + UINT32_MAX - 10) == EMBENET_TIMER_TIMEBASE_Update(&timebase, UINT32_MAX - 10));
+    wrapTicks += (uint64_t)1 << 32;
+    EMBENET_TIMER_TIMEBASE_OnTimeout(&timebase, 2);
+    TEST_CHECK(TestTicksToUs(wrapTicks + 3) == EMBENET_TIMER_TIMEBASE_Update(&timebase, 3));
+}
+
+// Ticks set for any counter value, as after standby, are read back, converted to time and reached by the compare value
+static void TestSetTicks(void) {
+    EMBENET_TIMER_TIMEBASE_Timebase timebase;
+    EMBENET_TIMER_TIMEBASE_Init(&timebase);
+    for (unsigned i = 0; i < 10000; ++i) {
+        uint64_t ticks   = ((uint64_t)(TestRandom() % 64) << 32) | TestRandom();
+        uint32_t hwTicks = TestRandom();
+        EMBENET_TIMER_TIMEBASE_SetTicks(&timebase, ticks, hwTicks);
+        TEST_CHECK(ticks == EMBENET_TIMER_TIMEBASE_GetTicks(&timebase, hwTicks));
+        TEST_CHECK(TestTicksToUs(ticks) == EMBENET_TIMER_TIMEBASE_Update(&timebase, hwTicks));
+        TEST_CHECK(EMBENET_TIMER_TIMEBASE_TicksToUs(ticks) == TestTicksToUs(ticks));
+
+        // the compare value is the first tick at which the time reaches the compare, also when it lies after the next wrap
+        uint64_t time    = TestTicksToUs(ticks) + 1 + TestRandom() % (UINT32_MAX / 2);
+        uint32_t compare = EMBENET_TIMER_TIMEBASE_GetCounterValue(&timebase, time);
+        uint64_t reached = ticks + (uint32_t)(compare - hwTicks);
+        TEST_CHECK(TestTicksToUs(reached) >= time);
+        TEST_CHECK(TestTicksToUs(reached - 1) < time);
+    }
+}
+
+// Returns the fastest time of a read in ns, converting the counter values of testTicks either with the timebase or with a 64-bit division
+static double TestBenchmark(bool timebase) {
+    EMBENET_TIMER_TIMEBASE_Timebase state;
+    volatile uint64_t               sink = 0;
+    double                          best = 0;
+    for (unsigned repeat = 0; repeat < TEST_BENCH_REPEATS; ++repeat) {
+        EMBENET_TIMER_TIMEBASE_Init(&state);
+        uint64_t ticks = 0;
+        double   start = TestNow();
+        for (size_t i = 0; i < TEST_BENCH_COUNT; ++i) {
+            if (timebase) {
+                sink = EMBENET_TIMER_TIMEBASE_Update(&state, testTicks[i]);
+            } else {
+                ticks += (uint32_t)(testTicks[i] - (uint32_t)ticks);
+                sink = TestTicksToUs(ticks);
+            }
+        }
+        double time = TestNow() - start;
+        best        = ((0 == repeat) || (time < best)) ? time : best;
+    }
+    (void)sink;
+    return best / TEST_BENCH_COUNT;
+}
+
+// Prints the cost of reading the time with the timebase and as the port did before, extending the counter to 64 bits and computing ticks * 4 / 3.
+// The times are wall-clock ns on the host, which divides 64-bit values in hardware; the Cortex-M4F of the CC1312 calls a library routine instead
+static void TestReadCost(void) {
+    uint32_t hwTicks = 0;
+    for (size_t i = 0; i < TEST_BENCH_COUNT; ++i) {
+        hwTicks += TestRandom() % 20000; // reads spaced as by the stack, wrapping a few times over the run
+        testTicks[i] = hwTicks;
+    }
+    double division = TestBenchmark(false);
+    double timebase = TestBenchmark(true);
+    printf("| read of the time          | host time [ns] |\n");
+    printf("| (uint64_t)ticks * 4 / 3   | %14.2f |\n", division);
+    printf("| EMBENET_TIMER_TIMEBASE    | %14.2f |\n", timebase);
+}
+
+int main(void) {
+    TEST_RUN(TestDivideBy3);
+    TEST_RUN(TestTimeAcrossWraps);
+    TEST_RUN(TestWrapAtTimeout);
+    TEST_RUN(TestSetTicks);
+    TEST_RUN(TestReadCost);
+    return TEST_RESULT();
+}
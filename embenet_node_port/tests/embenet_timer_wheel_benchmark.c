@@ -0,0 +1,125 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Benchmark of the software timer wheel, checks that its operations take constant time with thousands of timers
+*/
+
+#include "embenet_test.h"
+
+#include <embenet_timer_wheel.h>
+
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+    BENCH_MIN_TIMERS   = 1000,
+    BENCH_MAX_TIMERS   = 64000,
+    BENCH_RANGE_BITS   = 24, ///< Expiries are spread over 2^24 us from now, covering four levels of the wheel
+    BENCH_REPEATS      = 5,  ///< Every measurement is repeated, the fastest run is taken
+    BENCH_MAX_SLOWDOWN = 4,  ///< Allowed growth of the cost of an operation from the smallest to the largest number of timers, for cache effects
+};
+
+typedef struct {
+    double insertNs;  ///< Mean time of starting a timer
+    double removeNs;  ///< Mean time of stopping a timer
+    double advanceNs; ///< Mean time of advancing the wheel per expired timer
+} BenchResult;
+
+static EMBENET_TIMER_WHEEL_Wheel benchWheel;
+static EMBENET_TIMER_SoftTimer   benchTimers[BENCH_MAX_TIMERS];
+static size_t                    benchOrder[BENCH_MAX_TIMERS];
+static size_t                    benchExpired;
+static uint32_t                  benchRandom = 12345;
+
+static uint32_t BenchRandom(void) {
+    benchRandom ^= benchRandom << 13;
+    benchRandom ^= benchRandom >> 17;
+    benchRandom ^= benchRandom << 5;
+    return benchRandom;
+}
+
+static double BenchNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void BenchCallback(EMBENET_TIMER_SoftTimer* timer, void* context) {
+    (void)timer;
+    (void)context;
+    benchExpired++;
+}
+
+// Starts count timers at random times, stops half of them in random order, then lets the rest expire.
+// The wheel is advanced from one event to the next, as by the timer interrupt.
+static BenchResult BenchRun(size_t count) {
+    uint64_t now = 1000000;
+    EMBENET_TIMER_WHEEL_Init(&benchWheel, now);
+    for (size_t i = 0; i < count; ++i) {
+        EMBENET_TIMER_WHEEL_InitTimer(&benchTimers[i]);
+        benchTimers[i].expiry   = now + (BenchRandom() & ((1u << BENCH_RANGE_BITS) - 1));
+        benchTimers[i].period   = 0;
+        benchTimers[i].callback = BenchCallback;
+        benchTimers[i].context  = NULL;
+        benchOrder[i]           = i;
+    }
+    for (size_t i = count - 1; i > 0; --i) {
+        size_t j      = BenchRandom() % (i + 1);
+        size_t order  = benchOrder[i];
+        benchOrder[i] = benchOrder[j];
+        benchOrder[j] = order;
+    }
+
+    BenchResult result;
+    double      start = BenchNow();
+    for (size_t i = 0; i < count; ++i) {
+        EMBENET_TIMER_WHEEL_Insert(&benchWheel, &benchTimers[i]);
+    }
+    result.insertNs = (BenchNow() - start) / (double)count;
+
+    start = BenchNow();
+    for (size_t i = 0; i < count / 2; ++i) {
+        EMBENET_TIMER_WHEEL_Remove(&benchWheel, &benchTimers[benchOrder[i]]);
+    }
+    result.removeNs = (BenchNow() - start) / (double)(count / 2);
+
+    benchExpired = 0;
+    start        = BenchNow();
+    while (EMBENET_TIMER_WHEEL_GetNextEvent(&benchWheel, &now)) {
+        EMBENET_TIMER_WHEEL_Advance(&benchWheel, now);
+    }
+    result.advanceNs = (BenchNow() - start) / (double)(count - count / 2);
+    TEST_CHECK(count - count / 2 == benchExpired);
+    return result;
+}
+
+static BenchResult BenchBest(size_t count) {
+    BenchResult best = BenchRun(count);
+    for (unsigned i = 1; i < BENCH_REPEATS; ++i) {
+        BenchResult result = BenchRun(count);
+        best.insertNs      = (result.insertNs < best.insertNs) ? result.insertNs : best.insertNs;
+        best.removeNs      = (result.removeNs < best.removeNs) ? result.removeNs : best.removeNs;
+        best.advanceNs     = (result.advanceNs < best.advanceNs) ? result.advanceNs : best.advanceNs;
+    }
+    printf("%6zu timers: insert %5.1f ns, remove %5.1f ns, advance %5.1f ns per expired timer\n", count, best.insertNs, best.removeNs, best.advanceNs);
+    return best;
+}
+
+// The cost per timer must not grow with their number
+static void BenchConstantTime(void) {
+    BenchResult smallest = BenchBest(BENCH_MIN_TIMERS);
+    BenchBest(BENCH_MIN_TIMERS * 4);
+    BenchBest(BENCH_MIN_TIMERS * 16);
+    BenchResult largest = BenchBest(BENCH_MAX_TIMERS);
+    TEST_CHECK(largest.insertNs < smallest.insertNs * BENCH_MAX_SLOWDOWN);
+    TEST_CHECK(largest.removeNs < smallest.removeNs * BENCH_MAX_SLOWDOWN);
+    TEST_CHECK(largest.advanceNs < smallest.advanceNs * BENCH_MAX_SLOWDOWN);
+}
+
+int main(void) {
+    TEST_RUN(BenchConstantTime);
+    return TEST_RESULT();
+}
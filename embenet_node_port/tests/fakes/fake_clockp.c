@@ -0,0 +1,95 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK ClockP module
+*/
+
+#include "sim.h"
+
+#include <ti/drivers/dpl/ClockP.h>
+
+#include <stddef.h>
+
+enum {
+    FAKE_CLOCKP_MAX_CLOCKS = 4,
+    FAKE_CLOCKP_TICK_US    = 10, ///< System tick period
+};
+
+static ClockP_Struct* fakeClocks[FAKE_CLOCKP_MAX_CLOCKS];
+
+static ClockP_Struct* FAKE_CLOCKP_Earliest(void) {
+    ClockP_Struct* earliest = NULL;
+    for (unsigned i = 0; i < FAKE_CLOCKP_MAX_CLOCKS; ++i) {
+        ClockP_Struct* clock = fakeClocks[i];
+        if ((NULL != clock) && clock->active && ((NULL == earliest) || (clock->deadline < earliest->deadline))) {
+            earliest = clock;
+        }
+    }
+    return earliest;
+}
+
+static uint64_t FAKE_CLOCKP_Next(void) {
+    ClockP_Struct* clock = FAKE_CLOCKP_Earliest();
+    return (NULL != clock) ? clock->deadline : SIM_NEVER;
+}
+
+// Clocks are one-shot, the period is not simulated
+static void FAKE_CLOCKP_Service(void) {
+    ClockP_Struct* clock = FAKE_CLOCKP_Earliest();
+    clock->active        = false;
+    clock->fxn(clock->arg);
+}
+
+static SIM_Source const fakeClockPSource = {.next = FAKE_CLOCKP_Next, .service = FAKE_CLOCKP_Service};
+
+void ClockP_Params_init(ClockP_Params* params) {
+    *params = (ClockP_Params){.startFlag = false, .period = 0, .arg = 0};
+}
+
+ClockP_Handle ClockP_construct(ClockP_Struct* clockP, ClockP_Fxn clockFxn, uint32_t timeout, ClockP_Params* params) {
+    *clockP = (ClockP_Struct){.fxn = clockFxn, .arg = params->arg, .timeout = timeout, .deadline = SIM_NEVER, .active = false};
+    for (unsigned i = 0; i < FAKE_CLOCKP_MAX_CLOCKS; ++i) {
+        if ((NULL == fakeClocks[i]) || (clockP == fakeClocks[i])) {
+            fakeClocks[i] = clockP;
+            break;
+        }
+    }
+    SIM_AddSource(&fakeClockPSource);
+    if (params->startFlag) {
+        ClockP_start(clockP);
+    }
+    return clockP;
+}
+
+void ClockP_destruct(ClockP_Struct* clockP) {
+    for (unsigned i = 0; i < FAKE_CLOCKP_MAX_CLOCKS; ++i) {
+        if (clockP == fakeClocks[i]) {
+            fakeClocks[i] = NULL;
+        }
+    }
+}
+
+ClockP_Handle ClockP_handle(ClockP_Struct* clockP) {
+    return clockP;
+}
+
+void ClockP_setTimeout(ClockP_Handle handle, uint32_t timeout) {
+    handle->timeout = timeout;
+}
+
+// The clock runs from the RTC, whose drift is neglected here
+void ClockP_start(ClockP_Handle handle) {
+    handle->deadline = SIM_Now() + (uint64_t)handle->timeout * FAKE_CLOCKP_TICK_US * 1000u;
+    handle->active   = true;
+}
+
+void ClockP_stop(ClockP_Handle handle) {
+    handle->active = false;
+}
+
+uint32_t ClockP_getSystemTickPeriod(void) {
+    return FAKE_CLOCKP_TICK_US;
+}
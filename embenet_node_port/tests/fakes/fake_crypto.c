@@ -0,0 +1,199 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK crypto drivers, computed with OpenSSL
+*/
+
+#include "sim_crypto.h"
+
+#include <ti/drivers/AESCCM.h>
+#include <ti/drivers/AESECB.h>
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKeyPlaintext.h>
+
+#include <openssl/evp.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    FAKE_AES_BLOCK_LENGTH     = 16,
+    FAKE_AESCCM_MAX_LENGTH    = 1024, ///< Longest data handled by the fake accelerator
+    FAKE_AESCCM_CORRUPT_VALUE = 0xa5, ///< Written over the part of the data transformed before an injected failure
+};
+
+struct AESECB_Config {
+    bool open;
+};
+
+struct AESCCM_Config {
+    bool open;
+};
+
+static struct AESECB_Config aesecb;
+static struct AESCCM_Config aesccm;
+
+static struct {
+    unsigned       ecbBlocks;
+    unsigned       ccmOperations;
+    bool           ccmFail;
+    int_fast16_t   ccmFailStatus;
+    uint8_t const* ecbKey; ///< Key material of the last AESECB operation
+} fakeCrypto;
+
+static void FAKE_CRYPTO_Abort(char const* why) {
+    fprintf(stderr, "%s\n", why);
+    abort();
+}
+
+int_fast16_t CryptoKeyPlaintext_initKey(CryptoKey* keyHandle, uint8_t* key, size_t keyLength) {
+    keyHandle->encoding                = CryptoKey_PLAINTEXT;
+    keyHandle->u.plaintext.keyMaterial = key;
+    keyHandle->u.plaintext.keyLength   = (uint32_t)keyLength;
+    return 0;
+}
+
+void AESECB_init(void) {
+}
+
+void AESECB_Params_init(AESECB_Params* params) {
+    params->returnBehavior = AESECB_RETURN_BEHAVIOR_BLOCKING;
+}
+
+AESECB_Handle AESECB_open(uint_least8_t index, AESECB_Params const* params) {
+    (void)index;
+    if ((aesecb.open) || (AESECB_RETURN_BEHAVIOR_POLLING != params->returnBehavior)) {
+        return NULL;
+    }
+    aesecb.open          = true;
+    fakeCrypto.ecbBlocks = 0;
+    return &aesecb;
+}
+
+void AESECB_close(AESECB_Handle handle) {
+    handle->open = false;
+}
+
+void AESECB_Operation_init(AESECB_Operation* operation) {
+    memset(operation, 0, sizeof(*operation));
+}
+
+static int_fast16_t FAKE_AESECB_Run(AESECB_Handle handle, AESECB_Operation* operation, bool encrypt) {
+    if (!handle->open || (0 != operation->inputLength % FAKE_AES_BLOCK_LENGTH) || (FAKE_AES_BLOCK_LENGTH != operation->key->u.plaintext.keyLength)) {
+        return AESECB_STATUS_ERROR;
+    }
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int             length;
+    EVP_CipherInit_ex(ctx, EVP_aes_128_ecb(), NULL, operation->key->u.plaintext.keyMaterial, NULL, encrypt ? 1 : 0);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_CipherUpdate(ctx, operation->output, &length, operation->input, (int)operation->inputLength);
+    EVP_CIPHER_CTX_free(ctx);
+    fakeCrypto.ecbBlocks += (unsigned)(operation->inputLength / FAKE_AES_BLOCK_LENGTH);
+    fakeCrypto.ecbKey    = operation->key->u.plaintext.keyMaterial;
+    return AESECB_STATUS_SUCCESS;
+}
+
+int_fast16_t AESECB_oneStepEncrypt(AESECB_Handle handle, AESECB_Operation* operation) {
+    return FAKE_AESECB_Run(handle, operation, true);
+}
+
+int_fast16_t AESECB_oneStepDecrypt(AESECB_Handle handle, AESECB_Operation* operation) {
+    return FAKE_AESECB_Run(handle, operation, false);
+}
+
+void AESCCM_init(void) {
+}
+
+void AESCCM_Params_init(AESCCM_Params* params) {
+    params->returnBehavior = AESCCM_RETURN_BEHAVIOR_BLOCKING;
+}
+
+AESCCM_Handle AESCCM_open(uint_least8_t index, AESCCM_Params const* params) {
+    (void)index;
+    if ((aesccm.open) || (AESCCM_RETURN_BEHAVIOR_POLLING != params->returnBehavior)) {
+        return NULL;
+    }
+    aesccm.open              = true;
+    fakeCrypto.ccmOperations = 0;
+    fakeCrypto.ccmFail       = false;
+    return &aesccm;
+}
+
+void AESCCM_close(AESCCM_Handle handle) {
+    handle->open = false;
+}
+
+void AESCCM_OneStepOperation_init(AESCCM_OneStepOperation* operation) {
+    memset(operation, 0, sizeof(*operation));
+}
+
+// Runs the operation as the accelerator does, which takes neither an empty MIC nor an empty message, the port must not pass them
+static int_fast16_t FAKE_AESCCM_Run(AESCCM_Handle handle, AESCCM_OneStepOperation* operation, bool encrypt) {
+    bool macValid = (operation->macLength >= 4) && (operation->macLength <= 16) && (0 == operation->macLength % 2);
+    if (!handle->open || !macValid || ((0 == operation->aadLength) && (0 == operation->inputLength)) || (operation->inputLength > FAKE_AESCCM_MAX_LENGTH) ||
+        (operation->nonceLength < 7) || (operation->nonceLength > 13)) {
+        FAKE_CRYPTO_Abort("AESCCM operation not supported by the accelerator");
+    }
+    fakeCrypto.ccmOperations++;
+    if (fakeCrypto.ccmFail) {
+        fakeCrypto.ccmFail = false;
+        memset(operation->output, FAKE_AESCCM_CORRUPT_VALUE, operation->inputLength / 2);
+        if (encrypt) {
+            memset(operation->mac, FAKE_AESCCM_CORRUPT_VALUE, operation->macLength);
+        }
+        return fakeCrypto.ccmFailStatus;
+    }
+
+    uint8_t input[FAKE_AESCCM_MAX_LENGTH];
+    memcpy(input, operation->input, operation->inputLength);
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int             length;
+    EVP_CipherInit_ex(ctx, EVP_aes_128_ccm(), NULL, NULL, NULL, encrypt ? 1 : 0);
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_IVLEN, operation->nonceLength, NULL);
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_TAG, operation->macLength, encrypt ? NULL : operation->mac);
+    EVP_CipherInit_ex(ctx, NULL, NULL, operation->key->u.plaintext.keyMaterial, operation->nonce, -1);
+    EVP_CipherUpdate(ctx, NULL, &length, NULL, (int)operation->inputLength);
+    if (0 != operation->aadLength) {
+        EVP_CipherUpdate(ctx, NULL, &length, operation->aad, (int)operation->aadLength);
+    }
+    int          result = EVP_CipherUpdate(ctx, operation->output, &length, input, (int)operation->inputLength);
+    int_fast16_t status = AESCCM_STATUS_SUCCESS;
+    if (encrypt) {
+        EVP_CipherFinal_ex(ctx, operation->output + length, &length);
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_GET_TAG, operation->macLength, operation->mac);
+    } else if (result <= 0) {
+        memset(operation->output, FAKE_AESCCM_CORRUPT_VALUE, operation->inputLength); // OpenSSL drops the plaintext, the accelerator leaves it in place
+        status = AESCCM_STATUS_MAC_INVALID;
+    }
+    EVP_CIPHER_CTX_free(ctx);
+    return status;
+}
+
+int_fast16_t AESCCM_oneStepEncrypt(AESCCM_Handle handle, AESCCM_OneStepOperation* operation) {
+    return FAKE_AESCCM_Run(handle, operation, true);
+}
+
+int_fast16_t AESCCM_oneStepDecrypt(AESCCM_Handle handle, AESCCM_OneStepOperation* operation) {
+    return FAKE_AESCCM_Run(handle, operation, false);
+}
+
+void SIM_AESCCM_FailNext(int_fast16_t status) {
+    fakeCrypto.ccmFail       = true;
+    fakeCrypto.ccmFailStatus = status;
+}
+
+unsigned SIM_AESCCM_GetOperationCount(void) {
+    return fakeCrypto.ccmOperations;
+}
+
+unsigned SIM_AESECB_GetBlockCount(void) {
+    return fakeCrypto.ecbBlocks;
+}
+
+uint8_t const* SIM_AESECB_GetLastKey(void) {
+    return fakeCrypto.ecbKey;
+}
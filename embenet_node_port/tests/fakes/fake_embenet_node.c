@@ -0,0 +1,255 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the embeNET Node API used by the demo services: tasks, UDP sockets, addresses, diagnostics and ENMS services
+*/
+
+#include "sim_node.h"
+
+#include "enms_node.h"
+
+#include <string.h>
+
+enum {
+    FAKE_NODE_MAX_TASKS    = 8,
+    FAKE_NODE_MAX_SOCKETS  = 4,
+    FAKE_NODE_MAX_SERVICES = 8,
+};
+
+typedef struct {
+    EMBENET_NODE_TaskFunction function;
+    void*                     context;
+    EMBENET_NODE_TimeSource   timeSource;
+    uint64_t                  time;
+    bool                      scheduled;
+} FakeTask;
+
+typedef struct {
+    char const* name;
+    uint8_t     state;
+} FakeService;
+
+static struct {
+    uint64_t                       now;
+    FakeTask                       tasks[FAKE_NODE_MAX_TASKS];
+    size_t                         taskCount;
+    EMBENET_UDP_SocketDescriptor*  sockets[FAKE_NODE_MAX_SOCKETS];
+    size_t                         socketCount;
+    FakeService                    services[FAKE_NODE_MAX_SERVICES];
+    size_t                         serviceCount;
+    SIM_NODE_Datagram              sent[SIM_NODE_MAX_SENT];
+    size_t                         sentCount;
+    EMBENET_NODE_DIAG_NeighborInfo neighbors[SIM_NODE_MAX_ENTRIES];
+    size_t                         neighborCount;
+    EMBENET_NODE_DIAG_CellInfo     cells[SIM_NODE_MAX_ENTRIES];
+    size_t                         cellCount;
+    uint16_t                       parentPdr;
+} fakeNode;
+
+static EMBENET_IPV6 const fakeBorderRouterAddress = {{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01}};
+static EMBENET_IPV6 const fakeParentAddress       = {{0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02}};
+
+void SIM_NODE_Reset(void) {
+    memset(&fakeNode, 0, sizeof(fakeNode));
+}
+
+void SIM_NODE_RunUntil(uint64_t time) {
+    for (;;) {
+        FakeTask* next = NULL;
+        for (size_t i = 0; i != fakeNode.taskCount; ++i) {
+            FakeTask* task = &fakeNode.tasks[i];
+            if (task->scheduled && (task->time <= time) && ((NULL == next) || (task->time < next->time))) {
+                next = task;
+            }
+        }
+        if (NULL == next) {
+            break;
+        }
+        if (next->time > fakeNode.now) {
+            fakeNode.now = next->time;
+        }
+        next->scheduled = false;
+        next->function((EMBENET_TaskId)(next - fakeNode.tasks), next->timeSource, next->time, next->context);
+    }
+    fakeNode.now = time;
+}
+
+void SIM_NODE_Deliver(EMBENET_IPV6 const* source, uint16_t port, void const* data, size_t size) {
+    for (size_t i = 0; i != fakeNode.socketCount; ++i) {
+        if (port == fakeNode.sockets[i]->port) {
+            fakeNode.sockets[i]->rxDataHandler(fakeNode.sockets[i], source, port, data, size);
+        }
+    }
+}
+
+size_t SIM_NODE_GetSentCount(void) {
+    return fakeNode.sentCount;
+}
+
+SIM_NODE_Datagram const* SIM_NODE_GetSent(size_t index) {
+    size_t kept  = (fakeNode.sentCount < SIM_NODE_MAX_SENT) ? fakeNode.sentCount : SIM_NODE_MAX_SENT;
+    size_t first = fakeNode.sentCount - kept;
+    return (index < kept) ? &fakeNode.sent[(first + index) % SIM_NODE_MAX_SENT] : NULL;
+}
+
+void SIM_NODE_ClearSent(void) {
+    fakeNode.sentCount = 0;
+}
+
+EMBENET_IPV6 SIM_NODE_GetParentAddress(void) {
+    return fakeParentAddress;
+}
+
+bool SIM_NODE_IsGroupAddress(EMBENET_IPV6 const* address, EMBENET_GroupId groupId) {
+    EMBENET_IPV6 group = EMBENET_AssembleMulticastIpv6(0, groupId);
+    return 0 == memcmp(address, &group, sizeof(group));
+}
+
+void SIM_NODE_SetNeighbors(EMBENET_NODE_DIAG_NeighborInfo const* neighbors, size_t count) {
+    fakeNode.neighborCount = (count < SIM_NODE_MAX_ENTRIES) ? count : SIM_NODE_MAX_ENTRIES;
+    memcpy(fakeNode.neighbors, neighbors, fakeNode.neighborCount * sizeof(*neighbors));
+}
+
+void SIM_NODE_SetCells(EMBENET_NODE_DIAG_CellInfo const* cells, size_t count) {
+    fakeNode.cellCount = (count < SIM_NODE_MAX_ENTRIES) ? count : SIM_NODE_MAX_ENTRIES;
+    memcpy(fakeNode.cells, cells, fakeNode.cellCount * sizeof(*cells));
+}
+
+void SIM_NODE_SetParentPdr(uint16_t pdr) {
+    fakeNode.parentPdr = pdr;
+}
+
+int SIM_NODE_GetServiceState(char const* serviceName) {
+    for (size_t i = 0; i != fakeNode.serviceCount; ++i) {
+        if (0 == strcmp(serviceName, fakeNode.services[i].name)) {
+            return fakeNode.services[i].state;
+        }
+    }
+    return -1;
+}
+
+EMBENET_TaskId EMBENET_NODE_TaskCreate(EMBENET_NODE_TaskFunction taskFunction, void* userContext) {
+    if (FAKE_NODE_MAX_TASKS == fakeNode.taskCount) {
+        return EMBENET_TASKID_INVALID;
+    }
+    fakeNode.tasks[fakeNode.taskCount] = (FakeTask){.function = taskFunction, .context = userContext};
+    return fakeNode.taskCount++;
+}
+
+EMBENET_Result EMBENET_NODE_TaskSchedule(EMBENET_TaskId taskId, EMBENET_NODE_TimeSource timeSource, uint64_t t) {
+    if (taskId >= fakeNode.taskCount) {
+        return EMBENET_RESULT_INVALID_ARGUMENT;
+    }
+    fakeNode.tasks[taskId].timeSource = timeSource;
+    fakeNode.tasks[taskId].time       = t;
+    fakeNode.tasks[taskId].scheduled  = true;
+    return EMBENET_RESULT_OK;
+}
+
+EMBENET_Result EMBENET_NODE_TaskCancel(EMBENET_TaskId taskId) {
+    if (taskId >= fakeNode.taskCount) {
+        return EMBENET_RESULT_INVALID_ARGUMENT;
+    }
+    fakeNode.tasks[taskId].scheduled = false;
+    return EMBENET_RESULT_OK;
+}
+
+uint64_t EMBENET_NODE_GetLocalTime(void) {
+    return fakeNode.now;
+}
+
+uint64_t EMBENET_NODE_GetNetworkTime(void) {
+    return fakeNode.now;
+}
+
+bool EMBENET_NODE_JoinGroup(EMBENET_GroupId groupId) {
+    (void)groupId;
+    return true;
+}
+
+void EMBENET_NODE_LeaveGroup(EMBENET_GroupId groupId) {
+    (void)groupId;
+}
+
+EMBENET_Result EMBENET_NODE_GetBorderRouterAddress(EMBENET_IPV6* ipv6) {
+    *ipv6 = fakeBorderRouterAddress;
+    return EMBENET_RESULT_OK;
+}
+
+EMBENET_Result EMBENET_NODE_GetParentAddress(EMBENET_IPV6* ipv6) {
+    *ipv6 = fakeParentAddress;
+    return EMBENET_RESULT_OK;
+}
+
+EMBENET_IPV6 EMBENET_AssembleMulticastIpv6(EMBENET_NetworkPrefix nwkPrefix, EMBENET_GroupId gid) {
+    (void)nwkPrefix; // the prefix is the same for the whole simulated network
+    EMBENET_IPV6 address = {{0xff, 0x03}};
+    address.val[14]      = (uint8_t)(gid >> 8);
+    address.val[15]      = (uint8_t)gid;
+    return address;
+}
+
+EMBENET_Result EMBENET_UDP_RegisterSocket(EMBENET_UDP_SocketDescriptor* socket) {
+    if (FAKE_NODE_MAX_SOCKETS == fakeNode.socketCount) {
+        return EMBENET_RESULT_UNSPECIFIED_ERROR;
+    }
+    fakeNode.sockets[fakeNode.socketCount++] = socket;
+    return EMBENET_RESULT_OK;
+}
+
+EMBENET_Result EMBENET_UDP_Send(EMBENET_UDP_SocketDescriptor const* socket, EMBENET_IPV6 const* destinationAddress, uint16_t destinationPort, const void* data,
+                                size_t dataSize) {
+    (void)socket;
+    if (dataSize > SIM_NODE_MAX_DATAGRAM) {
+        return EMBENET_RESULT_INVALID_ARGUMENT;
+    }
+    SIM_NODE_Datagram* datagram = &fakeNode.sent[fakeNode.sentCount++ % SIM_NODE_MAX_SENT];
+    datagram->destination       = *destinationAddress;
+    datagram->port              = destinationPort;
+    datagram->size              = dataSize;
+    memcpy(datagram->data, data, dataSize);
+    return EMBENET_RESULT_OK;
+}
+
+unsigned EMBENET_NODE_DIAG_GetNeighborCount(void) {
+    return (unsigned)fakeNode.neighborCount;
+}
+
+EMBENET_NODE_DIAG_NeighborInfo EMBENET_NODE_DIAG_GetNeighborInfo(unsigned index) {
+    return (index < fakeNode.neighborCount) ? fakeNode.neighbors[index] : (EMBENET_NODE_DIAG_NeighborInfo){.eui = 0};
+}
+
+unsigned EMBENET_NODE_DIAG_GetCellsCount(void) {
+    return (unsigned)fakeNode.cellCount;
+}
+
+EMBENET_NODE_DIAG_CellInfo EMBENET_NODE_DIAG_GetCellInfo(unsigned index) {
+    return (index < fakeNode.cellCount) ? fakeNode.cells[index] : (EMBENET_NODE_DIAG_CellInfo){.role = EMBENET_NODE_DIAG_CELL_ROLE_NONE};
+}
+
+uint16_t EMBENET_NODE_DIAG_GetParentPDR(void) {
+    return fakeNode.parentPdr;
+}
+
+EnmsNodeResult ENMS_NODE_RegisterService(EnmsNode* enmsNode, const char* serviceName, uint8_t serviceState) {
+    (void)enmsNode;
+    if (FAKE_NODE_MAX_SERVICES == fakeNode.serviceCount) {
+        return ENMS_NODE_RESULT_FAILED_TO_REGISTER_SERVICE;
+    }
+    fakeNode.services[fakeNode.serviceCount++] = (FakeService){.name = serviceName, .state = serviceState};
+    return ENMS_NODE_RESULT_OK;
+}
+
+EnmsNodeResult ENMS_NODE_SetServiceState(EnmsNode* enmsNode, const char* serviceName, uint8_t serviceState) {
+    (void)enmsNode;
+    for (size_t i = 0; i != fakeNode.serviceCount; ++i) {
+        if (0 == strcmp(serviceName, fakeNode.services[i].name)) {
+            fakeNode.services[i].state = serviceState;
+            return ENMS_NODE_RESULT_OK;
+        }
+    }
+    return ENMS_NODE_RESULT_INVALID_INPUT_ARGUMENT;
+}
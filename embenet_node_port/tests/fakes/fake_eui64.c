@@ -0,0 +1,16 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the EUI64 interface, the factory configuration area does not exist on the host
+*/
+
+#include "sim.h"
+
+#include <embenet_eui64.h>
+
+uint64_t EMBENET_EUI64_Get(void) {
+    return SIM_EUI64;
+}
@@ -0,0 +1,194 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK GPTimerCC26XX driver
+*/
+
+#include "fake_internal.h"
+#include "sim.h"
+
+#include <ti/drivers/power/PowerCC26XX.h>
+#include <ti/drivers/timer/GPTimerCC26XX.h>
+
+#include <stddef.h>
+
+enum {
+    FAKE_GPTIMER_INT_NUM = 31,
+};
+
+static GPTimerCC26XX_HWAttrs const fakeGpTimerHwAttrs = {.intNum = FAKE_GPTIMER_INT_NUM};
+static GPTimerCC26XX_Config        fakeGpTimerConfig  = {.hwAttrs = &fakeGpTimerHwAttrs};
+
+/// The timer counts up through the whole 32-bit range on the ticks of the prescaled clock, which runs at 3/4 MHz also while the timer is stopped
+typedef struct {
+    bool                  running;
+    uint32_t              value; ///< Counter value at 'since', or the stopped counter value
+    uint64_t              since; ///< Clock ticks since the start of the simulation at which the counter was started
+    uint32_t              match;
+    uint64_t              matchTime;
+    uint64_t              timeoutTime;
+    bool                  forced; ///< Interrupt pended by software
+    GPTimerCC26XX_HwiFxn  callback;
+    GPTimerCC26XX_IntMask enabled;
+    uint32_t              valueAfterStandby;
+} FAKE_GPTIMER_State;
+
+static FAKE_GPTIMER_State fakeGpTimer;
+
+static uint64_t FAKE_GPTIMER_ClockTicks(void) {
+    return SIM_Now() * 3 / 4000;
+}
+
+static uint64_t FAKE_GPTIMER_Elapsed(void) {
+    return FAKE_GPTIMER_ClockTicks() - fakeGpTimer.since;
+}
+
+static uint32_t FAKE_GPTIMER_Counter(void) {
+    return fakeGpTimer.running ? fakeGpTimer.value + (uint32_t)FAKE_GPTIMER_Elapsed() : fakeGpTimer.value;
+}
+
+// Time of the next tick at which the counter changes to the given value
+static uint64_t FAKE_GPTIMER_TimeOfValue(uint32_t value) {
+    if (!fakeGpTimer.running) {
+        return SIM_NEVER;
+    }
+    uint64_t elapsed = FAKE_GPTIMER_Elapsed();
+    uint64_t ticks   = (uint32_t)(value - (fakeGpTimer.value + (uint32_t)elapsed));
+    if (0 == ticks) {
+        ticks = (uint64_t)1 << 32;
+    }
+    return ((fakeGpTimer.since + elapsed + ticks) * 4000 + 2) / 3;
+}
+
+static uint64_t FAKE_GPTIMER_Next(void) {
+    uint64_t next = fakeGpTimer.forced ? SIM_Now() : SIM_NEVER;
+    if ((0 != (fakeGpTimer.enabled & GPT_INT_MATCH)) && (fakeGpTimer.matchTime < next)) {
+        next = fakeGpTimer.matchTime;
+    }
+    if ((0 != (fakeGpTimer.enabled & GPT_INT_TIMEOUT)) && (fakeGpTimer.timeoutTime < next)) {
+        next = fakeGpTimer.timeoutTime;
+    }
+    return next;
+}
+
+static void FAKE_GPTIMER_Service(void) {
+    uint64_t              now  = SIM_Now();
+    GPTimerCC26XX_IntMask mask = 0;
+    fakeGpTimer.forced         = false;
+    if ((0 != (fakeGpTimer.enabled & GPT_INT_MATCH)) && (fakeGpTimer.matchTime <= now)) {
+        mask |= GPT_INT_MATCH;
+        fakeGpTimer.matchTime = FAKE_GPTIMER_TimeOfValue(fakeGpTimer.match);
+    }
+    if ((0 != (fakeGpTimer.enabled & GPT_INT_TIMEOUT)) && (fakeGpTimer.timeoutTime <= now)) {
+        mask |= GPT_INT_TIMEOUT;
+        fakeGpTimer.timeoutTime = FAKE_GPTIMER_TimeOfValue(0);
+    }
+    if (NULL != fakeGpTimer.callback) {
+        fakeGpTimer.callback(&fakeGpTimerConfig, mask);
+    }
+}
+
+static SIM_Source const fakeGpTimerSource = {.next = FAKE_GPTIMER_Next, .service = FAKE_GPTIMER_Service};
+
+void FAKE_GPTIMER_EnterStandby(void) {
+    if (!fakeGpTimer.running) {
+        fakeGpTimer.value = fakeGpTimer.valueAfterStandby;
+    }
+}
+
+void SIM_GPTIMER_SetValueAfterStandby(uint32_t value) {
+    fakeGpTimer.valueAfterStandby = value;
+}
+
+void GPTimerCC26XX_Params_init(GPTimerCC26XX_Params* params) {
+    *params = (GPTimerCC26XX_Params){.width = GPT_CONFIG_16BIT, .mode = GPT_MODE_PERIODIC_UP, .debugStallMode = GPTimerCC26XX_DEBUG_STALL_OFF};
+}
+
+GPTimerCC26XX_Handle GPTimerCC26XX_open(unsigned int index, const GPTimerCC26XX_Params* params) {
+    (void)index;
+    (void)params;
+    uint32_t valueAfterStandby = fakeGpTimer.valueAfterStandby;
+    fakeGpTimer = (FAKE_GPTIMER_State){.matchTime = SIM_NEVER, .timeoutTime = SIM_NEVER, .valueAfterStandby = valueAfterStandby};
+    SIM_AddSource(&fakeGpTimerSource);
+    return &fakeGpTimerConfig;
+}
+
+void GPTimerCC26XX_close(GPTimerCC26XX_Handle handle) {
+    (void)handle;
+}
+
+void GPTimerCC26XX_start(GPTimerCC26XX_Handle handle) {
+    (void)handle;
+    if (fakeGpTimer.running) {
+        return;
+    }
+    fakeGpTimer.running = true;
+    fakeGpTimer.since   = FAKE_GPTIMER_ClockTicks();
+    Power_setConstraint(PowerCC26XX_DISALLOW_STANDBY);
+    fakeGpTimer.matchTime   = FAKE_GPTIMER_TimeOfValue(fakeGpTimer.match);
+    fakeGpTimer.timeoutTime = FAKE_GPTIMER_TimeOfValue(0);
+}
+
+void GPTimerCC26XX_stop(GPTimerCC26XX_Handle handle) {
+    (void)handle;
+    if (!fakeGpTimer.running) {
+        return;
+    }
+    fakeGpTimer.value       = FAKE_GPTIMER_Counter();
+    fakeGpTimer.running     = false;
+    fakeGpTimer.matchTime   = SIM_NEVER;
+    fakeGpTimer.timeoutTime = SIM_NEVER;
+    Power_releaseConstraint(PowerCC26XX_DISALLOW_STANDBY);
+}
+
+// The counter always wraps at 2^32
+void GPTimerCC26XX_setLoadValue(GPTimerCC26XX_Handle handle, uint32_t loadValue) {
+    (void)handle;
+    (void)loadValue;
+}
+
+void GPTimerCC26XX_setMatchValue(GPTimerCC26XX_Handle handle, uint32_t matchValue) {
+    (void)handle;
+    fakeGpTimer.match     = matchValue;
+    fakeGpTimer.matchTime = FAKE_GPTIMER_TimeOfValue(matchValue);
+}
+
+uint32_t GPTimerCC26XX_getFreeRunValue(GPTimerCC26XX_Handle handle) {
+    (void)handle;
+    SIM_Access();
+    return FAKE_GPTIMER_Counter();
+}
+
+void GPTimerCC26XX_registerInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_HwiFxn callback, GPTimerCC26XX_IntMask intMask) {
+    fakeGpTimer.callback = callback;
+    GPTimerCC26XX_enableInterrupt(handle, intMask);
+}
+
+void GPTimerCC26XX_unregisterInterrupt(GPTimerCC26XX_Handle handle) {
+    (void)handle;
+    fakeGpTimer.callback = NULL;
+    fakeGpTimer.enabled  = 0;
+}
+
+// A status latched while the interrupt was disabled is dropped
+void GPTimerCC26XX_enableInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask intMask) {
+    (void)handle;
+    if ((0 != (intMask & GPT_INT_MATCH)) && (0 == (fakeGpTimer.enabled & GPT_INT_MATCH))) {
+        fakeGpTimer.matchTime = FAKE_GPTIMER_TimeOfValue(fakeGpTimer.match);
+    }
+    fakeGpTimer.enabled |= intMask;
+}
+
+void GPTimerCC26XX_disableInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask intMask) {
+    (void)handle;
+    fakeGpTimer.enabled &= (GPTimerCC26XX_IntMask)~intMask;
+}
+
+void IntPendSet(uint32_t intNum) {
+    if (FAKE_GPTIMER_INT_NUM == intNum) {
+        fakeGpTimer.forced = true;
+    }
+}
@@ -0,0 +1,23 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK HwiP module
+*/
+
+#include "sim.h"
+
+#include <ti/drivers/dpl/HwiP.h>
+
+// The key mirrors PRIMASK, 0 if interrupts were enabled
+uintptr_t HwiP_disable(void) {
+    return SIM_DisableInterrupts() ? 0 : 1;
+}
+
+void HwiP_restore(uintptr_t key) {
+    if (0 == key) {
+        SIM_EnableInterrupts();
+    }
+}
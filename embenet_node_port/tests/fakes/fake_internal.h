@@ -0,0 +1,16 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Interactions between the fake SDK drivers
+*/
+
+#ifndef FAKE_INTERNAL_H_
+#define FAKE_INTERNAL_H_
+
+/// Drops the state the GPTimer loses in standby
+void FAKE_GPTIMER_EnterStandby(void);
+
+#endif // FAKE_INTERNAL_H_ included
@@ -0,0 +1,103 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK Power driver and of the AON RTC
+*/
+
+#include "fake_internal.h"
+#include "sim.h"
+
+#include <ti/drivers/power/PowerCC26XX.h>
+#include <ti/devices/DeviceFamily.h>
+#include DeviceFamily_constructPath(driverlib/aon_rtc.h)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static struct {
+    unsigned constraints[PowerCC26XX_NUMCONSTRAINTS];
+    unsigned cryptoDependencies;
+    uint64_t wakeLatency;
+    unsigned standbyCount;
+    int32_t  rtcDrift;
+} fakePower;
+
+int_fast16_t Power_setConstraint(uint_fast16_t constraintId) {
+    fakePower.constraints[constraintId]++;
+    return 0;
+}
+
+int_fast16_t Power_releaseConstraint(uint_fast16_t constraintId) {
+    if (0 == fakePower.constraints[constraintId]) {
+        fprintf(stderr, "constraint %u released more times than set\n", (unsigned)constraintId);
+        abort();
+    }
+    fakePower.constraints[constraintId]--;
+    return 0;
+}
+
+int_fast16_t Power_setDependency(uint_fast16_t resourceId) {
+    if (PowerCC26XX_PERIPH_CRYPTO == resourceId) {
+        fakePower.cryptoDependencies++;
+    }
+    return 0;
+}
+
+int_fast16_t Power_releaseDependency(uint_fast16_t resourceId) {
+    if ((PowerCC26XX_PERIPH_CRYPTO == resourceId) && (0 == fakePower.cryptoDependencies--)) {
+        fprintf(stderr, "dependency %u released more times than set\n", (unsigned)resourceId);
+        abort();
+    }
+    return 0;
+}
+
+uint_fast32_t Power_getConstraintMask(void) {
+    uint_fast32_t mask = 0;
+    for (unsigned i = 0; i < PowerCC26XX_NUMCONSTRAINTS; ++i) {
+        if (0 != fakePower.constraints[i]) {
+            mask |= (uint_fast32_t)1 << i;
+        }
+    }
+    return mask;
+}
+
+// The policy disables interrupts, enters standby if allowed and waits for the next interrupt, which is handled once it re-enables them
+void Power_idleFunc(void) {
+    bool     enabled = SIM_DisableInterrupts();
+    uint64_t wake    = SIM_NextEvent();
+    if (SIM_NEVER == wake) {
+        fprintf(stderr, "the device waits for an interrupt that never comes\n");
+        abort();
+    }
+    SIM_AdvanceTo(wake);
+    if (0 == fakePower.constraints[PowerCC26XX_DISALLOW_STANDBY]) {
+        fakePower.standbyCount++;
+        FAKE_GPTIMER_EnterStandby();
+        SIM_Advance(fakePower.wakeLatency);
+    }
+    if (enabled) {
+        SIM_EnableInterrupts();
+    }
+}
+
+void SIM_POWER_SetWakeLatency(uint64_t ns) {
+    fakePower.wakeLatency = ns;
+}
+
+unsigned SIM_POWER_GetStandbyCount(void) {
+    return fakePower.standbyCount;
+}
+
+void SIM_RTC_SetDrift(int32_t ppb) {
+    fakePower.rtcDrift = ppb;
+}
+
+// The RTC counts 32768 Hz ticks in units of 2^-32 s
+uint64_t AONRTCCurrent64BitValueGet(void) {
+    SIM_Access();
+    unsigned __int128 ticks = (unsigned __int128)SIM_Now() * 32768u * (uint64_t)(1000000000 + (int64_t)fakePower.rtcDrift) / 1000000000000000000u;
+    return (uint64_t)ticks << 17;
+}
@@ -0,0 +1,32 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the radio configuration generated by SysConfig
+*/
+
+#include <ti_radio_config.h>
+
+RF_Mode RF_prop_custom868_0 = {.rfMode = 0};
+
+// 50 kbps 2-GFSK, 25 kHz deviation, as generated by SysConfig
+rfc_CMD_PROP_RADIO_DIV_SETUP_t RF_cmdPropRadioDivSetup_custom868_0 = {
+    .commandNo            = CMD_PROP_RADIO_DIV_SETUP,
+    .modulation.modType   = 1,
+    .modulation.deviation = 0x64,
+    .symbolRate.preScale  = 0xF,
+    .symbolRate.rateWord  = 0x8000,
+    .rxBw                 = 0x52,
+    .centerFreq           = 0x0364,
+};
+
+rfc_CMD_TX_TEST_t RF_cmdTxTest_custom868_0 = {
+    .commandNo = CMD_TX_TEST,
+};
+
+RF_TxPowerTable_Entry txPowerTable_custom868_0[TX_POWER_TABLE_SIZE_custom868_0] = {
+    {0, {0}},   {1, {1}},   {2, {2}},   {3, {3}},   {4, {4}},   {5, {5}},   {6, {6}},   {7, {7}},
+    {8, {8}},   {9, {9}},   {10, {10}}, {11, {11}}, {12, {12}}, {13, {13}}, {14, {14}}, {RF_TxPowerTable_INVALID_DBM, {0}},
+};
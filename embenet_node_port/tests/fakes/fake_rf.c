@@ -0,0 +1,280 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK RF driver
+*/
+
+#include "sim.h"
+#include "sim_rf.h"
+
+#include <ti/drivers/rf/RF.h>
+// clang-format off
+#include DeviceFamily_constructPath(driverlib/rf_data_entry.h)
+#include DeviceFamily_constructPath(driverlib/rf_prop_mailbox.h)
+// clang-format on
+
+#include <string.h>
+
+enum {
+    FAKE_RF_MAX_COMMANDS     = 32, ///< Commands remembered, older ones are overwritten
+    FAKE_RF_MAX_CALLBACKS    = 16,
+    FAKE_RF_TIMESTAMP_LENGTH = 4,
+};
+
+typedef struct {
+    RF_Op*       op;
+    RF_Callback  callback;
+    RF_EventMask events; ///< Events subscribed when the command was posted
+    bool         active;
+} FAKE_RF_Command;
+
+typedef struct {
+    RF_CmdHandle ch;
+    RF_EventMask events;
+    uint64_t     at; ///< Simulated time of the call in ns
+} FAKE_RF_Callback;
+
+static struct {
+    RF_Handle        handle;
+    FAKE_RF_Command  commands[FAKE_RF_MAX_COMMANDS];
+    RF_CmdHandle     nextHandle;
+    RF_CmdHandle     lastCommand;
+    FAKE_RF_Callback callbacks[FAKE_RF_MAX_CALLBACKS];
+    unsigned         callbackCount;
+    int8_t           rssi;
+    int8_t           txPower;
+} fakeRf;
+
+// Events reported even if they were not subscribed
+static RF_EventMask const FAKE_RF_TERMINATION_EVENTS = RF_EventLastCmdDone | RF_EventCmdCancelled | RF_EventCmdAborted | RF_EventCmdStopped;
+
+static FAKE_RF_Command* FAKE_RF_GetCommand(RF_CmdHandle ch) {
+    if ((ch < 0) || (ch >= fakeRf.nextHandle) || (fakeRf.nextHandle - ch > FAKE_RF_MAX_COMMANDS)) {
+        return NULL;
+    }
+    return &fakeRf.commands[ch % FAKE_RF_MAX_COMMANDS];
+}
+
+static unsigned FAKE_RF_Earliest(void) {
+    unsigned earliest = 0;
+    for (unsigned i = 1; i < fakeRf.callbackCount; ++i) {
+        if (fakeRf.callbacks[i].at < fakeRf.callbacks[earliest].at) {
+            earliest = i;
+        }
+    }
+    return earliest;
+}
+
+static uint64_t FAKE_RF_Next(void) {
+    return (0 != fakeRf.callbackCount) ? fakeRf.callbacks[FAKE_RF_Earliest()].at : SIM_NEVER;
+}
+
+// The RF driver calls the callbacks from a software interrupt, one at a time
+static void FAKE_RF_Service(void) {
+    unsigned         index    = FAKE_RF_Earliest();
+    FAKE_RF_Callback callback = fakeRf.callbacks[index];
+    fakeRf.callbacks[index]   = fakeRf.callbacks[--fakeRf.callbackCount];
+
+    FAKE_RF_Command* command = FAKE_RF_GetCommand(callback.ch);
+    if (NULL == command) {
+        return;
+    }
+    if (0 != (callback.events & FAKE_RF_TERMINATION_EVENTS)) {
+        command->active = false;
+    }
+    RF_EventMask events = callback.events & (command->events | FAKE_RF_TERMINATION_EVENTS);
+    if ((NULL != command->callback) && (0 != events)) {
+        command->callback(fakeRf.handle, callback.ch, events);
+    }
+}
+
+static SIM_Source const fakeRfSource = {.next = FAKE_RF_Next, .service = FAKE_RF_Service};
+
+void SIM_RF_Reset(void) {
+    memset(&fakeRf, 0, sizeof(fakeRf));
+    fakeRf.lastCommand = RF_ALLOC_ERROR;
+    fakeRf.rssi        = RF_GET_RSSI_ERROR_VAL;
+    fakeRf.txPower     = RF_TxPowerTable_INVALID_DBM;
+    SIM_AddSource(&fakeRfSource);
+}
+
+RF_CmdHandle SIM_RF_GetLastCommand(void) {
+    return fakeRf.lastCommand;
+}
+
+bool SIM_RF_IsActive(RF_CmdHandle ch) {
+    FAKE_RF_Command* command = FAKE_RF_GetCommand(ch);
+    return (NULL != command) && command->active;
+}
+
+RF_Op* SIM_RF_FindOp(RF_CmdHandle ch, uint16_t commandNo) {
+    FAKE_RF_Command* command = FAKE_RF_GetCommand(ch);
+    for (RF_Op* op = (NULL != command) ? command->op : NULL; NULL != op; op = op->pNextOp) {
+        if (commandNo == op->commandNo) {
+            return op;
+        }
+    }
+    return NULL;
+}
+
+void SIM_RF_SetStatus(RF_CmdHandle ch, uint16_t commandNo, uint16_t status) {
+    RF_Op* op = SIM_RF_FindOp(ch, commandNo);
+    if (NULL != op) {
+        op->status = status;
+    }
+}
+
+void SIM_RF_Callback(RF_CmdHandle ch, RF_EventMask events, uint64_t delay) {
+    if (fakeRf.callbackCount < FAKE_RF_MAX_CALLBACKS) {
+        fakeRf.callbacks[fakeRf.callbackCount++] = (FAKE_RF_Callback){.ch = ch, .events = events, .at = SIM_Now() + delay};
+    }
+}
+
+bool SIM_RF_ReceiveFrame(RF_CmdHandle ch, uint8_t const* psdu, size_t length, int8_t rssi, ratmr_t syncTime) {
+    rfc_CMD_PROP_RX_t* rx = (rfc_CMD_PROP_RX_t*)SIM_RF_FindOp(ch, CMD_PROP_RX);
+    if ((NULL == rx) || (NULL == rx->pQueue)) {
+        return false;
+    }
+    rfc_dataEntryPointer_t* entry = (rfc_dataEntryPointer_t*)rx->pQueue->pCurrEntry;
+    size_t                  size  = (rx->rxConf.bIncludeHdr ? 1 : 0) + length + (rx->rxConf.bAppendRssi ? 1 : 0) + (rx->rxConf.bAppendTimestamp ? FAKE_RF_TIMESTAMP_LENGTH : 0);
+    if ((DATA_ENTRY_PENDING != entry->status) || (size > entry->length)) {
+        return false;
+    }
+
+    uint8_t* data = entry->pData;
+    if (rx->rxConf.bIncludeHdr) {
+        *data++ = (uint8_t)length;
+    }
+    memcpy(data, psdu, length);
+    data += length;
+    if (rx->rxConf.bAppendRssi) {
+        *data++ = (uint8_t)rssi;
+    }
+    if (rx->rxConf.bAppendTimestamp) {
+        for (unsigned i = 0; i < FAKE_RF_TIMESTAMP_LENGTH; ++i) {
+            *data++ = (uint8_t)(syncTime >> (8 * i));
+        }
+    }
+    entry->status          = DATA_ENTRY_FINISHED;
+    rx->pQueue->pCurrEntry = entry->pNextEntry;
+    return true;
+}
+
+void SIM_RF_SetRssi(int8_t rssi) {
+    fakeRf.rssi = rssi;
+}
+
+// The RSSI is compared with the threshold once, an RSSI not available until the timeout gives the result configured by timeoutRes
+bool SIM_RF_SenseChannel(RF_CmdHandle ch) {
+    rfc_CMD_PROP_CS_t* cs = (rfc_CMD_PROP_CS_t*)SIM_RF_FindOp(ch, CMD_PROP_CS);
+    if (NULL == cs) {
+        return false;
+    }
+    bool busy  = (RF_GET_RSSI_ERROR_VAL == fakeRf.rssi) ? (0 == cs->csConf.timeoutRes) : (fakeRf.rssi > cs->rssiThr);
+    cs->status = busy ? PROP_DONE_BUSY : PROP_DONE_IDLETIMEOUT;
+    return busy;
+}
+
+int8_t SIM_RF_GetTxPower(void) {
+    return fakeRf.txPower;
+}
+
+void RF_Params_init(RF_Params* params) {
+    *params = (RF_Params){.nInactivityTimeout = UINT32_MAX, .nPowerUpDuration = 0};
+}
+
+RF_Handle RF_open(RF_Object* pObj, RF_Mode* pRfMode, RF_RadioSetup* pRadioSetup, RF_Params* params) {
+    (void)params;
+    *pObj         = (RF_Object){.mode = pRfMode, .setup = pRadioSetup};
+    fakeRf.handle = pObj;
+    return pObj;
+}
+
+void RF_close(RF_Handle h) {
+    (void)h;
+    fakeRf.handle = NULL;
+}
+
+RF_CmdHandle RF_postCmd(RF_Handle h, RF_Op* pOp, RF_Priority ePri, RF_Callback pCb, RF_EventMask bmEvent) {
+    (void)ePri;
+    if ((h != fakeRf.handle) || (NULL == h)) {
+        return RF_ALLOC_ERROR;
+    }
+    for (RF_Op* op = pOp; NULL != op; op = op->pNextOp) {
+        op->status = PENDING;
+    }
+    RF_CmdHandle ch                            = fakeRf.nextHandle++;
+    fakeRf.commands[ch % FAKE_RF_MAX_COMMANDS] = (FAKE_RF_Command){.op = pOp, .callback = pCb, .events = bmEvent, .active = true};
+    if (NULL != pCb) {
+        fakeRf.lastCommand = ch;
+    }
+    return ch;
+}
+
+// The command is not executed, it ends at once
+RF_EventMask RF_runCmd(RF_Handle h, RF_Op* pOp, RF_Priority ePri, RF_Callback pCb, RF_EventMask bmEvent) {
+    RF_CmdHandle ch = RF_postCmd(h, pOp, ePri, pCb, bmEvent);
+    if (RF_ALLOC_ERROR == ch) {
+        return RF_EventCmdCancelled;
+    }
+    fakeRf.commands[ch % FAKE_RF_MAX_COMMANDS].active = false;
+    return RF_EventLastCmdDone;
+}
+
+// An active command is aborted, its callback comes SIM_RF_CALLBACK_LATENCY_NS later
+RF_Stat RF_flushCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode) {
+    (void)h;
+    (void)mode;
+    if (!SIM_RF_IsActive(ch)) {
+        return RF_StatInvalidParamsError;
+    }
+    FAKE_RF_GetCommand(ch)->active = false;
+    SIM_RF_Callback(ch, RF_EventCmdAborted, SIM_RF_CALLBACK_LATENCY_NS);
+    return RF_StatSuccess;
+}
+
+RF_Stat RF_control(RF_Handle h, int8_t ctrl, void* args) {
+    (void)h;
+    (void)ctrl;
+    (void)args;
+    return RF_StatSuccess;
+}
+
+RF_Stat RF_setTxPower(RF_Handle h, RF_TxPowerTable_Value value) {
+    (void)h;
+    fakeRf.txPower = (int8_t)value.rawValue;
+    return RF_StatSuccess;
+}
+
+uint32_t RF_getCurrentTime(void) {
+    SIM_Access();
+    return (uint32_t)(SIM_Now() * RF_NUM_RAT_TICKS_IN_1_US / 1000);
+}
+
+int8_t RF_getRssi(RF_Handle h) {
+    (void)h;
+    SIM_Access();
+    return fakeRf.rssi;
+}
+
+RF_TxPowerTable_Value RF_TxPowerTable_findValue(RF_TxPowerTable_Entry table[], int8_t powerLevel) {
+    size_t last = 0;
+    while (RF_TxPowerTable_INVALID_DBM != table[last + 1].power) {
+        ++last;
+    }
+    if (RF_TxPowerTable_MAX_DBM == powerLevel) {
+        return table[last].value;
+    }
+    if (RF_TxPowerTable_MIN_DBM == powerLevel) {
+        return table[0].value;
+    }
+    for (size_t i = 0; i <= last; ++i) {
+        if (powerLevel == table[i].power) {
+            return table[i].value;
+        }
+    }
+    return (RF_TxPowerTable_Value){.rawValue = (uint32_t)RF_TxPowerTable_INVALID_DBM};
+}
@@ -0,0 +1,254 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK UART2 driver backed by a pseudo terminal
+*/
+
+#define _XOPEN_SOURCE   700 // posix_openpt
+#define _DEFAULT_SOURCE     // cfmakeraw and the baud rates above 38400
+
+#include "sim.h"
+#include "sim_uart.h"
+
+#include <ti/devices/DeviceFamily.h>
+#include <ti/drivers/UART2.h>
+#include <ti/drivers/uart2/UART2Support.h>
+#include DeviceFamily_constructPath(driverlib/sys_ctrl.h)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+typedef struct {
+    int          master; ///< side of the border router
+    int          line;   ///< slave side held open, so that the master does not see a hang-up while UART is reopened
+    int          fd;     ///< slave side opened by UART2_open, -1 if closed
+    UART2_Params params;
+    UART2_Config config;
+    void const*  txBuffer; ///< data of the write in progress, NULL if none
+    size_t       txSize;
+    uint64_t     txDone; ///< simulated time the last byte of the write is shifted out
+    unsigned     openCount;
+    unsigned     readCount;
+    unsigned     writeCount;
+    size_t       writtenBytes;
+} FAKE_UART_State;
+
+static FAKE_UART_State fakeUart = {.master = -1, .line = -1, .fd = -1};
+
+static struct {
+    uint32_t baudRate;
+    speed_t  speed;
+} const fakeUartSpeeds[] = {
+    {115200, B115200},   {230400, B230400},   {460800, B460800},   {500000, B500000},   {576000, B576000},   {921600, B921600},
+    {1000000, B1000000}, {1152000, B1152000}, {1500000, B1500000}, {2000000, B2000000}, {2500000, B2500000}, {3000000, B3000000},
+};
+
+static void FAKE_UART_Fail(char const* what) {
+    fprintf(stderr, "UART2: %s (%s)\n", what, strerror(errno));
+    abort();
+}
+
+static uint64_t FAKE_UART_Next(void) {
+    return (NULL != fakeUart.txBuffer) ? fakeUart.txDone : SIM_NEVER;
+}
+
+// The shifted out bytes reach the border router and the write callback is called, as the driver does from the DMA interrupt
+static void FAKE_UART_Service(void) {
+    uint8_t const* data = fakeUart.txBuffer;
+    size_t         size = fakeUart.txSize;
+    for (size_t written = 0; written < size;) {
+        ssize_t result = write(fakeUart.fd, data + written, size - written);
+        if (result < 0) {
+            FAKE_UART_Fail("write to the pseudo terminal failed");
+        }
+        written += (size_t)result;
+    }
+    fakeUart.txBuffer = NULL;
+    fakeUart.params.writeCallback(&fakeUart.config, (void*)data, size, fakeUart.params.userArg, UART2_STATUS_SUCCESS);
+}
+
+static SIM_Source const fakeUartSource = {.next = FAKE_UART_Next, .service = FAKE_UART_Service};
+
+void SIM_UART_Reset(void) {
+    if (fakeUart.fd >= 0) {
+        close(fakeUart.fd);
+    }
+    if (fakeUart.line >= 0) {
+        close(fakeUart.line);
+    }
+    if (fakeUart.master >= 0) {
+        close(fakeUart.master);
+    }
+    fakeUart = (FAKE_UART_State){.master = -1, .line = -1, .fd = -1};
+
+    fakeUart.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((fakeUart.master < 0) || (0 != grantpt(fakeUart.master)) || (0 != unlockpt(fakeUart.master))) {
+        FAKE_UART_Fail("cannot open a pseudo terminal");
+    }
+    fakeUart.line = open(ptsname(fakeUart.master), O_RDWR | O_NOCTTY);
+    if (fakeUart.line < 0) {
+        FAKE_UART_Fail("cannot open the slave side of the pseudo terminal");
+    }
+
+    // Bytes pass unchanged in both directions
+    struct termios attributes;
+    tcgetattr(fakeUart.line, &attributes);
+    cfmakeraw(&attributes);
+    tcsetattr(fakeUart.line, TCSANOW, &attributes);
+}
+
+int SIM_UART_GetPeer(void) {
+    return fakeUart.master;
+}
+
+uint32_t SIM_UART_GetBaudRate(void) {
+    struct termios attributes;
+    tcgetattr(fakeUart.line, &attributes);
+    for (size_t i = 0; i < sizeof(fakeUartSpeeds) / sizeof(fakeUartSpeeds[0]); ++i) {
+        if (fakeUartSpeeds[i].speed == cfgetospeed(&attributes)) {
+            return fakeUartSpeeds[i].baudRate;
+        }
+    }
+    return 0;
+}
+
+unsigned SIM_UART_GetOpenCount(void) {
+    return fakeUart.openCount;
+}
+
+size_t SIM_UART_GetPending(void) {
+    int count = 0;
+    if (0 != ioctl(fakeUart.line, FIONREAD, &count)) {
+        FAKE_UART_Fail("cannot get the number of received bytes");
+    }
+    return (size_t)count;
+}
+
+unsigned SIM_UART_GetReadCount(void) {
+    return fakeUart.readCount;
+}
+
+unsigned SIM_UART_GetWriteCount(void) {
+    return fakeUart.writeCount;
+}
+
+size_t SIM_UART_GetWrittenBytes(void) {
+    return fakeUart.writtenBytes;
+}
+
+void UART2_Params_init(UART2_Params* params) {
+    *params = (UART2_Params){.readMode = UART2_Mode_BLOCKING, .writeMode = UART2_Mode_BLOCKING, .baudRate = 115200};
+}
+
+// Only the modes used by the port are supported: non-blocking reads and writes completed with a callback
+UART2_Handle UART2_open(uint_least8_t index, UART2_Params* params) {
+    (void)index;
+    if ((fakeUart.fd >= 0) || (UART2_Mode_NONBLOCKING != params->readMode) || (UART2_Mode_CALLBACK != params->writeMode) || (NULL == params->writeCallback)) {
+        return NULL;
+    }
+
+    speed_t speed = B0;
+    for (size_t i = 0; i < sizeof(fakeUartSpeeds) / sizeof(fakeUartSpeeds[0]); ++i) {
+        if (fakeUartSpeeds[i].baudRate == params->baudRate) {
+            speed = fakeUartSpeeds[i].speed;
+        }
+    }
+    if (B0 == speed) {
+        return NULL;
+    }
+
+    fakeUart.fd = open(ptsname(fakeUart.master), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fakeUart.fd < 0) {
+        FAKE_UART_Fail("cannot open the slave side of the pseudo terminal");
+    }
+    struct termios attributes;
+    tcgetattr(fakeUart.fd, &attributes);
+    cfsetspeed(&attributes, speed);
+    tcsetattr(fakeUart.fd, TCSANOW, &attributes);
+
+    fakeUart.params = *params;
+    fakeUart.config = (UART2_Config){.object = &fakeUart, .hwAttrs = &fakeUart};
+    fakeUart.openCount++;
+    SIM_AddSource(&fakeUartSource);
+    return &fakeUart.config;
+}
+
+void UART2_close(UART2_Handle handle) {
+    (void)handle;
+    if (NULL != fakeUart.txBuffer) {
+        fprintf(stderr, "UART2: closed while a write is in progress, the rest of the frame is lost\n");
+        abort();
+    }
+    if (fakeUart.fd >= 0) {
+        close(fakeUart.fd);
+        fakeUart.fd = -1;
+    }
+}
+
+void UART2_rxEnable(UART2_Handle handle) {
+    (void)handle;
+}
+
+size_t UART2_getRxCount(UART2_Handle handle) {
+    (void)handle;
+    int count = 0;
+    SIM_Access();
+    if (0 != ioctl(fakeUart.fd, FIONREAD, &count)) {
+        FAKE_UART_Fail("cannot get the number of received bytes");
+    }
+    return (size_t)count;
+}
+
+int_fast16_t UART2_read(UART2_Handle handle, void* buffer, size_t size, size_t* bytesRead) {
+    (void)handle;
+    ssize_t result = read(fakeUart.fd, buffer, size);
+    if (result < 0) {
+        if ((EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+            FAKE_UART_Fail("read from the pseudo terminal failed");
+        }
+        result = 0;
+    }
+    if (result > 0) {
+        fakeUart.readCount++;
+    }
+    if (NULL != bytesRead) {
+        *bytesRead = (size_t)result;
+    }
+    return (result > 0) ? UART2_STATUS_SUCCESS : UART2_STATUS_EAGAIN;
+}
+
+int_fast16_t UART2_write(UART2_Handle handle, const void* buffer, size_t size, size_t* bytesWritten) {
+    (void)handle;
+    if (NULL != fakeUart.txBuffer) {
+        return UART2_STATUS_EINUSE;
+    }
+    fakeUart.txBuffer = buffer;
+    fakeUart.txSize   = size;
+    fakeUart.txDone   = SIM_Now() + (uint64_t)size * 10 * 1000000000 / fakeUart.params.baudRate;
+    fakeUart.writeCount++;
+    fakeUart.writtenBytes += size;
+    if (NULL != bytesWritten) {
+        *bytesWritten = 0; // known only in the callback
+    }
+    return UART2_STATUS_SUCCESS;
+}
+
+bool UART2Support_txDone(void const* hwAttrs) {
+    (void)hwAttrs;
+    SIM_Access();
+    return NULL == fakeUart.txBuffer;
+}
+
+void SysCtrlSystemReset(void) {
+    fprintf(stderr, "the device was reset\n");
+    abort();
+}
@@ -0,0 +1,80 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Simulated time and interrupts behind the fake SDK drivers
+*/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SIM_NEVER UINT64_MAX                   ///< Event time of a source without a pending event
+#define SIM_EUI64 UINT64_C(0x00124b0000a1b2c3) ///< EUI-64 of the simulated device, as returned by EMBENET_EUI64_Get
+
+/**
+ * @brief Source of interrupts of the simulated device.
+ *
+ * A due event stays pending, i.e. @ref next returns a time not later than now, until the source is serviced. Sources are serviced
+ * one at a time, only when interrupts are enabled and no other interrupt is handled.
+ */
+typedef struct {
+    uint64_t (*next)(void);  ///< Returns the time of the next event in ns, SIM_NEVER if none
+    void (*service)(void);   ///< Handles the due event, i.e. calls the interrupt handler
+} SIM_Source;
+
+/// Resets the time to 0, drops all sources and enables interrupts
+void SIM_Reset(void);
+
+/// Returns the simulated time in ns
+uint64_t SIM_Now(void);
+
+/// Registers a source of interrupts, unless it is registered already. The source must stay valid until SIM_Reset.
+void SIM_AddSource(SIM_Source const* source);
+
+/// Advances the time by the given number of ns, handling the interrupts due in the meantime
+void SIM_Advance(uint64_t ns);
+
+/// Advances the time to the given time in ns, handling the interrupts due in the meantime
+void SIM_AdvanceTo(uint64_t time);
+
+/// Advances the time by the duration of a register access, every read of a simulated peripheral calls it
+void SIM_Access(void);
+
+/// Returns the time of the earliest event of all sources
+uint64_t SIM_NextEvent(void);
+
+/// Disables interrupts, returns true if they were enabled
+bool SIM_DisableInterrupts(void);
+
+/// Enables interrupts and handles the pending ones
+void SIM_EnableInterrupts(void);
+
+/// Returns true while an interrupt is handled
+bool SIM_InInterrupt(void);
+
+/// Sets the rate error of the RTC in parts per billion, positive if the RTC runs fast
+void SIM_RTC_SetDrift(int32_t ppb);
+
+/// Sets the time from the wake-up event until the device runs again
+void SIM_POWER_SetWakeLatency(uint64_t ns);
+
+/// Returns the number of times the device entered standby
+unsigned SIM_POWER_GetStandbyCount(void);
+
+/// Sets the counter value the GPTimer restarts from after standby, its state is lost in standby
+void SIM_GPTIMER_SetValueAfterStandby(uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_H_ included
@@ -0,0 +1,35 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Control of the fake crypto drivers, backed by OpenSSL
+*/
+
+#ifndef SIM_CRYPTO_H_
+#define SIM_CRYPTO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Makes the next AESCCM operation fail with the given status, after it has transformed part of the data in place as the accelerator does
+void SIM_AESCCM_FailNext(int_fast16_t status);
+
+/// Returns the number of AESCCM operations run since the driver was opened
+unsigned SIM_AESCCM_GetOperationCount(void);
+
+/// Returns the number of blocks encrypted or decrypted by AESECB since the driver was opened
+unsigned SIM_AESECB_GetBlockCount(void);
+
+/// Returns the key material the last AESECB operation was run with, i.e. the storage of the key in the port
+uint8_t const* SIM_AESECB_GetLastKey(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_CRYPTO_H_ included
@@ -0,0 +1,78 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Control of the fake embeNET Node API used by the demo services, the test plays the part of the stack and of the network
+*/
+
+#ifndef SIM_NODE_H_
+#define SIM_NODE_H_
+
+#include "embenet_node.h"
+#include "embenet_node_diag.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    SIM_NODE_MAX_DATAGRAM = 64, ///< Longest datagram kept by SIM_NODE_GetSent
+    SIM_NODE_MAX_SENT     = 32, ///< Number of datagrams kept by SIM_NODE_GetSent, the oldest are dropped
+    SIM_NODE_MAX_ENTRIES  = 16, ///< Number of neighbors and cells reported by the diagnostics
+};
+
+/// Datagram sent by the node
+typedef struct {
+    EMBENET_IPV6 destination;
+    uint16_t     port;
+    size_t       size;
+    uint8_t      data[SIM_NODE_MAX_DATAGRAM];
+} SIM_NODE_Datagram;
+
+/// Drops tasks, sockets, ENMS services, sent datagrams and diagnostics, and sets the time to 0
+void SIM_NODE_Reset(void);
+
+/// Runs the tasks due until the given time in ms, in the order of their time, then sets the time. Local and network time are the same.
+void SIM_NODE_RunUntil(uint64_t time);
+
+/// Passes a datagram received from the given source to the sockets registered on the given port
+void SIM_NODE_Deliver(EMBENET_IPV6 const* source, uint16_t port, void const* data, size_t size);
+
+/// Returns the number of datagrams sent since SIM_NODE_ClearSent, at most SIM_NODE_MAX_SENT are kept
+size_t SIM_NODE_GetSentCount(void);
+
+/// Returns a sent datagram, 0 is the oldest one kept
+SIM_NODE_Datagram const* SIM_NODE_GetSent(size_t index);
+
+/// Drops sent datagrams
+void SIM_NODE_ClearSent(void);
+
+/// Returns the address returned by EMBENET_NODE_GetParentAddress
+EMBENET_IPV6 SIM_NODE_GetParentAddress(void);
+
+/// Returns true if the address is a multicast address built by EMBENET_AssembleMulticastIpv6 for the group
+bool SIM_NODE_IsGroupAddress(EMBENET_IPV6 const* address, EMBENET_GroupId groupId);
+
+/// Sets the neighbors reported by the diagnostics, at most SIM_NODE_MAX_ENTRIES
+void SIM_NODE_SetNeighbors(EMBENET_NODE_DIAG_NeighborInfo const* neighbors, size_t count);
+
+/// Sets the cells reported by the diagnostics, at most SIM_NODE_MAX_ENTRIES
+void SIM_NODE_SetCells(EMBENET_NODE_DIAG_CellInfo const* cells, size_t count);
+
+/// Sets the delivery ratio to the parent reported by the diagnostics in 0.01% units
+void SIM_NODE_SetParentPdr(uint16_t pdr);
+
+/// Returns the state of a service registered in ENMS, -1 if it is not registered
+int SIM_NODE_GetServiceState(char const* serviceName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_NODE_H_ included
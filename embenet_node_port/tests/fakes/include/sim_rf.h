@@ -0,0 +1,67 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Control of the fake RF driver, the test plays the part of the RF core
+*/
+
+#ifndef SIM_RF_H_
+#define SIM_RF_H_
+
+#include <ti/drivers/rf/RF.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    SIM_RF_CALLBACK_LATENCY_NS = 20000, ///< Delay of the callbacks of commands flushed with RF_flushCmd
+};
+
+/// Drops all commands and pending callbacks, call after SIM_Reset
+void SIM_RF_Reset(void);
+
+/// Returns the handle of the last command posted with a callback, RF_ALLOC_ERROR if there is none
+RF_CmdHandle SIM_RF_GetLastCommand(void);
+
+/// Returns true until the command ends with RF_EventLastCmdDone or is flushed
+bool SIM_RF_IsActive(RF_CmdHandle ch);
+
+/// Returns the operation with the given command ID in the chain of the command, NULL if there is none
+RF_Op* SIM_RF_FindOp(RF_CmdHandle ch, uint16_t commandNo);
+
+/// Sets the status of the operation with the given command ID in the chain of the command
+void SIM_RF_SetStatus(RF_CmdHandle ch, uint16_t commandNo, uint16_t status);
+
+/// Calls the callback of the command with the given events after the given delay in ns, as the RF driver does from its software interrupt
+void SIM_RF_Callback(RF_CmdHandle ch, RF_EventMask events, uint64_t delay);
+
+/**
+ * @brief Writes a frame into the data queue of the CMD_PROP_RX operation of the command, as configured by its rxConf.
+ * @return false if the current entry of the queue is not free, the frame is then lost
+ */
+bool SIM_RF_ReceiveFrame(RF_CmdHandle ch, uint8_t const* psdu, size_t length, int8_t rssi, ratmr_t syncTime);
+
+/// Sets the RSSI returned by RF_getRssi and sensed by CMD_PROP_CS
+void SIM_RF_SetRssi(int8_t rssi);
+
+/**
+ * @brief Senses the channel with the CMD_PROP_CS operation of the command, as configured by its rssiThr and csConf, and sets its status.
+ * @return true if the channel was found busy, false if it was found clear or the command has no such operation
+ */
+bool SIM_RF_SenseChannel(RF_CmdHandle ch);
+
+/// Returns the power in dBm of the last RF_setTxPower, RF_TxPowerTable_INVALID_DBM if none
+int8_t SIM_RF_GetTxPower(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_RF_H_ included
@@ -0,0 +1,53 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Control of the fake UART2 driver, the test plays the border router on the other side of a pseudo terminal
+*/
+
+#ifndef SIM_UART_H_
+#define SIM_UART_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opens a new pseudo terminal in raw mode, call after SIM_Reset.
+ *
+ * The fake UART2 driver reads and writes the slave side. Written bytes reach the master side once they are shifted out at the configured baud rate,
+ * i.e. after 10 bit periods per byte of simulated time.
+ */
+void SIM_UART_Reset(void);
+
+/// Returns the file descriptor of the master side of the pseudo terminal
+int SIM_UART_GetPeer(void);
+
+/// Returns the baud rate the pseudo terminal is configured with by UART2_open
+uint32_t SIM_UART_GetBaudRate(void);
+
+/// Returns the number of times UART2_open was called since SIM_UART_Reset
+unsigned SIM_UART_GetOpenCount(void);
+
+/// Returns the number of bytes written by the peer and not read by the port yet
+size_t SIM_UART_GetPending(void);
+
+/// Returns the number of UART2_read calls that returned data since SIM_UART_Reset
+unsigned SIM_UART_GetReadCount(void);
+
+/// Returns the number of UART2_write calls that started a write since SIM_UART_Reset
+unsigned SIM_UART_GetWriteCount(void);
+
+/// Returns the number of bytes passed to the writes counted by SIM_UART_GetWriteCount
+size_t SIM_UART_GetWrittenBytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_UART_H_ included
@@ -0,0 +1,15 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK device family selection
+*/
+
+#ifndef FAKE_TI_DEVICES_DEVICEFAMILY_H_
+#define FAKE_TI_DEVICES_DEVICEFAMILY_H_
+
+#define DeviceFamily_constructPath(x) <ti/devices/cc13x2_cc26x2/x>
+
+#endif // FAKE_TI_DEVICES_DEVICEFAMILY_H_ included
@@ -0,0 +1,25 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the driverlib AON RTC API
+*/
+
+#ifndef FAKE_DRIVERLIB_AON_RTC_H_
+#define FAKE_DRIVERLIB_AON_RTC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t AONRTCCurrent64BitValueGet(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_DRIVERLIB_AON_RTC_H_ included
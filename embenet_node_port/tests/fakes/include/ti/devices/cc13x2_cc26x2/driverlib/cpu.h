@@ -0,0 +1,13 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the driverlib CPU API
+*/
+
+#ifndef FAKE_DRIVERLIB_CPU_H_
+#define FAKE_DRIVERLIB_CPU_H_
+
+#endif // FAKE_DRIVERLIB_CPU_H_ included
@@ -0,0 +1,25 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the driverlib interrupt controller API
+*/
+
+#ifndef FAKE_DRIVERLIB_INTERRUPT_H_
+#define FAKE_DRIVERLIB_INTERRUPT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void IntPendSet(uint32_t intNum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_DRIVERLIB_INTERRUPT_H_ included
@@ -0,0 +1,24 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the driverlib PRCM API
+*/
+
+#ifndef FAKE_DRIVERLIB_PRCM_H_
+#define FAKE_DRIVERLIB_PRCM_H_
+
+#include <stdint.h>
+
+#define PRCM_CLOCK_DIV_64 6
+
+static inline void PRCMGPTimerClockDivisionSet(uint32_t clkDiv) {
+    (void)clkDiv; // the fake timer always runs at 3/4 MHz
+}
+
+static inline void PRCMLoadSet(void) {
+}
+
+#endif // FAKE_DRIVERLIB_PRCM_H_ included
@@ -0,0 +1,89 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the common RF core commands, only the fields used by the port
+*/
+
+#ifndef FAKE_DRIVERLIB_RF_COMMON_CMD_H_
+#define FAKE_DRIVERLIB_RF_COMMON_CMD_H_
+
+#include "rf_mailbox.h"
+
+#include <stdint.h>
+
+// Command IDs
+#define CMD_FS      0x0803
+#define CMD_FS_OFF  0x0804
+#define CMD_RX_TEST 0x0807
+#define CMD_TX_TEST 0x0808
+
+/// Trigger of a radio operation
+typedef struct {
+    uint8_t triggerType; ///< TRIG_NOW..TRIG_REL_PREVEND
+    uint8_t bEnaCmd;
+    uint8_t triggerNo;
+    uint8_t pastTrig; ///< 1 if a trigger in the past fires at once
+} rfc_trigger_t;
+
+/// Condition for running the next operation of a chain
+typedef struct {
+    uint8_t rule; ///< COND_ALWAYS..COND_STOP_ON_TRUE
+    uint8_t nSkip;
+} rfc_condition_t;
+
+/// Fields shared by all radio operations, every command starts with them so that it can be posted as RF_Op
+#define FAKE_RFC_RADIO_OP_FIELDS         \
+    uint16_t              commandNo;    \
+    uint16_t              status;       \
+    struct rfc_radioOp_s* pNextOp;      \
+    ratmr_t               startTime;    \
+    rfc_trigger_t         startTrigger; \
+    rfc_condition_t       condition;
+
+typedef struct rfc_radioOp_s {
+    FAKE_RFC_RADIO_OP_FIELDS
+} rfc_radioOp_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    uint16_t frequency; ///< Integer part of the frequency in MHz
+    uint16_t fractFreq; ///< Fractional part of the frequency in 1/65536 MHz
+    struct {
+        uint8_t bTxMode;
+        uint8_t refFreq;
+    } synthConf;
+} rfc_CMD_FS_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+} rfc_CMD_FS_OFF_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint8_t bEnaFifo;
+        uint8_t bFsOff;
+        uint8_t bNoSync;
+    } config;
+    rfc_trigger_t endTrigger;
+    uint32_t      syncWord;
+    ratmr_t       endTime;
+} rfc_CMD_RX_TEST_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint8_t bUseCw;
+        uint8_t bFsOff;
+        uint8_t whitenMode;
+    } config;
+    uint16_t      txWord;
+    rfc_trigger_t endTrigger;
+    uint32_t      syncWord;
+    ratmr_t       endTime;
+} rfc_CMD_TX_TEST_t;
+
+#endif // FAKE_DRIVERLIB_RF_COMMON_CMD_H_ included
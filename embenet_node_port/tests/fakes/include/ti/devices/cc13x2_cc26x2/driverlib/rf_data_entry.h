@@ -0,0 +1,41 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the RF core data entry definitions, only the ones used by the port
+*/
+
+#ifndef FAKE_DRIVERLIB_RF_DATA_ENTRY_H_
+#define FAKE_DRIVERLIB_RF_DATA_ENTRY_H_
+
+#include <stdint.h>
+
+// Status of data entries
+#define DATA_ENTRY_PENDING    0
+#define DATA_ENTRY_ACTIVE     1
+#define DATA_ENTRY_BUSY       2
+#define DATA_ENTRY_FINISHED   3
+#define DATA_ENTRY_UNFINISHED 4
+
+// Types of data entries
+#define DATA_ENTRY_TYPE_GEN     0
+#define DATA_ENTRY_TYPE_MULTI   1
+#define DATA_ENTRY_TYPE_PTR     2
+#define DATA_ENTRY_TYPE_PARTIAL 3
+
+/// Data entry pointing at a separate buffer
+typedef struct {
+    uint8_t* pNextEntry; ///< Next entry of the queue
+    uint8_t  status;     ///< DATA_ENTRY_PENDING..DATA_ENTRY_UNFINISHED
+    struct {
+        uint8_t type;
+        uint8_t lenSz;
+        uint8_t irqIntv;
+    } config;
+    uint16_t length; ///< Size of the buffer
+    uint8_t* pData;  ///< Buffer
+} rfc_dataEntryPointer_t;
+
+#endif // FAKE_DRIVERLIB_RF_DATA_ENTRY_H_ included
@@ -0,0 +1,45 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the RF core mailbox definitions, only the ones used by the port
+*/
+
+#ifndef FAKE_DRIVERLIB_RF_MAILBOX_H_
+#define FAKE_DRIVERLIB_RF_MAILBOX_H_
+
+#include <stdint.h>
+
+typedef uint32_t ratmr_t; ///< Radio timer (RAT) time, 4 ticks per us
+
+/// Queue of data entries, filled by the RF core
+typedef struct {
+    uint8_t* pCurrEntry; ///< Entry filled next
+    uint8_t* pLastEntry; ///< Last entry, NULL for a circular queue
+} dataQueue_t;
+
+// Start and end trigger types
+#define TRIG_NOW            0
+#define TRIG_NEVER          1
+#define TRIG_ABSTIME        2
+#define TRIG_REL_SUBMIT     3
+#define TRIG_REL_START      4
+#define TRIG_REL_PREVSTART  5
+#define TRIG_REL_FIRSTSTART 6
+#define TRIG_REL_PREVEND    7
+
+// Conditions for running the next command of a chain
+#define COND_ALWAYS        0
+#define COND_NEVER         1
+#define COND_STOP_ON_FALSE 2
+#define COND_STOP_ON_TRUE  3
+
+// Status of radio operations
+#define IDLE    0x0000
+#define PENDING 0x0001
+#define ACTIVE  0x0002
+#define DONE_OK 0x0400
+
+#endif // FAKE_DRIVERLIB_RF_MAILBOX_H_ included
@@ -0,0 +1,102 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the proprietary RF core commands, only the fields used by the port
+*/
+
+#ifndef FAKE_DRIVERLIB_RF_PROP_CMD_H_
+#define FAKE_DRIVERLIB_RF_PROP_CMD_H_
+
+#include "rf_common_cmd.h"
+
+#include <stdint.h>
+
+// Command IDs
+#define CMD_PROP_TX              0x3801
+#define CMD_PROP_RX              0x3802
+#define CMD_PROP_CS              0x3805
+#define CMD_PROP_RADIO_DIV_SETUP 0x3807
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint8_t bFsOff;
+        uint8_t bUseCrc;
+        uint8_t bVarLen;
+    } pktConf;
+    uint8_t  pktLen;
+    uint32_t syncWord;
+    uint8_t* pPkt;
+} rfc_CMD_PROP_TX_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint8_t bFsOff;
+        uint8_t bRepeatOk;
+        uint8_t bRepeatNok;
+        uint8_t bUseCrc;
+        uint8_t bVarLen;
+        uint8_t bChkAddress;
+        uint8_t endType;
+        uint8_t filterOp;
+    } pktConf;
+    struct {
+        uint8_t bAutoFlushIgnored;
+        uint8_t bAutoFlushCrcErr;
+        uint8_t bIncludeHdr;
+        uint8_t bIncludeCrc;
+        uint8_t bAppendRssi;
+        uint8_t bAppendTimestamp;
+        uint8_t bAppendStatus;
+    } rxConf;
+    uint32_t      syncWord;
+    uint8_t       maxPktLen;
+    uint8_t       address0;
+    uint8_t       address1;
+    rfc_trigger_t endTrigger;
+    ratmr_t       endTime;
+    dataQueue_t*  pQueue;
+    uint8_t*      pOutput;
+} rfc_CMD_PROP_RX_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint8_t bFsOffIdle;
+        uint8_t bFsOffBusy;
+    } csFsConf;
+    struct {
+        uint8_t bEnaRssi;
+        uint8_t bEnaCorr;
+        uint8_t operation;
+        uint8_t busyOp;
+        uint8_t idleOp;
+        uint8_t timeoutRes;
+    } csConf;
+    int8_t        rssiThr;
+    uint8_t       numRssiIdle;
+    uint8_t       numRssiBusy;
+    uint16_t      corrPeriod;
+    rfc_trigger_t csEndTrigger;
+    ratmr_t       csEndTime;
+} rfc_CMD_PROP_CS_t;
+
+typedef struct {
+    FAKE_RFC_RADIO_OP_FIELDS
+    struct {
+        uint16_t modType;
+        uint16_t deviation; ///< Frequency deviation in 250 Hz steps
+    } modulation;
+    struct {
+        uint8_t  preScale;
+        uint32_t rateWord;
+    } symbolRate;
+    uint8_t  rxBw;
+    uint16_t centerFreq;
+} rfc_CMD_PROP_RADIO_DIV_SETUP_t;
+
+#endif // FAKE_DRIVERLIB_RF_PROP_CMD_H_ included
@@ -0,0 +1,31 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the proprietary RF mailbox definitions, only the ones used by the port
+*/
+
+#ifndef FAKE_DRIVERLIB_RF_PROP_MAILBOX_H_
+#define FAKE_DRIVERLIB_RF_PROP_MAILBOX_H_
+
+#include "rf_mailbox.h"
+
+// Status of proprietary radio operations
+#define PROP_DONE_OK          0x3400
+#define PROP_DONE_RXTIMEOUT   0x3401
+#define PROP_DONE_BREAK       0x3402
+#define PROP_DONE_ENDED       0x3403
+#define PROP_DONE_STOPPED     0x3404
+#define PROP_DONE_ABORT       0x3405
+#define PROP_DONE_RXERR       0x3406
+#define PROP_DONE_IDLE        0x3407
+#define PROP_DONE_BUSY        0x3408
+#define PROP_DONE_IDLETIMEOUT 0x3409
+#define PROP_DONE_BUSYTIMEOUT 0x340A
+#define PROP_ERROR_PAR        0x3800
+#define PROP_ERROR_RXBUF      0x3801
+#define PROP_ERROR_RXFULL     0x3802
+
+#endif // FAKE_DRIVERLIB_RF_PROP_MAILBOX_H_ included
@@ -0,0 +1,16 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the driverlib system control API
+*/
+
+#ifndef FAKE_DRIVERLIB_SYS_CTRL_H_
+#define FAKE_DRIVERLIB_SYS_CTRL_H_
+
+/// Aborts the test, the device is never reset
+void SysCtrlSystemReset(void);
+
+#endif // FAKE_DRIVERLIB_SYS_CTRL_H_ included
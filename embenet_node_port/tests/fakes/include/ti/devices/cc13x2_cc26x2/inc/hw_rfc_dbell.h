@@ -0,0 +1,13 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the RF core doorbell register definitions, no register is used by the port
+*/
+
+#ifndef FAKE_INC_HW_RFC_DBELL_H_
+#define FAKE_INC_HW_RFC_DBELL_H_
+
+#endif // FAKE_INC_HW_RFC_DBELL_H_ included
@@ -0,0 +1,64 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK AESCCM driver, polling mode only
+*/
+
+#ifndef FAKE_TI_DRIVERS_AESCCM_H_
+#define FAKE_TI_DRIVERS_AESCCM_H_
+
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKey.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AESCCM_STATUS_SUCCESS              ((int_fast16_t)0)
+#define AESCCM_STATUS_ERROR                ((int_fast16_t)-1)
+#define AESCCM_STATUS_RESOURCE_UNAVAILABLE ((int_fast16_t)-2)
+#define AESCCM_STATUS_MAC_INVALID          ((int_fast16_t)-3)
+
+typedef enum {
+    AESCCM_RETURN_BEHAVIOR_CALLBACK = 1,
+    AESCCM_RETURN_BEHAVIOR_BLOCKING = 2,
+    AESCCM_RETURN_BEHAVIOR_POLLING  = 4,
+} AESCCM_ReturnBehavior;
+
+typedef struct AESCCM_Config* AESCCM_Handle;
+
+typedef struct {
+    AESCCM_ReturnBehavior returnBehavior;
+} AESCCM_Params;
+
+typedef struct {
+    CryptoKey* key;
+    uint8_t*   aad;
+    uint8_t*   input;
+    uint8_t*   output;
+    uint8_t*   nonce;
+    uint8_t*   mac;
+    size_t     aadLength;
+    size_t     inputLength;
+    uint8_t    nonceLength;
+    uint8_t    macLength;
+} AESCCM_OneStepOperation;
+
+void          AESCCM_init(void);
+void          AESCCM_Params_init(AESCCM_Params* params);
+AESCCM_Handle AESCCM_open(uint_least8_t index, AESCCM_Params const* params);
+void          AESCCM_close(AESCCM_Handle handle);
+void          AESCCM_OneStepOperation_init(AESCCM_OneStepOperation* operation);
+int_fast16_t  AESCCM_oneStepEncrypt(AESCCM_Handle handle, AESCCM_OneStepOperation* operation);
+int_fast16_t  AESCCM_oneStepDecrypt(AESCCM_Handle handle, AESCCM_OneStepOperation* operation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_AESCCM_H_ included
@@ -0,0 +1,56 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK AESECB driver, polling mode only
+*/
+
+#ifndef FAKE_TI_DRIVERS_AESECB_H_
+#define FAKE_TI_DRIVERS_AESECB_H_
+
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKey.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AESECB_STATUS_SUCCESS ((int_fast16_t)0)
+#define AESECB_STATUS_ERROR   ((int_fast16_t)-1)
+
+typedef enum {
+    AESECB_RETURN_BEHAVIOR_CALLBACK = 1,
+    AESECB_RETURN_BEHAVIOR_BLOCKING = 2,
+    AESECB_RETURN_BEHAVIOR_POLLING  = 4,
+} AESECB_ReturnBehavior;
+
+typedef struct AESECB_Config* AESECB_Handle;
+
+typedef struct {
+    AESECB_ReturnBehavior returnBehavior;
+} AESECB_Params;
+
+typedef struct {
+    CryptoKey* key;
+    uint8_t*   input;
+    uint8_t*   output;
+    size_t     inputLength;
+} AESECB_Operation;
+
+void          AESECB_init(void);
+void          AESECB_Params_init(AESECB_Params* params);
+AESECB_Handle AESECB_open(uint_least8_t index, AESECB_Params const* params);
+void          AESECB_close(AESECB_Handle handle);
+void          AESECB_Operation_init(AESECB_Operation* operation);
+int_fast16_t  AESECB_oneStepEncrypt(AESECB_Handle handle, AESECB_Operation* operation);
+int_fast16_t  AESECB_oneStepDecrypt(AESECB_Handle handle, AESECB_Operation* operation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_AESECB_H_ included
@@ -0,0 +1,30 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK Power driver
+*/
+
+#ifndef FAKE_TI_DRIVERS_POWER_H_
+#define FAKE_TI_DRIVERS_POWER_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int_fast16_t  Power_setConstraint(uint_fast16_t constraintId);
+int_fast16_t  Power_releaseConstraint(uint_fast16_t constraintId);
+uint_fast32_t Power_getConstraintMask(void);
+void          Power_idleFunc(void);
+int_fast16_t  Power_setDependency(uint_fast16_t resourceId);
+int_fast16_t  Power_releaseDependency(uint_fast16_t resourceId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_POWER_H_ included
@@ -0,0 +1,61 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK UART2 driver
+*/
+
+#ifndef FAKE_TI_DRIVERS_UART2_H_
+#define FAKE_TI_DRIVERS_UART2_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UART2_STATUS_SUCCESS ((int_fast16_t)0)
+#define UART2_STATUS_EINUSE  ((int_fast16_t)-4)
+#define UART2_STATUS_EAGAIN  ((int_fast16_t)-5)
+
+typedef enum {
+    UART2_Mode_BLOCKING,
+    UART2_Mode_CALLBACK,
+    UART2_Mode_NONBLOCKING,
+} UART2_Mode;
+
+typedef struct UART2_Config_* UART2_Handle;
+
+typedef void (*UART2_Callback)(UART2_Handle handle, void* buf, size_t count, void* userArg, int_fast16_t status);
+
+typedef struct {
+    UART2_Mode     readMode;
+    UART2_Mode     writeMode;
+    UART2_Callback readCallback;
+    UART2_Callback writeCallback;
+    uint32_t       baudRate;
+    void*          userArg;
+} UART2_Params;
+
+typedef struct UART2_Config_ {
+    void*       object;
+    void const* hwAttrs;
+} UART2_Config;
+
+void         UART2_Params_init(UART2_Params* params);
+UART2_Handle UART2_open(uint_least8_t index, UART2_Params* params);
+void         UART2_close(UART2_Handle handle);
+void         UART2_rxEnable(UART2_Handle handle);
+size_t       UART2_getRxCount(UART2_Handle handle);
+int_fast16_t UART2_read(UART2_Handle handle, void* buffer, size_t size, size_t* bytesRead);
+int_fast16_t UART2_write(UART2_Handle handle, const void* buffer, size_t size, size_t* bytesWritten);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_UART2_H_ included
@@ -0,0 +1,40 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK CryptoKey definitions, plaintext keys only
+*/
+
+#ifndef FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEY_H_
+#define FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CryptoKey_PLAINTEXT 0x02
+
+typedef uint8_t CryptoKey_Encoding;
+
+typedef struct {
+    uint8_t* keyMaterial;
+    uint32_t keyLength;
+} CryptoKey_Plaintext;
+
+typedef struct {
+    CryptoKey_Encoding encoding;
+    union {
+        CryptoKey_Plaintext plaintext;
+    } u;
+} CryptoKey;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEY_H_ included
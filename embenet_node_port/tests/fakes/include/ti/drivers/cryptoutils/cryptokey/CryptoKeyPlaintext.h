@@ -0,0 +1,25 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK CryptoKeyPlaintext module
+*/
+
+#ifndef FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEYPLAINTEXT_H_
+#define FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEYPLAINTEXT_H_
+
+#include <ti/drivers/cryptoutils/cryptokey/CryptoKey.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int_fast16_t CryptoKeyPlaintext_initKey(CryptoKey* keyHandle, uint8_t* key, size_t keyLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_CRYPTOUTILS_CRYPTOKEY_CRYPTOKEYPLAINTEXT_H_ included
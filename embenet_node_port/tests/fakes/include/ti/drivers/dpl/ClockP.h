@@ -0,0 +1,51 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK ClockP module
+*/
+
+#ifndef FAKE_TI_DRIVERS_DPL_CLOCKP_H_
+#define FAKE_TI_DRIVERS_DPL_CLOCKP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*ClockP_Fxn)(uintptr_t arg);
+
+typedef struct {
+    bool      startFlag;
+    uint32_t  period;
+    uintptr_t arg;
+} ClockP_Params;
+
+typedef struct ClockP_Struct {
+    ClockP_Fxn fxn;
+    uintptr_t  arg;
+    uint32_t   timeout;  ///< in system ticks
+    uint64_t   deadline; ///< simulated time of the expiry in ns
+    bool       active;
+} ClockP_Struct;
+
+typedef ClockP_Struct* ClockP_Handle;
+
+void          ClockP_Params_init(ClockP_Params* params);
+ClockP_Handle ClockP_construct(ClockP_Struct* clockP, ClockP_Fxn clockFxn, uint32_t timeout, ClockP_Params* params);
+void          ClockP_destruct(ClockP_Struct* clockP);
+ClockP_Handle ClockP_handle(ClockP_Struct* clockP);
+void          ClockP_setTimeout(ClockP_Handle handle, uint32_t timeout);
+void          ClockP_start(ClockP_Handle handle);
+void          ClockP_stop(ClockP_Handle handle);
+uint32_t      ClockP_getSystemTickPeriod(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_DPL_CLOCKP_H_ included
@@ -0,0 +1,26 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK HwiP module
+*/
+
+#ifndef FAKE_TI_DRIVERS_DPL_HWIP_H_
+#define FAKE_TI_DRIVERS_DPL_HWIP_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uintptr_t HwiP_disable(void);
+void      HwiP_restore(uintptr_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_DPL_HWIP_H_ included
@@ -0,0 +1,15 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK CC26X2 power definitions
+*/
+
+#ifndef FAKE_TI_DRIVERS_POWER_POWERCC26X2_H_
+#define FAKE_TI_DRIVERS_POWER_POWERCC26X2_H_
+
+#include <ti/drivers/power/PowerCC26XX.h>
+
+#endif // FAKE_TI_DRIVERS_POWER_POWERCC26X2_H_ included
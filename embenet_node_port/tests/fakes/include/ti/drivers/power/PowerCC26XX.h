@@ -0,0 +1,22 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK CC26XX power definitions
+*/
+
+#ifndef FAKE_TI_DRIVERS_POWER_POWERCC26XX_H_
+#define FAKE_TI_DRIVERS_POWER_POWERCC26XX_H_
+
+#include <ti/drivers/Power.h>
+
+#define PowerCC26XX_DISALLOW_SHUTDOWN 0
+#define PowerCC26XX_DISALLOW_STANDBY  1
+#define PowerCC26XX_DISALLOW_IDLE     2
+#define PowerCC26XX_NUMCONSTRAINTS    8
+
+#define PowerCC26XX_PERIPH_CRYPTO 5
+
+#endif // FAKE_TI_DRIVERS_POWER_POWERCC26XX_H_ included
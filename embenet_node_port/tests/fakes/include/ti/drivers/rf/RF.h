@@ -0,0 +1,110 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK RF driver, commands are recorded and their events are raised by the test, see sim_rf.h
+*/
+
+#ifndef FAKE_TI_DRIVERS_RF_RF_H_
+#define FAKE_TI_DRIVERS_RF_RF_H_
+
+#include <ti/devices/DeviceFamily.h>
+// clang-format off
+#include DeviceFamily_constructPath(driverlib/rf_mailbox.h)
+#include DeviceFamily_constructPath(driverlib/rf_common_cmd.h)
+#include DeviceFamily_constructPath(driverlib/rf_prop_cmd.h)
+// clang-format on
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RF_NUM_RAT_TICKS_IN_1_US 4
+#define RF_GET_RSSI_ERROR_VAL    (-128)
+#define RF_ALLOC_ERROR           (-2)
+
+#define RF_TxPowerTable_MIN_DBM     (-128)
+#define RF_TxPowerTable_MAX_DBM     126
+#define RF_TxPowerTable_INVALID_DBM 127
+
+#define RF_CTRL_UPDATE_SETUP_CMD 1
+
+typedef uint64_t RF_EventMask;
+
+#define RF_EventCmdDone      ((RF_EventMask)1 << 0)
+#define RF_EventLastCmdDone  ((RF_EventMask)1 << 1)
+#define RF_EventMdmSoft      ((RF_EventMask)1 << 9)
+#define RF_EventRxOk         ((RF_EventMask)1 << 16)
+#define RF_EventRxNOk        ((RF_EventMask)1 << 17)
+#define RF_EventCmdCancelled ((RF_EventMask)1 << 60)
+#define RF_EventCmdAborted   ((RF_EventMask)1 << 61)
+#define RF_EventCmdStopped   ((RF_EventMask)1 << 62)
+
+typedef rfc_radioOp_t RF_Op;
+typedef int16_t       RF_CmdHandle;
+
+typedef enum {
+    RF_PriorityNormal  = 0,
+    RF_PriorityHigh    = 1,
+    RF_PriorityHighest = 2,
+} RF_Priority;
+
+typedef enum {
+    RF_StatSuccess,
+    RF_StatError,
+    RF_StatInvalidParamsError,
+} RF_Stat;
+
+typedef struct {
+    uint8_t rfMode;
+} RF_Mode;
+
+typedef union {
+    rfc_radioOp_t                  commandId;
+    rfc_CMD_PROP_RADIO_DIV_SETUP_t prop_div;
+} RF_RadioSetup;
+
+typedef struct {
+    uint32_t nInactivityTimeout;
+    uint32_t nPowerUpDuration;
+} RF_Params;
+
+typedef struct {
+    RF_Mode const* mode;
+    RF_RadioSetup* setup;
+} RF_Object;
+
+typedef RF_Object* RF_Handle;
+
+typedef void (*RF_Callback)(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+
+typedef struct {
+    uint32_t rawValue; ///< The fake stores the power in dBm
+} RF_TxPowerTable_Value;
+
+typedef struct {
+    int8_t                power;
+    RF_TxPowerTable_Value value;
+} RF_TxPowerTable_Entry;
+
+void                  RF_Params_init(RF_Params* params);
+RF_Handle             RF_open(RF_Object* pObj, RF_Mode* pRfMode, RF_RadioSetup* pRadioSetup, RF_Params* params);
+void                  RF_close(RF_Handle h);
+RF_CmdHandle          RF_postCmd(RF_Handle h, RF_Op* pOp, RF_Priority ePri, RF_Callback pCb, RF_EventMask bmEvent);
+RF_EventMask          RF_runCmd(RF_Handle h, RF_Op* pOp, RF_Priority ePri, RF_Callback pCb, RF_EventMask bmEvent);
+RF_Stat               RF_flushCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode);
+RF_Stat               RF_control(RF_Handle h, int8_t ctrl, void* args);
+RF_Stat               RF_setTxPower(RF_Handle h, RF_TxPowerTable_Value value);
+uint32_t              RF_getCurrentTime(void);
+int8_t                RF_getRssi(RF_Handle h);
+RF_TxPowerTable_Value RF_TxPowerTable_findValue(RF_TxPowerTable_Entry table[], int8_t powerLevel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_RF_RF_H_ included
@@ -0,0 +1,79 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK GPTimerCC26XX driver
+*/
+
+#ifndef FAKE_TI_DRIVERS_TIMER_GPTIMERCC26XX_H_
+#define FAKE_TI_DRIVERS_TIMER_GPTIMERCC26XX_H_
+
+#include <ti/devices/DeviceFamily.h>
+#include DeviceFamily_constructPath(driverlib/interrupt.h)
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    GPT_INT_TIMEOUT = 1 << 0,
+    GPT_INT_MATCH   = 1 << 4,
+} GPTimerCC26XX_Interrupt;
+
+typedef uint16_t GPTimerCC26XX_IntMask;
+
+typedef enum {
+    GPT_CONFIG_32BIT,
+    GPT_CONFIG_16BIT,
+} GPTimerCC26XX_Width;
+
+typedef enum {
+    GPT_MODE_ONESHOT_UP,
+    GPT_MODE_PERIODIC_UP,
+} GPTimerCC26XX_Mode;
+
+typedef enum {
+    GPTimerCC26XX_DEBUG_STALL_OFF,
+    GPTimerCC26XX_DEBUG_STALL_ON,
+} GPTimerCC26XX_DebugMode;
+
+typedef struct {
+    GPTimerCC26XX_Width     width;
+    GPTimerCC26XX_Mode      mode;
+    GPTimerCC26XX_DebugMode debugStallMode;
+} GPTimerCC26XX_Params;
+
+typedef struct {
+    uint32_t intNum;
+} GPTimerCC26XX_HWAttrs;
+
+typedef struct GPTimerCC26XX_Config {
+    const GPTimerCC26XX_HWAttrs* hwAttrs;
+} GPTimerCC26XX_Config;
+
+typedef GPTimerCC26XX_Config* GPTimerCC26XX_Handle;
+
+typedef void (*GPTimerCC26XX_HwiFxn)(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask interruptMask);
+
+void                 GPTimerCC26XX_Params_init(GPTimerCC26XX_Params* params);
+GPTimerCC26XX_Handle GPTimerCC26XX_open(unsigned int index, const GPTimerCC26XX_Params* params);
+void                 GPTimerCC26XX_close(GPTimerCC26XX_Handle handle);
+void                 GPTimerCC26XX_start(GPTimerCC26XX_Handle handle);
+void                 GPTimerCC26XX_stop(GPTimerCC26XX_Handle handle);
+void                 GPTimerCC26XX_setLoadValue(GPTimerCC26XX_Handle handle, uint32_t loadValue);
+void                 GPTimerCC26XX_setMatchValue(GPTimerCC26XX_Handle handle, uint32_t matchValue);
+uint32_t             GPTimerCC26XX_getFreeRunValue(GPTimerCC26XX_Handle handle);
+void                 GPTimerCC26XX_registerInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_HwiFxn callback, GPTimerCC26XX_IntMask intMask);
+void                 GPTimerCC26XX_unregisterInterrupt(GPTimerCC26XX_Handle handle);
+void                 GPTimerCC26XX_enableInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask intMask);
+void                 GPTimerCC26XX_disableInterrupt(GPTimerCC26XX_Handle handle, GPTimerCC26XX_IntMask intMask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_TIMER_GPTIMERCC26XX_H_ included
@@ -0,0 +1,26 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the SimpleLink SDK UART2 support functions
+*/
+
+#ifndef FAKE_TI_DRIVERS_UART2_UART2SUPPORT_H_
+#define FAKE_TI_DRIVERS_UART2_UART2SUPPORT_H_
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Returns true when the transmitter shifted out the last byte
+bool UART2Support_txDone(void const* hwAttrs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_DRIVERS_UART2_UART2SUPPORT_H_ included
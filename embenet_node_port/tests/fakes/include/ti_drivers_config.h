@@ -0,0 +1,20 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the configuration generated by SysConfig
+*/
+
+#ifndef FAKE_TI_DRIVERS_CONFIG_H_
+#define FAKE_TI_DRIVERS_CONFIG_H_
+
+#include <ti/devices/DeviceFamily.h>
+
+#define CONFIG_GPTIMER_0 0
+#define EMBENET_AES      0
+#define EMBENET_AESCCM   0
+#define EMBENET_UART     0
+
+#endif // FAKE_TI_DRIVERS_CONFIG_H_ included
@@ -0,0 +1,30 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Fake of the radio configuration generated by SysConfig
+*/
+
+#ifndef FAKE_TI_RADIO_CONFIG_H_
+#define FAKE_TI_RADIO_CONFIG_H_
+
+#include <ti/drivers/rf/RF.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TX_POWER_TABLE_SIZE_custom868_0 16 ///< 0 to 14 dBm, and the termination entry
+
+extern RF_Mode                        RF_prop_custom868_0;
+extern rfc_CMD_PROP_RADIO_DIV_SETUP_t RF_cmdPropRadioDivSetup_custom868_0;
+extern rfc_CMD_TX_TEST_t              RF_cmdTxTest_custom868_0;
+extern RF_TxPowerTable_Entry          txPowerTable_custom868_0[TX_POWER_TABLE_SIZE_custom868_0];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAKE_TI_RADIO_CONFIG_H_ included
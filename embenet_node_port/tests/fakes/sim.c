@@ -0,0 +1,113 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Simulated time and interrupts behind the fake SDK drivers
+*/
+
+#include "sim.h"
+
+#include <stddef.h>
+
+enum {
+    SIM_MAX_SOURCES = 8,
+    SIM_ACCESS_NS   = 50, ///< Duration of a register access
+};
+
+static struct {
+    uint64_t          now;
+    SIM_Source const* sources[SIM_MAX_SOURCES];
+    unsigned          sourceCount;
+    bool              interruptsEnabled;
+    bool              inInterrupt;
+} sim = {.interruptsEnabled = true};
+
+void SIM_Reset(void) {
+    sim.now               = 0;
+    sim.sourceCount       = 0;
+    sim.interruptsEnabled = true;
+    sim.inInterrupt       = false;
+}
+
+uint64_t SIM_Now(void) {
+    return sim.now;
+}
+
+void SIM_AddSource(SIM_Source const* source) {
+    for (unsigned i = 0; i < sim.sourceCount; ++i) {
+        if (sim.sources[i] == source) {
+            return;
+        }
+    }
+    if (sim.sourceCount < SIM_MAX_SOURCES) {
+        sim.sources[sim.sourceCount++] = source;
+    }
+}
+
+static SIM_Source const* SIM_EarliestSource(uint64_t* time) {
+    SIM_Source const* earliest = NULL;
+    *time                      = SIM_NEVER;
+    for (unsigned i = 0; i < sim.sourceCount; ++i) {
+        uint64_t next = sim.sources[i]->next();
+        if (next < *time) {
+            *time    = next;
+            earliest = sim.sources[i];
+        }
+    }
+    return earliest;
+}
+
+uint64_t SIM_NextEvent(void) {
+    uint64_t time;
+    (void)SIM_EarliestSource(&time);
+    return time;
+}
+
+// Handles the interrupts that are due, if they can be taken now
+static void SIM_HandlePending(void) {
+    while (sim.interruptsEnabled && !sim.inInterrupt) {
+        uint64_t          time;
+        SIM_Source const* source = SIM_EarliestSource(&time);
+        if ((NULL == source) || (time > sim.now)) {
+            return;
+        }
+        sim.inInterrupt = true;
+        source->service();
+        sim.inInterrupt = false;
+    }
+}
+
+void SIM_AdvanceTo(uint64_t time) {
+    while (sim.now < time) {
+        uint64_t next = SIM_NextEvent();
+        // Pending interrupts that cannot be taken now do not stop the time
+        sim.now = (next > sim.now && next < time) ? next : time;
+        SIM_HandlePending();
+    }
+    SIM_HandlePending();
+}
+
+void SIM_Advance(uint64_t ns) {
+    SIM_AdvanceTo(sim.now + ns);
+}
+
+void SIM_Access(void) {
+    SIM_Advance(SIM_ACCESS_NS);
+}
+
+bool SIM_DisableInterrupts(void) {
+    bool enabled          = sim.interruptsEnabled;
+    sim.interruptsEnabled = false;
+    return enabled;
+}
+
+void SIM_EnableInterrupts(void) {
+    sim.interruptsEnabled = true;
+    SIM_HandlePending();
+}
+
+bool SIM_InInterrupt(void) {
+    return sim.inInterrupt;
+}
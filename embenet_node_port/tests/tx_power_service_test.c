@@ -0,0 +1,247 @@
+/**
+@file
+@license   Commercial
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET Node port tests
+@brief     Transmission power service of the demo, simulated over links with log-distance path loss
+
+The node runs the service, each of its neighbors runs the same control law on its side of the link. Frames arrive
+when the power less the path loss and a Gaussian fade is above the sensitivity. ACKs are sent at the maximum power
+and carry it, so the path loss reported by the radio is exact up to the fade. The radio functions used by the service are provided by the simulation.
+*/
+
+#include "embenet_test.h"
+#include "sim_node.h"
+
+#include <embenet_radio_cc1312.h>
+#include <tx_power_service.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    TEST_LINKS             = 5,     ///< Neighbors of the node
+    TEST_FRAMES_PER_PERIOD = 100,   ///< Frames sent in each direction of a link in a period of the service
+    TEST_PERIOD            = 10000, ///< Period of the service in ms
+    TEST_PERIODS           = 60,    ///< Periods simulated in a run, the second half is evaluated
+    TEST_SENSITIVITY       = -100,  ///< Sensitivity of the radio in dBm
+    TEST_MIN_OUTPUT_POWER  = 0,
+    TEST_MAX_OUTPUT_POWER  = 14,
+    TEST_RSSI_UNKNOWN      = 127,
+    TEST_ACK_RSSI_WEIGHT   = 4,     ///< Inverse of the weight of a new sample in the average RSSI of ACKs, as in the radio of the port
+};
+
+#define TEST_PATH_LOSS_1M       31.2 ///< Free space loss at 1 m and 868 MHz in dB
+#define TEST_PATH_LOSS_EXPONENT 3.0  ///< Exponent of the log-distance model, urban environment
+#define TEST_FADE_SIGMA         3.0  ///< Standard deviation of the fade of a single frame in dB
+#define TEST_PI                 3.14159265358979323846
+#define TEST_EUI(link)          (UINT64_C(0x00124b0000000100) + (link))
+
+/// Link to a neighbor
+typedef struct {
+    double              distance;             ///< Distance to the neighbor in m
+    double              pathLoss;             ///< Path loss in dB
+    EMBENET_RADIO_Power txp;                  ///< Power set by the service for frames to the neighbor
+    EMBENET_RADIO_Power settledTxp;           ///< Power set by the service at the end of the run
+    TxPowerControl      neighbor;             ///< Power control of the neighbor, for frames to the node
+    double              ackRssi;              ///< Average RSSI of ACKs of the neighbor received by the node
+    bool                ackRssiKnown;         ///< True if ackRssi holds at least one sample
+    double              neighborAckRssi;      ///< Average RSSI of ACKs of the node received by the neighbor
+    bool                neighborAckRssiKnown; ///< True if neighborAckRssi holds at least one sample
+    uint32_t            sent;                 ///< Frames sent to the neighbor in the evaluated periods
+    uint32_t            delivered;            ///< Frames delivered to the neighbor in the evaluated periods
+    double              energy;               ///< Sum of the power of the frames sent in the evaluated periods in mW
+} TestLink;
+
+static TestLink                   testLinks[TEST_LINKS];
+static bool                       testAckRssiAvailable; ///< False simulates the service estimating the loss from any frame of the neighbor
+static uint32_t                   testRandomState;
+static EMBENET_RADIO_Capabilities testCapabilities = {
+    .sensitivity    = TEST_SENSITIVITY,
+    .maxOutputPower = TEST_MAX_OUTPUT_POWER,
+    .minOutputPower = TEST_MIN_OUTPUT_POWER,
+};
+
+EMBENET_RADIO_Capabilities const* EMBENET_RADIO_GetCapabilities(void) {
+    return &testCapabilities;
+}
+
+EMBENET_RADIO_Status EMBENET_RADIO_SetLinkTxPower(uint64_t eui, EMBENET_RADIO_Power txp) {
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        if (TEST_EUI(i) == eui) {
+            testLinks[i].txp = (EMBENET_RADIO_LINK_TXP_DEFAULT == txp) ? TEST_MAX_OUTPUT_POWER : txp;
+            return EMBENET_RADIO_STATUS_SUCCESS;
+        }
+    }
+    return EMBENET_RADIO_STATUS_PARAMETER_ARG1_OUT_OF_BOUNDS;
+}
+
+bool EMBENET_RADIO_GetLinkPathLoss(uint64_t eui, int16_t* pathLoss) {
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        if ((TEST_EUI(i) == eui) && testAckRssiAvailable && testLinks[i].ackRssiKnown) {
+            *pathLoss = (int16_t)ceil(TEST_MAX_OUTPUT_POWER - testLinks[i].ackRssi); // the ACK carries its power, the maximum one in the simulation
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Deterministic generator, so that every run simulates the same fades
+static double TestUniform(void) {
+    testRandomState ^= testRandomState << 13;
+    testRandomState ^= testRandomState >> 17;
+    testRandomState ^= testRandomState << 5;
+    return (testRandomState + 1.0) / 4294967297.0;
+}
+
+static double TestFade(void) {
+    return TEST_FADE_SIGMA * sqrt(-2.0 * log(TestUniform())) * cos(2.0 * TEST_PI * TestUniform());
+}
+
+/**
+ * @brief Sends a frame over a link and its ACK back
+ * @param[in] link link
+ * @param[in] txp power of the frame
+ * @param[out] rssi RSSI of the frame
+ * @param[out] ackRssi RSSI of the ACK, sent at the maximum power
+ * @return 0 if the frame was lost, 1 if the frame arrived, 2 if its ACK arrived too
+ */
+static unsigned TestSendFrame(TestLink const* link, EMBENET_RADIO_Power txp, double* rssi, double* ackRssi) {
+    *rssi = txp - link->pathLoss + TestFade();
+    if (*rssi < TEST_SENSITIVITY) {
+        return 0;
+    }
+    *ackRssi = TEST_MAX_OUTPUT_POWER - link->pathLoss + TestFade();
+    return (*ackRssi < TEST_SENSITIVITY) ? 1 : 2;
+}
+
+static void TestAverage(double* average, bool* known, double sample) {
+    *average = *known ? (*average + (sample - *average) / TEST_ACK_RSSI_WEIGHT) : sample;
+    *known   = true;
+}
+
+/// Sends the traffic of a period in both directions of every link and updates the diagnostics of the node
+static void TestRunPeriod(bool evaluated) {
+    EMBENET_NODE_DIAG_NeighborInfo neighbors[TEST_LINKS];
+    EMBENET_NODE_DIAG_CellInfo     cells[TEST_LINKS];
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        TestLink* link = &testLinks[i];
+        double    rssi;
+        double    ackRssi;
+
+        // the neighbor sends with the power of its own control loop, the node hears the frames and the neighbor hears the ACKs
+        double   rssiSum  = 0;
+        unsigned received = 0;
+        unsigned acked    = 0;
+        for (unsigned frame = 0; frame != TEST_FRAMES_PER_PERIOD; ++frame) {
+            unsigned result = TestSendFrame(link, link->neighbor.txp, &rssi, &ackRssi);
+            if (0 != result) {
+                rssiSum += rssi;
+                ++received;
+            }
+            if (2 == result) {
+                TestAverage(&link->neighborAckRssi, &link->neighborAckRssiKnown, ackRssi);
+                ++acked;
+            }
+        }
+        (void)tx_power_control_update(&link->neighbor, &testCapabilities, link->neighborAckRssiKnown ? (int8_t)floor(link->neighborAckRssi) : TEST_RSSI_UNKNOWN,
+                                      (uint16_t)(acked * 10000u / TEST_FRAMES_PER_PERIOD));
+
+        // the node sends with the power set by the service
+        acked = 0;
+        for (unsigned frame = 0; frame != TEST_FRAMES_PER_PERIOD; ++frame) {
+            if (2 == TestSendFrame(link, link->txp, &rssi, &ackRssi)) {
+                TestAverage(&link->ackRssi, &link->ackRssiKnown, ackRssi);
+                ++acked;
+            }
+        }
+        if (evaluated) {
+            link->sent += TEST_FRAMES_PER_PERIOD;
+            link->delivered += acked;
+            link->energy += TEST_FRAMES_PER_PERIOD * pow(10.0, link->txp / 10.0);
+        }
+
+        neighbors[i] = (EMBENET_NODE_DIAG_NeighborInfo){
+            .eui  = TEST_EUI(i),
+            .rssi = (0 != received) ? (int8_t)floor(rssiSum / received) : TEST_RSSI_UNKNOWN,
+            .role = EMBENET_NODE_DIAG_NEIGHBOR_ROLE_CHILD,
+        };
+        cells[i] = (EMBENET_NODE_DIAG_CellInfo){
+            .role         = EMBENET_NODE_DIAG_CELL_ROLE_MANAGED,
+            .type         = EMBENET_NODE_DIAG_CELL_TYPE_TX,
+            .pdr          = (uint16_t)((0 != acked) ? acked * 10000u / TEST_FRAMES_PER_PERIOD : 1), // 0 stands for a cell that carried nothing
+            .companionEui = TEST_EUI(i),
+        };
+    }
+    SIM_NODE_SetNeighbors(neighbors, TEST_LINKS);
+    SIM_NODE_SetCells(cells, TEST_LINKS);
+}
+
+/// Runs the service over links to neighbors at increasing distances and prints the result of every link
+static void TestRunNetwork(bool ackRssiAvailable) {
+    static double const distances[TEST_LINKS] = {60, 100, 150, 200, 300};
+
+    SIM_NODE_Reset();
+    testAckRssiAvailable = ackRssiAvailable;
+    testRandomState      = 0x2545f491;
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        testLinks[i] = (TestLink){
+            .distance = distances[i],
+            .pathLoss = TEST_PATH_LOSS_1M + 10.0 * TEST_PATH_LOSS_EXPONENT * log10(distances[i]),
+            .txp      = TEST_MAX_OUTPUT_POWER,
+        };
+        tx_power_control_init(&testLinks[i].neighbor, &testCapabilities);
+    }
+
+    tx_power_service_init();
+    tx_power_service_start();
+    for (size_t period = 0; period != TEST_PERIODS; ++period) {
+        TestRunPeriod(period >= TEST_PERIODS / 2);
+        SIM_NODE_RunUntil((period + 1) * TEST_PERIOD);
+    }
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        testLinks[i].settledTxp = testLinks[i].txp;
+    }
+    tx_power_service_stop();
+
+    printf("path loss from %s\n", ackRssiAvailable ? "ACKs" : "any frame");
+    printf("distance   loss  neighbor txp  txp     PDR   mW/frame\n");
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        TestLink const* link = &testLinks[i];
+        printf("%6.0f m  %5.1f  %12d  %3d  %5.1f%%  %9.2f\n", link->distance, link->pathLoss, (int)link->neighbor.txp, (int)link->settledTxp,
+               100.0 * link->delivered / link->sent, link->energy / link->sent);
+    }
+}
+
+/// Power needed for the frames to arrive TX_POWER_BASE_MARGIN (10 dB) above the sensitivity, within the range of the radio
+static int TestIdealTxp(TestLink const* link) {
+    int txp = (int)ceil(TEST_SENSITIVITY + 10 + link->pathLoss);
+    return (txp < TEST_MIN_OUTPUT_POWER) ? TEST_MIN_OUTPUT_POWER : ((txp > TEST_MAX_OUTPUT_POWER) ? TEST_MAX_OUTPUT_POWER : txp);
+}
+
+static void TestPowerFollowsPathLoss(void) {
+    double energyWithoutAcks = 0;
+    TestRunNetwork(false);
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        energyWithoutAcks += testLinks[i].energy / testLinks[i].sent;
+    }
+
+    double energy = 0;
+    TestRunNetwork(true);
+    for (size_t i = 0; i != TEST_LINKS; ++i) {
+        TestLink const* link = &testLinks[i];
+        energy += link->energy / link->sent;
+        TEST_CHECK_RANGE(link->delivered * 100u / link->sent, 95, 100);
+        TEST_CHECK_RANGE(link->settledTxp, TestIdealTxp(link) - 1, TestIdealTxp(link) + 3);
+    }
+    printf("mean power %.2f mW from ACKs, %.2f mW from any frame\n", energy / TEST_LINKS, energyWithoutAcks / TEST_LINKS);
+    // the neighbors lower their power as well, so their frames overstate the loss and the node wastes power
+    TEST_CHECK(energy < 0.7 * energyWithoutAcks);
+}
+
+int main(void) {
+    TEST_RUN(TestPowerFollowsPathLoss);
+    return TEST_RESULT();
+}
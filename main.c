@@ -19,10 +19,14 @@
 
 // embeNET includes
 #include "embenet_node.h"
+#include "embenet_timer_cc1312.h"
 #include "enms_node.h"
 // demo services
+#include "channel_map_service.h"
 #include "custom_service.h"
 #include "mqttsn_client_service.h"
+#include "radio_diag_service.h"
+#include "tx_power_service.h"
 // board and chip specific header files
 #include "ti_drivers_config.h"
 #include <ti/drivers/GPIO.h>
@@ -64,6 +68,12 @@ static void onJoined(EMBENET_PANID panId, const EMBENET_NODE_QuickJoinCredential
     } else {
         printf("ENMS service failed to start with status: %d\n", (int)enmsStartStatus);
     }
+    // Start channel map service that excludes channels with poor link quality network-wide
+    channel_map_service_start();
+    // Start transmission power control of neighbor links
+    tx_power_service_start();
+    // Start evaluation of radio counters
+    radio_diag_service_start();
 
 #if 1 != IS_ROOT
     // Start exemplary, user-defined custom service
@@ -85,6 +95,12 @@ static void onLeft(void) {
     } else {
         printf("ENMS service failed to stop with status: %d\n", (int)enmsStopStatus);
     }
+    // Stop channel map service
+    channel_map_service_stop();
+    // Stop transmission power control
+    tx_power_service_stop();
+    // Stop evaluation of radio counters
+    radio_diag_service_stop();
 
 #if 1 != IS_ROOT
     // Stop exemplary, user-defined custom service
@@ -160,6 +176,9 @@ int main(void) {
     } else {
         printf("Failed to initialize embeNET Node\n");
     }
+    // Feed link layer events to the channel map service
+    static const EMBENET_NODE_TraceHandlers traceHandlers = {.onLinkLayerEvent = channel_map_service_on_link_layer_event};
+    EMBENET_NODE_SetTraceHandlers(&traceHandlers);
     // Construct 128-bit hardware ID using 64-bit UID (here actually 802.15.4 MAC Address)
     uint8_t hardwareId[16] = {0x00};
     uint64_t uid = EMBENET_NODE_GetUID();
@@ -171,6 +190,12 @@ int main(void) {
     } else {
         printf("Failed to initialize ENMS service!\n");
     }
+    // Initialize channel map service, the root builds and distributes the channel map
+    channel_map_service_init(&enmsNode, 1 == IS_ROOT);
+    // Initialize transmission power control service
+    tx_power_service_init();
+    // Initialize radio diagnostic service, which reports the radio state through ENMS
+    radio_diag_service_init(&enmsNode);
 
 #if 1 == IS_ROOT
     printf("Acting as root with UID: 0x%x%08x\n", (unsigned)(EMBENET_NODE_GetUID()>>32), (unsigned)(EMBENET_NODE_GetUID()));
@@ -210,6 +235,8 @@ int main(void) {
             // When acting as Node, run the MQTT-SN service process
             mqttsn_client_service_proc();
         #endif
+        // Enter standby until shortly before the next event of the stack, unless it has work pending
+        (void)EMBENET_TIMER_Sleep();
     }
 }
 
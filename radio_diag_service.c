@@ -0,0 +1,104 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Periodic evaluation of radio event counters
+*/
+
+#include "radio_diag_service.h"
+
+#include "embenet_node.h"
+#include "embenet_radio_cc1312.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+enum {
+    RADIO_DIAG_PERIOD        = 60000, ///< Time between evaluations of the counters in ms
+    RADIO_DIAG_MAX_ERROR_PCT = 10,    ///< Share of failed receptions or transmissions in percent above which the radio is reported degraded
+};
+
+/// Name of the service reported to ENMS
+static const char radioDiagServiceName[] = "radio";
+/// Id of the task evaluating the counters
+static EMBENET_TaskId radioDiagTaskId = EMBENET_TASKID_INVALID;
+/// ENMS instance the state is reported to
+static EnmsNode* radioDiagEnmsNode;
+/// Counters read in the previous evaluation
+static EMBENET_RADIO_Counters previousCounters;
+
+
+/**
+ * @brief Checks whether failures exceed RADIO_DIAG_MAX_ERROR_PCT of all attempts
+ * @param[in] failures number of failures in the period
+ * @param[in] successes number of successes in the period
+ * @return true if too many attempts failed
+ */
+static bool isDegraded(uint32_t failures, uint32_t successes) {
+    return (uint64_t)failures * 100 > (uint64_t)(failures + successes) * RADIO_DIAG_MAX_ERROR_PCT;
+}
+
+
+/**
+ * @brief Task evaluating radio counters, invoked every RADIO_DIAG_PERIOD
+ *
+ * @param[in] taskId id of the task
+ * @param[in] timeSource time source (local time or network time)
+ * @param[in] t time at which the task was scheduled to run
+ * @param[in] context generic, user-defined context
+ */
+static void radioDiagTask(EMBENET_TaskId taskId, EMBENET_NODE_TimeSource timeSource, uint64_t t, void* context) {
+    EMBENET_RADIO_Counters counters;
+    EMBENET_RADIO_GetCounters(&counters);
+
+    // counters wrap, differences stay valid
+    uint32_t rxFrames       = counters.rxFrames - previousCounters.rxFrames;
+    uint32_t rxCrcErrors    = counters.rxCrcErrors - previousCounters.rxCrcErrors;
+    uint32_t rxSyncMisses   = counters.rxSyncMisses - previousCounters.rxSyncMisses;
+    uint32_t rxOverflows    = counters.rxOverflows - previousCounters.rxOverflows;
+    uint32_t rxErrors       = counters.rxErrors - previousCounters.rxErrors;
+    uint32_t txFrames       = counters.txFrames - previousCounters.txFrames;
+    uint32_t txCcaBusy      = counters.txCcaBusy - previousCounters.txCcaBusy;
+    uint32_t txAborts       = counters.txAborts - previousCounters.txAborts;
+    uint32_t ackFlushMisses = counters.ackFlushMisses - previousCounters.ackFlushMisses;
+    uint32_t rxLatencySum   = counters.rxLatencySum - previousCounters.rxLatencySum;
+    previousCounters        = counters;
+
+    printf("RADIO_DIAG_SERVICE: rx %" PRIu32 " crc %" PRIu32 " sync miss %" PRIu32 " overflow %" PRIu32 " error %" PRIu32 "\n", rxFrames, rxCrcErrors,
+           rxSyncMisses, rxOverflows, rxErrors);
+    printf("RADIO_DIAG_SERVICE: tx %" PRIu32 " cca busy %" PRIu32 " abort %" PRIu32 " unwanted ack %" PRIu32 " callback latency mean %" PRIu32 " max %" PRIu32
+           " us\n",
+           txFrames, txCcaBusy, txAborts, ackFlushMisses, (0 != rxFrames) ? (rxLatencySum / rxFrames) : 0, (uint32_t)counters.rxLatencyMax);
+
+    bool degraded = isDegraded(rxCrcErrors + rxOverflows + rxErrors, rxFrames) || isDegraded(txAborts, txFrames);
+    (void)ENMS_NODE_SetServiceState(radioDiagEnmsNode, radioDiagServiceName, degraded ? 0 : 1);
+
+    EMBENET_NODE_TaskSchedule(taskId, timeSource, t + RADIO_DIAG_PERIOD);
+}
+
+
+void radio_diag_service_init(EnmsNode* enmsNode) {
+    radioDiagEnmsNode = enmsNode;
+    (void)ENMS_NODE_RegisterService(enmsNode, radioDiagServiceName, 1);
+    radioDiagTaskId = EMBENET_NODE_TaskCreate(radioDiagTask, NULL);
+    if (EMBENET_TASKID_INVALID == radioDiagTaskId) {
+        printf("RADIO_DIAG_SERVICE: Unable to create task\n");
+    } else {
+        printf("RADIO_DIAG_SERVICE: Service initialized\n");
+    }
+}
+
+
+void radio_diag_service_start(void) {
+    printf("RADIO_DIAG_SERVICE: Starting service\n");
+    EMBENET_RADIO_GetCounters(&previousCounters);
+    EMBENET_NODE_TaskSchedule(radioDiagTaskId, EMBENET_NODE_TIME_SOURCE_LOCAL, EMBENET_NODE_GetLocalTime() + RADIO_DIAG_PERIOD);
+}
+
+
+void radio_diag_service_stop(void) {
+    printf("RADIO_DIAG_SERVICE: Stopping service\n");
+    EMBENET_NODE_TaskCancel(radioDiagTaskId);
+}
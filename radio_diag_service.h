@@ -0,0 +1,34 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Periodic evaluation of radio event counters
+*/
+
+#ifndef RADIO_DIAG_SERVICE_H_
+#define RADIO_DIAG_SERVICE_H_
+
+#include "enms_node.h"
+
+/**
+ * @brief Initializes the radio diagnostic service.
+ *
+ * Registers the "radio" service in ENMS and initializes a periodic task. The state of the service reported in the ENMS status
+ * is 1 while the radio works normally and 0 after a period with many CRC errors, overflows or aborted transmissions.
+ *
+ * @param[in] enmsNode ENMS Node service instance
+ */
+void radio_diag_service_init(EnmsNode* enmsNode);
+
+/**
+ * @brief Starts the radio diagnostic service.
+ */
+void radio_diag_service_start(void);
+
+/**
+ * @brief Stops the radio diagnostic service.
+ */
+void radio_diag_service_stop(void);
+
+#endif
@@ -0,0 +1,196 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Closed-loop transmission power control of every neighbor link
+*/
+
+#include "tx_power_service.h"
+
+#include "embenet_node.h"
+#include "embenet_node_diag.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+enum {
+    TX_POWER_PERIOD      = 10000, ///< Time between updates of the power in ms
+    TX_POWER_LINK_COUNT  = 16,    ///< Maximum number of controlled links
+    TX_POWER_BASE_MARGIN = 10,    ///< Margin above sensitivity kept on links without losses in dB
+    TX_POWER_MAX_MARGIN  = 20,    ///< Maximum margin added on lossy links in dB
+    TX_POWER_MARGIN_UP   = 3,     ///< Margin increase after a period with poor delivery in dB
+    TX_POWER_MARGIN_DOWN = 1,     ///< Margin decrease after a period with good delivery in dB
+    TX_POWER_MAX_STEP    = 2,     ///< Maximum decrease of power in a single period in dB
+    TX_POWER_PDR_LOW     = 9000,  ///< Delivery ratio below which the margin grows in 0.01% units
+    TX_POWER_PDR_HIGH    = 9800,  ///< Delivery ratio above which the margin shrinks in 0.01% units
+    RSSI_UNKNOWN         = 127,   ///< RSSI reported by the stack if it is not available
+};
+
+/// Controlled link
+typedef struct {
+    uint64_t       eui;     ///< EUI of the neighbor, 0 if the entry is free
+    TxPowerControl control; ///< State of power control
+    bool           seen;    ///< True if the neighbor was present in the last update
+} TxPowerLink;
+
+/// Id of the task running the power control
+static EMBENET_TaskId txPowerTaskId = EMBENET_TASKID_INVALID;
+/// Controlled links
+static TxPowerLink links[TX_POWER_LINK_COUNT];
+
+
+void tx_power_control_init(TxPowerControl* control, EMBENET_RADIO_Capabilities const* capabilities) {
+    *control = (TxPowerControl){.txp = capabilities->maxOutputPower, .margin = 0};
+}
+
+
+EMBENET_RADIO_Power tx_power_control_update(TxPowerControl* control, EMBENET_RADIO_Capabilities const* capabilities, int8_t rssi, uint16_t pdr) {
+    if (TX_POWER_PDR_UNKNOWN != pdr) {
+        if (pdr < TX_POWER_PDR_LOW) {
+            control->margin = (int8_t)((control->margin + TX_POWER_MARGIN_UP > TX_POWER_MAX_MARGIN) ? TX_POWER_MAX_MARGIN : control->margin + TX_POWER_MARGIN_UP);
+        } else if (pdr >= TX_POWER_PDR_HIGH) {
+            control->margin = (int8_t)((control->margin < TX_POWER_MARGIN_DOWN) ? 0 : control->margin - TX_POWER_MARGIN_DOWN);
+        }
+    }
+
+    int target = capabilities->maxOutputPower;
+    if (RSSI_UNKNOWN != rssi) {
+        int pathLoss = capabilities->maxOutputPower - rssi; // rssi is that of a frame sent at the maximum power
+        target       = capabilities->sensitivity + TX_POWER_BASE_MARGIN + control->margin + pathLoss;
+    }
+    if (target > capabilities->maxOutputPower) {
+        target = capabilities->maxOutputPower;
+    }
+    if (target < capabilities->minOutputPower) {
+        target = capabilities->minOutputPower;
+    }
+
+    // Losses are repaired at once, while the power is lowered slowly so that a single strong frame does not break the link
+    if (target < control->txp - TX_POWER_MAX_STEP) {
+        target = control->txp - TX_POWER_MAX_STEP;
+    }
+    control->txp = (EMBENET_RADIO_Power)target;
+    return control->txp;
+}
+
+
+/**
+ * @brief Gets delivery ratio of frames sent to given neighbor
+ * @param[in] eui EUI of the neighbor
+ * @param[in] role role of the neighbor
+ * @return delivery ratio in 0.01% units, TX_POWER_PDR_UNKNOWN if there are no transmit cells to the neighbor
+ */
+static uint16_t getNeighborPdr(uint64_t eui, EMBENET_NODE_DIAG_NeighborRole role) {
+    if (EMBENET_NODE_DIAG_NEIGHBOR_ROLE_PARENT == role) {
+        return EMBENET_NODE_DIAG_GetParentPDR();
+    }
+    uint32_t pdrSum    = 0;
+    unsigned cellCount = 0;
+    unsigned cells     = EMBENET_NODE_DIAG_GetCellsCount();
+    for (unsigned i = 0; i != cells; ++i) {
+        EMBENET_NODE_DIAG_CellInfo cell = EMBENET_NODE_DIAG_GetCellInfo(i);
+        bool                       tx   = (EMBENET_NODE_DIAG_CELL_TYPE_TX == cell.type) || (EMBENET_NODE_DIAG_CELL_TYPE_TXRX == cell.type);
+        // cells that carried no frames yet report 0
+        if (tx && (eui == cell.companionEui) && (0 != cell.pdr)) {
+            pdrSum += cell.pdr;
+            ++cellCount;
+        }
+    }
+    return (0 == cellCount) ? TX_POWER_PDR_UNKNOWN : (uint16_t)(pdrSum / cellCount);
+}
+
+
+static TxPowerLink* findLink(uint64_t eui) {
+    TxPowerLink* freeLink = NULL;
+    for (size_t i = 0; i != TX_POWER_LINK_COUNT; ++i) {
+        if (eui == links[i].eui) {
+            return &links[i];
+        }
+        if ((NULL == freeLink) && (0 == links[i].eui)) {
+            freeLink = &links[i];
+        }
+    }
+    if (NULL != freeLink) {
+        freeLink->eui = eui;
+        tx_power_control_init(&freeLink->control, EMBENET_RADIO_GetCapabilities());
+    }
+    return freeLink;
+}
+
+
+static void releaseLinks(bool all) {
+    for (size_t i = 0; i != TX_POWER_LINK_COUNT; ++i) {
+        if ((0 != links[i].eui) && (all || !links[i].seen)) {
+            (void)EMBENET_RADIO_SetLinkTxPower(links[i].eui, EMBENET_RADIO_LINK_TXP_DEFAULT);
+            links[i].eui = 0;
+        }
+        links[i].seen = false;
+    }
+}
+
+
+/**
+ * @brief Task updating the power of every link, invoked every TX_POWER_PERIOD
+ *
+ * @param[in] taskId id of the task
+ * @param[in] timeSource time source (local time or network time)
+ * @param[in] t time at which the task was scheduled to run
+ * @param[in] context generic, user-defined context
+ */
+static void txPowerTask(EMBENET_TaskId taskId, EMBENET_NODE_TimeSource timeSource, uint64_t t, void* context) {
+    EMBENET_RADIO_Capabilities const* capabilities = EMBENET_RADIO_GetCapabilities();
+
+    unsigned neighbors = EMBENET_NODE_DIAG_GetNeighborCount();
+    for (unsigned i = 0; i != neighbors; ++i) {
+        EMBENET_NODE_DIAG_NeighborInfo neighbor = EMBENET_NODE_DIAG_GetNeighborInfo(i);
+        TxPowerLink*                   link     = (0 != neighbor.eui) ? findLink(neighbor.eui) : NULL;
+        if (NULL == link) {
+            continue;
+        }
+        link->seen = true;
+
+        // Until an ACK carrying its power is heard, RSSI of other frames of the neighbor overstates the loss, as they may be sent with lowered power
+        int8_t  rssi = neighbor.rssi;
+        int16_t pathLoss;
+        if (EMBENET_RADIO_GetLinkPathLoss(neighbor.eui, &pathLoss)) {
+            int equivalentRssi = capabilities->maxOutputPower - pathLoss; // RSSI of a frame sent at the maximum power
+            rssi               = (int8_t)((equivalentRssi < INT8_MIN) ? INT8_MIN : (equivalentRssi >= RSSI_UNKNOWN) ? RSSI_UNKNOWN - 1 : equivalentRssi);
+        }
+        EMBENET_RADIO_Power previousTxp = link->control.txp;
+        EMBENET_RADIO_Power txp         = tx_power_control_update(&link->control, capabilities, rssi, getNeighborPdr(neighbor.eui, neighbor.role));
+        if (txp != previousTxp) {
+            printf("TX_POWER_SERVICE: Power to 0x%08" PRIx32 "%08" PRIx32 " set to %d dBm\n", (uint32_t)(neighbor.eui >> 32), (uint32_t)neighbor.eui,
+                   (int)txp);
+        }
+        (void)EMBENET_RADIO_SetLinkTxPower(neighbor.eui, txp);
+    }
+    // neighbors that disappeared start again from the maximum power
+    releaseLinks(false);
+
+    EMBENET_NODE_TaskSchedule(taskId, timeSource, t + TX_POWER_PERIOD);
+}
+
+
+void tx_power_service_init(void) {
+    txPowerTaskId = EMBENET_NODE_TaskCreate(txPowerTask, NULL);
+    if (EMBENET_TASKID_INVALID == txPowerTaskId) {
+        printf("TX_POWER_SERVICE: Unable to create task\n");
+    } else {
+        printf("TX_POWER_SERVICE: Service initialized\n");
+    }
+}
+
+
+void tx_power_service_start(void) {
+    printf("TX_POWER_SERVICE: Starting service\n");
+    EMBENET_NODE_TaskSchedule(txPowerTaskId, EMBENET_NODE_TIME_SOURCE_LOCAL, EMBENET_NODE_GetLocalTime() + TX_POWER_PERIOD);
+}
+
+
+void tx_power_service_stop(void) {
+    printf("TX_POWER_SERVICE: Stopping service\n");
+    EMBENET_NODE_TaskCancel(txPowerTaskId);
+    releaseLinks(true);
+}
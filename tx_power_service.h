@@ -0,0 +1,67 @@
+/**
+@file
+@copyright (c) 2023 EMBETECH SP. Z O.O. All rights reserved.
+@version   1.1.4417
+@purpose   embeNET demo
+@brief     Closed-loop transmission power control of every neighbor link
+*/
+
+#ifndef TX_POWER_SERVICE_H_
+#define TX_POWER_SERVICE_H_
+
+#include "embenet_radio_cc1312.h"
+
+#include <stdint.h>
+
+/// Value of pdr passed to @ref tx_power_control_update when the delivery ratio of the link is not known
+#define TX_POWER_PDR_UNKNOWN UINT16_MAX
+
+/// State of power control of a single link
+typedef struct {
+    EMBENET_RADIO_Power txp;    ///< Current transmission power in dBm
+    int8_t              margin; ///< Extra link margin in dB, grows when frames are lost despite good RSSI
+} TxPowerControl;
+
+/**
+ * @brief Starts power control of a new link at the maximum power.
+ *
+ * @param[out] control state of the link
+ * @param[in] capabilities radio capabilities
+ */
+void tx_power_control_init(TxPowerControl* control, EMBENET_RADIO_Capabilities const* capabilities);
+
+/**
+ * @brief Computes transmission power of a link for the next period.
+ *
+ * The path loss is the maximum power less the given RSSI of a frame sent at the maximum power, derived from the path loss measured
+ * with ACKs (see @ref EMBENET_RADIO_GetLinkPathLoss). RSSI of other frames may be passed while no ACK was received, the neighbor may send
+ * them with less power, so the loss is overstated and the power errs on the high side. The power is chosen so that
+ * the frames arrive with a fixed margin above the sensitivity, extended when frames are lost. The power is raised at once
+ * and lowered gradually. The function has no dependencies on the stack, so the control law can be simulated on a host.
+ *
+ * @param[in, out] control state of the link
+ * @param[in] capabilities radio capabilities
+ * @param[in] rssi RSSI a frame sent by the neighbor at the maximum power would have in dBm, 127 if unknown
+ * @param[in] pdr delivery ratio of frames sent to the neighbor in 0.01% units, TX_POWER_PDR_UNKNOWN if unknown
+ * @return power to use in dBm
+ */
+EMBENET_RADIO_Power tx_power_control_update(TxPowerControl* control, EMBENET_RADIO_Capabilities const* capabilities, int8_t rssi, uint16_t pdr);
+
+/**
+ * @brief Initializes the transmission power control service.
+ *
+ * Initializes a periodic task that updates the transmission power of every neighbor from the diagnostic data of the stack.
+ */
+void tx_power_service_init(void);
+
+/**
+ * @brief Starts the transmission power control service.
+ */
+void tx_power_service_start(void);
+
+/**
+ * @brief Stops the transmission power control service and restores the power requested by the stack for every neighbor.
+ */
+void tx_power_service_stop(void);
+
+#endif